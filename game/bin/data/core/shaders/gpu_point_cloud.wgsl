@@ -0,0 +1,28 @@
+struct VertexInput
+{
+    @location(0) position: vec4f
+};
+
+struct VertexOutput 
+{
+    @builtin(position) position: vec4f,
+    @location(0) color: vec4f
+};
+
+@group(0) @binding(0) var<uniform> uGlobalUniforms: GlobalUniforms;
+
+@vertex fn vertexMain(in: VertexInput) -> VertexOutput
+{
+    var out: VertexOutput;
+    out.position = uGlobalUniforms.projectionMatrix * uGlobalUniforms.viewMatrix * vec4f(in.position.xyz, 1.0);
+
+    // Shade by altitude so shells at different heights can be told apart.
+    let altitude = clamp((length(in.position.xyz) - 6378.137) / 2000.0, 0.0, 1.0);
+    out.color = vec4f(mix(vec3f(1.0, 0.6, 0.2), vec3f(0.3, 0.8, 1.0), altitude), 1.0);
+    return out;
+}
+
+@fragment fn fragmentMain(in: VertexOutput) -> @location(0) vec4f 
+{
+    return in.color;
+}
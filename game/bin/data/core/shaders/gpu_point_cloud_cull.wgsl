@@ -0,0 +1,94 @@
+// Frustum and horizon culling of the propagated point cloud, one invocation per object. Visible positions
+// are compacted into a second buffer, and the number of them becomes the vertex count of an indirect draw.
+// Each workgroup counts its own survivors first, so only one global atomic is needed per workgroup.
+
+struct CullingUniforms
+{
+    planes: array<vec4f, 5>, // Four sides and the near plane: inward normal, and distance
+    scaledCameraPosition: vec3f, // In the space where the Earth is the unit sphere
+    horizonDistance2: f32,
+    inverseRadii: vec3f,
+    objectCount: u32,
+    occlusionEnabled: u32,
+    _padding0: u32,
+    _padding1: u32,
+    _padding2: u32
+};
+
+// Laid out as the arguments of DrawIndirect.
+struct DrawArguments
+{
+    vertexCount: atomic<u32>,
+    instanceCount: u32,
+    firstVertex: u32,
+    firstInstance: u32
+};
+
+@group(0) @binding(0) var<uniform> uCulling: CullingUniforms;
+@group(0) @binding(1) var<storage, read> positions: array<vec4f>;
+@group(0) @binding(2) var<storage, read_write> visiblePositions: array<vec4f>;
+@group(0) @binding(3) var<storage, read_write> drawArguments: DrawArguments;
+
+var<workgroup> workgroupCount: atomic<u32>;
+var<workgroup> workgroupBase: u32;
+
+fn isVisible(position: vec3f) -> bool
+{
+    for (var i = 0; i < 5; i++)
+    {
+        let plane = uCulling.planes[i];
+        if (dot(plane.xyz, position) + plane.w < 0.0)
+        {
+            return false;
+        }
+    }
+
+    if (uCulling.occlusionEnabled == 0u)
+    {
+        return true;
+    }
+
+    // Hidden when beyond the horizon plane and inside the cone which grazes the horizon.
+    let toObject = position * uCulling.inverseRadii - uCulling.scaledCameraPosition;
+    let alongCentre = -dot(toObject, uCulling.scaledCameraPosition);
+    let beyondHorizon = alongCentre > uCulling.horizonDistance2;
+    let insideCone = alongCentre * alongCentre > dot(toObject, toObject) * uCulling.horizonDistance2;
+    return !(beyondHorizon && insideCone);
+}
+
+@compute @workgroup_size(64) fn computeMain(@builtin(global_invocation_id) id: vec3u, @builtin(local_invocation_index) localIndex: u32)
+{
+    if (localIndex == 0u)
+    {
+        atomicStore(&workgroupCount, 0u);
+    }
+    workgroupBarrier();
+
+    // No early return for the tail of the last workgroup, as every invocation has to reach the barriers.
+    let index = id.x;
+    var position = vec4f(0.0);
+    var visible = false;
+    if (index < uCulling.objectCount)
+    {
+        position = positions[index];
+        visible = isVisible(position.xyz);
+    }
+
+    var slot = 0u;
+    if (visible)
+    {
+        slot = atomicAdd(&workgroupCount, 1u);
+    }
+    workgroupBarrier();
+
+    if (localIndex == 0u)
+    {
+        workgroupBase = atomicAdd(&drawArguments.vertexCount, atomicLoad(&workgroupCount));
+    }
+    let base = workgroupUniformLoad(&workgroupBase);
+
+    if (visible)
+    {
+        visiblePositions[base + slot] = position;
+    }
+}
@@ -0,0 +1,50 @@
+// Two-body propagation of every object in the point cloud, one invocation per object.
+// Mean anomalies are relative to a reference time which the CPU moves forward every so often, so the time
+// offset stays small enough for single precision.
+
+struct PropagationUniforms
+{
+    timeOffset: f32, // Seconds since the reference time
+    objectCount: u32,
+    _padding0: u32,
+    _padding1: u32
+};
+
+struct Orbit
+{
+    p: vec4f, // xyz: perifocal x axis scaled by the semi-major axis (km), w: eccentricity
+    q: vec4f  // xyz: perifocal y axis scaled by the semi-minor axis (km), w: mean motion (rad/s)
+};
+
+@group(0) @binding(0) var<uniform> uPropagation: PropagationUniforms;
+@group(0) @binding(1) var<storage, read> orbits: array<Orbit>;
+@group(0) @binding(2) var<storage, read> meanAnomalies: array<f32>; // At the reference time (rad)
+@group(0) @binding(3) var<storage, read_write> positions: array<vec4f>;
+
+const kTwoPi = 6.283185307179586;
+const kPi = 3.141592653589793;
+const kIterationCount = 8;
+
+@compute @workgroup_size(64) fn computeMain(@builtin(global_invocation_id) id: vec3u)
+{
+    let index = id.x;
+    if (index >= uPropagation.objectCount)
+    {
+        return;
+    }
+
+    let orbit = orbits[index];
+    let e = orbit.p.w;
+    var M = meanAnomalies[index] + orbit.q.w * uPropagation.timeOffset;
+    M = M - kTwoPi * floor(M / kTwoPi);
+
+    // A fixed number of Newton iterations keeps every invocation in step. Starting from π when the orbit
+    // is very eccentric avoids the overshoot near periapsis.
+    var E = select(M + e * sin(M), kPi, e > 0.8);
+    for (var i = 0; i < kIterationCount; i++)
+    {
+        E = E - (E - e * sin(E) - M) / (1.0 - e * cos(E));
+    }
+
+    positions[index] = vec4f((cos(E) - e) * orbit.p.xyz + sin(E) * orbit.q.xyz, 1.0);
+}
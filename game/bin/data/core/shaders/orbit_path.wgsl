@@ -0,0 +1,24 @@
+struct VertexInput
+{
+    @location(0) position: vec3f
+};
+
+struct VertexOutput
+{
+    @builtin(position) position: vec4f
+};
+
+@group(0) @binding(0) var<uniform> uGlobalUniforms: GlobalUniforms;
+
+@vertex fn vertexMain(in: VertexInput) -> VertexOutput
+{
+    var out: VertexOutput;
+    out.position = uGlobalUniforms.projectionMatrix * uGlobalUniforms.viewMatrix * vec4f(in.position, 1.0);
+    return out;
+}
+
+@fragment fn fragmentMain(in: VertexOutput) -> @location(0) vec4f
+{
+    // Faint, so a shell of thousands of overlapping orbits reads as a band rather than a solid sheet.
+    return vec4f(0.4, 0.7, 1.0, 0.25);
+}
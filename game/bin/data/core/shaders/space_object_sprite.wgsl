@@ -0,0 +1,56 @@
+struct InstanceInput
+{
+    @location(0) position: vec3f,
+    @location(1) style: vec4u // Red, green, blue, and the size in quarter pixels
+};
+
+struct VertexOutput
+{
+    @builtin(position) position: vec4f,
+    @location(0) color: vec3f,
+    @location(1) corner: vec2f
+};
+
+struct SpriteUniforms
+{
+    referenceDistance: f32,
+    minimumSize: f32,
+    maximumSize: f32,
+    _padding0: f32
+};
+
+@group(0) @binding(0) var<uniform> uGlobalUniforms: GlobalUniforms;
+@group(1) @binding(0) var<uniform> uSpriteUniforms: SpriteUniforms;
+
+@vertex fn vertexMain(@builtin(vertex_index) vertexIndex: u32, in: InstanceInput) -> VertexOutput
+{
+    var out: VertexOutput;
+
+    // Corners of a triangle strip quad, from -1 to 1.
+    let corner = vec2f(f32(vertexIndex & 1u), f32(vertexIndex >> 1u)) * 2.0 - 1.0;
+
+    // The size is inversely proportional to the distance, so nearby objects stand out from the shells behind them.
+    let distance = max(length(in.position - uGlobalUniforms.cameraPosition.xyz), 1.0);
+    let nominalSize = f32(in.style.w) * 0.25;
+    let size = clamp(nominalSize * uSpriteUniforms.referenceDistance / distance, uSpriteUniforms.minimumSize, uSpriteUniforms.maximumSize);
+
+    // Offset in clip space, scaled by w so the quad keeps its size in pixels after the perspective divide.
+    let center = uGlobalUniforms.projectionMatrix * uGlobalUniforms.viewMatrix * vec4f(in.position, 1.0);
+    let viewport = vec2f(uGlobalUniforms.windowWidth, uGlobalUniforms.windowHeight);
+    out.position = center + vec4f(corner * size / viewport * center.w, 0.0, 0.0);
+    out.color = vec3f(in.style.xyz) / 255.0;
+    out.corner = corner;
+    return out;
+}
+
+@fragment fn fragmentMain(in: VertexOutput) -> @location(0) vec4f
+{
+    let radius2 = dot(in.corner, in.corner);
+    if (radius2 > 1.0)
+    {
+        discard;
+    }
+
+    // Slightly darker towards the rim, so overlapping sprites can still be told apart.
+    return vec4f(in.color * (1.0 - 0.4 * radius2), 1.0);
+}
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <glm/vec3.hpp>
-#include <webgpu/webgpu_cpp.h>
 
 #include <scene/components/component_factory.hpp>
 #include <scene/components/icomponent.hpp>
@@ -47,12 +46,6 @@ public:
     // Number of samples for ray marching (5-10 typical)
     // More samples = better quality but slower
     int numSamples{ 5 };
-
-    // GPU resources
-    wgpu::Buffer uniformBuffer;
-    wgpu::BindGroup bindGroup;
-
-    bool initialized{ false };
 };
 
 REGISTER_COMPONENT(AtmosphereComponent, "atmosphere")
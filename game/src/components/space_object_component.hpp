@@ -1,29 +1,33 @@
 #pragma once
 
+#include <cstdint>
+
 #include <scene/components/component_factory.hpp>
 #include <scene/components/icomponent.hpp>
 
-#include "space_objects/space_object.hpp"
-
 namespace WingsOfSteel
 {
 
+// Refers to a space object in the sector's SpaceObjectCatalogue by NORAD catalogue ID, which stays the same
+// as the catalogue's records move and are replaced. The catalogue owns the element set; when it is updated
+// in place, the component is patched so systems know to read it again.
 class SpaceObjectComponent : public IComponent
 {
 public:
     SpaceObjectComponent() {}
+    SpaceObjectComponent(uint32_t noradCatalogueId)
+    : m_NoradCatalogueId(noradCatalogueId)
+    {}
     ~SpaceObjectComponent() {}
 
     void Deserialize(const ResourceDataStore* pContext, const Json::Data& json) override
     {
     }
 
-    void AssignSpaceObject(const SpaceObject& spaceObject) { m_SpaceObject = spaceObject; }
-    const SpaceObject& GetSpaceObject() const { return m_SpaceObject; }
-    SpaceObject& GetSpaceObject() { return m_SpaceObject; }
+    uint32_t GetNoradCatalogueId() const { return m_NoradCatalogueId; }
 
 private:
-    SpaceObject m_SpaceObject;
+    uint32_t m_NoradCatalogueId{ 0 };
 };
 
 REGISTER_COMPONENT(SpaceObjectComponent, "space_object")
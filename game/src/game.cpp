@@ -1,3 +1,20 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#include <array>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <core/log.hpp>
 #include <debug_visualization/model_visualization.hpp>
 #include <imgui/imgui_system.hpp>
 #include <input/input_system.hpp>
@@ -11,14 +28,95 @@
 #include <scene/systems/physics_simulation_system.hpp>
 
 #include "game.hpp"
+#include "jobs/worker_pool.hpp"
+#include "propagation/kepler_solver.hpp"
+#include "propagation/synthetic_population.hpp"
 #include "render/game_ui_render_pass.hpp"
 #include "render/sector_render_pass.hpp"
+#include "render/upload_ring.hpp"
 #include "sector/sector.hpp"
+#include "systems/gpu_propagation_system.hpp"
+#include "systems/orbit_path_system.hpp"
+#include "systems/orbit_simulation_system.hpp"
 #include "systems/planet_render_system.hpp"
+#include "systems/space_object_culling_system.hpp"
+#include "systems/space_object_render_system.hpp"
 
 namespace WingsOfSteel
 {
 
+namespace
+{
+
+constexpr const char* kTimeFormat = "%Y-%m-%dT%H:%M:%S";
+
+// Name searches in the Catalogue menu list no more than this many objects.
+constexpr size_t kMaximumFindResults = 10;
+
+// By OrbitalRegime.
+constexpr std::array<const char*, 5> kRegimeNames = { "LEO", "MEO", "GEO", "HEO", "Other" };
+
+std::string FormatTime(std::chrono::system_clock::time_point timePoint)
+{
+    const std::time_t time = std::chrono::system_clock::to_time_t(timePoint);
+    std::ostringstream ss;
+    ss << std::put_time(std::gmtime(&time), kTimeFormat);
+    return ss.str();
+}
+
+// Parses a UTC time in the same format FormatTime() writes.
+bool ParseTime(const char* pText, std::chrono::system_clock::time_point& timePoint)
+{
+    std::tm tm = {};
+    std::istringstream ss(pText);
+    ss >> std::get_time(&tm, kTimeFormat);
+    if (ss.fail())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    const std::time_t time = _mkgmtime(&tm);
+#else
+    const std::time_t time = timegm(&tm);
+#endif
+    timePoint = std::chrono::system_clock::from_time_t(time);
+    return true;
+}
+
+#if defined(TARGET_PLATFORM_NATIVE)
+std::filesystem::path GetExecutableDirectory()
+{
+#if defined(_WIN32)
+    std::wstring path(MAX_PATH, L'\0');
+    const DWORD length = GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size()));
+    path.resize(length);
+    return std::filesystem::path(path).parent_path();
+#else
+    std::error_code error;
+    const std::filesystem::path path = std::filesystem::read_symlink("/proc/self/exe", error);
+    return error ? std::filesystem::path() : path.parent_path();
+#endif
+}
+
+// The build copies the executable next to the data directory, so that is where the data is looked for first,
+// wherever the game was started from. The working directory is the fallback, e.g. when running the
+// executable straight from the build directory.
+std::filesystem::path FindDataDirectory()
+{
+    const std::filesystem::path relativePath = std::filesystem::path("data") / "core";
+    std::error_code error;
+    const std::filesystem::path executableDirectory = GetExecutableDirectory();
+    if (!executableDirectory.empty() && std::filesystem::is_directory(executableDirectory / relativePath, error))
+    {
+        return executableDirectory / relativePath;
+    }
+    return std::filesystem::current_path(error) / relativePath;
+}
+#endif
+
+} // anonymous namespace
+
 Game* g_pGame = nullptr;
 
 Game::Game()
@@ -52,6 +150,14 @@ void Game::Initialize()
     GetInputSystem()->SetCursorMode(CursorMode::Normal);
 #endif
 
+#if defined(TARGET_PLATFORM_NATIVE)
+    m_DataDirectory = FindDataDirectory();
+    Log::Info() << "Data directory is " << m_DataDirectory.string();
+#endif
+
+    m_pWorkerPool = std::make_unique<WorkerPool>();
+    m_pUploadRing = std::make_unique<UploadRing>();
+
     m_pSector = std::make_shared<Sector>();
     m_pSector->Initialize();
 
@@ -62,6 +168,14 @@ void Game::Update(float delta)
 {
 }
 
+#if defined(TARGET_PLATFORM_NATIVE)
+std::filesystem::path Game::GetResourceFilePath(const std::string& resourcePath) const
+{
+    // Resource paths are absolute within the data directory.
+    return m_DataDirectory / std::filesystem::path(resourcePath).relative_path();
+}
+#endif
+
 void Game::Shutdown()
 {
 }
@@ -161,6 +275,391 @@ void Game::DrawImGuiMenuBar()
             }
             ImGui::EndMenu();
         }
+
+        if (ImGui::BeginMenu("Catalogue"))
+        {
+            const Sector::IngestionProgress progress = m_pSector->GetIngestionProgress();
+            if (progress.loading)
+            {
+                ImGui::Text("Loading...");
+            }
+            else if (progress.created < progress.total)
+            {
+                const std::string overlay = std::to_string(progress.created) + " / " + std::to_string(progress.total);
+                ImGui::ProgressBar(static_cast<float>(progress.created) / static_cast<float>(progress.total), ImVec2(0.0f, 0.0f), overlay.c_str());
+            }
+            else
+            {
+                ImGui::Text("%zu objects", m_pSector->GetSpaceObjectCatalogue()->GetCount());
+            }
+
+            ImGui::SeparatorText("Groups");
+            for (size_t group = 0; group < m_pSector->GetCatalogueGroupCount(); ++group)
+            {
+                const Sector::CatalogueGroupState state = m_pSector->GetCatalogueGroupState(group);
+                const std::string& name = m_pSector->GetCatalogueGroupName(group);
+                std::string label = name;
+                if (state == Sector::CatalogueGroupState::Loading)
+                {
+                    label += " (loading)";
+                }
+                else if (state == Sector::CatalogueGroupState::Failed)
+                {
+                    label += " (failed to load)";
+                }
+
+                const bool selected = state == Sector::CatalogueGroupState::Loading || state == Sector::CatalogueGroupState::Loaded;
+                if (ImGui::MenuItem(label.c_str(), nullptr, selected))
+                {
+                    if (!selected)
+                    {
+                        m_pSector->LoadCatalogueGroup(group);
+                    }
+                    else
+                    {
+                        m_pSector->UnloadCatalogueGroup(group);
+                    }
+                }
+            }
+
+            SpaceObjectRenderSystem* pSpaceObjectRenderSystem = m_pSector->GetSystem<SpaceObjectRenderSystem>();
+            if (pSpaceObjectRenderSystem)
+            {
+                ImGui::SeparatorText("Display");
+                bool colorByRegime = pSpaceObjectRenderSystem->IsColorByRegimeEnabled();
+                if (ImGui::MenuItem("Color by regime", nullptr, &colorByRegime))
+                {
+                    pSpaceObjectRenderSystem->SetColorByRegimeEnabled(colorByRegime);
+                }
+
+                float pointSize = pSpaceObjectRenderSystem->GetPointSize();
+                if (ImGui::SliderFloat("Point size (px)", &pointSize, 1.0f, 16.0f, "%.1f"))
+                {
+                    pSpaceObjectRenderSystem->SetPointSize(pointSize);
+                }
+            }
+
+            SpaceObjectCullingSystem* pCullingSystem = m_pSector->GetSystem<SpaceObjectCullingSystem>();
+            if (pCullingSystem)
+            {
+                ImGui::SeparatorText("Culling");
+                bool cullingEnabled = pCullingSystem->IsEnabled();
+                if (ImGui::MenuItem("Cull hidden objects", nullptr, &cullingEnabled))
+                {
+                    pCullingSystem->SetEnabled(cullingEnabled);
+                }
+                ImGui::Text("%zu of %zu visible", pCullingSystem->GetVisibleCount(), pCullingSystem->GetObjectCount());
+            }
+
+            OrbitPathSystem* pOrbitPathSystem = m_pSector->GetSystem<OrbitPathSystem>();
+            if (pOrbitPathSystem)
+            {
+                ImGui::SeparatorText("Orbit paths");
+                for (size_t group = 0; group < m_pSector->GetCatalogueGroupCount(); ++group)
+                {
+                    if (m_pSector->GetCatalogueGroupState(group) != Sector::CatalogueGroupState::Loaded)
+                    {
+                        continue;
+                    }
+
+                    const std::string label = m_pSector->GetCatalogueGroupName(group) + "##OrbitPaths";
+                    const SpaceObjectCatalogue::GroupMask groupMask = m_pSector->GetCatalogueGroupMask(group);
+                    bool shown = (pOrbitPathSystem->GetShownGroups() & groupMask) != 0;
+                    if (ImGui::MenuItem(label.c_str(), nullptr, &shown))
+                    {
+                        if (shown)
+                        {
+                            pOrbitPathSystem->ShowGroupOrbits(groupMask);
+                        }
+                        else
+                        {
+                            pOrbitPathSystem->HideGroupOrbits(groupMask);
+                        }
+                    }
+                }
+
+                static int sOrbitNoradCatalogueId = 25544;
+                ImGui::InputInt("NORAD ID##OrbitPaths", &sOrbitNoradCatalogueId);
+                if (ImGui::Button("Show##OrbitPaths") && sOrbitNoradCatalogueId > 0)
+                {
+                    pOrbitPathSystem->ShowOrbit(static_cast<uint32_t>(sOrbitNoradCatalogueId));
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Hide##OrbitPaths") && sOrbitNoradCatalogueId > 0)
+                {
+                    pOrbitPathSystem->HideOrbit(static_cast<uint32_t>(sOrbitNoradCatalogueId));
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Clear##OrbitPaths"))
+                {
+                    pOrbitPathSystem->ClearOrbits();
+                }
+                ImGui::Text("%zu paths, %zu vertices", pOrbitPathSystem->GetPathCount(), pOrbitPathSystem->GetVertexCount());
+
+                // Objects found through the catalogue's indexes have their orbits shown or hidden.
+                ImGui::SeparatorText("Find");
+                const SpaceObjectCatalogue* pCatalogue = m_pSector->GetSpaceObjectCatalogue();
+                const auto showFoundOrbit = [pOrbitPathSystem, pCatalogue](uint32_t noradCatalogueId) {
+                    const std::string label = std::string(pCatalogue->GetObjectName(noradCatalogueId)) + " (" + std::to_string(noradCatalogueId) + ")##Find";
+                    bool shown = pOrbitPathSystem->IsOrbitShown(noradCatalogueId);
+                    if (!ImGui::MenuItem(label.c_str(), nullptr, &shown))
+                    {
+                        return;
+                    }
+
+                    if (shown)
+                    {
+                        pOrbitPathSystem->ShowOrbit(noradCatalogueId);
+                    }
+                    else
+                    {
+                        pOrbitPathSystem->HideOrbit(noradCatalogueId);
+                    }
+                };
+
+                static char sNamePrefix[64] = "";
+                ImGui::InputText("Name##Find", sNamePrefix, sizeof(sNamePrefix));
+                if (sNamePrefix[0] != '\0')
+                {
+                    for (const uint32_t noradCatalogueId : pCatalogue->FindByNamePrefix(sNamePrefix, kMaximumFindResults))
+                    {
+                        showFoundOrbit(noradCatalogueId);
+                    }
+                }
+
+                static char sObjectId[16] = "";
+                ImGui::InputText("COSPAR ID##Find", sObjectId, sizeof(sObjectId));
+                if (sObjectId[0] != '\0')
+                {
+                    const std::optional<SpaceObjectView> spaceObject = pCatalogue->FindByObjectId(sObjectId);
+                    if (spaceObject.has_value())
+                    {
+                        showFoundOrbit(spaceObject->GetNoradCatalogueId());
+                    }
+                    else
+                    {
+                        ImGui::Text("No match");
+                    }
+                }
+
+                for (size_t regime = 0; regime < kRegimeNames.size(); ++regime)
+                {
+                    const std::string label = std::string(kRegimeNames[regime]) + "##Find";
+                    if (regime > 0)
+                    {
+                        ImGui::SameLine();
+                    }
+                    if (ImGui::Button(label.c_str()))
+                    {
+                        pOrbitPathSystem->ShowOrbits(pCatalogue->FindByRegime(static_cast<OrbitalRegime>(regime)));
+                    }
+                }
+
+                static float sMinimumInclination = 96.0f;
+                static float sMaximumInclination = 100.0f;
+                ImGui::SliderFloat("Minimum inclination (deg)##Find", &sMinimumInclination, 0.0f, 180.0f, "%.1f");
+                ImGui::SliderFloat("Maximum inclination (deg)##Find", &sMaximumInclination, 0.0f, 180.0f, "%.1f");
+                if (ImGui::Button("Show inclination range##Find"))
+                {
+                    CatalogueIndex::RangeQuery query;
+                    query.inclination = CatalogueIndex::Range{ sMinimumInclination, sMaximumInclination };
+                    pOrbitPathSystem->ShowOrbits(pCatalogue->FindInRanges(query));
+                }
+            }
+
+            ImGui::SeparatorText("Ingestion");
+            float ingestionBudget = m_pSector->GetIngestionBudget();
+            if (ImGui::SliderFloat("Budget (ms/frame)", &ingestionBudget, 0.5f, 16.0f, "%.1f"))
+            {
+                m_pSector->SetIngestionBudget(ingestionBudget);
+            }
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("Time"))
+        {
+            SimulationClock& clock = m_pSector->GetSimulationClock();
+            const std::string timeLabel = FormatTime(clock.GetTimePoint()) + " UTC";
+            ImGui::SeparatorText(timeLabel.c_str());
+
+            bool paused = clock.IsPaused();
+            if (ImGui::MenuItem("Paused", nullptr, &paused))
+            {
+                clock.SetPaused(paused);
+            }
+
+            double timeScale = clock.GetTimeScale();
+            if (ImGui::SliderScalar("Time scale", ImGuiDataType_Double, &timeScale, &SimulationClock::kMinimumTimeScale, &SimulationClock::kMaximumTimeScale, "%.0fx", ImGuiSliderFlags_Logarithmic))
+            {
+                clock.SetTimeScale(timeScale);
+            }
+
+            if (ImGui::MenuItem("Jump to now"))
+            {
+                clock.JumpToNow();
+            }
+
+            static char sEpoch[32] = "";
+            ImGui::InputText("##Epoch", sEpoch, sizeof(sEpoch));
+            ImGui::SameLine();
+            std::chrono::system_clock::time_point epoch;
+            if (ImGui::Button("Jump to epoch") && ParseTime(sEpoch, epoch))
+            {
+                clock.JumpTo(epoch);
+            }
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("Orbits"))
+        {
+            OrbitSimulationSystem* pOrbitSimulationSystem = m_pSector->GetSystem<OrbitSimulationSystem>();
+            if (pOrbitSimulationSystem)
+            {
+                ImGui::SeparatorText("Propagator");
+                const PropagationStore::Model model = pOrbitSimulationSystem->GetPropagationModel();
+                if (ImGui::MenuItem("Two-body", nullptr, model == PropagationStore::Model::TwoBody))
+                {
+                    pOrbitSimulationSystem->SetPropagationModel(PropagationStore::Model::TwoBody);
+                }
+                if (ImGui::MenuItem("J2 secular", nullptr, model == PropagationStore::Model::J2Secular))
+                {
+                    pOrbitSimulationSystem->SetPropagationModel(PropagationStore::Model::J2Secular);
+                }
+                if (ImGui::MenuItem("SGP4", nullptr, model == PropagationStore::Model::Sgp4))
+                {
+                    pOrbitSimulationSystem->SetPropagationModel(PropagationStore::Model::Sgp4);
+                }
+
+                const std::string solverLabel = std::string("Kepler solver (") + KeplerSolver::GetInstructionSet() + ")";
+                ImGui::SeparatorText(solverLabel.c_str());
+                bool singlePrecision = pOrbitSimulationSystem->GetKeplerAccuracy() == KeplerSolver::Accuracy::Single;
+                if (ImGui::MenuItem("Single precision", nullptr, &singlePrecision))
+                {
+                    pOrbitSimulationSystem->SetKeplerAccuracy(singlePrecision ? KeplerSolver::Accuracy::Single : KeplerSolver::Accuracy::Double);
+                }
+
+                ImGui::SeparatorText("Level of detail");
+                bool levelOfDetail = pOrbitSimulationSystem->IsLevelOfDetailEnabled();
+                if (ImGui::MenuItem("Enabled", nullptr, &levelOfDetail))
+                {
+                    pOrbitSimulationSystem->SetLevelOfDetailEnabled(levelOfDetail);
+                }
+
+                float errorTolerance = pOrbitSimulationSystem->GetScreenSpaceErrorTolerance();
+                if (ImGui::SliderFloat("Error (px)", &errorTolerance, 0.05f, 4.0f, "%.2f", ImGuiSliderFlags_Logarithmic))
+                {
+                    pOrbitSimulationSystem->SetScreenSpaceErrorTolerance(errorTolerance);
+                }
+
+                int budget = static_cast<int>(pOrbitSimulationSystem->GetPropagationBudget());
+                if (ImGui::SliderInt("Budget", &budget, 0, 100000, budget == 0 ? "Unlimited" : "%d"))
+                {
+                    pOrbitSimulationSystem->SetPropagationBudget(static_cast<size_t>(budget));
+                }
+
+                ImGui::Text("%zu propagations", pOrbitSimulationSystem->GetPropagationCount());
+
+                ImGui::SeparatorText("Ephemeris cache");
+                EphemerisCache& ephemerisCache = pOrbitSimulationSystem->GetEphemerisCache();
+                bool ephemerisCacheEnabled = ephemerisCache.IsEnabled();
+                if (ImGui::MenuItem("Enabled##EphemerisCache", nullptr, &ephemerisCacheEnabled, GetWorkerPool()->GetWorkerCount() > 0))
+                {
+                    ephemerisCache.SetEnabled(ephemerisCacheEnabled);
+                }
+
+                float halfWindowHours = static_cast<float>(ephemerisCache.GetHalfWindow() / 3600.0);
+                if (ImGui::SliderFloat("Window (±h)", &halfWindowHours, 1.0f, 48.0f, "%.0f"))
+                {
+                    ephemerisCache.SetHalfWindow(halfWindowHours * 3600.0);
+                }
+
+                ImGui::Text("%s, %.1f MB", ephemerisCache.IsFitting() ? "Fitting" : "Idle", ephemerisCache.GetMemoryUsage() / (1024.0 * 1024.0));
+
+                ImGui::SeparatorText("Numerical propagation");
+                NumericalPropagator& numericalPropagator = pOrbitSimulationSystem->GetNumericalPropagator();
+                const NumericalPropagator::Integrator integrator = numericalPropagator.GetIntegrator();
+                if (ImGui::MenuItem("RK4", nullptr, integrator == NumericalPropagator::Integrator::RungeKutta4))
+                {
+                    numericalPropagator.SetIntegrator(NumericalPropagator::Integrator::RungeKutta4);
+                }
+                if (ImGui::MenuItem("Dormand-Prince 8(7)", nullptr, integrator == NumericalPropagator::Integrator::DormandPrince87))
+                {
+                    numericalPropagator.SetIntegrator(NumericalPropagator::Integrator::DormandPrince87);
+                }
+
+                if (integrator == NumericalPropagator::Integrator::RungeKutta4)
+                {
+                    float stepSize = static_cast<float>(numericalPropagator.GetStepSize());
+                    if (ImGui::SliderFloat("Step (s)", &stepSize, 1.0f, 300.0f, "%.0f", ImGuiSliderFlags_Logarithmic))
+                    {
+                        numericalPropagator.SetStepSize(stepSize);
+                    }
+                }
+                else
+                {
+                    float toleranceExponent = static_cast<float>(std::log10(numericalPropagator.GetTolerance()));
+                    if (ImGui::SliderFloat("Tolerance (10^x)", &toleranceExponent, -14.0f, -6.0f, "%.0f"))
+                    {
+                        numericalPropagator.SetTolerance(std::pow(10.0, std::round(toleranceExponent)));
+                    }
+                }
+
+                NumericalPropagator::ForceModel forceModel = numericalPropagator.GetForceModel();
+                int zonalDegree = static_cast<int>(forceModel.zonalDegree);
+                bool forceModelChanged = ImGui::SliderInt("Zonal degree", &zonalDegree, 2, 6);
+                forceModelChanged |= ImGui::MenuItem("Drag", nullptr, &forceModel.drag);
+                forceModelChanged |= ImGui::MenuItem("Sun and Moon", nullptr, &forceModel.thirdBody);
+                if (forceModelChanged)
+                {
+                    forceModel.zonalDegree = static_cast<uint32_t>(zonalDegree);
+                    numericalPropagator.SetForceModel(forceModel);
+                }
+
+                static int sNoradCatalogueId = 25544;
+                ImGui::InputInt("NORAD ID", &sNoradCatalogueId);
+                if (ImGui::Button("Add") && sNoradCatalogueId > 0)
+                {
+                    pOrbitSimulationSystem->AddHighFidelityObject(static_cast<uint32_t>(sNoradCatalogueId));
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Clear"))
+                {
+                    pOrbitSimulationSystem->ClearHighFidelityObjects();
+                }
+                ImGui::Text("%zu objects", pOrbitSimulationSystem->GetHighFidelityObjectCount());
+            }
+
+            GpuPropagationSystem* pGpuPropagationSystem = m_pSector->GetSystem<GpuPropagationSystem>();
+            if (pGpuPropagationSystem)
+            {
+                ImGui::SeparatorText("GPU point cloud");
+                bool gpuPropagationEnabled = pGpuPropagationSystem->IsEnabled();
+                if (ImGui::MenuItem("Enabled##GpuPropagation", nullptr, &gpuPropagationEnabled))
+                {
+                    pGpuPropagationSystem->SetEnabled(gpuPropagationEnabled);
+                }
+                bool gpuCullingEnabled = pGpuPropagationSystem->IsCullingEnabled();
+                if (ImGui::MenuItem("Cull on GPU", nullptr, &gpuCullingEnabled))
+                {
+                    pGpuPropagationSystem->SetCullingEnabled(gpuCullingEnabled);
+                }
+
+                static int sSyntheticObjectCount = 100000;
+                ImGui::SliderInt("Objects", &sSyntheticObjectCount, 1000, static_cast<int>(GpuPropagationSystem::kMaximumObjectCount), "%d", ImGuiSliderFlags_Logarithmic);
+                if (ImGui::Button("Generate"))
+                {
+                    const double epoch = m_pSector->GetSimulationClock().GetTime();
+                    pGpuPropagationSystem->SetObjects(GenerateSyntheticPopulation(static_cast<size_t>(sSyntheticObjectCount), epoch));
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Clear##GpuPropagation"))
+                {
+                    pGpuPropagationSystem->Clear();
+                }
+                ImGui::Text("%zu objects", pGpuPropagationSystem->GetObjectCount());
+            }
+            ImGui::EndMenu();
+        }
     }
 }
 
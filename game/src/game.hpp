@@ -1,5 +1,8 @@
 #pragma once
 
+#include <filesystem>
+#include <string>
+
 #include "core/smart_ptr.hpp"
 #include "scene/entity.hpp"
 #include "scene/scene.hpp"
@@ -8,6 +11,8 @@ namespace WingsOfSteel
 {
 
 DECLARE_SMART_PTR(Sector);
+DECLARE_SMART_PTR(UploadRing);
+DECLARE_SMART_PTR(WorkerPool);
 
 class Game
 {
@@ -20,13 +25,26 @@ public:
     void Shutdown();
 
     Sector* GetSector();
+    WorkerPool* GetWorkerPool();
+    UploadRing* GetUploadRing();
+
+#if defined(TARGET_PLATFORM_NATIVE)
+    // Where a resource, such as "/celestrak/stations.json", is on disk, for code which reads or watches the
+    // file itself rather than going through the resource system.
+    std::filesystem::path GetResourceFilePath(const std::string& resourcePath) const;
+#endif
 
     static Game* Get();
 
 private:
     void DrawImGuiMenuBar();
 
+    WorkerPoolUniquePtr m_pWorkerPool; // Declared before the sector so it outlives the sector's systems
+    UploadRingUniquePtr m_pUploadRing;
     SectorSharedPtr m_pSector;
+#if defined(TARGET_PLATFORM_NATIVE)
+    std::filesystem::path m_DataDirectory;
+#endif
 };
 
 inline Sector* Game::GetSector()
@@ -34,4 +52,14 @@ inline Sector* Game::GetSector()
     return m_pSector.get();
 }
 
+inline WorkerPool* Game::GetWorkerPool()
+{
+    return m_pWorkerPool.get();
+}
+
+inline UploadRing* Game::GetUploadRing()
+{
+    return m_pUploadRing.get();
+}
+
 } // namespace WingsOfSteel
@@ -0,0 +1,208 @@
+#include <algorithm>
+
+#include "jobs/worker_pool.hpp"
+
+namespace WingsOfSteel
+{
+
+WorkerPool::WorkerPool(size_t workerCount)
+{
+    m_ChunkQueues.reserve(workerCount + 1);
+    for (size_t i = 0; i < workerCount + 1; ++i)
+    {
+        m_ChunkQueues.push_back(std::make_unique<ChunkQueue>());
+    }
+
+    m_Threads.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        m_Threads.emplace_back(&WorkerPool::WorkerMain, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Stop = true;
+    }
+    m_WakeCondition.notify_all();
+
+    // Workers finish whatever they are running, but background tasks which haven't started yet are dropped.
+    for (std::thread& thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+size_t WorkerPool::GetDefaultWorkerCount()
+{
+#if defined(TARGET_PLATFORM_WEB)
+    return 0;
+#else
+    // The thread calling ParallelFor() does its share of the work, so it doesn't need a worker of its own.
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+#endif
+}
+
+void WorkerPool::ParallelFor(size_t count, size_t grainSize, const RangeFunction& function)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (m_Threads.empty() || chunkCount == 1)
+    {
+        function(0, count);
+        return;
+    }
+
+    ParallelForJob job;
+    job.pFunction = &function;
+    job.remainingChunks.store(chunkCount, std::memory_order_relaxed);
+
+    // Chunks are dealt out round-robin so every worker starts with something in its own queue,
+    // and only has to steal once it has run dry.
+    const size_t queueCount = m_ChunkQueues.size();
+    for (size_t queueIndex = 0; queueIndex < queueCount; ++queueIndex)
+    {
+        ChunkQueue& queue = *m_ChunkQueues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t chunkIndex = queueIndex; chunkIndex < chunkCount; chunkIndex += queueCount)
+        {
+            const size_t begin = chunkIndex * grainSize;
+            queue.chunks.push_back({ &job, begin, std::min(begin + grainSize, count) });
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_QueuedChunks.fetch_add(chunkCount, std::memory_order_relaxed);
+    }
+    m_WakeCondition.notify_all();
+
+    // Help out until every chunk of this job has been claimed, then wait for the ones still in flight.
+    // The calling thread may end up running chunks belonging to other ParallelFor() calls, but never
+    // background tasks, which could stall it for much longer than the job itself.
+    const size_t externalQueueIndex = queueCount - 1;
+    Chunk chunk;
+    while (job.remainingChunks.load(std::memory_order_acquire) > 0)
+    {
+        if (TryPopChunk(externalQueueIndex, chunk) || TryStealChunk(externalQueueIndex, chunk))
+        {
+            RunChunk(chunk);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkerPool::Submit(Task task)
+{
+    if (m_Threads.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Tasks.push_back(std::move(task));
+        m_QueuedTasks++;
+    }
+    m_WakeCondition.notify_one();
+}
+
+void WorkerPool::WorkerMain(size_t workerIndex)
+{
+    Chunk chunk;
+    Task task;
+    while (true)
+    {
+        if (TryPopChunk(workerIndex, chunk) || TryStealChunk(workerIndex, chunk))
+        {
+            RunChunk(chunk);
+            continue;
+        }
+
+        if (TryPopTask(task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.wait(lock, [this]() { return m_Stop || m_QueuedChunks.load(std::memory_order_relaxed) > 0 || m_QueuedTasks > 0; });
+        if (m_Stop)
+        {
+            return;
+        }
+    }
+}
+
+bool WorkerPool::TryPopChunk(size_t queueIndex, Chunk& chunk)
+{
+    ChunkQueue& queue = *m_ChunkQueues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.chunks.empty())
+    {
+        return false;
+    }
+
+    // The owner takes from the back, which is where the most recently queued job's chunks are...
+    chunk = queue.chunks.back();
+    queue.chunks.pop_back();
+    m_QueuedChunks.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkerPool::TryStealChunk(size_t thiefIndex, Chunk& chunk)
+{
+    const size_t queueCount = m_ChunkQueues.size();
+    for (size_t offset = 1; offset < queueCount; ++offset)
+    {
+        ChunkQueue& queue = *m_ChunkQueues[(thiefIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.chunks.empty())
+        {
+            // ... while thieves take from the front, so they rarely contend with it.
+            chunk = queue.chunks.front();
+            queue.chunks.pop_front();
+            m_QueuedChunks.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::TryPopTask(Task& task)
+{
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    if (m_Tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(m_Tasks.front());
+    m_Tasks.pop_front();
+    m_QueuedTasks--;
+    return true;
+}
+
+void WorkerPool::RunChunk(const Chunk& chunk)
+{
+    (*chunk.pJob->pFunction)(chunk.begin, chunk.end);
+
+    // The job lives on the stack of the thread that called ParallelFor(), which may return as soon as
+    // this reaches zero, so it mustn't be touched afterwards.
+    chunk.pJob->remainingChunks.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+} // namespace WingsOfSteel
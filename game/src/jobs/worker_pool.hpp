@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+// Persistent pool of worker threads, sized to the machine.
+// ParallelFor() splits a range into fixed-size chunks which are spread over per-worker deques; each worker
+// drains its own deque and steals from the others once it runs dry, and the calling thread joins in until
+// every chunk has run. Chunk boundaries only depend on the grain size, so any work that writes results by
+// index is deterministic regardless of how many threads there are.
+// Submit() queues longer-running background work, which workers only pick up when there are no chunks to
+// run, and which ParallelFor() callers never execute themselves.
+// Builds without thread support (e.g. the web build) have no workers and run everything inline.
+DECLARE_SMART_PTR(WorkerPool);
+class WorkerPool
+{
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+    using Task = std::function<void()>;
+
+    WorkerPool(size_t workerCount = GetDefaultWorkerCount());
+    ~WorkerPool();
+
+    void ParallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+    void Submit(Task task);
+
+    size_t GetWorkerCount() const { return m_Threads.size(); }
+    static size_t GetDefaultWorkerCount();
+
+private:
+    struct ParallelForJob
+    {
+        const RangeFunction* pFunction{ nullptr };
+        std::atomic<size_t> remainingChunks{ 0 };
+    };
+
+    struct Chunk
+    {
+        ParallelForJob* pJob{ nullptr };
+        size_t begin{ 0 };
+        size_t end{ 0 };
+    };
+
+    struct ChunkQueue
+    {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    void WorkerMain(size_t workerIndex);
+    bool TryPopChunk(size_t queueIndex, Chunk& chunk);
+    bool TryStealChunk(size_t thiefIndex, Chunk& chunk);
+    bool TryPopTask(Task& task);
+    void RunChunk(const Chunk& chunk);
+
+    // One chunk queue per worker plus one shared by every other thread, which is always the last one.
+    std::vector<std::unique_ptr<ChunkQueue>> m_ChunkQueues;
+    std::deque<Task> m_Tasks;
+    std::vector<std::thread> m_Threads;
+
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+    std::atomic<size_t> m_QueuedChunks{ 0 };
+    size_t m_QueuedTasks{ 0 }; // Guarded by m_WakeMutex, as is m_Tasks
+    bool m_Stop{ false };
+};
+
+} // namespace WingsOfSteel
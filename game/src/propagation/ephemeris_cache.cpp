@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/gtc/constants.hpp>
+
+#include "jobs/worker_pool.hpp"
+#include "propagation/ephemeris_cache.hpp"
+#include "propagation/propagation_store.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Each segment is a degree 16 polynomial per axis, fitted by sampling at the Chebyshev nodes.
+constexpr size_t kCoefficientCount = 17;
+constexpr size_t kCoefficientsPerSegment = kCoefficientCount * 3;
+
+// Segments per orbit needed to keep the fitting error below ~1e-6 of the semi-major axis. Eccentric orbits
+// need shorter segments, as they move much faster around perigee than elsewhere. Orbits more eccentric than
+// the last entry aren't fitted at all.
+struct SegmentsForEccentricity
+{
+    double maximumEccentricity;
+    uint32_t segmentsPerOrbit;
+};
+
+constexpr std::array<SegmentsForEccentricity, 7> kSegmentsForEccentricity = { {
+    { 0.1, 1 },
+    { 0.3, 2 },
+    { 0.5, 4 },
+    { 0.7, 8 },
+    { 0.8, 16 },
+    { 0.9, 32 },
+    { 0.93, 64 },
+} };
+
+// Slots fitted by each background task.
+constexpr size_t kFitGrainSize = 64;
+
+// A new fit is started once the clock is this fraction of the half window away from the current fit's centre.
+constexpr double kRefitThreshold = 0.5;
+
+uint32_t GetSegmentsPerOrbit(double eccentricity)
+{
+    for (const SegmentsForEccentricity& entry : kSegmentsForEccentricity)
+    {
+        if (eccentricity < entry.maximumEccentricity)
+        {
+            return entry.segmentsPerOrbit;
+        }
+    }
+    return 0;
+}
+
+// Chebyshev nodes on [-1, 1], and the cosine terms used to turn samples at them into coefficients.
+struct ChebyshevBasis
+{
+    ChebyshevBasis()
+    {
+        for (size_t k = 0; k < kCoefficientCount; ++k)
+        {
+            nodes[k] = std::cos(glm::pi<double>() * (k + 0.5) / kCoefficientCount);
+            for (size_t j = 0; j < kCoefficientCount; ++j)
+            {
+                const double scale = (j == 0 ? 1.0 : 2.0) / kCoefficientCount;
+                transform[j][k] = scale * std::cos(glm::pi<double>() * j * (k + 0.5) / kCoefficientCount);
+            }
+        }
+    }
+
+    std::array<double, kCoefficientCount> nodes;
+    std::array<std::array<double, kCoefficientCount>, kCoefficientCount> transform;
+};
+
+const ChebyshevBasis& GetChebyshevBasis()
+{
+    static const ChebyshevBasis sBasis;
+    return sBasis;
+}
+
+// Clenshaw's recurrence for Σ c[j]·T_j(u).
+float EvaluateChebyshev(const float* pCoefficients, float u)
+{
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    for (size_t j = kCoefficientCount - 1; j >= 1; --j)
+    {
+        const float b0 = 2.0f * u * b1 - b2 + pCoefficients[j];
+        b2 = b1;
+        b1 = b0;
+    }
+    return u * b1 - b2 + pCoefficients[0];
+}
+
+} // anonymous namespace
+
+struct EphemerisCache::Table
+{
+    double windowBegin{ 0.0 };
+    double windowEnd{ 0.0 };
+
+    // Per slot. Slots which weren't fitted have no segments.
+    std::vector<double> segmentDuration;
+    std::vector<uint32_t> segmentCount;
+    std::vector<size_t> firstSegment;
+
+    // x, y and z coefficients of each segment, one after the other.
+    std::vector<float> coefficients;
+};
+
+struct EphemerisCache::Fit
+{
+    PropagationStore propagationStore;
+    std::shared_ptr<Table> pTable;
+    std::atomic<size_t> remainingTasks{ 0 };
+    std::atomic<bool> cancelled{ false };
+    std::atomic<bool> complete{ false };
+};
+
+EphemerisCache::EphemerisCache()
+{
+}
+
+EphemerisCache::~EphemerisCache()
+{
+    Invalidate();
+}
+
+void EphemerisCache::FitSlots(const PropagationStore& propagationStore, Table& table, size_t begin, size_t end)
+{
+    const ChebyshevBasis& basis = GetChebyshevBasis();
+    std::vector<uint32_t> slots;
+    std::vector<double> times;
+    std::vector<glm::vec3> samples;
+
+    for (size_t slot = begin; slot < end; ++slot)
+    {
+        const uint32_t segmentCount = table.segmentCount[slot];
+        if (segmentCount == 0)
+        {
+            continue;
+        }
+
+        // Every node of every segment is propagated in one batch.
+        const size_t sampleCount = segmentCount * kCoefficientCount;
+        const double halfDuration = table.segmentDuration[slot] * 0.5;
+        slots.assign(sampleCount, static_cast<uint32_t>(slot));
+        times.resize(sampleCount);
+        samples.resize(sampleCount);
+        for (uint32_t segment = 0; segment < segmentCount; ++segment)
+        {
+            const double segmentCentre = table.windowBegin + (segment * 2 + 1) * halfDuration;
+            for (size_t k = 0; k < kCoefficientCount; ++k)
+            {
+                times[segment * kCoefficientCount + k] = segmentCentre + basis.nodes[k] * halfDuration;
+            }
+        }
+        propagationStore.Propagate(slots.data(), times.data(), sampleCount, samples.data(), nullptr);
+
+        for (uint32_t segment = 0; segment < segmentCount; ++segment)
+        {
+            const glm::vec3* pSamples = &samples[segment * kCoefficientCount];
+            float* pCoefficients = &table.coefficients[(table.firstSegment[slot] + segment) * kCoefficientsPerSegment];
+            for (size_t j = 0; j < kCoefficientCount; ++j)
+            {
+                double x = 0.0;
+                double y = 0.0;
+                double z = 0.0;
+                for (size_t k = 0; k < kCoefficientCount; ++k)
+                {
+                    x += basis.transform[j][k] * pSamples[k].x;
+                    y += basis.transform[j][k] * pSamples[k].y;
+                    z += basis.transform[j][k] * pSamples[k].z;
+                }
+                pCoefficients[j] = static_cast<float>(x);
+                pCoefficients[kCoefficientCount + j] = static_cast<float>(y);
+                pCoefficients[kCoefficientCount * 2 + j] = static_cast<float>(z);
+            }
+        }
+    }
+}
+
+void EphemerisCache::Update(double time, const PropagationStore& propagationStore, WorkerPool* pWorkerPool)
+{
+    // Without worker threads a fit would run inline, stalling whichever frame started it for far longer than
+    // the propagation it saves, so the cache is never used there.
+    if (!m_Enabled || pWorkerPool->GetWorkerCount() == 0)
+    {
+        return;
+    }
+
+    if (m_pFit && m_pFit->complete.load(std::memory_order_acquire))
+    {
+        m_pTable = m_pFit->pTable;
+        m_pFit.reset();
+    }
+
+    if (m_pFit || propagationStore.GetCount() == 0)
+    {
+        return;
+    }
+
+    const bool needsFit = !m_pTable || std::abs(time - (m_pTable->windowBegin + m_pTable->windowEnd) * 0.5) > m_HalfWindow * kRefitThreshold;
+    if (needsFit)
+    {
+        StartFit(time, propagationStore, pWorkerPool);
+    }
+}
+
+void EphemerisCache::StartFit(double time, const PropagationStore& propagationStore, WorkerPool* pWorkerPool)
+{
+    std::shared_ptr<Fit> pFit = std::make_shared<Fit>();
+    pFit->propagationStore = propagationStore;
+    pFit->pTable = std::make_shared<Table>();
+    pFit->pTable->windowBegin = time - m_HalfWindow;
+    pFit->pTable->windowEnd = time + m_HalfWindow;
+    m_pFit = pFit;
+
+    // Laying out and allocating the table can take a while for a large catalogue, so even that is left to a worker.
+    pWorkerPool->Submit([pFit, pWorkerPool]()
+    {
+        if (pFit->cancelled.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        Table& table = *pFit->pTable;
+        const PropagationStore& store = pFit->propagationStore;
+        const size_t slotCount = store.GetCount();
+        const double windowDuration = table.windowEnd - table.windowBegin;
+        table.segmentDuration.resize(slotCount);
+        table.segmentCount.resize(slotCount);
+        table.firstSegment.resize(slotCount);
+
+        size_t totalSegments = 0;
+        for (size_t slot = 0; slot < slotCount; ++slot)
+        {
+            const uint32_t segmentsPerOrbit = GetSegmentsPerOrbit(store.GetEccentricity(slot));
+            const double period = 2.0 * glm::pi<double>() / store.GetMeanMotion(slot);
+            const double segmentDuration = segmentsPerOrbit > 0 ? period / segmentsPerOrbit : 0.0;
+            const uint32_t segmentCount = segmentsPerOrbit > 0 ? static_cast<uint32_t>(std::ceil(windowDuration / segmentDuration)) : 0;
+            table.segmentDuration[slot] = segmentDuration;
+            table.segmentCount[slot] = segmentCount;
+            table.firstSegment[slot] = totalSegments;
+            totalSegments += segmentCount;
+        }
+        table.coefficients.resize(totalSegments * kCoefficientsPerSegment);
+
+        // The fit is split into independent background tasks rather than a ParallelFor(), so none of it can
+        // end up running on the thread updating the frame.
+        const size_t taskCount = (slotCount + kFitGrainSize - 1) / kFitGrainSize;
+        pFit->remainingTasks.store(taskCount, std::memory_order_relaxed);
+        for (size_t task = 0; task < taskCount; ++task)
+        {
+            const size_t begin = task * kFitGrainSize;
+            const size_t end = std::min(begin + kFitGrainSize, slotCount);
+            pWorkerPool->Submit([pFit, begin, end]()
+            {
+                if (!pFit->cancelled.load(std::memory_order_relaxed))
+                {
+                    FitSlots(pFit->propagationStore, *pFit->pTable, begin, end);
+                }
+
+                if (pFit->remainingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    pFit->complete.store(true, std::memory_order_release);
+                }
+            });
+        }
+    });
+}
+
+void EphemerisCache::Invalidate()
+{
+    if (m_pFit)
+    {
+        // Tasks which are already queued keep the fit alive, but skip the work and their results are never used.
+        m_pFit->cancelled.store(true, std::memory_order_relaxed);
+        m_pFit.reset();
+    }
+    m_pTable.reset();
+}
+
+bool EphemerisCache::Contains(double time) const
+{
+    return m_pTable && time >= m_pTable->windowBegin && time <= m_pTable->windowEnd;
+}
+
+void EphemerisCache::Evaluate(double time, size_t begin, size_t end, const PropagationStore& propagationStore, glm::vec3* pPositions) const
+{
+    const Table& table = *m_pTable;
+    for (size_t slot = begin; slot < end; ++slot)
+    {
+        const uint32_t segmentCount = table.segmentCount[slot];
+        if (segmentCount == 0)
+        {
+            propagationStore.Propagate(time, slot, slot + 1, pPositions);
+            continue;
+        }
+
+        const double segmentDuration = table.segmentDuration[slot];
+        const double offset = (time - table.windowBegin) / segmentDuration;
+        const uint32_t segment = std::min(static_cast<uint32_t>(offset), segmentCount - 1);
+        const float u = static_cast<float>((offset - segment) * 2.0 - 1.0);
+
+        const float* pCoefficients = &table.coefficients[(table.firstSegment[slot] + segment) * kCoefficientsPerSegment];
+        pPositions[slot] = glm::vec3(
+            EvaluateChebyshev(pCoefficients, u),
+            EvaluateChebyshev(pCoefficients + kCoefficientCount, u),
+            EvaluateChebyshev(pCoefficients + kCoefficientCount * 2, u));
+    }
+}
+
+void EphemerisCache::SetEnabled(bool enabled)
+{
+    m_Enabled = enabled;
+    if (!enabled)
+    {
+        Invalidate();
+    }
+}
+
+size_t EphemerisCache::GetMemoryUsage() const
+{
+    if (!m_pTable)
+    {
+        return 0;
+    }
+
+    const Table& table = *m_pTable;
+    return table.coefficients.size() * sizeof(float)
+        + table.segmentDuration.size() * (sizeof(double) + sizeof(uint32_t) + sizeof(size_t));
+}
+
+} // namespace WingsOfSteel
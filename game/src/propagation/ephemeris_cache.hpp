@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <glm/vec3.hpp>
+
+namespace WingsOfSteel
+{
+
+class PropagationStore;
+class WorkerPool;
+
+// Piecewise Chebyshev approximation of every object's trajectory over a window of time centred on the
+// simulation clock, so positions anywhere in the window cost a short polynomial evaluation rather than a
+// full propagation. Fits are carried out by background tasks on the worker pool against a copy of the
+// propagation store, and replace the current fit once complete. A new fit is started whenever the clock
+// drifts halfway towards the edge of the window.
+// Builds without worker threads, such as the web build, never fit anything and always propagate directly.
+class EphemerisCache
+{
+public:
+    EphemerisCache();
+    ~EphemerisCache();
+
+    void Update(double time, const PropagationStore& propagationStore, WorkerPool* pWorkerPool);
+
+    // Discards the current fit and any fit in progress, e.g. because the propagation store's slots changed.
+    void Invalidate();
+
+    bool Contains(double time) const;
+
+    // Writes the positions (km, ECI) of slots [begin, end) at the given time, which must be inside the window,
+    // to pPositions[begin, end). Slots too eccentric to be fitted are propagated directly instead.
+    void Evaluate(double time, size_t begin, size_t end, const PropagationStore& propagationStore, glm::vec3* pPositions) const;
+
+    bool IsEnabled() const { return m_Enabled; }
+    void SetEnabled(bool enabled);
+
+    // Time covered either side of the clock by new fits (s).
+    double GetHalfWindow() const { return m_HalfWindow; }
+    void SetHalfWindow(double halfWindow) { m_HalfWindow = halfWindow; }
+
+    bool IsFitting() const { return m_pFit != nullptr; }
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Table;
+    struct Fit;
+
+    void StartFit(double time, const PropagationStore& propagationStore, WorkerPool* pWorkerPool);
+    static void FitSlots(const PropagationStore& propagationStore, Table& table, size_t begin, size_t end);
+
+    std::shared_ptr<const Table> m_pTable;
+    std::shared_ptr<Fit> m_pFit;
+    double m_HalfWindow{ 12.0 * 3600.0 };
+    bool m_Enabled{ true };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,124 @@
+#if defined(SIMD_DISPATCH_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "propagation/kepler_solver.hpp"
+#include "propagation/kepler_solver_kernel.hpp"
+
+namespace WingsOfSteel
+{
+
+KeplerSolverKernels GetKeplerSolverKernelsBaseline()
+{
+    return MakeKeplerSolverKernels();
+}
+
+namespace
+{
+
+#if defined(SIMD_DISPATCH_X86)
+#if defined(_MSC_VER)
+// Checks that the OS saves the given XCR0 state components on context switches.
+bool IsOSStateEnabled(unsigned long long mask)
+{
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    return osxsave && (_xgetbv(0) & mask) == mask;
+}
+#endif
+
+bool IsAvx2Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+    return fma && avx2 && IsOSStateEnabled(0x6);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+bool IsAvx512Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    const bool avx512f = (info[1] & (1 << 16)) != 0;
+    return avx512f && IsOSStateEnabled(0xE6);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#endif
+
+} // anonymous namespace
+
+std::vector<KeplerSolverKernels> GetSupportedKeplerSolverKernels()
+{
+    std::vector<KeplerSolverKernels> kernels = { GetKeplerSolverKernelsBaseline() };
+#if defined(SIMD_DISPATCH_X86)
+    if (IsAvx2Supported())
+    {
+        kernels.push_back(GetKeplerSolverKernelsAvx2());
+    }
+    if (IsAvx512Supported())
+    {
+        kernels.push_back(GetKeplerSolverKernelsAvx512());
+    }
+#endif
+    return kernels;
+}
+
+namespace
+{
+
+const KeplerSolverKernels& GetKernels()
+{
+    static const KeplerSolverKernels sKernels = GetSupportedKeplerSolverKernels().back();
+    return sKernels;
+}
+
+} // anonymous namespace
+
+void KeplerSolver::Solve(const double* pMeanAnomaly, const double* pEccentricity, double* pEccentricAnomaly, size_t count)
+{
+    GetKernels().pSolveDouble(pMeanAnomaly, pEccentricity, pEccentricAnomaly, count);
+}
+
+void KeplerSolver::Solve(const float* pMeanAnomaly, const float* pEccentricity, float* pEccentricAnomaly, size_t count)
+{
+    GetKernels().pSolveFloat(pMeanAnomaly, pEccentricity, pEccentricAnomaly, count);
+}
+
+void KeplerSolver::SolveSinCos(const double* pMeanAnomaly, const double* pEccentricity, double* pSinE, double* pCosE, size_t count)
+{
+    GetKernels().pSolveSinCosDouble(pMeanAnomaly, pEccentricity, pSinE, pCosE, count);
+}
+
+void KeplerSolver::SolveSinCos(const float* pMeanAnomaly, const float* pEccentricity, float* pSinE, float* pCosE, size_t count)
+{
+    GetKernels().pSolveSinCosFloat(pMeanAnomaly, pEccentricity, pSinE, pCosE, count);
+}
+
+void KeplerSolver::SinCos(const double* pAngle, double* pSin, double* pCos, size_t count)
+{
+    GetKernels().pSinCosDouble(pAngle, pSin, pCos, count);
+}
+
+const char* KeplerSolver::GetInstructionSet()
+{
+    return GetKernels().pInstructionSet;
+}
+
+size_t KeplerSolver::GetLaneCount(Accuracy accuracy)
+{
+    return accuracy == Accuracy::Double ? GetKernels().doubleLanes : GetKernels().floatLanes;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+namespace WingsOfSteel
+{
+
+// Batch solver for Kepler's equation, M = E - e*sin(E), for elliptical orbits.
+// Arrays of mean anomalies and eccentricities are solved several lanes at a time using the widest SIMD
+// instruction set available at runtime (AVX-512, AVX2, SSE2, NEON or WebAssembly SIMD). Every lane runs
+// a fixed number of iterations, so there is no data-dependent branching in the inner loop.
+//
+// Accuracy, relative to a fully converged solution:
+//  - Double: within 2e-15 rad for e <= 0.99.
+//  - Single: within 1e-6 rad for e <= 0.95, with twice as many lanes per register.
+// Orbits beyond those eccentricities are finished by a scalar Newton-Raphson pass.
+// The eccentric anomaly is returned in [-π, π]; mean anomalies can be any finite value.
+class KeplerSolver
+{
+public:
+    enum class Accuracy
+    {
+        Single,
+        Double
+    };
+
+    static void Solve(const double* pMeanAnomaly, const double* pEccentricity, double* pEccentricAnomaly, size_t count);
+    static void Solve(const float* pMeanAnomaly, const float* pEccentricity, float* pEccentricAnomaly, size_t count);
+
+    // As Solve(), but returns sin(E) and cos(E), which is all that positions and velocities need.
+    static void SolveSinCos(const double* pMeanAnomaly, const double* pEccentricity, double* pSinE, double* pCosE, size_t count);
+    static void SolveSinCos(const float* pMeanAnomaly, const float* pEccentricity, float* pSinE, float* pCosE, size_t count);
+
+    // The vectorized sine and cosine the solver iterates with, for callers with other angles to evaluate in bulk.
+    // Accurate to a few ulp for angles up to about 1e6 rad.
+    static void SinCos(const double* pAngle, double* pSin, double* pCos, size_t count);
+
+    static const char* GetInstructionSet();
+    static size_t GetLaneCount(Accuracy accuracy);
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,17 @@
+// Built with AVX2 and FMA enabled on x86-64 targets (see game/CMakeLists.txt) and only called after a
+// runtime CPU check.
+#if defined(SIMD_DISPATCH_X86)
+
+#include "propagation/kepler_solver_kernel.hpp"
+
+namespace WingsOfSteel
+{
+
+KeplerSolverKernels GetKeplerSolverKernelsAvx2()
+{
+    return MakeKeplerSolverKernels();
+}
+
+} // namespace WingsOfSteel
+
+#endif
@@ -0,0 +1,331 @@
+#pragma once
+
+// Lane-generic implementation of the batch Kepler solver. Only included by the kepler_solver*.cpp translation
+// units, each of which is built with different instruction set flags, and by the tests; see simd_lanes.hpp for
+// why the kernels have internal linkage.
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "propagation/simd_lanes.hpp"
+
+namespace WingsOfSteel
+{
+
+// Entry points exported by each instruction set specific translation unit.
+struct KeplerSolverKernels
+{
+    const char* pInstructionSet;
+    size_t doubleLanes;
+    size_t floatLanes;
+    void (*pSolveDouble)(const double* pMeanAnomaly, const double* pEccentricity, double* pEccentricAnomaly, size_t count);
+    void (*pSolveFloat)(const float* pMeanAnomaly, const float* pEccentricity, float* pEccentricAnomaly, size_t count);
+    void (*pSolveSinCosDouble)(const double* pMeanAnomaly, const double* pEccentricity, double* pSinE, double* pCosE, size_t count);
+    void (*pSolveSinCosFloat)(const float* pMeanAnomaly, const float* pEccentricity, float* pSinE, float* pCosE, size_t count);
+    void (*pSinCosDouble)(const double* pAngle, double* pSin, double* pCos, size_t count);
+};
+
+KeplerSolverKernels GetKeplerSolverKernelsBaseline();
+KeplerSolverKernels GetKeplerSolverKernelsAvx2();
+KeplerSolverKernels GetKeplerSolverKernelsAvx512();
+
+// Every kernel set the running CPU can execute, baseline first. KeplerSolver dispatches to the last one.
+std::vector<KeplerSolverKernels> GetSupportedKeplerSolverKernels();
+
+namespace
+{
+
+template <typename T>
+struct KeplerKernelConstants;
+
+template <>
+struct KeplerKernelConstants<double>
+{
+    // Four quartic (Danby) iterations from the M + 0.85e starting guess converge to within 2e-15 rad for e <= 0.99.
+    static constexpr int kIterations = 4;
+    static constexpr double kMaxEccentricity = 0.99;
+
+    static constexpr double kInvTwoPi = 0.15915494309189533577;
+    static constexpr double kTwoOverPi = 0.63661977236758134308;
+    static constexpr double kPiOver2Hi = 1.57079632673412561417; // 33 significant bits, so products with small integers are exact
+    static constexpr double kPiOver2Lo = 6.07710050650619224932e-11;
+    static constexpr double kTwoPiHi = 4.0 * kPiOver2Hi; // The same split, so whole turns are removed exactly too
+    static constexpr double kTwoPiLo = 4.0 * kPiOver2Lo;
+
+    // Minimax coefficients for sin and cos on [-π/4, π/4] (Cephes)
+    static constexpr double kSin[] = { 1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6, -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1 };
+    static constexpr double kCos[] = { -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7, 2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2 };
+};
+
+template <>
+struct KeplerKernelConstants<float>
+{
+    // Three iterations converge to within 1e-6 rad, a few float ulp, for e <= 0.95.
+    static constexpr int kIterations = 3;
+    static constexpr float kMaxEccentricity = 0.95f;
+
+    static constexpr float kInvTwoPi = 0.159154943f;
+    static constexpr float kTwoOverPi = 0.636619772f;
+    static constexpr float kPiOver2Hi = 1.5703125f;
+    static constexpr float kPiOver2Lo = 4.83751296997070312500e-4f;
+    static constexpr float kPiOver2Lo2 = 7.54978995489188216e-8f; // Single precision needs a third term
+    static constexpr float kTwoPiHi = 4.0f * kPiOver2Hi;
+    static constexpr float kTwoPiLo = 4.0f * kPiOver2Lo;
+    static constexpr float kTwoPiLo2 = 4.0f * kPiOver2Lo2;
+
+    static constexpr float kSin[] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+    static constexpr float kCos[] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+};
+
+template <typename Lanes, typename Scalar, size_t N>
+inline Lanes EvaluatePolynomial(Lanes x, const Scalar (&coefficients)[N])
+{
+    Lanes result = Lanes::Broadcast(coefficients[0]);
+    for (size_t i = 1; i < N; ++i)
+    {
+        result = result * x + coefficients[i];
+    }
+    return result;
+}
+
+template <typename Lanes>
+inline void SinCos(Lanes x, Lanes& sinX, Lanes& cosX)
+{
+    using Scalar = typename Lanes::Scalar;
+    using Constants = KeplerKernelConstants<Scalar>;
+
+    // Reduce to r in [-π/4, π/4] and the quadrant x lies in (Cody-Waite).
+    const Lanes quadrant = Round(x * Constants::kTwoOverPi);
+    Lanes r = (x - quadrant * Constants::kPiOver2Hi) - quadrant * Constants::kPiOver2Lo;
+    if constexpr (std::is_same_v<Scalar, float>)
+    {
+        r = r - quadrant * Constants::kPiOver2Lo2;
+    }
+
+    const Lanes z = r * r;
+    const Lanes sinR = r + r * z * EvaluatePolynomial(z, Constants::kSin);
+    const Lanes cosR = (Scalar(1) - z * Scalar(0.5)) + z * z * EvaluatePolynomial(z, Constants::kCos);
+
+    // quadrant mod 4, without leaving floating point registers.
+    const Lanes quarter = quadrant * Scalar(0.25);
+    Lanes turns = Round(quarter);
+    turns = Select(turns > quarter, turns - Scalar(1), turns);
+    const Lanes index = quadrant - turns * Scalar(4);
+
+    const Lanes one = Lanes::Broadcast(Scalar(1));
+    const Lanes two = Lanes::Broadcast(Scalar(2));
+    const Lanes three = Lanes::Broadcast(Scalar(3));
+    const typename Lanes::Mask swap = (index == one) | (index == three);
+    sinX = Select(swap, cosR, sinR);
+    cosX = Select(swap, sinR, cosR);
+    sinX = Select(index >= two, -sinX, sinX);
+    cosX = Select((index == one) | (index == two), -cosX, cosX);
+}
+
+// Solves M = E - e*sin(E) for one register's worth of orbits. The iteration count is fixed so every lane
+// does the same work; E is returned in [-π, π].
+template <typename Lanes, bool kSinCos>
+inline void SolveKeplerLanes(Lanes meanAnomaly, Lanes eccentricity, Lanes& out0, Lanes& out1)
+{
+    using Scalar = typename Lanes::Scalar;
+    using Constants = KeplerKernelConstants<Scalar>;
+
+    // Reduce M to [-π, π] and solve for |M|, as Kepler's equation is odd in M.
+    const Lanes turns = Round(meanAnomaly * Constants::kInvTwoPi);
+    Lanes reduced = (meanAnomaly - turns * Constants::kTwoPiHi) - turns * Constants::kTwoPiLo;
+    if constexpr (std::is_same_v<Scalar, float>)
+    {
+        reduced = reduced - turns * Constants::kTwoPiLo2;
+    }
+    const typename Lanes::Mask negative = reduced < Lanes::Broadcast(Scalar(0));
+    const Lanes M = Abs(reduced);
+    const Lanes e = eccentricity;
+
+    // Danby's starting guess followed by his quartically convergent correction.
+    Lanes E = M + e * Scalar(0.85);
+    Lanes sinE;
+    Lanes cosE;
+    for (int iteration = 0; iteration < Constants::kIterations; ++iteration)
+    {
+        SinCos(E, sinE, cosE);
+        const Lanes esinE = e * sinE;
+        const Lanes ecosE = e * cosE;
+        const Lanes f = (E - esinE) - M;
+        const Lanes f1 = Scalar(1) - ecosE;
+        const Lanes d1 = -f / f1;
+        const Lanes d2 = -f / (f1 + d1 * esinE * Scalar(0.5));
+        const Lanes d3 = -f / (f1 + d2 * esinE * Scalar(0.5) + d2 * d2 * ecosE * Scalar(1.0 / 6.0));
+        E = E + d3;
+    }
+
+    if constexpr (kSinCos)
+    {
+        SinCos(E, sinE, cosE);
+        out0 = Select(negative, -sinE, sinE);
+        out1 = cosE;
+    }
+    else
+    {
+        out0 = Select(negative, -E, E);
+    }
+}
+
+// Scalar fallback for eccentricities beyond what the fixed iteration count covers. Newton's method started at
+// E = π converges monotonically for any e < 1, as f(E) is convex on [0, π].
+inline double SolveKeplerScalar(double meanAnomaly, double eccentricity)
+{
+    using Constants = KeplerKernelConstants<double>;
+    constexpr double kPi = 3.14159265358979323846;
+    const double turns = std::nearbyint(meanAnomaly * Constants::kInvTwoPi);
+    const double reduced = (meanAnomaly - turns * Constants::kTwoPiHi) - turns * Constants::kTwoPiLo;
+    const double M = std::abs(reduced);
+
+    double E = kPi;
+    for (int iteration = 0; iteration < 64; ++iteration)
+    {
+        const double delta = (E - eccentricity * std::sin(E) - M) / (1.0 - eccentricity * std::cos(E));
+        E -= delta;
+        if (std::abs(delta) < 1e-15)
+        {
+            break;
+        }
+    }
+    return reduced < 0.0 ? -E : E;
+}
+
+template <typename Lanes, bool kSinCos>
+void SolveKeplerBatch(const typename Lanes::Scalar* pMeanAnomaly, const typename Lanes::Scalar* pEccentricity, typename Lanes::Scalar* pOut0, typename Lanes::Scalar* pOut1, size_t count)
+{
+    using Scalar = typename Lanes::Scalar;
+    constexpr size_t kWidth = Lanes::kWidth;
+
+    Lanes out0;
+    Lanes out1;
+    size_t index = 0;
+    for (; index + kWidth <= count; index += kWidth)
+    {
+        SolveKeplerLanes<Lanes, kSinCos>(Lanes::Load(pMeanAnomaly + index), Lanes::Load(pEccentricity + index), out0, out1);
+        out0.Store(pOut0 + index);
+        if constexpr (kSinCos)
+        {
+            out1.Store(pOut1 + index);
+        }
+    }
+
+    // Pad the remainder out to a full register.
+    if (index < count)
+    {
+        Scalar meanAnomaly[kWidth] = {};
+        Scalar eccentricity[kWidth] = {};
+        Scalar result0[kWidth];
+        Scalar result1[kWidth];
+        const size_t remaining = count - index;
+        for (size_t lane = 0; lane < remaining; ++lane)
+        {
+            meanAnomaly[lane] = pMeanAnomaly[index + lane];
+            eccentricity[lane] = pEccentricity[index + lane];
+        }
+
+        SolveKeplerLanes<Lanes, kSinCos>(Lanes::Load(meanAnomaly), Lanes::Load(eccentricity), out0, out1);
+        out0.Store(result0);
+        if constexpr (kSinCos)
+        {
+            out1.Store(result1);
+        }
+        for (size_t lane = 0; lane < remaining; ++lane)
+        {
+            pOut0[index + lane] = result0[lane];
+            if constexpr (kSinCos)
+            {
+                pOut1[index + lane] = result1[lane];
+            }
+        }
+    }
+
+    // Near-parabolic orbits are rare, so patch them up afterwards rather than slowing down every lane.
+    for (index = 0; index < count; ++index)
+    {
+        if (pEccentricity[index] > KeplerKernelConstants<Scalar>::kMaxEccentricity)
+        {
+            const double E = SolveKeplerScalar(pMeanAnomaly[index], pEccentricity[index]);
+            if constexpr (kSinCos)
+            {
+                pOut0[index] = static_cast<Scalar>(std::sin(E));
+                pOut1[index] = static_cast<Scalar>(std::cos(E));
+            }
+            else
+            {
+                pOut0[index] = static_cast<Scalar>(E);
+            }
+        }
+    }
+}
+
+template <typename Lanes>
+void SolveKepler(const typename Lanes::Scalar* pMeanAnomaly, const typename Lanes::Scalar* pEccentricity, typename Lanes::Scalar* pEccentricAnomaly, size_t count)
+{
+    SolveKeplerBatch<Lanes, false>(pMeanAnomaly, pEccentricity, pEccentricAnomaly, nullptr, count);
+}
+
+template <typename Lanes>
+void SolveKeplerSinCos(const typename Lanes::Scalar* pMeanAnomaly, const typename Lanes::Scalar* pEccentricity, typename Lanes::Scalar* pSinE, typename Lanes::Scalar* pCosE, size_t count)
+{
+    SolveKeplerBatch<Lanes, true>(pMeanAnomaly, pEccentricity, pSinE, pCosE, count);
+}
+
+template <typename Lanes>
+void SinCosBatch(const typename Lanes::Scalar* pAngle, typename Lanes::Scalar* pSin, typename Lanes::Scalar* pCos, size_t count)
+{
+    using Scalar = typename Lanes::Scalar;
+    constexpr size_t kWidth = Lanes::kWidth;
+
+    Lanes sinX;
+    Lanes cosX;
+    size_t index = 0;
+    for (; index + kWidth <= count; index += kWidth)
+    {
+        SinCos(Lanes::Load(pAngle + index), sinX, cosX);
+        sinX.Store(pSin + index);
+        cosX.Store(pCos + index);
+    }
+
+    if (index < count)
+    {
+        Scalar angle[kWidth] = {};
+        Scalar sinResult[kWidth];
+        Scalar cosResult[kWidth];
+        const size_t remaining = count - index;
+        for (size_t lane = 0; lane < remaining; ++lane)
+        {
+            angle[lane] = pAngle[index + lane];
+        }
+
+        SinCos(Lanes::Load(angle), sinX, cosX);
+        sinX.Store(sinResult);
+        cosX.Store(cosResult);
+        for (size_t lane = 0; lane < remaining; ++lane)
+        {
+            pSin[index + lane] = sinResult[lane];
+            pCos[index + lane] = cosResult[lane];
+        }
+    }
+}
+
+inline KeplerSolverKernels MakeKeplerSolverKernels()
+{
+    return KeplerSolverKernels{
+        .pInstructionSet = kSimdInstructionSet,
+        .doubleLanes = F64Lanes::kWidth,
+        .floatLanes = F32Lanes::kWidth,
+        .pSolveDouble = &SolveKepler<F64Lanes>,
+        .pSolveFloat = &SolveKepler<F32Lanes>,
+        .pSolveSinCosDouble = &SolveKeplerSinCos<F64Lanes>,
+        .pSolveSinCosFloat = &SolveKeplerSinCos<F32Lanes>,
+        .pSinCosDouble = &SinCosBatch<F64Lanes>
+    };
+}
+
+} // anonymous namespace
+} // namespace WingsOfSteel
@@ -0,0 +1,605 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "jobs/worker_pool.hpp"
+#include "propagation/numerical_propagator.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Earth's gravitational parameter (km³/s²), equatorial radius (km) and rotation rate (rad/s).
+constexpr double kMu = 398600.4418;
+constexpr double kEarthRadius = 6378.137;
+constexpr double kEarthRotationRate = 7.292115e-5;
+
+// Unnormalised zonal harmonics J2 to J6 (EGM96).
+constexpr std::array<double, 7> kZonalHarmonics = { 0.0, 0.0, 1.08262668e-3, -2.53265649e-6, -1.61962159e-6, -2.27296083e-7, 5.40681239e-7 };
+
+constexpr double kSunMu = 1.32712440018e11; // km³/s²
+constexpr double kMoonMu = 4902.800066; // km³/s²
+
+// The Sun and the Moon are tabulated at this interval (s) and linearly interpolated. Over ten minutes the
+// Moon moves by about 0.1°, so the interpolated position is within a few hundred metres.
+constexpr double kThirdBodyTableStep = 600.0;
+
+// Exponential atmosphere (Vallado, table 8-4): base altitude (km), density at the base (kg/m³) and scale height (km).
+struct AtmosphereLayer
+{
+    double baseAltitude;
+    double density;
+    double scaleHeight;
+};
+
+constexpr std::array<AtmosphereLayer, 28> kAtmosphere = { {
+    { 0.0, 1.225, 7.249 },
+    { 25.0, 3.899e-2, 6.349 },
+    { 30.0, 1.774e-2, 6.682 },
+    { 40.0, 3.972e-3, 7.554 },
+    { 50.0, 1.057e-3, 8.382 },
+    { 60.0, 3.206e-4, 7.714 },
+    { 70.0, 8.770e-5, 6.549 },
+    { 80.0, 1.905e-5, 5.799 },
+    { 90.0, 3.396e-6, 5.382 },
+    { 100.0, 5.297e-7, 5.877 },
+    { 110.0, 9.661e-8, 7.263 },
+    { 120.0, 2.438e-8, 9.473 },
+    { 130.0, 8.484e-9, 12.636 },
+    { 140.0, 3.845e-9, 16.149 },
+    { 150.0, 2.070e-9, 22.523 },
+    { 180.0, 5.464e-10, 29.740 },
+    { 200.0, 2.789e-10, 37.105 },
+    { 250.0, 7.248e-11, 45.546 },
+    { 300.0, 2.418e-11, 53.628 },
+    { 350.0, 9.518e-12, 53.298 },
+    { 400.0, 3.725e-12, 58.515 },
+    { 450.0, 1.585e-12, 60.828 },
+    { 500.0, 6.967e-13, 63.822 },
+    { 600.0, 1.454e-13, 71.835 },
+    { 700.0, 3.614e-14, 88.667 },
+    { 800.0, 1.170e-14, 124.64 },
+    { 900.0, 5.245e-15, 181.05 },
+    { 1000.0, 3.019e-15, 268.00 },
+} };
+
+// Drag is negligible above this altitude (km), so the density isn't evaluated at all.
+constexpr double kMaximumDragAltitude = 2500.0;
+
+double GetAtmosphericDensity(double altitude)
+{
+    if (altitude > kMaximumDragAltitude)
+    {
+        return 0.0;
+    }
+
+    size_t layer = 0;
+    while (layer + 1 < kAtmosphere.size() && altitude >= kAtmosphere[layer + 1].baseAltitude)
+    {
+        layer++;
+    }
+    return kAtmosphere[layer].density * std::exp(-(altitude - kAtmosphere[layer].baseAltitude) / kAtmosphere[layer].scaleHeight);
+}
+
+// Low precision solar and lunar coordinates (Montenbruck & Gill, section 3.3.2), rotated from the ecliptic
+// to the equator. Good to about 0.1% for the Sun and a few hundred km for the Moon, which is far more than
+// point-mass perturbations need.
+constexpr double kObliquity = 23.43929111 * glm::pi<double>() / 180.0;
+constexpr double kArcSecond = glm::pi<double>() / (180.0 * 3600.0);
+
+double GetJulianCenturiesSinceJ2000(double time)
+{
+    return (time / 86400.0 + 2440587.5 - 2451545.0) / 36525.0;
+}
+
+glm::dvec3 EclipticToEquatorial(const glm::dvec3& ecliptic)
+{
+    const double c = std::cos(kObliquity);
+    const double s = std::sin(kObliquity);
+    return glm::dvec3(ecliptic.x, c * ecliptic.y - s * ecliptic.z, s * ecliptic.y + c * ecliptic.z);
+}
+
+glm::dvec3 CalculateSunPosition(double time)
+{
+    const double T = GetJulianCenturiesSinceJ2000(time);
+    const double M = glm::radians(357.5256 + 35999.049 * T);
+    const double longitude = glm::radians(282.9400) + M + (6892.0 * std::sin(M) + 72.0 * std::sin(2.0 * M)) * kArcSecond;
+    const double distance = (149.619 - 2.499 * std::cos(M) - 0.021 * std::cos(2.0 * M)) * 1.0e6;
+    return EclipticToEquatorial(glm::dvec3(distance * std::cos(longitude), distance * std::sin(longitude), 0.0));
+}
+
+glm::dvec3 CalculateMoonPosition(double time)
+{
+    const double T = GetJulianCenturiesSinceJ2000(time);
+    const double L0 = glm::radians(218.31617 + 481267.88088 * T);
+    const double l = glm::radians(134.96292 + 477198.86753 * T);
+    const double lp = glm::radians(357.52543 + 35999.04944 * T);
+    const double F = glm::radians(93.27283 + 483202.01873 * T);
+    const double D = glm::radians(297.85027 + 445267.11135 * T);
+
+    const double longitude = L0 + kArcSecond * (22640.0 * std::sin(l) + 769.0 * std::sin(2.0 * l) - 4586.0 * std::sin(l - 2.0 * D)
+        + 2370.0 * std::sin(2.0 * D) - 668.0 * std::sin(lp) - 412.0 * std::sin(2.0 * F) - 212.0 * std::sin(2.0 * l - 2.0 * D)
+        - 206.0 * std::sin(l + lp - 2.0 * D) + 192.0 * std::sin(l + 2.0 * D) - 165.0 * std::sin(lp - 2.0 * D)
+        + 148.0 * std::sin(l - lp) - 125.0 * std::sin(D) - 110.0 * std::sin(l + lp) - 55.0 * std::sin(2.0 * F - 2.0 * D));
+    const double latitude = kArcSecond * (18520.0 * std::sin(F + longitude - L0 + kArcSecond * (412.0 * std::sin(2.0 * F) + 541.0 * std::sin(lp)))
+        - 526.0 * std::sin(F - 2.0 * D) + 44.0 * std::sin(l + F - 2.0 * D) - 31.0 * std::sin(-l + F - 2.0 * D)
+        - 25.0 * std::sin(-2.0 * l + F) - 23.0 * std::sin(lp + F - 2.0 * D) + 21.0 * std::sin(-l + F) + 11.0 * std::sin(-lp + F - 2.0 * D));
+    const double distance = 385000.0 - 20905.0 * std::cos(l) - 3699.0 * std::cos(2.0 * D - l) - 2956.0 * std::cos(2.0 * D)
+        - 570.0 * std::cos(2.0 * l) + 246.0 * std::cos(2.0 * l - 2.0 * D) - 205.0 * std::cos(lp - 2.0 * D)
+        - 171.0 * std::cos(l + 2.0 * D) - 152.0 * std::cos(l + lp - 2.0 * D);
+
+    return EclipticToEquatorial(distance * glm::dvec3(std::cos(latitude) * std::cos(longitude), std::cos(latitude) * std::sin(longitude), std::sin(latitude)));
+}
+
+// Perturbation of a body at r relative to the Earth by a third body at s, which also accelerates the Earth.
+glm::dvec3 GetThirdBodyAcceleration(const glm::dvec3& r, const glm::dvec3& s, double mu)
+{
+    const glm::dvec3 d = s - r;
+    const double dLength = glm::length(d);
+    const double sLength = glm::length(s);
+    return mu * (d / (dLength * dLength * dLength) - s / (sLength * sLength * sLength));
+}
+
+// Objects are integrated in batches of this many lanes, which advance in lockstep but with their own steps.
+constexpr size_t kBatchSize = 32;
+
+// Batches per ParallelFor() chunk. Each step of each object is expensive, so a chunk is a single batch.
+constexpr size_t kGrainSize = kBatchSize;
+
+// RK8(7)13M coefficients (Prince & Dormand, 1981).
+constexpr size_t kStageCount = 13;
+
+constexpr std::array<double, kStageCount> kC = {
+    0.0, 1.0 / 18.0, 1.0 / 12.0, 1.0 / 8.0, 5.0 / 16.0, 3.0 / 8.0, 59.0 / 400.0, 93.0 / 200.0,
+    5490023248.0 / 9719169821.0, 13.0 / 20.0, 1201146811.0 / 1299019798.0, 1.0, 1.0
+};
+
+constexpr std::array<std::array<double, kStageCount>, kStageCount> kA = { {
+    {},
+    { 1.0 / 18.0 },
+    { 1.0 / 48.0, 1.0 / 16.0 },
+    { 1.0 / 32.0, 0.0, 3.0 / 32.0 },
+    { 5.0 / 16.0, 0.0, -75.0 / 64.0, 75.0 / 64.0 },
+    { 3.0 / 80.0, 0.0, 0.0, 3.0 / 16.0, 3.0 / 20.0 },
+    { 29443841.0 / 614563906.0, 0.0, 0.0, 77736538.0 / 692538347.0, -28693883.0 / 1125000000.0, 23124283.0 / 1800000000.0 },
+    { 16016141.0 / 946692911.0, 0.0, 0.0, 61564180.0 / 158732637.0, 22789713.0 / 633445777.0, 545815736.0 / 2771057229.0, -180193667.0 / 1043307555.0 },
+    { 39632708.0 / 573591083.0, 0.0, 0.0, -433636366.0 / 683701615.0, -421739975.0 / 2616292301.0, 100302831.0 / 723423059.0, 790204164.0 / 839813087.0, 800635310.0 / 3783071287.0 },
+    { 246121993.0 / 1340847787.0, 0.0, 0.0, -37695042795.0 / 15268766246.0, -309121744.0 / 1061227803.0, -12992083.0 / 490766935.0, 6005943493.0 / 2108947869.0, 393006217.0 / 1396673457.0, 123872331.0 / 1001029789.0 },
+    { -1028468189.0 / 846180014.0, 0.0, 0.0, 8478235783.0 / 508512852.0, 1311729495.0 / 1432422823.0, -10304129995.0 / 1701304382.0, -48777925059.0 / 3047939560.0, 15336726248.0 / 1032824649.0, -45442868181.0 / 3398467696.0, 3065993473.0 / 597172653.0 },
+    { 185892177.0 / 718116043.0, 0.0, 0.0, -3185094517.0 / 667107341.0, -477755414.0 / 1098053517.0, -703635378.0 / 230739211.0, 5731566787.0 / 1027545527.0, 5232866602.0 / 850066563.0, -4093664535.0 / 808688257.0, 3962137247.0 / 1805957418.0, 65686358.0 / 487910083.0 },
+    { 403863854.0 / 491063109.0, 0.0, 0.0, -5068492393.0 / 434740067.0, -411421997.0 / 543043805.0, 652783627.0 / 914296604.0, 11173962825.0 / 925320556.0, -13158990841.0 / 6184727034.0, 3936647629.0 / 1978049680.0, -160528059.0 / 685178525.0, 248638103.0 / 1413531060.0, 0.0 },
+} };
+
+// 8th order weights, and the 7th order weights the error is estimated against.
+constexpr std::array<double, kStageCount> kB = {
+    14005451.0 / 335480064.0, 0.0, 0.0, 0.0, 0.0, -59238493.0 / 1068277825.0, 181606767.0 / 758867731.0, 561292985.0 / 797845732.0,
+    -1041891430.0 / 1371343529.0, 760417239.0 / 1151165299.0, 118820643.0 / 751138087.0, -528747749.0 / 2220607170.0, 1.0 / 4.0
+};
+
+constexpr std::array<double, kStageCount> kBHat = {
+    13451932.0 / 455176623.0, 0.0, 0.0, 0.0, 0.0, -808719846.0 / 976000145.0, 1757004468.0 / 5645159321.0, 656045339.0 / 265891186.0,
+    -3867574721.0 / 1518517206.0, 465885868.0 / 322736535.0, 53011238.0 / 667516719.0, 2.0 / 45.0, 0.0
+};
+
+// Step size control for the adaptive integrator.
+constexpr double kInitialAdaptiveStep = 60.0; // s
+constexpr double kMinimumAdaptiveStep = 1.0e-3; // s
+constexpr double kSafetyFactor = 0.9;
+constexpr double kMinimumStepScale = 0.2;
+constexpr double kMaximumStepScale = 5.0;
+
+// Times within this of the target (s) count as having reached it.
+constexpr double kTimeEpsilon = 1.0e-9;
+
+} // anonymous namespace
+
+// Position and velocity components of every lane of a batch, one array per component.
+struct NumericalPropagator::StateLanes
+{
+    std::array<std::array<double, kBatchSize>, 6> components;
+
+    std::array<double, kBatchSize>& operator[](size_t component) { return components[component]; }
+    const std::array<double, kBatchSize>& operator[](size_t component) const { return components[component]; }
+};
+
+struct NumericalPropagator::Batch
+{
+    size_t count{ 0 };
+    double target{ 0.0 };
+    std::array<double, kBatchSize> time;
+    std::array<double, kBatchSize> step;
+    std::array<double, kBatchSize> adaptiveStep;
+    std::array<double, kBatchSize> ballisticCoefficient;
+    std::array<uint8_t, kBatchSize> decayed;
+
+    // Lanes which haven't reached the target yet.
+    std::array<uint8_t, kBatchSize> lanes;
+    size_t laneCount{ 0 };
+
+    StateLanes state;
+    StateLanes stageState;
+    std::array<double, kBatchSize> stageTime;
+    std::array<StateLanes, kStageCount> derivatives;
+};
+
+NumericalPropagator::NumericalPropagator()
+{
+}
+
+NumericalPropagator::~NumericalPropagator()
+{
+}
+
+size_t NumericalPropagator::Add(double time, const glm::dvec3& position, const glm::dvec3& velocity, double ballisticCoefficient)
+{
+    const size_t index = GetCount();
+    m_Time.push_back(time);
+    m_Px.push_back(position.x);
+    m_Py.push_back(position.y);
+    m_Pz.push_back(position.z);
+    m_Vx.push_back(velocity.x);
+    m_Vy.push_back(velocity.y);
+    m_Vz.push_back(velocity.z);
+    m_BallisticCoefficient.push_back(ballisticCoefficient);
+    m_AdaptiveStep.push_back(kInitialAdaptiveStep);
+    m_Decayed.push_back(0);
+    return index;
+}
+
+void NumericalPropagator::Set(size_t index, double time, const glm::dvec3& position, const glm::dvec3& velocity)
+{
+    m_Time[index] = time;
+    m_Px[index] = position.x;
+    m_Py[index] = position.y;
+    m_Pz[index] = position.z;
+    m_Vx[index] = velocity.x;
+    m_Vy[index] = velocity.y;
+    m_Vz[index] = velocity.z;
+    m_AdaptiveStep[index] = kInitialAdaptiveStep;
+    m_Decayed[index] = 0;
+}
+
+void NumericalPropagator::Clear()
+{
+    m_Time.clear();
+    m_Px.clear();
+    m_Py.clear();
+    m_Pz.clear();
+    m_Vx.clear();
+    m_Vy.clear();
+    m_Vz.clear();
+    m_BallisticCoefficient.clear();
+    m_AdaptiveStep.clear();
+    m_Decayed.clear();
+}
+
+void NumericalPropagator::Advance(double time, WorkerPool* pWorkerPool)
+{
+    const size_t count = GetCount();
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (m_ForceModel.thirdBody)
+    {
+        const auto [earliest, latest] = std::minmax_element(m_Time.begin(), m_Time.end());
+        BuildThirdBodyTable(std::min(*earliest, time), std::max(*latest, time));
+    }
+
+    pWorkerPool->ParallelFor(count, kGrainSize, [this, time](size_t begin, size_t end)
+    {
+        for (size_t batchBegin = begin; batchBegin < end; batchBegin += kBatchSize)
+        {
+            IntegrateBatch(batchBegin, std::min(batchBegin + kBatchSize, end), time);
+        }
+    });
+}
+
+void NumericalPropagator::BuildThirdBodyTable(double begin, double end)
+{
+    const size_t entryCount = static_cast<size_t>(std::ceil((end - begin) / kThirdBodyTableStep)) + 2;
+    m_ThirdBodyTableBegin = begin;
+    m_SunPositions.resize(entryCount);
+    m_MoonPositions.resize(entryCount);
+    for (size_t i = 0; i < entryCount; ++i)
+    {
+        const double time = begin + i * kThirdBodyTableStep;
+        m_SunPositions[i] = CalculateSunPosition(time);
+        m_MoonPositions[i] = CalculateMoonPosition(time);
+    }
+}
+
+glm::dvec3 NumericalPropagator::GetThirdBodyPosition(const std::vector<glm::dvec3>& table, double time) const
+{
+    const double offset = std::clamp((time - m_ThirdBodyTableBegin) / kThirdBodyTableStep, 0.0, static_cast<double>(table.size() - 1));
+    const size_t index = std::min(static_cast<size_t>(offset), table.size() - 2);
+    const double fraction = offset - static_cast<double>(index);
+    return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+void NumericalPropagator::IntegrateBatch(size_t begin, size_t end, double time)
+{
+    Batch batch;
+    batch.count = end - begin;
+    batch.target = time;
+    batch.laneCount = 0;
+    for (size_t lane = 0; lane < batch.count; ++lane)
+    {
+        const size_t index = begin + lane;
+        batch.time[lane] = m_Time[index];
+        batch.adaptiveStep[lane] = m_AdaptiveStep[index];
+        batch.ballisticCoefficient[lane] = m_BallisticCoefficient[index];
+        batch.decayed[lane] = m_Decayed[index];
+        batch.state[0][lane] = m_Px[index];
+        batch.state[1][lane] = m_Py[index];
+        batch.state[2][lane] = m_Pz[index];
+        batch.state[3][lane] = m_Vx[index];
+        batch.state[4][lane] = m_Vy[index];
+        batch.state[5][lane] = m_Vz[index];
+        if (!batch.decayed[lane] && std::abs(time - batch.time[lane]) > kTimeEpsilon)
+        {
+            batch.lanes[batch.laneCount++] = static_cast<uint8_t>(lane);
+        }
+    }
+
+    if (m_Integrator == Integrator::RungeKutta4)
+    {
+        IntegrateRungeKutta4(batch);
+    }
+    else
+    {
+        IntegrateDormandPrince87(batch);
+    }
+
+    for (size_t lane = 0; lane < batch.count; ++lane)
+    {
+        const size_t index = begin + lane;
+        m_Time[index] = batch.time[lane];
+        m_AdaptiveStep[index] = batch.adaptiveStep[lane];
+        m_Decayed[index] = batch.decayed[lane];
+        m_Px[index] = batch.state[0][lane];
+        m_Py[index] = batch.state[1][lane];
+        m_Pz[index] = batch.state[2][lane];
+        m_Vx[index] = batch.state[3][lane];
+        m_Vy[index] = batch.state[4][lane];
+        m_Vz[index] = batch.state[5][lane];
+    }
+}
+
+void NumericalPropagator::EvaluateDerivatives(const Batch& batch, const double* pTimes, const StateLanes& state, StateLanes& derivative) const
+{
+    const bool thirdBody = m_ForceModel.thirdBody;
+    const bool drag = m_ForceModel.drag;
+    const uint32_t zonalDegree = std::clamp(m_ForceModel.zonalDegree, 2u, 6u);
+
+    for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+    {
+        const size_t lane = batch.lanes[laneIndex];
+        const glm::dvec3 r(state[0][lane], state[1][lane], state[2][lane]);
+        const glm::dvec3 v(state[3][lane], state[4][lane], state[5][lane]);
+        const double radius = glm::length(r);
+        const double inverseRadius = 1.0 / radius;
+
+        // Central body.
+        glm::dvec3 acceleration = -kMu * inverseRadius * inverseRadius * inverseRadius * r;
+
+        // Zonal harmonics, from the gradient of -μ/r·Jn·(R/r)ⁿ·Pn(sin φ). Pn and Pn' follow from their
+        // recurrences in s = sin φ = z/r.
+        const double s = r.z * inverseRadius;
+        std::array<double, 7> P;
+        std::array<double, 7> dP;
+        P[0] = 1.0;
+        P[1] = s;
+        dP[0] = 0.0;
+        dP[1] = 1.0;
+        double radialScale = kMu * inverseRadius * inverseRadius * (kEarthRadius * inverseRadius);
+        double radial = 0.0;
+        double polar = 0.0;
+        for (uint32_t n = 2; n <= zonalDegree; ++n)
+        {
+            P[n] = ((2.0 * n - 1.0) * s * P[n - 1] - (n - 1.0) * P[n - 2]) / n;
+            dP[n] = dP[n - 2] + (2.0 * n - 1.0) * P[n - 1];
+            radialScale *= kEarthRadius * inverseRadius;
+            radial += radialScale * kZonalHarmonics[n] * ((n + 1.0) * P[n] + s * dP[n]);
+            polar += radialScale * kZonalHarmonics[n] * dP[n];
+        }
+        acceleration += radial * inverseRadius * r;
+        acceleration.z -= polar;
+
+        if (drag && batch.ballisticCoefficient[lane] > 0.0)
+        {
+            const double density = GetAtmosphericDensity(radius - kEarthRadius);
+            if (density > 0.0)
+            {
+                // Velocity relative to the co-rotating atmosphere. The factor of 1000 takes ρ·|v|·v from
+                // kg/m³·(km/s)² to km/s² per m²/kg.
+                const glm::dvec3 relativeVelocity = v - glm::dvec3(-kEarthRotationRate * r.y, kEarthRotationRate * r.x, 0.0);
+                acceleration -= 0.5e3 * batch.ballisticCoefficient[lane] * density * glm::length(relativeVelocity) * relativeVelocity;
+            }
+        }
+
+        if (thirdBody)
+        {
+            acceleration += GetThirdBodyAcceleration(r, GetThirdBodyPosition(m_SunPositions, pTimes[lane]), kSunMu);
+            acceleration += GetThirdBodyAcceleration(r, GetThirdBodyPosition(m_MoonPositions, pTimes[lane]), kMoonMu);
+        }
+
+        derivative[0][lane] = v.x;
+        derivative[1][lane] = v.y;
+        derivative[2][lane] = v.z;
+        derivative[3][lane] = acceleration.x;
+        derivative[4][lane] = acceleration.y;
+        derivative[5][lane] = acceleration.z;
+    }
+}
+
+void NumericalPropagator::IntegrateRungeKutta4(Batch& batch) const
+{
+    StateLanes& k1 = batch.derivatives[0];
+    StateLanes& k2 = batch.derivatives[1];
+    StateLanes& k3 = batch.derivatives[2];
+    StateLanes& k4 = batch.derivatives[3];
+
+    while (batch.laneCount > 0)
+    {
+        for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+        {
+            const size_t lane = batch.lanes[laneIndex];
+            const double remaining = batch.target - batch.time[lane];
+            batch.step[lane] = std::copysign(std::min(m_StepSize, std::abs(remaining)), remaining);
+        }
+
+        // k1..k4, each stage built from the previous one.
+        EvaluateDerivatives(batch, batch.time.data(), batch.state, k1);
+        const std::array<std::pair<const StateLanes*, StateLanes*>, 3> stages = { { { &k1, &k2 }, { &k2, &k3 }, { &k3, &k4 } } };
+        for (size_t stage = 0; stage < stages.size(); ++stage)
+        {
+            const double fraction = stage < 2 ? 0.5 : 1.0;
+            const StateLanes& previous = *stages[stage].first;
+            for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+            {
+                const size_t lane = batch.lanes[laneIndex];
+                const double h = batch.step[lane] * fraction;
+                batch.stageTime[lane] = batch.time[lane] + h;
+                for (size_t component = 0; component < 6; ++component)
+                {
+                    batch.stageState[component][lane] = batch.state[component][lane] + h * previous[component][lane];
+                }
+            }
+            EvaluateDerivatives(batch, batch.stageTime.data(), batch.stageState, *stages[stage].second);
+        }
+
+        size_t remainingLanes = 0;
+        for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+        {
+            const size_t lane = batch.lanes[laneIndex];
+            const double h = batch.step[lane];
+            for (size_t component = 0; component < 6; ++component)
+            {
+                batch.state[component][lane] += h / 6.0 * (k1[component][lane] + 2.0 * k2[component][lane] + 2.0 * k3[component][lane] + k4[component][lane]);
+            }
+            batch.time[lane] += h;
+
+            const double radius = std::sqrt(batch.state[0][lane] * batch.state[0][lane] + batch.state[1][lane] * batch.state[1][lane] + batch.state[2][lane] * batch.state[2][lane]);
+            if (radius < kEarthRadius)
+            {
+                batch.decayed[lane] = 1;
+            }
+            else if (std::abs(batch.target - batch.time[lane]) > kTimeEpsilon)
+            {
+                batch.lanes[remainingLanes++] = static_cast<uint8_t>(lane);
+            }
+            else
+            {
+                batch.time[lane] = batch.target;
+            }
+        }
+        batch.laneCount = remainingLanes;
+    }
+}
+
+void NumericalPropagator::IntegrateDormandPrince87(Batch& batch) const
+{
+    while (batch.laneCount > 0)
+    {
+        for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+        {
+            const size_t lane = batch.lanes[laneIndex];
+            const double remaining = batch.target - batch.time[lane];
+            batch.step[lane] = std::copysign(std::min(batch.adaptiveStep[lane], std::abs(remaining)), remaining);
+        }
+
+        EvaluateDerivatives(batch, batch.time.data(), batch.state, batch.derivatives[0]);
+        for (size_t stage = 1; stage < kStageCount; ++stage)
+        {
+            for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+            {
+                const size_t lane = batch.lanes[laneIndex];
+                const double h = batch.step[lane];
+                batch.stageTime[lane] = batch.time[lane] + kC[stage] * h;
+                for (size_t component = 0; component < 6; ++component)
+                {
+                    double sum = 0.0;
+                    for (size_t previous = 0; previous < stage; ++previous)
+                    {
+                        sum += kA[stage][previous] * batch.derivatives[previous][component][lane];
+                    }
+                    batch.stageState[component][lane] = batch.state[component][lane] + h * sum;
+                }
+            }
+            EvaluateDerivatives(batch, batch.stageTime.data(), batch.stageState, batch.derivatives[stage]);
+        }
+
+        size_t remainingLanes = 0;
+        for (size_t laneIndex = 0; laneIndex < batch.laneCount; ++laneIndex)
+        {
+            const size_t lane = batch.lanes[laneIndex];
+            const double h = batch.step[lane];
+
+            // The error is measured separately for position and velocity, relative to their magnitudes.
+            std::array<double, 6> solution;
+            std::array<double, 6> difference;
+            for (size_t component = 0; component < 6; ++component)
+            {
+                double high = 0.0;
+                double low = 0.0;
+                for (size_t stage = 0; stage < kStageCount; ++stage)
+                {
+                    high += kB[stage] * batch.derivatives[stage][component][lane];
+                    low += kBHat[stage] * batch.derivatives[stage][component][lane];
+                }
+                solution[component] = batch.state[component][lane] + h * high;
+                difference[component] = h * (high - low);
+            }
+
+            const double positionScale = std::sqrt(solution[0] * solution[0] + solution[1] * solution[1] + solution[2] * solution[2]);
+            const double velocityScale = std::sqrt(solution[3] * solution[3] + solution[4] * solution[4] + solution[5] * solution[5]);
+            const double positionError = std::sqrt(difference[0] * difference[0] + difference[1] * difference[1] + difference[2] * difference[2]) / (m_Tolerance * positionScale);
+            const double velocityError = std::sqrt(difference[3] * difference[3] + difference[4] * difference[4] + difference[5] * difference[5]) / (m_Tolerance * velocityScale);
+            const double error = std::max(positionError, velocityError);
+
+            const double scale = error > 0.0 ? std::clamp(kSafetyFactor * std::pow(error, -1.0 / 8.0), kMinimumStepScale, kMaximumStepScale) : kMaximumStepScale;
+            const bool accepted = error <= 1.0 || std::abs(h) <= kMinimumAdaptiveStep;
+            if (accepted)
+            {
+                for (size_t component = 0; component < 6; ++component)
+                {
+                    batch.state[component][lane] = solution[component];
+                }
+                batch.time[lane] += h;
+
+                // A step cut short by the target says nothing about the step size the orbit can take.
+                if (std::abs(h) >= batch.adaptiveStep[lane])
+                {
+                    batch.adaptiveStep[lane] = std::max(std::abs(h) * scale, kMinimumAdaptiveStep);
+                }
+            }
+            else
+            {
+                batch.adaptiveStep[lane] = std::max(std::abs(h) * scale, kMinimumAdaptiveStep);
+            }
+
+            if (positionScale < kEarthRadius)
+            {
+                batch.decayed[lane] = 1;
+            }
+            else if (std::abs(batch.target - batch.time[lane]) > kTimeEpsilon)
+            {
+                batch.lanes[remainingLanes++] = static_cast<uint8_t>(lane);
+            }
+            else
+            {
+                batch.time[lane] = batch.target;
+            }
+        }
+        batch.laneCount = remainingLanes;
+    }
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+namespace WingsOfSteel
+{
+
+class WorkerPool;
+
+// Numerical propagation of Cartesian states, for objects which need more fidelity than the analytic models
+// give. Accelerations include the J2 to J6 zonal harmonics, drag through an exponential atmosphere that
+// co-rotates with the Earth, and the Sun and the Moon as point masses.
+// States are stored as structure-of-arrays, and Advance() splits them into batches which are integrated in
+// lockstep on the worker pool, each object with its own step size.
+class NumericalPropagator
+{
+public:
+    enum class Integrator
+    {
+        RungeKutta4, // Classic fixed step RK4
+        DormandPrince87 // Adaptive 8th order with a 7th order error estimate (Prince & Dormand's RK8(7)13M)
+    };
+
+    struct ForceModel
+    {
+        uint32_t zonalDegree{ 6 }; // Highest zonal harmonic included, from 2 (J2 only) to 6
+        bool drag{ true };
+        bool thirdBody{ true };
+    };
+
+    NumericalPropagator();
+    ~NumericalPropagator();
+
+    // Adds an object with its ECI state (km, km/s) at the given time (seconds since the Unix epoch) and its
+    // ballistic coefficient Cd·A/m (m²/kg). Returns its index.
+    size_t Add(double time, const glm::dvec3& position, const glm::dvec3& velocity, double ballisticCoefficient);
+
+    // Replaces an object's state, e.g. to re-seed it from an analytic model.
+    void Set(size_t index, double time, const glm::dvec3& position, const glm::dvec3& velocity);
+
+    void Clear();
+    size_t GetCount() const { return m_Time.size(); }
+
+    // Integrates every object forwards or backwards to the given time. Objects which re-enter stop at the
+    // surface and are flagged as decayed.
+    void Advance(double time, WorkerPool* pWorkerPool);
+
+    double GetTime(size_t index) const { return m_Time[index]; }
+    glm::dvec3 GetPosition(size_t index) const { return glm::dvec3(m_Px[index], m_Py[index], m_Pz[index]); }
+    glm::dvec3 GetVelocity(size_t index) const { return glm::dvec3(m_Vx[index], m_Vy[index], m_Vz[index]); }
+    bool IsDecayed(size_t index) const { return m_Decayed[index] != 0; }
+
+    Integrator GetIntegrator() const { return m_Integrator; }
+    void SetIntegrator(Integrator integrator) { m_Integrator = integrator; }
+
+    const ForceModel& GetForceModel() const { return m_ForceModel; }
+    void SetForceModel(const ForceModel& forceModel) { m_ForceModel = forceModel; }
+
+    // Step used by RK4 (s).
+    double GetStepSize() const { return m_StepSize; }
+    void SetStepSize(double stepSize) { m_StepSize = stepSize; }
+
+    // Relative error allowed per step by the adaptive integrator.
+    double GetTolerance() const { return m_Tolerance; }
+    void SetTolerance(double tolerance) { m_Tolerance = tolerance; }
+
+private:
+    struct StateLanes;
+    struct Batch;
+
+    void BuildThirdBodyTable(double begin, double end);
+    glm::dvec3 GetThirdBodyPosition(const std::vector<glm::dvec3>& table, double time) const;
+    void IntegrateBatch(size_t begin, size_t end, double time);
+    void IntegrateRungeKutta4(Batch& batch) const;
+    void IntegrateDormandPrince87(Batch& batch) const;
+    void EvaluateDerivatives(const Batch& batch, const double* pTimes, const StateLanes& state, StateLanes& derivative) const;
+
+    Integrator m_Integrator{ Integrator::DormandPrince87 };
+    ForceModel m_ForceModel;
+    double m_StepSize{ 30.0 };
+    double m_Tolerance{ 1.0e-10 };
+
+    std::vector<double> m_Time; // Seconds since the Unix epoch
+    std::vector<double> m_Px; // km, ECI
+    std::vector<double> m_Py;
+    std::vector<double> m_Pz;
+    std::vector<double> m_Vx; // km/s, ECI
+    std::vector<double> m_Vy;
+    std::vector<double> m_Vz;
+    std::vector<double> m_BallisticCoefficient; // m²/kg
+    std::vector<double> m_AdaptiveStep; // Last step the adaptive integrator accepted, reused as the next first guess (s)
+    std::vector<uint8_t> m_Decayed;
+
+    // Sun and Moon positions tabulated over the span of the current Advance(), shared by every batch.
+    std::vector<glm::dvec3> m_SunPositions;
+    std::vector<glm::dvec3> m_MoonPositions;
+    double m_ThirdBodyTableBegin{ 0.0 };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+#include "propagation/propagation_store.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Earth's gravitational parameter (km³/s²)
+constexpr double kMu = 398600.4418;
+
+// Earth's equatorial radius (km) and second zonal harmonic, for the secular J2 rates.
+constexpr double kEarthRadius = 6378.137;
+constexpr double kJ2 = 1.08262668e-3;
+
+// Objects are propagated in blocks small enough for the intermediate arrays to stay in L1.
+constexpr size_t kBlockSize = 256;
+
+} // anonymous namespace
+
+PropagationStore::PropagationStore()
+{
+}
+
+PropagationStore::~PropagationStore()
+{
+}
+
+size_t PropagationStore::Add(const SpaceObject& spaceObject)
+{
+    const size_t index = GetCount();
+    const size_t count = index + 1;
+    m_Epoch.resize(count);
+    m_MeanAnomalyAtEpoch.resize(count);
+    m_MeanMotion.resize(count);
+    m_Eccentricity.resize(count);
+    m_SemiMajorAxis.resize(count);
+    m_SemiMinorAxis.resize(count);
+    m_Px.resize(count);
+    m_Py.resize(count);
+    m_Pz.resize(count);
+    m_Qx.resize(count);
+    m_Qy.resize(count);
+    m_Qz.resize(count);
+    m_CosInclination.resize(count);
+    m_SinInclination.resize(count);
+    m_NodeAtEpoch.resize(count);
+    m_PerigeeAtEpoch.resize(count);
+    m_NodeRate.resize(count);
+    m_PerigeeRate.resize(count);
+    m_SecularMeanMotion.resize(count);
+    SetAnalyticTerms(index, spaceObject);
+    m_Sgp4.Add(Sgp4Elements::FromSpaceObject(spaceObject));
+    return index;
+}
+
+void PropagationStore::Set(size_t index, const SpaceObject& spaceObject)
+{
+    SetAnalyticTerms(index, spaceObject);
+    m_Sgp4.Set(index, Sgp4Elements::FromSpaceObject(spaceObject));
+}
+
+void PropagationStore::SetAnalyticTerms(size_t index, const SpaceObject& spaceObject)
+{
+    // Convert mean motion from rev/day to rad/s
+    const double n = spaceObject.GetMeanMotion() * 2.0 * glm::pi<double>() / 86400.0;
+
+    // Calculate semi-major axis from mean motion: n = sqrt(mu/a³) => a = (mu/n²)^(1/3)
+    const double a = std::cbrt(kMu / (n * n));
+    const double e = spaceObject.GetEccentricity();
+
+    // Convert angles from degrees to radians
+    const double i = glm::radians(static_cast<double>(spaceObject.GetInclination()));
+    const double omega = glm::radians(static_cast<double>(spaceObject.GetRightAscensionOfAscendingNode())); // RAAN (Ω)
+    const double w = glm::radians(static_cast<double>(spaceObject.GetArgumentOfPericenter())); // Argument of pericenter (ω)
+
+    const double cos_omega = std::cos(omega);
+    const double sin_omega = std::sin(omega);
+    const double cos_i = std::cos(i);
+    const double sin_i = std::sin(i);
+    const double cos_w = std::cos(w);
+    const double sin_w = std::sin(w);
+
+    m_Epoch[index] = std::chrono::duration<double>(spaceObject.GetEpoch().time_since_epoch()).count();
+    m_MeanAnomalyAtEpoch[index] = glm::radians(static_cast<double>(spaceObject.GetMeanAnomaly()));
+    m_MeanMotion[index] = n;
+    m_Eccentricity[index] = e;
+    m_SemiMajorAxis[index] = a;
+    m_SemiMinorAxis[index] = a * std::sqrt(1.0 - e * e);
+
+    // Perifocal to ECI rotation: R = R_z(-Ω) * R_x(-i) * R_z(-ω)
+    // Only the first two columns are needed as perifocal positions have no W component.
+    m_Px[index] = cos_omega * cos_w - sin_omega * sin_w * cos_i;
+    m_Py[index] = sin_omega * cos_w + cos_omega * sin_w * cos_i;
+    m_Pz[index] = sin_w * sin_i;
+    m_Qx[index] = -(cos_omega * sin_w + sin_omega * cos_w * cos_i);
+    m_Qy[index] = -(sin_omega * sin_w - cos_omega * cos_w * cos_i);
+    m_Qz[index] = cos_w * sin_i;
+
+    // Secular drift caused by J2: the node regresses, the line of apsides rotates, and the mean anomaly
+    // rate differs slightly from the two-body value. Element sets carry Kozai's mean motion, which already
+    // folds in most of the mean anomaly correction, so the rates are based on Brouwer's mean motion instead.
+    const double beta = std::sqrt(1.0 - e * e);
+    const double kozaiCorrection = 0.75 * kJ2 * (kEarthRadius / a) * (kEarthRadius / a) * (3.0 * cos_i * cos_i - 1.0) / (beta * beta * beta);
+    const double brouwerMeanMotion = n / (1.0 + kozaiCorrection);
+    const double p = a * (1.0 - e * e);
+    const double j2Factor = 1.5 * kJ2 * (kEarthRadius / p) * (kEarthRadius / p) * brouwerMeanMotion;
+    m_CosInclination[index] = cos_i;
+    m_SinInclination[index] = sin_i;
+    m_NodeAtEpoch[index] = omega;
+    m_PerigeeAtEpoch[index] = w;
+    m_NodeRate[index] = -j2Factor * cos_i;
+    m_PerigeeRate[index] = 0.5 * j2Factor * (4.0 - 5.0 * sin_i * sin_i);
+    m_SecularMeanMotion[index] = brouwerMeanMotion + j2Factor * beta * (1.0 - 1.5 * sin_i * sin_i);
+}
+
+void PropagationStore::Clear()
+{
+    m_Epoch.clear();
+    m_MeanAnomalyAtEpoch.clear();
+    m_MeanMotion.clear();
+    m_Eccentricity.clear();
+    m_SemiMajorAxis.clear();
+    m_SemiMinorAxis.clear();
+    m_Px.clear();
+    m_Py.clear();
+    m_Pz.clear();
+    m_Qx.clear();
+    m_Qy.clear();
+    m_Qz.clear();
+    m_CosInclination.clear();
+    m_SinInclination.clear();
+    m_NodeAtEpoch.clear();
+    m_PerigeeAtEpoch.clear();
+    m_NodeRate.clear();
+    m_PerigeeRate.clear();
+    m_SecularMeanMotion.clear();
+    m_Sgp4.Clear();
+}
+
+template <typename SlotFunction, typename TimeFunction>
+void PropagationStore::PropagateBlocks(size_t count, SlotFunction slotOf, TimeFunction timeOf, glm::vec3* pPositions, glm::vec3* pVelocities) const
+{
+    if (m_Model == Model::Sgp4)
+    {
+        PropagateSgp4(count, slotOf, timeOf, pPositions, pVelocities);
+    }
+    else
+    {
+        PropagateTwoBody(count, slotOf, timeOf, pPositions, pVelocities);
+    }
+}
+
+template <typename SlotFunction, typename TimeFunction>
+void PropagationStore::PropagateTwoBody(size_t count, SlotFunction slotOf, TimeFunction timeOf, glm::vec3* pPositions, glm::vec3* pVelocities) const
+{
+    std::array<double, kBlockSize> meanAnomaly;
+    std::array<double, kBlockSize> eccentricity;
+    std::array<double, kBlockSize> px;
+    std::array<double, kBlockSize> py;
+    std::array<double, kBlockSize> pz;
+    std::array<double, kBlockSize> qx;
+    std::array<double, kBlockSize> qy;
+    std::array<double, kBlockSize> qz;
+    std::array<double, kBlockSize> sinE;
+    std::array<double, kBlockSize> cosE;
+    std::array<double, kBlockSize> node;
+    std::array<double, kBlockSize> perigee;
+    std::array<double, kBlockSize> sinNode;
+    std::array<double, kBlockSize> cosNode;
+    std::array<double, kBlockSize> sinPerigee;
+    std::array<double, kBlockSize> cosPerigee;
+    std::array<float, kBlockSize> meanAnomalySingle;
+    std::array<float, kBlockSize> eccentricitySingle;
+    std::array<float, kBlockSize> sinESingle;
+    std::array<float, kBlockSize> cosESingle;
+
+    for (size_t blockBegin = 0; blockBegin < count; blockBegin += kBlockSize)
+    {
+        const size_t blockCount = std::min(kBlockSize, count - blockBegin);
+
+        // Propagate mean anomaly to the requested time. The solver reduces it to [-π, π] itself.
+        if (m_Model == Model::J2Secular)
+        {
+            // The orbital plane and the line of apsides drift, so the perifocal basis is rebuilt from the
+            // node and argument of perigee at the requested time, the same way Set() builds it at epoch. Their
+            // sines and cosines are evaluated for the whole block at once with the solver's vectorized SinCos.
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                const size_t slot = slotOf(blockBegin + i);
+                const double dt = timeOf(blockBegin + i) - m_Epoch[slot];
+                meanAnomaly[i] = m_MeanAnomalyAtEpoch[slot] + m_SecularMeanMotion[slot] * dt;
+                eccentricity[i] = m_Eccentricity[slot];
+                node[i] = m_NodeAtEpoch[slot] + m_NodeRate[slot] * dt;
+                perigee[i] = m_PerigeeAtEpoch[slot] + m_PerigeeRate[slot] * dt;
+            }
+
+            KeplerSolver::SinCos(node.data(), sinNode.data(), cosNode.data(), blockCount);
+            KeplerSolver::SinCos(perigee.data(), sinPerigee.data(), cosPerigee.data(), blockCount);
+
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                const size_t slot = slotOf(blockBegin + i);
+                const double cos_omega = cosNode[i];
+                const double sin_omega = sinNode[i];
+                const double cos_w = cosPerigee[i];
+                const double sin_w = sinPerigee[i];
+                const double cos_i = m_CosInclination[slot];
+                const double sin_i = m_SinInclination[slot];
+                px[i] = cos_omega * cos_w - sin_omega * sin_w * cos_i;
+                py[i] = sin_omega * cos_w + cos_omega * sin_w * cos_i;
+                pz[i] = sin_w * sin_i;
+                qx[i] = -(cos_omega * sin_w + sin_omega * cos_w * cos_i);
+                qy[i] = -(sin_omega * sin_w - cos_omega * cos_w * cos_i);
+                qz[i] = cos_w * sin_i;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                const size_t slot = slotOf(blockBegin + i);
+                meanAnomaly[i] = m_MeanAnomalyAtEpoch[slot] + m_MeanMotion[slot] * (timeOf(blockBegin + i) - m_Epoch[slot]);
+                eccentricity[i] = m_Eccentricity[slot];
+                px[i] = m_Px[slot];
+                py[i] = m_Py[slot];
+                pz[i] = m_Pz[slot];
+                qx[i] = m_Qx[slot];
+                qy[i] = m_Qy[slot];
+                qz[i] = m_Qz[slot];
+            }
+        }
+
+        if (m_KeplerAccuracy == KeplerSolver::Accuracy::Double)
+        {
+            KeplerSolver::SolveSinCos(meanAnomaly.data(), eccentricity.data(), sinE.data(), cosE.data(), blockCount);
+        }
+        else
+        {
+            // The mean anomaly grows without bound, so it is reduced in double precision before narrowing.
+            constexpr double kTwoPi = 2.0 * glm::pi<double>();
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                meanAnomalySingle[i] = static_cast<float>(meanAnomaly[i] - kTwoPi * std::nearbyint(meanAnomaly[i] / kTwoPi));
+                eccentricitySingle[i] = static_cast<float>(eccentricity[i]);
+            }
+            KeplerSolver::SolveSinCos(meanAnomalySingle.data(), eccentricitySingle.data(), sinESingle.data(), cosESingle.data(), blockCount);
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                sinE[i] = sinESingle[i];
+                cosE[i] = cosESingle[i];
+            }
+        }
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            const size_t slot = slotOf(blockBegin + i);
+
+            // Position in perifocal (orbital plane) coordinates, taken directly from the eccentric
+            // anomaly so neither the true anomaly nor the orbital radius need to be computed.
+            const double x_pf = m_SemiMajorAxis[slot] * (cosE[i] - eccentricity[i]);
+            const double y_pf = m_SemiMinorAxis[slot] * sinE[i];
+
+            pPositions[blockBegin + i] = glm::vec3(
+                static_cast<float>(x_pf * px[i] + y_pf * qx[i]),
+                static_cast<float>(x_pf * py[i] + y_pf * qy[i]),
+                static_cast<float>(x_pf * pz[i] + y_pf * qz[i]));
+
+            if (pVelocities)
+            {
+                // dE/dt = n / (1 - e·cos E), where n is the rate the mean anomaly was advanced at above. The slow
+                // rotation of the basis under J2 is negligible here.
+                const double meanMotion = m_Model == Model::J2Secular ? m_SecularMeanMotion[slot] : m_MeanMotion[slot];
+                const double dEdt = meanMotion / (1.0 - eccentricity[i] * cosE[i]);
+                const double vx_pf = -m_SemiMajorAxis[slot] * sinE[i] * dEdt;
+                const double vy_pf = m_SemiMinorAxis[slot] * cosE[i] * dEdt;
+
+                pVelocities[blockBegin + i] = glm::vec3(
+                    static_cast<float>(vx_pf * px[i] + vy_pf * qx[i]),
+                    static_cast<float>(vx_pf * py[i] + vy_pf * qy[i]),
+                    static_cast<float>(vx_pf * pz[i] + vy_pf * qz[i]));
+            }
+        }
+    }
+}
+
+// Slots SGP4 rejects are gathered per block and given two-body positions instead, so the caller never sees a hole.
+template <typename SlotFunction, typename TimeFunction>
+void PropagationStore::PropagateSgp4(size_t count, SlotFunction slotOf, TimeFunction timeOf, glm::vec3* pPositions, glm::vec3* pVelocities) const
+{
+    std::array<uint32_t, kBlockSize> failedSlots;
+    std::array<double, kBlockSize> failedTimes;
+    std::array<size_t, kBlockSize> failedIndices;
+    std::array<glm::vec3, kBlockSize> fallbackPositions;
+    std::array<glm::vec3, kBlockSize> fallbackVelocities;
+
+    for (size_t blockBegin = 0; blockBegin < count; blockBegin += kBlockSize)
+    {
+        const size_t blockCount = std::min(kBlockSize, count - blockBegin);
+        size_t failedCount = 0;
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            const size_t slot = slotOf(blockBegin + i);
+            const double time = timeOf(blockBegin + i);
+            glm::dvec3 position;
+            glm::dvec3 velocity;
+            if (m_Sgp4.Propagate(slot, time, position, velocity) != Sgp4::Error::None)
+            {
+                failedSlots[failedCount] = static_cast<uint32_t>(slot);
+                failedTimes[failedCount] = time;
+                failedIndices[failedCount] = blockBegin + i;
+                failedCount++;
+                continue;
+            }
+
+            pPositions[blockBegin + i] = glm::vec3(position);
+            if (pVelocities)
+            {
+                pVelocities[blockBegin + i] = glm::vec3(velocity);
+            }
+        }
+
+        if (failedCount > 0)
+        {
+            const uint32_t* pFailedSlots = failedSlots.data();
+            const double* pFailedTimes = failedTimes.data();
+            PropagateTwoBody(
+                failedCount,
+                [pFailedSlots](size_t i) { return static_cast<size_t>(pFailedSlots[i]); },
+                [pFailedTimes](size_t i) { return pFailedTimes[i]; },
+                fallbackPositions.data(),
+                fallbackVelocities.data());
+
+            for (size_t i = 0; i < failedCount; ++i)
+            {
+                pPositions[failedIndices[i]] = fallbackPositions[i];
+                if (pVelocities)
+                {
+                    pVelocities[failedIndices[i]] = fallbackVelocities[i];
+                }
+            }
+        }
+    }
+}
+
+void PropagationStore::Propagate(double time, size_t begin, size_t end, glm::vec3* pPositions, glm::vec3* pVelocities) const
+{
+    PropagateBlocks(
+        end - begin,
+        [begin](size_t i) { return begin + i; },
+        [time](size_t) { return time; },
+        pPositions + begin,
+        pVelocities ? pVelocities + begin : nullptr);
+}
+
+void PropagationStore::Propagate(const uint32_t* pSlots, const double* pTimes, size_t count, glm::vec3* pPositions, glm::vec3* pVelocities) const
+{
+    PropagateBlocks(
+        count,
+        [pSlots](size_t i) { return static_cast<size_t>(pSlots[i]); },
+        [pTimes](size_t i) { return pTimes[i]; },
+        pPositions,
+        pVelocities);
+}
+
+} // namespace WingsOfSteel
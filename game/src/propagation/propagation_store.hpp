@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "propagation/kepler_solver.hpp"
+#include "propagation/sgp4.hpp"
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+
+// Structure-of-arrays store of the per-object constants needed to propagate a Keplerian orbit.
+// Everything that only depends on the element set (semi-major axis, mean motion in rad/s and the
+// perifocal-to-ECI rotation) is computed once in Add() / Set(), so per-frame work is reduced to
+// solving Kepler's equation and a 2x3 matrix multiply.
+// The store is also initialised for the J2 secular and SGP4 models, which can be selected instead.
+class PropagationStore
+{
+public:
+    enum class Model
+    {
+        TwoBody,
+        J2Secular, // Two-body, plus the secular node, perigee and mean anomaly drift caused by J2
+        Sgp4 // Element sets SGP4 can't propagate (e.g. decayed objects) fall back to the two-body model
+    };
+
+    PropagationStore();
+    ~PropagationStore();
+
+    // Appends the object's element set and returns the slot it was stored in.
+    size_t Add(const SpaceObject& spaceObject);
+
+    // Recomputes the constants for an existing slot, e.g. when a new element set arrives.
+    void Set(size_t index, const SpaceObject& spaceObject);
+
+    void Clear();
+    size_t GetCount() const { return m_Epoch.size(); }
+
+    double GetEpoch(size_t index) const { return m_Epoch[index]; } // Seconds since the Unix epoch
+    double GetMeanMotion(size_t index) const { return m_MeanMotion[index]; } // rad/s
+    double GetEccentricity(size_t index) const { return m_Eccentricity[index]; }
+
+    // Propagates slots [begin, end) to the given time (seconds since the Unix epoch) and writes the
+    // resulting ECI positions (km) to pPositions[begin, end), and velocities (km/s) to pVelocities[begin, end)
+    // if it isn't null.
+    void Propagate(double time, size_t begin, size_t end, glm::vec3* pPositions, glm::vec3* pVelocities = nullptr) const;
+
+    // Propagates each slot pSlots[i] to its own time pTimes[i], writing the results to pPositions[i] and,
+    // unless it is null, pVelocities[i]. Slots may appear more than once.
+    void Propagate(const uint32_t* pSlots, const double* pTimes, size_t count, glm::vec3* pPositions, glm::vec3* pVelocities) const;
+
+    Model GetModel() const { return m_Model; }
+    void SetModel(Model model) { m_Model = model; }
+
+    KeplerSolver::Accuracy GetKeplerAccuracy() const { return m_KeplerAccuracy; }
+    void SetKeplerAccuracy(KeplerSolver::Accuracy accuracy) { m_KeplerAccuracy = accuracy; }
+
+private:
+    void SetAnalyticTerms(size_t index, const SpaceObject& spaceObject); // Everything but the SGP4 slot
+
+    template <typename SlotFunction, typename TimeFunction>
+    void PropagateBlocks(size_t count, SlotFunction slotOf, TimeFunction timeOf, glm::vec3* pPositions, glm::vec3* pVelocities) const;
+
+    template <typename SlotFunction, typename TimeFunction>
+    void PropagateTwoBody(size_t count, SlotFunction slotOf, TimeFunction timeOf, glm::vec3* pPositions, glm::vec3* pVelocities) const;
+
+    template <typename SlotFunction, typename TimeFunction>
+    void PropagateSgp4(size_t count, SlotFunction slotOf, TimeFunction timeOf, glm::vec3* pPositions, glm::vec3* pVelocities) const;
+
+    Model m_Model{ Model::TwoBody };
+    KeplerSolver::Accuracy m_KeplerAccuracy{ KeplerSolver::Accuracy::Double };
+    Sgp4 m_Sgp4;
+
+    std::vector<double> m_Epoch; // Seconds since the Unix epoch
+    std::vector<double> m_MeanAnomalyAtEpoch; // rad
+    std::vector<double> m_MeanMotion; // rad/s
+    std::vector<double> m_Eccentricity;
+    std::vector<double> m_SemiMajorAxis; // km
+    std::vector<double> m_SemiMinorAxis; // km
+
+    // First two columns of the perifocal-to-ECI rotation matrix (P and Q unit vectors).
+    std::vector<double> m_Px;
+    std::vector<double> m_Py;
+    std::vector<double> m_Pz;
+    std::vector<double> m_Qx;
+    std::vector<double> m_Qy;
+    std::vector<double> m_Qz;
+
+    // J2 secular model. Angles at epoch (rad) and their rates (rad/s).
+    std::vector<double> m_CosInclination;
+    std::vector<double> m_SinInclination;
+    std::vector<double> m_NodeAtEpoch;
+    std::vector<double> m_PerigeeAtEpoch;
+    std::vector<double> m_NodeRate;
+    std::vector<double> m_PerigeeRate;
+    std::vector<double> m_SecularMeanMotion;
+};
+
+} // namespace WingsOfSteel
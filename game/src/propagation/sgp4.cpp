@@ -0,0 +1,859 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+#include "propagation/sgp4.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr double kPi = glm::pi<double>();
+constexpr double kTwoPi = 2.0 * kPi;
+constexpr double kTwoThirds = 2.0 / 3.0;
+
+// WGS-72 constants, which the element sets are fitted against.
+constexpr double kEarthRadius = 6378.135; // km
+constexpr double kMu = 398600.8; // km³/s²
+constexpr double kJ2 = 0.001082616;
+constexpr double kJ3 = -0.00000253881;
+constexpr double kJ4 = -0.00000165597;
+constexpr double kJ3OverJ2 = kJ3 / kJ2;
+const double kXke = 60.0 / std::sqrt(kEarthRadius * kEarthRadius * kEarthRadius / kMu); // sqrt(mu) in earth radii³/min²
+const double kVelocityScale = kEarthRadius * kXke / 60.0; // earth radii/min to km/s
+
+// Lunar-solar constants.
+constexpr double kZes = 0.01675;
+constexpr double kZel = 0.05490;
+constexpr double kZns = 1.19459e-5;
+constexpr double kZnl = 1.5835218e-4;
+
+// Earth's rotation rate (rad/min)
+constexpr double kRptim = 4.37526908801129966e-3;
+
+// Deep-space element sets are referenced to days since 1950 January 0.0.
+constexpr double kUnixEpochJulianDate = 2440587.5;
+constexpr double kJulianDate1950 = 2433281.5;
+
+double GetJulianDateSince1950(double unixTime)
+{
+    return unixTime / 86400.0 + kUnixEpochJulianDate - kJulianDate1950;
+}
+
+// Greenwich mean sidereal time (rad) for a UT1 Julian date.
+double GetGreenwichSiderealTime(double julianDate)
+{
+    const double tut1 = (julianDate - 2451545.0) / 36525.0;
+    double gmst = -6.2e-6 * tut1 * tut1 * tut1 + 0.093104 * tut1 * tut1 + (876600.0 * 3600.0 + 8640184.812866) * tut1 + 67310.54841; // s
+    gmst = std::fmod(glm::radians(gmst) / 240.0, kTwoPi);
+    return gmst < 0.0 ? gmst + kTwoPi : gmst;
+}
+
+} // anonymous namespace
+
+Sgp4Elements Sgp4Elements::FromSpaceObject(const SpaceObject& spaceObject)
+{
+    Sgp4Elements elements;
+    elements.epoch = std::chrono::duration<double>(spaceObject.GetEpoch().time_since_epoch()).count();
+    elements.meanMotion = spaceObject.GetMeanMotion();
+    elements.eccentricity = spaceObject.GetEccentricity();
+    elements.inclination = spaceObject.GetInclination();
+    elements.rightAscensionOfAscendingNode = spaceObject.GetRightAscensionOfAscendingNode();
+    elements.argumentOfPericenter = spaceObject.GetArgumentOfPericenter();
+    elements.meanAnomaly = spaceObject.GetMeanAnomaly();
+    elements.bstar = spaceObject.GetBstar().value_or(0.0f);
+    return elements;
+}
+
+Sgp4::Sgp4()
+{
+}
+
+Sgp4::~Sgp4()
+{
+}
+
+size_t Sgp4::Add(const Sgp4Elements& elements)
+{
+    const size_t index = GetCount();
+    const size_t count = index + 1;
+    m_Epoch.resize(count);
+    for (std::vector<double>& term : m_Terms)
+    {
+        term.resize(count);
+    }
+    m_Simplified.resize(count);
+    m_DeepSpaceIndex.resize(count, kNearEarth);
+    m_InitialisationError.resize(count);
+    Set(index, elements);
+    return index;
+}
+
+void Sgp4::Set(size_t index, const Sgp4Elements& elements)
+{
+    const double ecco = elements.eccentricity;
+    const double inclo = glm::radians(elements.inclination);
+    const double nodeo = glm::radians(elements.rightAscensionOfAscendingNode);
+    const double argpo = glm::radians(elements.argumentOfPericenter);
+    const double mo = glm::radians(elements.meanAnomaly);
+    const double noKozai = elements.meanMotion * kTwoPi / 1440.0; // rad/min
+    const double bstar = elements.bstar;
+    const double epoch = GetJulianDateSince1950(elements.epoch);
+
+    // Recover the original mean motion and semi-major axis from the Kozai mean motion.
+    const double eccsq = ecco * ecco;
+    const double omeosq = 1.0 - eccsq;
+    const double rteosq = std::sqrt(omeosq);
+    const double cosio = std::cos(inclo);
+    const double cosio2 = cosio * cosio;
+    const double sinio = std::sin(inclo);
+    const double ak = std::pow(kXke / noKozai, kTwoThirds);
+    const double d1 = 0.75 * kJ2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    const double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+    del = d1 / (adel * adel);
+    const double no = noKozai / (1.0 + del);
+    const double ao = std::pow(kXke / no, kTwoThirds);
+    const double po = ao * omeosq;
+    const double con42 = 1.0 - 5.0 * cosio2;
+    const double con41 = -con42 - cosio2 - cosio2;
+    const double posq = po * po;
+    const double rp = ao * (1.0 - ecco);
+
+    // A slot which was already deep space keeps its terms, so setting it again doesn't grow m_DeepSpaceTerms.
+    const uint32_t previousDeepSpaceIndex = m_DeepSpaceIndex[index];
+    m_Epoch[index] = elements.epoch;
+    m_DeepSpaceIndex[index] = kNearEarth;
+    m_InitialisationError[index] = Error::None;
+    for (std::vector<double>& term : m_Terms)
+    {
+        term[index] = 0.0;
+    }
+
+    if (ecco < 0.0 || ecco >= 1.0)
+    {
+        m_InitialisationError[index] = Error::Eccentricity;
+        return;
+    }
+    if (no <= 0.0)
+    {
+        m_InitialisationError[index] = Error::MeanMotion;
+        return;
+    }
+
+    // Below 220 km perigee the drag terms are truncated.
+    bool simplified = rp < (220.0 / kEarthRadius + 1.0);
+
+    // Atmospheric density parameters, adjusted for perigees below 156 km.
+    double sfour = 78.0 / kEarthRadius + 1.0;
+    double qzms24 = std::pow((120.0 - 78.0) / kEarthRadius, 4.0);
+    const double perigee = (rp - 1.0) * kEarthRadius;
+    if (perigee < 156.0)
+    {
+        sfour = perigee < 98.0 ? 20.0 : perigee - 78.0;
+        qzms24 = std::pow((120.0 - sfour) / kEarthRadius, 4.0);
+        sfour = sfour / kEarthRadius + 1.0;
+    }
+
+    const double pinvsq = 1.0 / posq;
+    const double tsi = 1.0 / (ao - sfour);
+    const double eta = ao * ecco * tsi;
+    const double etasq = eta * eta;
+    const double eeta = ecco * eta;
+    const double psisq = std::abs(1.0 - etasq);
+    const double coef = qzms24 * std::pow(tsi, 4.0);
+    const double coef1 = coef / std::pow(psisq, 3.5);
+    const double cc2 = coef1 * no * (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) + 0.375 * kJ2 * tsi / psisq * con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+    const double cc1 = bstar * cc2;
+    const double cc3 = ecco > 1.0e-4 ? -2.0 * coef * tsi * kJ3OverJ2 * no * sinio / ecco : 0.0;
+    const double x1mth2 = 1.0 - cosio2;
+    const double cc4 = 2.0 * no * coef1 * ao * omeosq * (eta * (2.0 + 0.5 * etasq) + ecco * (0.5 + 2.0 * etasq) - kJ2 * tsi / (ao * psisq) * (-3.0 * con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) + 0.75 * x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * std::cos(2.0 * argpo)));
+    const double cc5 = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    // Secular rates due to J2 and J4.
+    const double cosio4 = cosio2 * cosio2;
+    const double temp1 = 1.5 * kJ2 * pinvsq * no;
+    const double temp2 = 0.5 * temp1 * kJ2 * pinvsq;
+    const double temp3 = -0.46875 * kJ4 * pinvsq * pinvsq * no;
+    const double mdot = no + 0.5 * temp1 * rteosq * con41 + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+    const double argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) + temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+    const double xhdot1 = -temp1 * cosio;
+    const double nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+    const double xpidot = argpdot + nodedot;
+
+    // Guard against the division by zero at 180° inclination.
+    const double onePlusCosio = std::abs(cosio + 1.0) > 1.5e-12 ? 1.0 + cosio : 1.5e-12;
+    const double delmotemp = 1.0 + eta * std::cos(mo);
+
+    m_Terms[kMeanAnomalyAtEpoch][index] = mo;
+    m_Terms[kMeanAnomalyRate][index] = mdot;
+    m_Terms[kArgumentOfPerigeeAtEpoch][index] = argpo;
+    m_Terms[kArgumentOfPerigeeRate][index] = argpdot;
+    m_Terms[kNodeAtEpoch][index] = nodeo;
+    m_Terms[kNodeRate][index] = nodedot;
+    m_Terms[kNodeDragCoefficient][index] = 3.5 * omeosq * xhdot1 * cc1;
+    m_Terms[kMeanMotion][index] = no;
+    m_Terms[kEccentricity][index] = ecco;
+    m_Terms[kInclination][index] = inclo;
+    m_Terms[kBstar][index] = bstar;
+    m_Terms[kEta][index] = eta;
+    m_Terms[kCc1][index] = cc1;
+    m_Terms[kCc4][index] = cc4;
+    m_Terms[kCc5][index] = cc5;
+    m_Terms[kDelMo][index] = delmotemp * delmotemp * delmotemp;
+    m_Terms[kSinMAo][index] = std::sin(mo);
+    m_Terms[kOmgCof][index] = bstar * cc3 * std::cos(argpo);
+    m_Terms[kXmCof][index] = ecco > 1.0e-4 ? -kTwoThirds * coef * bstar / eeta : 0.0;
+    m_Terms[kT2Cof][index] = 1.5 * cc1;
+    m_Terms[kAyCof][index] = -0.5 * kJ3OverJ2 * sinio;
+    m_Terms[kXlCof][index] = -0.25 * kJ3OverJ2 * sinio * (3.0 + 5.0 * cosio) / onePlusCosio;
+    m_Terms[kCon41][index] = con41;
+    m_Terms[kX1mth2][index] = x1mth2;
+    m_Terms[kX7thm1][index] = 7.0 * cosio2 - 1.0;
+
+    if (kTwoPi / no >= 225.0)
+    {
+        simplified = true;
+        if (previousDeepSpaceIndex != kNearEarth)
+        {
+            m_DeepSpaceIndex[index] = previousDeepSpaceIndex;
+            m_DeepSpaceTerms[previousDeepSpaceIndex] = DeepSpaceTerms{};
+        }
+        else
+        {
+            m_DeepSpaceIndex[index] = static_cast<uint32_t>(m_DeepSpaceTerms.size());
+            m_DeepSpaceTerms.emplace_back();
+        }
+        DeepSpaceTerms& ds = m_DeepSpaceTerms[m_DeepSpaceIndex[index]];
+        ds.gsto = GetGreenwichSiderealTime(epoch + kJulianDate1950);
+
+        // Lunar and solar gravity terms, from the positions of the Sun and the Moon at epoch.
+        constexpr double c1ss = 2.9864797e-6;
+        constexpr double c1l = 4.7968065e-7;
+        constexpr double zsinis = 0.39785416;
+        constexpr double zcosis = 0.91744867;
+        constexpr double zcosgs = 0.1945905;
+        constexpr double zsings = -0.98088458;
+
+        const double snodm = std::sin(nodeo);
+        const double cnodm = std::cos(nodeo);
+        const double sinomm = std::sin(argpo);
+        const double cosomm = std::cos(argpo);
+        const double sinim = sinio;
+        const double cosim = cosio;
+        const double emsq = eccsq;
+        const double betasq = 1.0 - emsq;
+        const double rtemsq = std::sqrt(betasq);
+
+        const double day = epoch + 18261.5;
+        const double xnodce = std::fmod(4.5236020 - 9.2422029e-4 * day, kTwoPi);
+        const double stem = std::sin(xnodce);
+        const double ctem = std::cos(xnodce);
+        const double zcosil = 0.91375164 - 0.03568096 * ctem;
+        const double zsinil = std::sqrt(1.0 - zcosil * zcosil);
+        const double zsinhl = 0.089683511 * stem / zsinil;
+        const double zcoshl = std::sqrt(1.0 - zsinhl * zsinhl);
+        const double gam = 5.8351514 + 0.0019443680 * day;
+        const double zx = gam + std::atan2(0.39785416 * stem / zsinil, zcoshl * ctem + 0.91744867 * zsinhl * stem) - xnodce;
+        const double zcosgl = std::cos(zx);
+        const double zsingl = std::sin(zx);
+
+        // The first pass is for the Sun, the second for the Moon.
+        double zcosg = zcosgs;
+        double zsing = zsings;
+        double zcosi = zcosis;
+        double zsini = zsinis;
+        double zcosh = cnodm;
+        double zsinh = snodm;
+        double cc = c1ss;
+        const double xnoi = 1.0 / no;
+
+        double s1, s2, s3, s4, s5, s6, s7;
+        double z1, z2, z3, z11, z12, z13, z21, z22, z23, z31, z32, z33;
+        double ss1, ss2, ss3, ss4, ss5, ss6, ss7;
+        double sz1, sz2, sz3, sz11, sz12, sz13, sz21, sz22, sz23, sz31, sz32, sz33;
+        for (int body = 0; body < 2; ++body)
+        {
+            const double a1 = zcosg * zcosh + zsing * zcosi * zsinh;
+            const double a3 = -zsing * zcosh + zcosg * zcosi * zsinh;
+            const double a7 = -zcosg * zsinh + zsing * zcosi * zcosh;
+            const double a8 = zsing * zsini;
+            const double a9 = zsing * zsinh + zcosg * zcosi * zcosh;
+            const double a10 = zcosg * zsini;
+            const double a2 = cosim * a7 + sinim * a8;
+            const double a4 = cosim * a9 + sinim * a10;
+            const double a5 = -sinim * a7 + cosim * a8;
+            const double a6 = -sinim * a9 + cosim * a10;
+
+            const double x1 = a1 * cosomm + a2 * sinomm;
+            const double x2 = a3 * cosomm + a4 * sinomm;
+            const double x3 = -a1 * sinomm + a2 * cosomm;
+            const double x4 = -a3 * sinomm + a4 * cosomm;
+            const double x5 = a5 * sinomm;
+            const double x6 = a6 * sinomm;
+            const double x7 = a5 * cosomm;
+            const double x8 = a6 * cosomm;
+
+            z31 = 12.0 * x1 * x1 - 3.0 * x3 * x3;
+            z32 = 24.0 * x1 * x2 - 6.0 * x3 * x4;
+            z33 = 12.0 * x2 * x2 - 3.0 * x4 * x4;
+            z1 = 3.0 * (a1 * a1 + a2 * a2) + z31 * emsq;
+            z2 = 6.0 * (a1 * a3 + a2 * a4) + z32 * emsq;
+            z3 = 3.0 * (a3 * a3 + a4 * a4) + z33 * emsq;
+            z11 = -6.0 * a1 * a5 + emsq * (-24.0 * x1 * x7 - 6.0 * x3 * x5);
+            z12 = -6.0 * (a1 * a6 + a3 * a5) + emsq * (-24.0 * (x2 * x7 + x1 * x8) - 6.0 * (x3 * x6 + x4 * x5));
+            z13 = -6.0 * a3 * a6 + emsq * (-24.0 * x2 * x8 - 6.0 * x4 * x6);
+            z21 = 6.0 * a2 * a5 + emsq * (24.0 * x1 * x5 - 6.0 * x3 * x7);
+            z22 = 6.0 * (a4 * a5 + a2 * a6) + emsq * (24.0 * (x2 * x5 + x1 * x6) - 6.0 * (x4 * x7 + x3 * x8));
+            z23 = 6.0 * a4 * a6 + emsq * (24.0 * x2 * x6 - 6.0 * x4 * x8);
+            z1 = z1 + z1 + betasq * z31;
+            z2 = z2 + z2 + betasq * z32;
+            z3 = z3 + z3 + betasq * z33;
+            s3 = cc * xnoi;
+            s2 = -0.5 * s3 / rtemsq;
+            s4 = s3 * rtemsq;
+            s1 = -15.0 * ecco * s4;
+            s5 = x1 * x3 + x2 * x4;
+            s6 = x2 * x3 + x1 * x4;
+            s7 = x2 * x4 - x1 * x3;
+
+            if (body == 0)
+            {
+                ss1 = s1;
+                ss2 = s2;
+                ss3 = s3;
+                ss4 = s4;
+                ss5 = s5;
+                ss6 = s6;
+                ss7 = s7;
+                sz1 = z1;
+                sz2 = z2;
+                sz3 = z3;
+                sz11 = z11;
+                sz12 = z12;
+                sz13 = z13;
+                sz21 = z21;
+                sz22 = z22;
+                sz23 = z23;
+                sz31 = z31;
+                sz32 = z32;
+                sz33 = z33;
+                zcosg = zcosgl;
+                zsing = zsingl;
+                zcosi = zcosil;
+                zsini = zsinil;
+                zcosh = zcoshl * cnodm + zsinhl * snodm;
+                zsinh = snodm * zcoshl - cnodm * zsinhl;
+                cc = c1l;
+            }
+        }
+
+        ds.zmol = std::fmod(4.7199672 + 0.22997150 * day - gam, kTwoPi);
+        ds.zmos = std::fmod(6.2565837 + 0.017201977 * day, kTwoPi);
+
+        ds.se2 = 2.0 * ss1 * ss6;
+        ds.se3 = 2.0 * ss1 * ss7;
+        ds.si2 = 2.0 * ss2 * sz12;
+        ds.si3 = 2.0 * ss2 * (sz13 - sz11);
+        ds.sl2 = -2.0 * ss3 * sz2;
+        ds.sl3 = -2.0 * ss3 * (sz3 - sz1);
+        ds.sl4 = -2.0 * ss3 * (-21.0 - 9.0 * emsq) * kZes;
+        ds.sgh2 = 2.0 * ss4 * sz32;
+        ds.sgh3 = 2.0 * ss4 * (sz33 - sz31);
+        ds.sgh4 = -18.0 * ss4 * kZes;
+        ds.sh2 = -2.0 * ss2 * sz22;
+        ds.sh3 = -2.0 * ss2 * (sz23 - sz21);
+
+        ds.ee2 = 2.0 * s1 * s6;
+        ds.e3 = 2.0 * s1 * s7;
+        ds.xi2 = 2.0 * s2 * z12;
+        ds.xi3 = 2.0 * s2 * (z13 - z11);
+        ds.xl2 = -2.0 * s3 * z2;
+        ds.xl3 = -2.0 * s3 * (z3 - z1);
+        ds.xl4 = -2.0 * s3 * (-21.0 - 9.0 * emsq) * kZel;
+        ds.xgh2 = 2.0 * s4 * z32;
+        ds.xgh3 = 2.0 * s4 * (z33 - z31);
+        ds.xgh4 = -18.0 * s4 * kZel;
+        ds.xh2 = -2.0 * s2 * z22;
+        ds.xh3 = -2.0 * s2 * (z23 - z21);
+
+        // Secular lunar-solar rates.
+        const bool nearEquatorial = inclo < 5.2359877e-2 || inclo > kPi - 5.2359877e-2;
+        const double ses = ss1 * kZns * ss5;
+        const double sis = ss2 * kZns * (sz11 + sz13);
+        const double sls = -kZns * ss3 * (sz1 + sz3 - 14.0 - 6.0 * emsq);
+        const double sghs = ss4 * kZns * (sz31 + sz33 - 6.0);
+        double shs = nearEquatorial ? 0.0 : -kZns * ss2 * (sz21 + sz23);
+        if (sinim != 0.0)
+        {
+            shs = shs / sinim;
+        }
+        const double sgs = sghs - cosim * shs;
+
+        ds.dedt = ses + s1 * kZnl * s5;
+        ds.didt = sis + s2 * kZnl * (z11 + z13);
+        ds.dmdt = sls - kZnl * s3 * (z1 + z3 - 14.0 - 6.0 * emsq);
+        const double sghl = s4 * kZnl * (z31 + z33 - 6.0);
+        const double shll = nearEquatorial ? 0.0 : -kZnl * s2 * (z21 + z23);
+        ds.domdt = sgs + sghl;
+        ds.dnodt = shs;
+        if (sinim != 0.0)
+        {
+            ds.domdt = ds.domdt - cosim / sinim * shll;
+            ds.dnodt = ds.dnodt + shll / sinim;
+        }
+
+        // Geopotential resonance, for synchronous (~24h) and half-day (~12h, eccentric) orbits.
+        ds.irez = 0;
+        if (no < 0.0052359877 && no > 0.0034906585)
+        {
+            ds.irez = 1;
+        }
+        if (no >= 8.26e-3 && no <= 9.24e-3 && ecco >= 0.5)
+        {
+            ds.irez = 2;
+        }
+
+        const double theta = ds.gsto;
+        const double aonv = std::pow(no / kXke, kTwoThirds);
+        if (ds.irez == 2)
+        {
+            constexpr double root22 = 1.7891679e-6;
+            constexpr double root32 = 3.7393792e-7;
+            constexpr double root44 = 7.3636953e-9;
+            constexpr double root52 = 1.1428639e-7;
+            constexpr double root54 = 2.1765803e-9;
+
+            const double cosisq = cosim * cosim;
+            const double em = ecco;
+            const double eoc = em * emsq;
+            const double g201 = -0.306 - (em - 0.64) * 0.440;
+            double g211, g310, g322, g410, g422, g520, g521, g532, g533;
+            if (em <= 0.65)
+            {
+                g211 = 3.616 - 13.2470 * em + 16.2900 * emsq;
+                g310 = -19.302 + 117.3900 * em - 228.4190 * emsq + 156.5910 * eoc;
+                g322 = -18.9068 + 109.7927 * em - 214.6334 * emsq + 146.5816 * eoc;
+                g410 = -41.122 + 242.6940 * em - 471.0940 * emsq + 313.9530 * eoc;
+                g422 = -146.407 + 841.8800 * em - 1629.014 * emsq + 1083.4350 * eoc;
+                g520 = -532.114 + 3017.977 * em - 5740.032 * emsq + 3708.2760 * eoc;
+            }
+            else
+            {
+                g211 = -72.099 + 331.819 * em - 508.738 * emsq + 266.724 * eoc;
+                g310 = -346.844 + 1582.851 * em - 2415.925 * emsq + 1246.113 * eoc;
+                g322 = -342.585 + 1554.908 * em - 2366.899 * emsq + 1215.972 * eoc;
+                g410 = -1052.797 + 4758.686 * em - 7193.992 * emsq + 3651.957 * eoc;
+                g422 = -3581.690 + 16178.110 * em - 24462.770 * emsq + 12422.520 * eoc;
+                g520 = em > 0.715 ? -5149.66 + 29936.92 * em - 54087.36 * emsq + 31324.56 * eoc : 1464.74 - 4664.75 * em + 3763.64 * emsq;
+            }
+            if (em < 0.7)
+            {
+                g533 = -919.22770 + 4988.6100 * em - 9064.7700 * emsq + 5542.21 * eoc;
+                g521 = -822.71072 + 4568.6173 * em - 8491.4146 * emsq + 5337.524 * eoc;
+                g532 = -853.66600 + 4690.2500 * em - 8624.7700 * emsq + 5341.4 * eoc;
+            }
+            else
+            {
+                g533 = -37995.780 + 161616.52 * em - 229838.20 * emsq + 109377.94 * eoc;
+                g521 = -51752.104 + 218913.95 * em - 309468.16 * emsq + 146349.42 * eoc;
+                g532 = -40023.880 + 170470.89 * em - 242699.48 * emsq + 115605.82 * eoc;
+            }
+
+            const double sini2 = sinim * sinim;
+            const double f220 = 0.75 * (1.0 + 2.0 * cosim + cosisq);
+            const double f221 = 1.5 * sini2;
+            const double f321 = 1.875 * sinim * (1.0 - 2.0 * cosim - 3.0 * cosisq);
+            const double f322 = -1.875 * sinim * (1.0 + 2.0 * cosim - 3.0 * cosisq);
+            const double f441 = 35.0 * sini2 * f220;
+            const double f442 = 39.3750 * sini2 * sini2;
+            const double f522 = 9.84375 * sinim * (sini2 * (1.0 - 2.0 * cosim - 5.0 * cosisq) + 0.33333333 * (-2.0 + 4.0 * cosim + 6.0 * cosisq));
+            const double f523 = sinim * (4.92187512 * sini2 * (-2.0 - 4.0 * cosim + 10.0 * cosisq) + 6.56250012 * (1.0 + 2.0 * cosim - 3.0 * cosisq));
+            const double f542 = 29.53125 * sinim * (2.0 - 8.0 * cosim + cosisq * (-12.0 + 8.0 * cosim + 10.0 * cosisq));
+            const double f543 = 29.53125 * sinim * (-2.0 - 8.0 * cosim + cosisq * (12.0 + 8.0 * cosim - 10.0 * cosisq));
+
+            double scale = 3.0 * no * no * aonv * aonv;
+            ds.d2201 = scale * root22 * f220 * g201;
+            ds.d2211 = scale * root22 * f221 * g211;
+            scale *= aonv;
+            ds.d3210 = scale * root32 * f321 * g310;
+            ds.d3222 = scale * root32 * f322 * g322;
+            scale *= aonv;
+            ds.d4410 = 2.0 * scale * root44 * f441 * g410;
+            ds.d4422 = 2.0 * scale * root44 * f442 * g422;
+            scale *= aonv;
+            ds.d5220 = scale * root52 * f522 * g520;
+            ds.d5232 = scale * root52 * f523 * g532;
+            ds.d5421 = 2.0 * scale * root54 * f542 * g521;
+            ds.d5433 = 2.0 * scale * root54 * f543 * g533;
+            ds.xlamo = std::fmod(mo + nodeo + nodeo - theta - theta, kTwoPi);
+            ds.xfact = mdot + ds.dmdt + 2.0 * (nodedot + ds.dnodt - kRptim) - no;
+        }
+        else if (ds.irez == 1)
+        {
+            constexpr double q22 = 1.7891679e-6;
+            constexpr double q31 = 2.1460748e-6;
+            constexpr double q33 = 2.2123015e-7;
+
+            const double g200 = 1.0 + emsq * (-2.5 + 0.8125 * emsq);
+            const double g310 = 1.0 + 2.0 * emsq;
+            const double g300 = 1.0 + emsq * (-6.0 + 6.60937 * emsq);
+            const double f220 = 0.75 * (1.0 + cosim) * (1.0 + cosim);
+            const double f311 = 0.9375 * sinim * sinim * (1.0 + 3.0 * cosim) - 0.75 * (1.0 + cosim);
+            const double f330 = 1.875 * (1.0 + cosim) * (1.0 + cosim) * (1.0 + cosim);
+            const double del1 = 3.0 * no * no * aonv * aonv;
+            ds.del2 = 2.0 * del1 * f220 * g200 * q22;
+            ds.del3 = 3.0 * del1 * f330 * g300 * q33 * aonv;
+            ds.del1 = del1 * f311 * g310 * q31 * aonv;
+            ds.xlamo = std::fmod(mo + nodeo + argpo - theta, kTwoPi);
+            ds.xfact = mdot + xpidot - kRptim + ds.dmdt + ds.domdt + ds.dnodt - no;
+        }
+    }
+
+    m_Simplified[index] = simplified ? 1 : 0;
+    if (!simplified)
+    {
+        const double cc1sq = cc1 * cc1;
+        const double d2 = 4.0 * ao * tsi * cc1sq;
+        const double temp = d2 * tsi * cc1 / 3.0;
+        const double d3 = (17.0 * ao + sfour) * temp;
+        const double d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * cc1;
+        m_Terms[kD2][index] = d2;
+        m_Terms[kD3][index] = d3;
+        m_Terms[kD4][index] = d4;
+        m_Terms[kT3Cof][index] = d2 + 2.0 * cc1sq;
+        m_Terms[kT4Cof][index] = 0.25 * (3.0 * d3 + cc1 * (12.0 * d2 + 10.0 * cc1sq));
+        m_Terms[kT5Cof][index] = 0.2 * (3.0 * d4 + 12.0 * cc1 * d3 + 6.0 * d2 * d2 + 15.0 * cc1sq * (2.0 * d2 + cc1sq));
+    }
+}
+
+void Sgp4::Clear()
+{
+    m_Epoch.clear();
+    for (std::vector<double>& term : m_Terms)
+    {
+        term.clear();
+    }
+    m_Simplified.clear();
+    m_DeepSpaceIndex.clear();
+    m_InitialisationError.clear();
+    m_DeepSpaceTerms.clear();
+}
+
+Sgp4::Error Sgp4::Propagate(size_t index, double time, glm::dvec3& position, glm::dvec3& velocity) const
+{
+    if (m_InitialisationError[index] != Error::None)
+    {
+        return m_InitialisationError[index];
+    }
+
+    const double t = (time - m_Epoch[index]) / 60.0; // Minutes since epoch
+    const double no = m_Terms[kMeanMotion][index];
+    const double bstar = m_Terms[kBstar][index];
+    const double cc1 = m_Terms[kCc1][index];
+
+    // Secular gravity and atmospheric drag.
+    const double xmdf = m_Terms[kMeanAnomalyAtEpoch][index] + m_Terms[kMeanAnomalyRate][index] * t;
+    const double argpdf = m_Terms[kArgumentOfPerigeeAtEpoch][index] + m_Terms[kArgumentOfPerigeeRate][index] * t;
+    const double nodedf = m_Terms[kNodeAtEpoch][index] + m_Terms[kNodeRate][index] * t;
+    const double t2 = t * t;
+    double argpm = argpdf;
+    double mm = xmdf;
+    double nodem = nodedf + m_Terms[kNodeDragCoefficient][index] * t2;
+    double tempa = 1.0 - cc1 * t;
+    double tempe = bstar * m_Terms[kCc4][index] * t;
+    double templ = m_Terms[kT2Cof][index] * t2;
+
+    if (!m_Simplified[index])
+    {
+        const double delomg = m_Terms[kOmgCof][index] * t;
+        const double delmtemp = 1.0 + m_Terms[kEta][index] * std::cos(xmdf);
+        const double delm = m_Terms[kXmCof][index] * (delmtemp * delmtemp * delmtemp - m_Terms[kDelMo][index]);
+        const double temp = delomg + delm;
+        mm = xmdf + temp;
+        argpm = argpdf - temp;
+        const double t3 = t2 * t;
+        const double t4 = t3 * t;
+        tempa = tempa - m_Terms[kD2][index] * t2 - m_Terms[kD3][index] * t3 - m_Terms[kD4][index] * t4;
+        tempe = tempe + bstar * m_Terms[kCc5][index] * (std::sin(mm) - m_Terms[kSinMAo][index]);
+        templ = templ + m_Terms[kT3Cof][index] * t3 + t4 * (m_Terms[kT4Cof][index] + t * m_Terms[kT5Cof][index]);
+    }
+
+    double nm = no;
+    double em = m_Terms[kEccentricity][index];
+    double inclm = m_Terms[kInclination][index];
+    const DeepSpaceTerms* pDeepSpace = m_DeepSpaceIndex[index] != kNearEarth ? &m_DeepSpaceTerms[m_DeepSpaceIndex[index]] : nullptr;
+    if (pDeepSpace)
+    {
+        const DeepSpaceTerms& ds = *pDeepSpace;
+
+        // Secular lunar-solar effects.
+        em += ds.dedt * t;
+        inclm += ds.didt * t;
+        argpm += ds.domdt * t;
+        nodem += ds.dnodt * t;
+        mm += ds.dmdt * t;
+
+        if (ds.irez != 0)
+        {
+            // Resonance effects are integrated numerically in 720 minute steps. The integration always
+            // restarts from epoch so propagation doesn't depend on previous calls.
+            constexpr double fasx2 = 0.13130908;
+            constexpr double fasx4 = 2.8843198;
+            constexpr double fasx6 = 0.37448087;
+            constexpr double g22 = 5.7686396;
+            constexpr double g32 = 0.95240898;
+            constexpr double g44 = 1.8014998;
+            constexpr double g52 = 1.0508330;
+            constexpr double g54 = 4.4108898;
+            constexpr double stepp = 720.0;
+            constexpr double step2 = 259200.0;
+
+            const double theta = std::fmod(ds.gsto + t * kRptim, kTwoPi);
+            const double delt = t > 0.0 ? stepp : -stepp;
+            const double argpo = m_Terms[kArgumentOfPerigeeAtEpoch][index];
+            const double argpdot = m_Terms[kArgumentOfPerigeeRate][index];
+            double atime = 0.0;
+            double xni = no;
+            double xli = ds.xlamo;
+            double xndt, xldot, xnddt;
+            while (true)
+            {
+                if (ds.irez != 2)
+                {
+                    xndt = ds.del1 * std::sin(xli - fasx2) + ds.del2 * std::sin(2.0 * (xli - fasx4)) + ds.del3 * std::sin(3.0 * (xli - fasx6));
+                    xldot = xni + ds.xfact;
+                    xnddt = ds.del1 * std::cos(xli - fasx2) + 2.0 * ds.del2 * std::cos(2.0 * (xli - fasx4)) + 3.0 * ds.del3 * std::cos(3.0 * (xli - fasx6));
+                    xnddt *= xldot;
+                }
+                else
+                {
+                    const double xomi = argpo + argpdot * atime;
+                    const double x2omi = xomi + xomi;
+                    const double x2li = xli + xli;
+                    xndt = ds.d2201 * std::sin(x2omi + xli - g22) + ds.d2211 * std::sin(xli - g22) + ds.d3210 * std::sin(xomi + xli - g32) + ds.d3222 * std::sin(-xomi + xli - g32) + ds.d4410 * std::sin(x2omi + x2li - g44) + ds.d4422 * std::sin(x2li - g44) + ds.d5220 * std::sin(xomi + xli - g52) + ds.d5232 * std::sin(-xomi + xli - g52) + ds.d5421 * std::sin(xomi + x2li - g54) + ds.d5433 * std::sin(-xomi + x2li - g54);
+                    xldot = xni + ds.xfact;
+                    xnddt = ds.d2201 * std::cos(x2omi + xli - g22) + ds.d2211 * std::cos(xli - g22) + ds.d3210 * std::cos(xomi + xli - g32) + ds.d3222 * std::cos(-xomi + xli - g32) + ds.d5220 * std::cos(xomi + xli - g52) + ds.d5232 * std::cos(-xomi + xli - g52) + 2.0 * (ds.d4410 * std::cos(x2omi + x2li - g44) + ds.d4422 * std::cos(x2li - g44) + ds.d5421 * std::cos(xomi + x2li - g54) + ds.d5433 * std::cos(-xomi + x2li - g54));
+                    xnddt *= xldot;
+                }
+
+                if (std::abs(t - atime) < stepp)
+                {
+                    break;
+                }
+
+                xli += xldot * delt + xndt * step2;
+                xni += xndt * delt + xnddt * step2;
+                atime += delt;
+            }
+
+            const double ft = t - atime;
+            nm = xni + xndt * ft + xnddt * ft * ft * 0.5;
+            const double xl = xli + xldot * ft + xndt * ft * ft * 0.5;
+            if (ds.irez != 1)
+            {
+                mm = xl - 2.0 * nodem + 2.0 * theta;
+            }
+            else
+            {
+                mm = xl - nodem - argpm + theta;
+            }
+        }
+    }
+
+    if (nm <= 0.0)
+    {
+        return Error::MeanMotion;
+    }
+
+    const double am = std::pow(kXke / nm, kTwoThirds) * tempa * tempa;
+    nm = kXke / std::pow(am, 1.5);
+    em -= tempe;
+    if (em >= 1.0 || em < -0.001)
+    {
+        return Error::Eccentricity;
+    }
+    em = std::max(em, 1.0e-6);
+
+    mm += no * templ;
+    double xlm = mm + argpm + nodem;
+    nodem = std::fmod(nodem, kTwoPi);
+    argpm = std::fmod(argpm, kTwoPi);
+    xlm = std::fmod(xlm, kTwoPi);
+    mm = std::fmod(xlm - argpm - nodem, kTwoPi);
+
+    double ep = em;
+    double xincp = inclm;
+    double argpp = argpm;
+    double nodep = nodem;
+    double mp = mm;
+    double sinip = std::sin(inclm);
+    double cosip = std::cos(inclm);
+    double aycof = m_Terms[kAyCof][index];
+    double xlcof = m_Terms[kXlCof][index];
+    double con41 = m_Terms[kCon41][index];
+    double x1mth2 = m_Terms[kX1mth2][index];
+    double x7thm1 = m_Terms[kX7thm1][index];
+
+    if (pDeepSpace)
+    {
+        // Lunar-solar periodics.
+        const DeepSpaceTerms& ds = *pDeepSpace;
+        double zm = ds.zmos + kZns * t;
+        double zf = zm + 2.0 * kZes * std::sin(zm);
+        double sinzf = std::sin(zf);
+        double f2 = 0.5 * sinzf * sinzf - 0.25;
+        double f3 = -0.5 * sinzf * std::cos(zf);
+        const double ses = ds.se2 * f2 + ds.se3 * f3;
+        const double sis = ds.si2 * f2 + ds.si3 * f3;
+        const double sls = ds.sl2 * f2 + ds.sl3 * f3 + ds.sl4 * sinzf;
+        const double sghs = ds.sgh2 * f2 + ds.sgh3 * f3 + ds.sgh4 * sinzf;
+        const double shs = ds.sh2 * f2 + ds.sh3 * f3;
+
+        zm = ds.zmol + kZnl * t;
+        zf = zm + 2.0 * kZel * std::sin(zm);
+        sinzf = std::sin(zf);
+        f2 = 0.5 * sinzf * sinzf - 0.25;
+        f3 = -0.5 * sinzf * std::cos(zf);
+        const double sel = ds.ee2 * f2 + ds.e3 * f3;
+        const double sil = ds.xi2 * f2 + ds.xi3 * f3;
+        const double sll = ds.xl2 * f2 + ds.xl3 * f3 + ds.xl4 * sinzf;
+        const double sghl = ds.xgh2 * f2 + ds.xgh3 * f3 + ds.xgh4 * sinzf;
+        const double shll = ds.xh2 * f2 + ds.xh3 * f3;
+
+        const double pe = ses + sel;
+        const double pinc = sis + sil;
+        const double pl = sls + sll;
+        double pgh = sghs + sghl;
+        double ph = shs + shll;
+
+        xincp += pinc;
+        ep += pe;
+        sinip = std::sin(xincp);
+        cosip = std::cos(xincp);
+
+        if (xincp >= 0.2)
+        {
+            ph = ph / sinip;
+            pgh = pgh - cosip * ph;
+            argpp += pgh;
+            nodep += ph;
+            mp += pl;
+        }
+        else
+        {
+            // Lyddane's modification, avoiding the singularity at low inclinations.
+            const double sinop = std::sin(nodep);
+            const double cosop = std::cos(nodep);
+            const double alfdp = sinip * sinop + ph * cosop + pinc * cosip * sinop;
+            const double betdp = sinip * cosop - ph * sinop + pinc * cosip * cosop;
+            nodep = std::fmod(nodep, kTwoPi);
+            const double xls = mp + argpp + cosip * nodep + pl + pgh - pinc * nodep * sinip;
+            const double xnoh = nodep;
+            nodep = std::atan2(alfdp, betdp);
+            if (std::abs(xnoh - nodep) > kPi)
+            {
+                nodep += nodep < xnoh ? kTwoPi : -kTwoPi;
+            }
+            mp += pl;
+            argpp = xls - mp - cosip * nodep;
+        }
+
+        if (xincp < 0.0)
+        {
+            xincp = -xincp;
+            nodep += kPi;
+            argpp -= kPi;
+        }
+        if (ep < 0.0 || ep > 1.0)
+        {
+            return Error::PerturbedEccentricity;
+        }
+
+        // The long and short period terms depend on the perturbed inclination.
+        sinip = std::sin(xincp);
+        cosip = std::cos(xincp);
+        aycof = -0.5 * kJ3OverJ2 * sinip;
+        xlcof = -0.25 * kJ3OverJ2 * sinip * (3.0 + 5.0 * cosip) / (std::abs(cosip + 1.0) > 1.5e-12 ? 1.0 + cosip : 1.5e-12);
+        const double cosisq = cosip * cosip;
+        con41 = 3.0 * cosisq - 1.0;
+        x1mth2 = 1.0 - cosisq;
+        x7thm1 = 7.0 * cosisq - 1.0;
+    }
+
+    // Long period periodics.
+    const double axnl = ep * std::cos(argpp);
+    double temp = 1.0 / (am * (1.0 - ep * ep));
+    const double aynl = ep * std::sin(argpp) + temp * aycof;
+    const double xl = mp + argpp + nodep + temp * xlcof * axnl;
+
+    // Kepler's equation, in terms of the eccentricity vector components.
+    const double u = std::fmod(xl - nodep, kTwoPi);
+    double eo1 = u;
+    double sineo1 = 0.0;
+    double coseo1 = 0.0;
+    double tem5 = 9999.9;
+    for (int iteration = 0; iteration < 10 && std::abs(tem5) >= 1.0e-12; ++iteration)
+    {
+        sineo1 = std::sin(eo1);
+        coseo1 = std::cos(eo1);
+        tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / (1.0 - coseo1 * axnl - sineo1 * aynl);
+        tem5 = std::clamp(tem5, -0.95, 0.95);
+        eo1 += tem5;
+    }
+
+    // Short period periodics.
+    const double ecose = axnl * coseo1 + aynl * sineo1;
+    const double esine = axnl * sineo1 - aynl * coseo1;
+    const double el2 = axnl * axnl + aynl * aynl;
+    const double pl = am * (1.0 - el2);
+    if (pl < 0.0)
+    {
+        return Error::SemiLatusRectum;
+    }
+
+    const double rl = am * (1.0 - ecose);
+    const double rdotl = std::sqrt(am) * esine / rl;
+    const double rvdotl = std::sqrt(pl) / rl;
+    const double betal = std::sqrt(1.0 - el2);
+    temp = esine / (1.0 + betal);
+    const double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+    const double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+    double su = std::atan2(sinu, cosu);
+    const double sin2u = (cosu + cosu) * sinu;
+    const double cos2u = 1.0 - 2.0 * sinu * sinu;
+    temp = 1.0 / pl;
+    const double temp1 = 0.5 * kJ2 * temp;
+    const double temp2 = temp1 * temp;
+
+    const double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41) + 0.5 * temp1 * x1mth2 * cos2u;
+    su = su - 0.25 * temp2 * x7thm1 * sin2u;
+    const double xnode = nodep + 1.5 * temp2 * cosip * sin2u;
+    const double xinc = xincp + 1.5 * temp2 * cosip * sinip * cos2u;
+    const double mvt = rdotl - nm * temp1 * x1mth2 * sin2u / kXke;
+    const double rvdot = rvdotl + nm * temp1 * (x1mth2 * cos2u + 1.5 * con41) / kXke;
+
+    // Orientation vectors.
+    const double sinsu = std::sin(su);
+    const double cossu = std::cos(su);
+    const double snod = std::sin(xnode);
+    const double cnod = std::cos(xnode);
+    const double sini = std::sin(xinc);
+    const double cosi = std::cos(xinc);
+    const double xmx = -snod * cosi;
+    const double xmy = cnod * cosi;
+    const glm::dvec3 uv(xmx * sinsu + cnod * cossu, xmy * sinsu + snod * cossu, sini * sinsu);
+    const glm::dvec3 vv(xmx * cossu - cnod * sinsu, xmy * cossu - snod * sinsu, sini * cossu);
+
+    position = mrt * uv * kEarthRadius;
+    velocity = (mvt * uv + rvdot * vv) * kVelocityScale;
+
+    return mrt < 1.0 ? Error::Decayed : Error::None;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+
+// Mean elements in the form SGP4 expects them, in double precision.
+struct Sgp4Elements
+{
+    double epoch{ 0.0 }; // Seconds since the Unix epoch
+    double meanMotion{ 0.0 }; // rev/day (Kozai)
+    double eccentricity{ 0.0 };
+    double inclination{ 0.0 }; // deg
+    double rightAscensionOfAscendingNode{ 0.0 }; // deg
+    double argumentOfPericenter{ 0.0 }; // deg
+    double meanAnomaly{ 0.0 }; // deg
+    double bstar{ 0.0 }; // 1/earth radii
+
+    static Sgp4Elements FromSpaceObject(const SpaceObject& spaceObject);
+};
+
+// SGP4 / SDP4 propagator for a batch of element sets, following Vallado's revision of the Spacetrack
+// Report #3 formulation (WGS-72 constants, "improved" operation mode), so its results can be checked
+// against the standard verification vectors. Output is in the TEME frame.
+// Everything which only depends on the element set is computed once in Add() / Set(), and stored as
+// structure-of-arrays. Objects with periods of 225 minutes or more additionally carry the lunar-solar and
+// resonance terms of the deep-space (SDP4) model, which are kept apart as only a minority of objects need them.
+// Propagation is stateless, so any number of threads can propagate from the same store at once.
+class Sgp4
+{
+public:
+    enum class Error : uint8_t
+    {
+        None,
+        Eccentricity, // Mean eccentricity out of range
+        MeanMotion, // Mean motion went negative
+        PerturbedEccentricity, // Eccentricity out of range after lunar-solar periodics
+        SemiLatusRectum, // Semi-latus rectum went negative
+        Decayed // Satellite has decayed
+    };
+
+    Sgp4();
+    ~Sgp4();
+
+    size_t Add(const Sgp4Elements& elements);
+    void Set(size_t index, const Sgp4Elements& elements);
+    void Clear();
+    size_t GetCount() const { return m_Epoch.size(); }
+
+    // Propagates a slot to the given time (seconds since the Unix epoch), giving its TEME position (km) and velocity (km/s).
+    Error Propagate(size_t index, double time, glm::dvec3& position, glm::dvec3& velocity) const;
+
+    // Returns the error encountered while initialising the slot, if any. Slots which failed to initialise
+    // can't be propagated.
+    Error GetInitialisationError(size_t index) const { return m_InitialisationError[index]; }
+
+private:
+    // Near-Earth constants, one array per term.
+    enum Term : size_t
+    {
+        kMeanAnomalyAtEpoch,
+        kMeanAnomalyRate,
+        kArgumentOfPerigeeAtEpoch,
+        kArgumentOfPerigeeRate,
+        kNodeAtEpoch,
+        kNodeRate,
+        kNodeDragCoefficient,
+        kMeanMotion, // Un-Kozai'd (rad/min)
+        kEccentricity,
+        kInclination,
+        kBstar,
+        kEta,
+        kCc1,
+        kCc4,
+        kCc5,
+        kD2,
+        kD3,
+        kD4,
+        kDelMo,
+        kSinMAo,
+        kOmgCof,
+        kXmCof,
+        kT2Cof,
+        kT3Cof,
+        kT4Cof,
+        kT5Cof,
+        kAyCof,
+        kXlCof,
+        kCon41,
+        kX1mth2,
+        kX7thm1,
+        kTermCount
+    };
+
+    // Lunar-solar periodics and resonance terms of the deep-space model.
+    struct DeepSpaceTerms
+    {
+        double gsto;
+        double zmol, zmos;
+        double e3, ee2, se2, se3;
+        double sgh2, sgh3, sgh4, sh2, sh3;
+        double si2, si3, sl2, sl3, sl4;
+        double xgh2, xgh3, xgh4, xh2, xh3;
+        double xi2, xi3, xl2, xl3, xl4;
+        double dedt, didt, dmdt, dnodt, domdt;
+        int irez;
+        double d2201, d2211, d3210, d3222, d4410, d4422, d5220, d5232, d5421, d5433;
+        double del1, del2, del3;
+        double xfact, xlamo;
+    };
+
+    static constexpr uint32_t kNearEarth = ~0u;
+
+    std::vector<double> m_Epoch; // Seconds since the Unix epoch
+    std::array<std::vector<double>, kTermCount> m_Terms;
+    std::vector<uint8_t> m_Simplified; // Perigee below 220 km, so the higher order drag terms are dropped
+    std::vector<uint32_t> m_DeepSpaceIndex; // Index into m_DeepSpaceTerms, or kNearEarth
+    std::vector<Error> m_InitialisationError;
+    std::vector<DeepSpaceTerms> m_DeepSpaceTerms;
+};
+
+} // namespace WingsOfSteel
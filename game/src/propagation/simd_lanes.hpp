@@ -0,0 +1,377 @@
+#pragma once
+
+// Thin wrappers over the SIMD registers available to the translation unit being compiled, exposing just
+// the operations needed by the batch propagation kernels. F64Lanes / F32Lanes map to the widest double and
+// float registers enabled by the compiler flags of the including TU (AVX-512, AVX2, SSE2, NEON, WebAssembly
+// SIMD), falling back to a single scalar lane.
+//
+// Everything lives in an unnamed namespace on purpose: the same kernel templates are compiled into several
+// TUs with different instruction set flags, and internal linkage guarantees that the linker never merges an
+// AVX2 instantiation into the baseline code path.
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace WingsOfSteel
+{
+namespace
+{
+
+#if defined(__AVX512F__)
+
+constexpr const char* kSimdInstructionSet = "AVX-512";
+
+struct F64Mask { __mmask8 m; };
+struct F64Lanes
+{
+    using Scalar = double;
+    using Mask = F64Mask;
+    static constexpr size_t kWidth = 8;
+    static F64Lanes Load(const double* p) { return { _mm512_loadu_pd(p) }; }
+    static F64Lanes Broadcast(double s) { return { _mm512_set1_pd(s) }; }
+    void Store(double* p) const { _mm512_storeu_pd(p, v); }
+    __m512d v;
+};
+inline F64Lanes operator+(F64Lanes a, F64Lanes b) { return { _mm512_add_pd(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a, F64Lanes b) { return { _mm512_sub_pd(a.v, b.v) }; }
+inline F64Lanes operator*(F64Lanes a, F64Lanes b) { return { _mm512_mul_pd(a.v, b.v) }; }
+inline F64Lanes operator/(F64Lanes a, F64Lanes b) { return { _mm512_div_pd(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a) { return { _mm512_sub_pd(_mm512_setzero_pd(), a.v) }; }
+inline F64Mask operator<(F64Lanes a, F64Lanes b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline F64Mask operator>(F64Lanes a, F64Lanes b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline F64Mask operator>=(F64Lanes a, F64Lanes b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ) }; }
+inline F64Mask operator==(F64Lanes a, F64Lanes b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ) }; }
+inline F64Mask operator|(F64Mask a, F64Mask b) { return { static_cast<__mmask8>(a.m | b.m) }; }
+inline F64Lanes Select(F64Mask mask, F64Lanes a, F64Lanes b) { return { _mm512_mask_blend_pd(mask.m, b.v, a.v) }; }
+inline F64Lanes Abs(F64Lanes a) { return { _mm512_abs_pd(a.v) }; }
+inline F64Lanes Round(F64Lanes a) { return { _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+struct F32Mask { __mmask16 m; };
+struct F32Lanes
+{
+    using Scalar = float;
+    using Mask = F32Mask;
+    static constexpr size_t kWidth = 16;
+    static F32Lanes Load(const float* p) { return { _mm512_loadu_ps(p) }; }
+    static F32Lanes Broadcast(float s) { return { _mm512_set1_ps(s) }; }
+    void Store(float* p) const { _mm512_storeu_ps(p, v); }
+    __m512 v;
+};
+inline F32Lanes operator+(F32Lanes a, F32Lanes b) { return { _mm512_add_ps(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a, F32Lanes b) { return { _mm512_sub_ps(a.v, b.v) }; }
+inline F32Lanes operator*(F32Lanes a, F32Lanes b) { return { _mm512_mul_ps(a.v, b.v) }; }
+inline F32Lanes operator/(F32Lanes a, F32Lanes b) { return { _mm512_div_ps(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a) { return { _mm512_sub_ps(_mm512_setzero_ps(), a.v) }; }
+inline F32Mask operator<(F32Lanes a, F32Lanes b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline F32Mask operator>(F32Lanes a, F32Lanes b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline F32Mask operator>=(F32Lanes a, F32Lanes b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ) }; }
+inline F32Mask operator==(F32Lanes a, F32Lanes b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ) }; }
+inline F32Mask operator|(F32Mask a, F32Mask b) { return { static_cast<__mmask16>(a.m | b.m) }; }
+inline F32Lanes Select(F32Mask mask, F32Lanes a, F32Lanes b) { return { _mm512_mask_blend_ps(mask.m, b.v, a.v) }; }
+inline F32Lanes Abs(F32Lanes a) { return { _mm512_abs_ps(a.v) }; }
+inline F32Lanes Round(F32Lanes a) { return { _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+#elif defined(__AVX2__)
+
+constexpr const char* kSimdInstructionSet = "AVX2";
+
+struct F64Mask { __m256d m; };
+struct F64Lanes
+{
+    using Scalar = double;
+    using Mask = F64Mask;
+    static constexpr size_t kWidth = 4;
+    static F64Lanes Load(const double* p) { return { _mm256_loadu_pd(p) }; }
+    static F64Lanes Broadcast(double s) { return { _mm256_set1_pd(s) }; }
+    void Store(double* p) const { _mm256_storeu_pd(p, v); }
+    __m256d v;
+};
+inline F64Lanes operator+(F64Lanes a, F64Lanes b) { return { _mm256_add_pd(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a, F64Lanes b) { return { _mm256_sub_pd(a.v, b.v) }; }
+inline F64Lanes operator*(F64Lanes a, F64Lanes b) { return { _mm256_mul_pd(a.v, b.v) }; }
+inline F64Lanes operator/(F64Lanes a, F64Lanes b) { return { _mm256_div_pd(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a) { return { _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)) }; }
+inline F64Mask operator<(F64Lanes a, F64Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+inline F64Mask operator>(F64Lanes a, F64Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+inline F64Mask operator>=(F64Lanes a, F64Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ) }; }
+inline F64Mask operator==(F64Lanes a, F64Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ) }; }
+inline F64Mask operator|(F64Mask a, F64Mask b) { return { _mm256_or_pd(a.m, b.m) }; }
+inline F64Lanes Select(F64Mask mask, F64Lanes a, F64Lanes b) { return { _mm256_blendv_pd(b.v, a.v, mask.m) }; }
+inline F64Lanes Abs(F64Lanes a) { return { _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v) }; }
+inline F64Lanes Round(F64Lanes a) { return { _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+struct F32Mask { __m256 m; };
+struct F32Lanes
+{
+    using Scalar = float;
+    using Mask = F32Mask;
+    static constexpr size_t kWidth = 8;
+    static F32Lanes Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+    static F32Lanes Broadcast(float s) { return { _mm256_set1_ps(s) }; }
+    void Store(float* p) const { _mm256_storeu_ps(p, v); }
+    __m256 v;
+};
+inline F32Lanes operator+(F32Lanes a, F32Lanes b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a, F32Lanes b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline F32Lanes operator*(F32Lanes a, F32Lanes b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline F32Lanes operator/(F32Lanes a, F32Lanes b) { return { _mm256_div_ps(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a) { return { _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)) }; }
+inline F32Mask operator<(F32Lanes a, F32Lanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline F32Mask operator>(F32Lanes a, F32Lanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline F32Mask operator>=(F32Lanes a, F32Lanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+inline F32Mask operator==(F32Lanes a, F32Lanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+inline F32Mask operator|(F32Mask a, F32Mask b) { return { _mm256_or_ps(a.m, b.m) }; }
+inline F32Lanes Select(F32Mask mask, F32Lanes a, F32Lanes b) { return { _mm256_blendv_ps(b.v, a.v, mask.m) }; }
+inline F32Lanes Abs(F32Lanes a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+inline F32Lanes Round(F32Lanes a) { return { _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+constexpr const char* kSimdInstructionSet = "SSE2";
+
+struct F64Mask { __m128d m; };
+struct F64Lanes
+{
+    using Scalar = double;
+    using Mask = F64Mask;
+    static constexpr size_t kWidth = 2;
+    static F64Lanes Load(const double* p) { return { _mm_loadu_pd(p) }; }
+    static F64Lanes Broadcast(double s) { return { _mm_set1_pd(s) }; }
+    void Store(double* p) const { _mm_storeu_pd(p, v); }
+    __m128d v;
+};
+inline F64Lanes operator+(F64Lanes a, F64Lanes b) { return { _mm_add_pd(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a, F64Lanes b) { return { _mm_sub_pd(a.v, b.v) }; }
+inline F64Lanes operator*(F64Lanes a, F64Lanes b) { return { _mm_mul_pd(a.v, b.v) }; }
+inline F64Lanes operator/(F64Lanes a, F64Lanes b) { return { _mm_div_pd(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a) { return { _mm_xor_pd(a.v, _mm_set1_pd(-0.0)) }; }
+inline F64Mask operator<(F64Lanes a, F64Lanes b) { return { _mm_cmplt_pd(a.v, b.v) }; }
+inline F64Mask operator>(F64Lanes a, F64Lanes b) { return { _mm_cmpgt_pd(a.v, b.v) }; }
+inline F64Mask operator>=(F64Lanes a, F64Lanes b) { return { _mm_cmpge_pd(a.v, b.v) }; }
+inline F64Mask operator==(F64Lanes a, F64Lanes b) { return { _mm_cmpeq_pd(a.v, b.v) }; }
+inline F64Mask operator|(F64Mask a, F64Mask b) { return { _mm_or_pd(a.m, b.m) }; }
+inline F64Lanes Select(F64Mask mask, F64Lanes a, F64Lanes b) { return { _mm_or_pd(_mm_and_pd(mask.m, a.v), _mm_andnot_pd(mask.m, b.v)) }; }
+inline F64Lanes Abs(F64Lanes a) { return { _mm_andnot_pd(_mm_set1_pd(-0.0), a.v) }; }
+
+// SSE2 has no rounding instruction; adding and subtracting 1.5 * 2^52 rounds to nearest for |a| < 2^51.
+inline F64Lanes Round(F64Lanes a)
+{
+    const __m128d magic = _mm_set1_pd(6755399441055744.0);
+    return { _mm_sub_pd(_mm_add_pd(a.v, magic), magic) };
+}
+
+struct F32Mask { __m128 m; };
+struct F32Lanes
+{
+    using Scalar = float;
+    using Mask = F32Mask;
+    static constexpr size_t kWidth = 4;
+    static F32Lanes Load(const float* p) { return { _mm_loadu_ps(p) }; }
+    static F32Lanes Broadcast(float s) { return { _mm_set1_ps(s) }; }
+    void Store(float* p) const { _mm_storeu_ps(p, v); }
+    __m128 v;
+};
+inline F32Lanes operator+(F32Lanes a, F32Lanes b) { return { _mm_add_ps(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a, F32Lanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline F32Lanes operator*(F32Lanes a, F32Lanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline F32Lanes operator/(F32Lanes a, F32Lanes b) { return { _mm_div_ps(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a) { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)) }; }
+inline F32Mask operator<(F32Lanes a, F32Lanes b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline F32Mask operator>(F32Lanes a, F32Lanes b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+inline F32Mask operator>=(F32Lanes a, F32Lanes b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+inline F32Mask operator==(F32Lanes a, F32Lanes b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+inline F32Mask operator|(F32Mask a, F32Mask b) { return { _mm_or_ps(a.m, b.m) }; }
+inline F32Lanes Select(F32Mask mask, F32Lanes a, F32Lanes b) { return { _mm_or_ps(_mm_and_ps(mask.m, a.v), _mm_andnot_ps(mask.m, b.v)) }; }
+inline F32Lanes Abs(F32Lanes a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+
+// Adding and subtracting 1.5 * 2^23 rounds to nearest for |a| < 2^22.
+inline F32Lanes Round(F32Lanes a)
+{
+    const __m128 magic = _mm_set1_ps(12582912.0f);
+    return { _mm_sub_ps(_mm_add_ps(a.v, magic), magic) };
+}
+
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+
+constexpr const char* kSimdInstructionSet = "NEON";
+
+struct F64Mask { uint64x2_t m; };
+struct F64Lanes
+{
+    using Scalar = double;
+    using Mask = F64Mask;
+    static constexpr size_t kWidth = 2;
+    static F64Lanes Load(const double* p) { return { vld1q_f64(p) }; }
+    static F64Lanes Broadcast(double s) { return { vdupq_n_f64(s) }; }
+    void Store(double* p) const { vst1q_f64(p, v); }
+    float64x2_t v;
+};
+inline F64Lanes operator+(F64Lanes a, F64Lanes b) { return { vaddq_f64(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a, F64Lanes b) { return { vsubq_f64(a.v, b.v) }; }
+inline F64Lanes operator*(F64Lanes a, F64Lanes b) { return { vmulq_f64(a.v, b.v) }; }
+inline F64Lanes operator/(F64Lanes a, F64Lanes b) { return { vdivq_f64(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a) { return { vnegq_f64(a.v) }; }
+inline F64Mask operator<(F64Lanes a, F64Lanes b) { return { vcltq_f64(a.v, b.v) }; }
+inline F64Mask operator>(F64Lanes a, F64Lanes b) { return { vcgtq_f64(a.v, b.v) }; }
+inline F64Mask operator>=(F64Lanes a, F64Lanes b) { return { vcgeq_f64(a.v, b.v) }; }
+inline F64Mask operator==(F64Lanes a, F64Lanes b) { return { vceqq_f64(a.v, b.v) }; }
+inline F64Mask operator|(F64Mask a, F64Mask b) { return { vorrq_u64(a.m, b.m) }; }
+inline F64Lanes Select(F64Mask mask, F64Lanes a, F64Lanes b) { return { vbslq_f64(mask.m, a.v, b.v) }; }
+inline F64Lanes Abs(F64Lanes a) { return { vabsq_f64(a.v) }; }
+inline F64Lanes Round(F64Lanes a) { return { vrndnq_f64(a.v) }; }
+
+struct F32Mask { uint32x4_t m; };
+struct F32Lanes
+{
+    using Scalar = float;
+    using Mask = F32Mask;
+    static constexpr size_t kWidth = 4;
+    static F32Lanes Load(const float* p) { return { vld1q_f32(p) }; }
+    static F32Lanes Broadcast(float s) { return { vdupq_n_f32(s) }; }
+    void Store(float* p) const { vst1q_f32(p, v); }
+    float32x4_t v;
+};
+inline F32Lanes operator+(F32Lanes a, F32Lanes b) { return { vaddq_f32(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a, F32Lanes b) { return { vsubq_f32(a.v, b.v) }; }
+inline F32Lanes operator*(F32Lanes a, F32Lanes b) { return { vmulq_f32(a.v, b.v) }; }
+inline F32Lanes operator/(F32Lanes a, F32Lanes b) { return { vdivq_f32(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a) { return { vnegq_f32(a.v) }; }
+inline F32Mask operator<(F32Lanes a, F32Lanes b) { return { vcltq_f32(a.v, b.v) }; }
+inline F32Mask operator>(F32Lanes a, F32Lanes b) { return { vcgtq_f32(a.v, b.v) }; }
+inline F32Mask operator>=(F32Lanes a, F32Lanes b) { return { vcgeq_f32(a.v, b.v) }; }
+inline F32Mask operator==(F32Lanes a, F32Lanes b) { return { vceqq_f32(a.v, b.v) }; }
+inline F32Mask operator|(F32Mask a, F32Mask b) { return { vorrq_u32(a.m, b.m) }; }
+inline F32Lanes Select(F32Mask mask, F32Lanes a, F32Lanes b) { return { vbslq_f32(mask.m, a.v, b.v) }; }
+inline F32Lanes Abs(F32Lanes a) { return { vabsq_f32(a.v) }; }
+inline F32Lanes Round(F32Lanes a) { return { vrndnq_f32(a.v) }; }
+
+#elif defined(__wasm_simd128__)
+
+constexpr const char* kSimdInstructionSet = "WebAssembly SIMD";
+
+struct F64Mask { v128_t m; };
+struct F64Lanes
+{
+    using Scalar = double;
+    using Mask = F64Mask;
+    static constexpr size_t kWidth = 2;
+    static F64Lanes Load(const double* p) { return { wasm_v128_load(p) }; }
+    static F64Lanes Broadcast(double s) { return { wasm_f64x2_splat(s) }; }
+    void Store(double* p) const { wasm_v128_store(p, v); }
+    v128_t v;
+};
+inline F64Lanes operator+(F64Lanes a, F64Lanes b) { return { wasm_f64x2_add(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a, F64Lanes b) { return { wasm_f64x2_sub(a.v, b.v) }; }
+inline F64Lanes operator*(F64Lanes a, F64Lanes b) { return { wasm_f64x2_mul(a.v, b.v) }; }
+inline F64Lanes operator/(F64Lanes a, F64Lanes b) { return { wasm_f64x2_div(a.v, b.v) }; }
+inline F64Lanes operator-(F64Lanes a) { return { wasm_f64x2_neg(a.v) }; }
+inline F64Mask operator<(F64Lanes a, F64Lanes b) { return { wasm_f64x2_lt(a.v, b.v) }; }
+inline F64Mask operator>(F64Lanes a, F64Lanes b) { return { wasm_f64x2_gt(a.v, b.v) }; }
+inline F64Mask operator>=(F64Lanes a, F64Lanes b) { return { wasm_f64x2_ge(a.v, b.v) }; }
+inline F64Mask operator==(F64Lanes a, F64Lanes b) { return { wasm_f64x2_eq(a.v, b.v) }; }
+inline F64Mask operator|(F64Mask a, F64Mask b) { return { wasm_v128_or(a.m, b.m) }; }
+inline F64Lanes Select(F64Mask mask, F64Lanes a, F64Lanes b) { return { wasm_v128_bitselect(a.v, b.v, mask.m) }; }
+inline F64Lanes Abs(F64Lanes a) { return { wasm_f64x2_abs(a.v) }; }
+inline F64Lanes Round(F64Lanes a) { return { wasm_f64x2_nearest(a.v) }; }
+
+struct F32Mask { v128_t m; };
+struct F32Lanes
+{
+    using Scalar = float;
+    using Mask = F32Mask;
+    static constexpr size_t kWidth = 4;
+    static F32Lanes Load(const float* p) { return { wasm_v128_load(p) }; }
+    static F32Lanes Broadcast(float s) { return { wasm_f32x4_splat(s) }; }
+    void Store(float* p) const { wasm_v128_store(p, v); }
+    v128_t v;
+};
+inline F32Lanes operator+(F32Lanes a, F32Lanes b) { return { wasm_f32x4_add(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a, F32Lanes b) { return { wasm_f32x4_sub(a.v, b.v) }; }
+inline F32Lanes operator*(F32Lanes a, F32Lanes b) { return { wasm_f32x4_mul(a.v, b.v) }; }
+inline F32Lanes operator/(F32Lanes a, F32Lanes b) { return { wasm_f32x4_div(a.v, b.v) }; }
+inline F32Lanes operator-(F32Lanes a) { return { wasm_f32x4_neg(a.v) }; }
+inline F32Mask operator<(F32Lanes a, F32Lanes b) { return { wasm_f32x4_lt(a.v, b.v) }; }
+inline F32Mask operator>(F32Lanes a, F32Lanes b) { return { wasm_f32x4_gt(a.v, b.v) }; }
+inline F32Mask operator>=(F32Lanes a, F32Lanes b) { return { wasm_f32x4_ge(a.v, b.v) }; }
+inline F32Mask operator==(F32Lanes a, F32Lanes b) { return { wasm_f32x4_eq(a.v, b.v) }; }
+inline F32Mask operator|(F32Mask a, F32Mask b) { return { wasm_v128_or(a.m, b.m) }; }
+inline F32Lanes Select(F32Mask mask, F32Lanes a, F32Lanes b) { return { wasm_v128_bitselect(a.v, b.v, mask.m) }; }
+inline F32Lanes Abs(F32Lanes a) { return { wasm_f32x4_abs(a.v) }; }
+inline F32Lanes Round(F32Lanes a) { return { wasm_f32x4_nearest(a.v) }; }
+
+#else
+
+constexpr const char* kSimdInstructionSet = "Scalar";
+
+struct F64Mask { bool m; };
+struct F64Lanes
+{
+    using Scalar = double;
+    using Mask = F64Mask;
+    static constexpr size_t kWidth = 1;
+    static F64Lanes Load(const double* p) { return { *p }; }
+    static F64Lanes Broadcast(double s) { return { s }; }
+    void Store(double* p) const { *p = v; }
+    double v;
+};
+inline F64Lanes operator+(F64Lanes a, F64Lanes b) { return { a.v + b.v }; }
+inline F64Lanes operator-(F64Lanes a, F64Lanes b) { return { a.v - b.v }; }
+inline F64Lanes operator*(F64Lanes a, F64Lanes b) { return { a.v * b.v }; }
+inline F64Lanes operator/(F64Lanes a, F64Lanes b) { return { a.v / b.v }; }
+inline F64Lanes operator-(F64Lanes a) { return { -a.v }; }
+inline F64Mask operator<(F64Lanes a, F64Lanes b) { return { a.v < b.v }; }
+inline F64Mask operator>(F64Lanes a, F64Lanes b) { return { a.v > b.v }; }
+inline F64Mask operator>=(F64Lanes a, F64Lanes b) { return { a.v >= b.v }; }
+inline F64Mask operator==(F64Lanes a, F64Lanes b) { return { a.v == b.v }; }
+inline F64Mask operator|(F64Mask a, F64Mask b) { return { a.m || b.m }; }
+inline F64Lanes Select(F64Mask mask, F64Lanes a, F64Lanes b) { return mask.m ? a : b; }
+inline F64Lanes Abs(F64Lanes a) { return { std::abs(a.v) }; }
+inline F64Lanes Round(F64Lanes a) { return { std::nearbyint(a.v) }; }
+
+struct F32Mask { bool m; };
+struct F32Lanes
+{
+    using Scalar = float;
+    using Mask = F32Mask;
+    static constexpr size_t kWidth = 1;
+    static F32Lanes Load(const float* p) { return { *p }; }
+    static F32Lanes Broadcast(float s) { return { s }; }
+    void Store(float* p) const { *p = v; }
+    float v;
+};
+inline F32Lanes operator+(F32Lanes a, F32Lanes b) { return { a.v + b.v }; }
+inline F32Lanes operator-(F32Lanes a, F32Lanes b) { return { a.v - b.v }; }
+inline F32Lanes operator*(F32Lanes a, F32Lanes b) { return { a.v * b.v }; }
+inline F32Lanes operator/(F32Lanes a, F32Lanes b) { return { a.v / b.v }; }
+inline F32Lanes operator-(F32Lanes a) { return { -a.v }; }
+inline F32Mask operator<(F32Lanes a, F32Lanes b) { return { a.v < b.v }; }
+inline F32Mask operator>(F32Lanes a, F32Lanes b) { return { a.v > b.v }; }
+inline F32Mask operator>=(F32Lanes a, F32Lanes b) { return { a.v >= b.v }; }
+inline F32Mask operator==(F32Lanes a, F32Lanes b) { return { a.v == b.v }; }
+inline F32Mask operator|(F32Mask a, F32Mask b) { return { a.m || b.m }; }
+inline F32Lanes Select(F32Mask mask, F32Lanes a, F32Lanes b) { return mask.m ? a : b; }
+inline F32Lanes Abs(F32Lanes a) { return { std::abs(a.v) }; }
+inline F32Lanes Round(F32Lanes a) { return { std::nearbyint(a.v) }; }
+
+#endif
+
+// Convenience overloads so kernels can mix lanes and scalar constants.
+template <typename Lanes>
+inline Lanes operator+(Lanes a, typename Lanes::Scalar b) { return a + Lanes::Broadcast(b); }
+template <typename Lanes>
+inline Lanes operator-(Lanes a, typename Lanes::Scalar b) { return a - Lanes::Broadcast(b); }
+template <typename Lanes>
+inline Lanes operator*(Lanes a, typename Lanes::Scalar b) { return a * Lanes::Broadcast(b); }
+template <typename Lanes>
+inline Lanes operator-(typename Lanes::Scalar a, Lanes b) { return Lanes::Broadcast(a) - b; }
+
+} // anonymous namespace
+} // namespace WingsOfSteel
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/constants.hpp>
+
+#include "propagation/synthetic_population.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr double kMu = 398600.4418; // km³/s²
+constexpr double kEarthRadius = 6378.137; // km
+
+// Fragments whose perigee would be below this altitude (km) are circularised until it isn't.
+constexpr double kMinimumPerigeeAltitude = 150.0;
+
+// Share of the population which belongs to constellations rather than debris clouds.
+constexpr double kConstellationFraction = 0.6;
+
+struct Shell
+{
+    double altitude; // km
+    double inclination; // deg
+    uint32_t planeCount;
+    double weight; // Relative number of satellites
+};
+
+constexpr std::array<Shell, 6> kShells = { {
+    { 550.0, 53.0, 72, 1584.0 },
+    { 540.0, 53.2, 72, 1584.0 },
+    { 570.0, 70.0, 36, 720.0 },
+    { 560.0, 97.6, 10, 348.0 },
+    { 1200.0, 87.9, 18, 648.0 },
+    { 1325.0, 50.0, 40, 1600.0 },
+} };
+
+struct FragmentationEvent
+{
+    double altitude; // km
+    double inclination; // deg
+    double rightAscensionOfAscendingNode; // deg
+    double weight; // Relative number of fragments
+};
+
+constexpr std::array<FragmentationEvent, 4> kFragmentationEvents = { {
+    { 850.0, 98.8, 40.0, 3500.0 },
+    { 790.0, 86.4, 120.0, 2300.0 },
+    { 480.0, 82.6, 200.0, 1800.0 },
+    { 700.0, 74.0, 300.0, 1000.0 },
+} };
+
+double GetMeanMotion(double semiMajorAxis)
+{
+    // rad/s to rev/day
+    return std::sqrt(kMu / (semiMajorAxis * semiMajorAxis * semiMajorAxis)) * 86400.0 / (2.0 * glm::pi<double>());
+}
+
+template <typename T, size_t N>
+std::array<size_t, N> Apportion(const std::array<T, N>& groups, size_t count)
+{
+    double totalWeight = 0.0;
+    for (const T& group : groups)
+    {
+        totalWeight += group.weight;
+    }
+
+    // Rounding down leaves a remainder, which goes to the first group.
+    std::array<size_t, N> counts;
+    size_t assigned = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        counts[i] = static_cast<size_t>(count * groups[i].weight / totalWeight);
+        assigned += counts[i];
+    }
+    counts[0] += count - assigned;
+    return counts;
+}
+
+} // anonymous namespace
+
+std::vector<Sgp4Elements> GenerateSyntheticPopulation(size_t count, double epoch, uint32_t seed)
+{
+    std::vector<Sgp4Elements> population;
+    population.reserve(count);
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> angle(0.0, 360.0);
+
+    // Walker delta shells, i:T/P/1. Satellites are spread evenly around each plane, and each plane is
+    // phased one slot further along than the previous one.
+    const size_t constellationCount = static_cast<size_t>(count * kConstellationFraction);
+    const std::array<size_t, kShells.size()> shellCounts = Apportion(kShells, constellationCount);
+    for (size_t shellIndex = 0; shellIndex < kShells.size(); ++shellIndex)
+    {
+        const Shell& shell = kShells[shellIndex];
+        const size_t satelliteCount = shellCounts[shellIndex];
+        const size_t planeCount = std::min<size_t>(shell.planeCount, std::max<size_t>(satelliteCount, 1));
+        const size_t satellitesPerPlane = (satelliteCount + planeCount - 1) / planeCount;
+        for (size_t satellite = 0; satellite < satelliteCount; ++satellite)
+        {
+            const size_t plane = satellite / satellitesPerPlane;
+            const size_t slot = satellite % satellitesPerPlane;
+
+            Sgp4Elements elements;
+            elements.epoch = epoch;
+            elements.meanMotion = GetMeanMotion(kEarthRadius + shell.altitude);
+            elements.eccentricity = 1.0e-4;
+            elements.inclination = shell.inclination;
+            elements.rightAscensionOfAscendingNode = 360.0 * plane / planeCount;
+            elements.argumentOfPericenter = 0.0;
+            elements.meanAnomaly = std::fmod(360.0 * (slot + static_cast<double>(plane) / planeCount) / satellitesPerPlane, 360.0);
+            population.push_back(elements);
+        }
+    }
+
+    // Debris clouds. Fragments share their parent's plane give or take the spread of the breakup, and are
+    // scattered all the way along it, as they would be a few months after the event.
+    std::normal_distribution<double> altitudeSpread(0.0, 120.0);
+    std::normal_distribution<double> eccentricitySpread(0.0, 0.01);
+    std::normal_distribution<double> inclinationSpread(0.0, 0.4);
+    std::normal_distribution<double> nodeSpread(0.0, 2.0);
+    const std::array<size_t, kFragmentationEvents.size()> fragmentCounts = Apportion(kFragmentationEvents, count - population.size());
+    for (size_t eventIndex = 0; eventIndex < kFragmentationEvents.size(); ++eventIndex)
+    {
+        const FragmentationEvent& event = kFragmentationEvents[eventIndex];
+        for (size_t fragment = 0; fragment < fragmentCounts[eventIndex]; ++fragment)
+        {
+            const double semiMajorAxis = kEarthRadius + std::max(event.altitude + altitudeSpread(generator), kMinimumPerigeeAltitude);
+            const double maximumEccentricity = 1.0 - (kEarthRadius + kMinimumPerigeeAltitude) / semiMajorAxis;
+
+            Sgp4Elements elements;
+            elements.epoch = epoch;
+            elements.meanMotion = GetMeanMotion(semiMajorAxis);
+            elements.eccentricity = std::clamp(std::abs(eccentricitySpread(generator)), 0.0, std::max(maximumEccentricity, 0.0));
+            elements.inclination = std::clamp(event.inclination + inclinationSpread(generator), 0.0, 180.0);
+            elements.rightAscensionOfAscendingNode = std::fmod(event.rightAscensionOfAscendingNode + nodeSpread(generator) + 360.0, 360.0);
+            elements.argumentOfPericenter = angle(generator);
+            elements.meanAnomaly = angle(generator);
+            population.push_back(elements);
+        }
+    }
+
+    return population;
+}
+
+} // namespace WingsOfSteel
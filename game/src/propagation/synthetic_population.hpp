@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "propagation/sgp4.hpp"
+
+namespace WingsOfSteel
+{
+
+// Generates element sets for a synthetic population of the given size, for stress testing: Walker delta
+// shells modelled on the large LEO constellations, and debris clouds from a handful of fragmentation
+// events. The same seed always gives the same population.
+std::vector<Sgp4Elements> GenerateSyntheticPopulation(size_t count, double epoch, uint32_t seed = 1);
+
+} // namespace WingsOfSteel
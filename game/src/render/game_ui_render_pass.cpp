@@ -4,6 +4,7 @@
 #include <render/rendersystem.hpp>
 #include <render/window.hpp>
 
+#include "render/upload_ring.hpp"
 #include "sector/sector.hpp"
 #include "systems/label_system.hpp"
 #include "game.hpp"
@@ -45,6 +46,7 @@ void GameUIRenderPass::Render(wgpu::CommandEncoder& encoder)
     }
 
     renderPass.End();
+    Game::Get()->GetUploadRing()->Flush();
 }
 
 } // namespace WingsOfSteel
@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "render/gpu_point_cloud.hpp"
+#include "jobs/worker_pool.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr double kMu = 398600.4418; // km³/s²
+
+// Must match PropagationUniforms in gpu_propagation.wgsl
+struct PropagationUniformData
+{
+    float timeOffset; // Seconds since the reference time
+    uint32_t objectCount;
+    uint32_t _padding0;
+    uint32_t _padding1;
+};
+
+// Must match Orbit in gpu_propagation.wgsl
+struct OrbitData
+{
+    glm::vec4 p; // Perifocal x axis scaled by the semi-major axis (km), and the eccentricity
+    glm::vec4 q; // Perifocal y axis scaled by the semi-minor axis (km), and the mean motion (rad/s)
+};
+
+// Must match CullingUniforms in gpu_point_cloud_cull.wgsl
+struct CullingUniformData
+{
+    std::array<glm::vec4, CullingViewState::kPlaneCount> planes;
+    glm::vec3 scaledCameraPosition;
+    float horizonDistance2;
+    glm::vec3 inverseRadii;
+    uint32_t objectCount;
+    uint32_t occlusionEnabled;
+    uint32_t _padding0;
+    uint32_t _padding1;
+    uint32_t _padding2;
+};
+
+// Must match DrawArguments in gpu_point_cloud_cull.wgsl, which follows the layout DrawIndirect() reads.
+struct DrawArgumentsData
+{
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+};
+
+// Must match the workgroup size in gpu_propagation.wgsl and gpu_point_cloud_cull.wgsl
+constexpr uint32_t kWorkgroupSize = 64;
+
+constexpr size_t kUploadGrainSize = 16384;
+
+} // anonymous namespace
+
+GpuPointCloud::GpuPointCloud(wgpu::Device device)
+    : m_Device(device)
+{
+    CreateBindGroupLayouts();
+
+    wgpu::BufferDescriptor uniformBufferDescriptor{
+        .label = "GPU propagation uniform buffer",
+        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
+        .size = sizeof(PropagationUniformData)
+    };
+    m_UniformBuffer = m_Device.CreateBuffer(&uniformBufferDescriptor);
+
+    wgpu::BufferDescriptor cullingUniformBufferDescriptor{
+        .label = "GPU point cloud culling uniform buffer",
+        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
+        .size = sizeof(CullingUniformData)
+    };
+    m_CullingUniformBuffer = m_Device.CreateBuffer(&cullingUniformBufferDescriptor);
+
+    // Copied from as well, so the vertex count can be read back.
+    wgpu::BufferDescriptor drawArgumentsBufferDescriptor{
+        .label = "GPU point cloud draw arguments buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::Indirect | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc,
+        .size = sizeof(DrawArgumentsData)
+    };
+    m_DrawArgumentsBuffer = m_Device.CreateBuffer(&drawArgumentsBufferDescriptor);
+}
+
+GpuPointCloud::~GpuPointCloud()
+{
+    Clear();
+}
+
+void GpuPointCloud::SetPropagationShader(const wgpu::ShaderModule& shaderModule)
+{
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &m_BindGroupLayout
+    };
+    wgpu::PipelineLayout pipelineLayout = m_Device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+    wgpu::ComputePipelineDescriptor descriptor{
+        .label = "GPU propagation compute pipeline",
+        .layout = pipelineLayout,
+        .compute = { .module = shaderModule }
+    };
+    m_ComputePipeline = m_Device.CreateComputePipeline(&descriptor);
+}
+
+void GpuPointCloud::SetCullingShader(const wgpu::ShaderModule& shaderModule)
+{
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &m_CullingBindGroupLayout
+    };
+    wgpu::PipelineLayout pipelineLayout = m_Device.CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+    wgpu::ComputePipelineDescriptor descriptor{
+        .label = "GPU point cloud culling compute pipeline",
+        .layout = pipelineLayout,
+        .compute = { .module = shaderModule }
+    };
+    m_CullingPipeline = m_Device.CreateComputePipeline(&descriptor);
+}
+
+void GpuPointCloud::SetObjects(const std::vector<Sgp4Elements>& objects, double time, WorkerPool& workerPool)
+{
+    Clear();
+
+    const size_t count = std::min(objects.size(), kMaximumObjectCount);
+    if (count == 0)
+    {
+        return;
+    }
+
+    // The perifocal basis is computed here in double precision, and scaled by the axes so the shader only
+    // has to combine the two vectors.
+    std::vector<OrbitData> orbits(count);
+    m_Epoch.resize(count);
+    m_MeanAnomalyAtEpoch.resize(count);
+    m_MeanMotion.resize(count);
+    workerPool.ParallelFor(count, kUploadGrainSize, [this, &objects, &orbits](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+        {
+            const Sgp4Elements& elements = objects[index];
+            const double n = elements.meanMotion * 2.0 * glm::pi<double>() / 86400.0;
+            const double a = std::cbrt(kMu / (n * n));
+            const double e = elements.eccentricity;
+            const double b = a * std::sqrt(1.0 - e * e);
+
+            const double cos_omega = std::cos(glm::radians(elements.rightAscensionOfAscendingNode));
+            const double sin_omega = std::sin(glm::radians(elements.rightAscensionOfAscendingNode));
+            const double cos_i = std::cos(glm::radians(elements.inclination));
+            const double sin_i = std::sin(glm::radians(elements.inclination));
+            const double cos_w = std::cos(glm::radians(elements.argumentOfPericenter));
+            const double sin_w = std::sin(glm::radians(elements.argumentOfPericenter));
+
+            const glm::dvec3 p(cos_omega * cos_w - sin_omega * sin_w * cos_i, sin_omega * cos_w + cos_omega * sin_w * cos_i, sin_w * sin_i);
+            const glm::dvec3 q(-(cos_omega * sin_w + sin_omega * cos_w * cos_i), -(sin_omega * sin_w - cos_omega * cos_w * cos_i), cos_w * sin_i);
+            orbits[index].p = glm::vec4(glm::vec3(a * p), static_cast<float>(e));
+            orbits[index].q = glm::vec4(glm::vec3(b * q), static_cast<float>(n));
+
+            m_Epoch[index] = elements.epoch;
+            m_MeanAnomalyAtEpoch[index] = glm::radians(elements.meanAnomaly);
+            m_MeanMotion[index] = n;
+        }
+    });
+
+    wgpu::BufferDescriptor orbitBufferDescriptor{
+        .label = "GPU propagation orbit buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+        .size = count * sizeof(OrbitData)
+    };
+    m_OrbitBuffer = m_Device.CreateBuffer(&orbitBufferDescriptor);
+    m_Device.GetQueue().WriteBuffer(m_OrbitBuffer, 0, orbits.data(), count * sizeof(OrbitData));
+
+    wgpu::BufferDescriptor meanAnomalyBufferDescriptor{
+        .label = "GPU propagation mean anomaly buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+        .size = count * sizeof(float)
+    };
+    m_MeanAnomalyBuffer = m_Device.CreateBuffer(&meanAnomalyBufferDescriptor);
+
+    // Copied from as well, so the positions can be read back.
+    wgpu::BufferDescriptor positionBufferDescriptor{
+        .label = "GPU propagation position buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopySrc,
+        .size = count * sizeof(glm::vec4)
+    };
+    m_PositionBuffer = m_Device.CreateBuffer(&positionBufferDescriptor);
+
+    wgpu::BufferDescriptor visiblePositionBufferDescriptor{
+        .label = "GPU point cloud visible position buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
+        .size = count * sizeof(glm::vec4)
+    };
+    m_VisiblePositionBuffer = m_Device.CreateBuffer(&visiblePositionBufferDescriptor);
+
+    m_ObjectCount = count;
+    UploadMeanAnomalies(time, workerPool);
+    SetTime(time, workerPool);
+    CreateBindGroups();
+}
+
+void GpuPointCloud::Clear()
+{
+    for (wgpu::Buffer* pBuffer : { &m_OrbitBuffer, &m_MeanAnomalyBuffer, &m_PositionBuffer, &m_VisiblePositionBuffer })
+    {
+        if (*pBuffer)
+        {
+            pBuffer->Destroy();
+            *pBuffer = nullptr;
+        }
+    }
+    m_BindGroup = nullptr;
+    m_CullingBindGroup = nullptr;
+    m_Epoch.clear();
+    m_MeanAnomalyAtEpoch.clear();
+    m_MeanMotion.clear();
+    m_MeanAnomalies.clear();
+    m_ObjectCount = 0;
+}
+
+void GpuPointCloud::SetTime(double time, WorkerPool& workerPool)
+{
+    if (m_ObjectCount == 0)
+    {
+        return;
+    }
+
+    if (std::abs(time - m_ReferenceTime) > kMaximumTimeOffset)
+    {
+        UploadMeanAnomalies(time, workerPool);
+    }
+
+    const PropagationUniformData data{
+        .timeOffset = static_cast<float>(time - m_ReferenceTime),
+        .objectCount = static_cast<uint32_t>(m_ObjectCount),
+        ._padding0 = 0,
+        ._padding1 = 0
+    };
+    m_Device.GetQueue().WriteBuffer(m_UniformBuffer, 0, &data, sizeof(PropagationUniformData));
+}
+
+bool GpuPointCloud::EncodePropagation(wgpu::ComputePassEncoder& computePass) const
+{
+    if (m_ObjectCount == 0 || !m_ComputePipeline || !m_BindGroup)
+    {
+        return false;
+    }
+
+    computePass.SetPipeline(m_ComputePipeline);
+    computePass.SetBindGroup(0, m_BindGroup);
+    computePass.DispatchWorkgroups(static_cast<uint32_t>((m_ObjectCount + kWorkgroupSize - 1) / kWorkgroupSize));
+    return true;
+}
+
+bool GpuPointCloud::EncodeCulling(wgpu::ComputePassEncoder& computePass, const CullingViewState& viewState) const
+{
+    if (m_ObjectCount == 0 || !m_CullingPipeline || !m_CullingBindGroup)
+    {
+        return false;
+    }
+
+    const CullingUniformData data{
+        .planes = viewState.planes,
+        .scaledCameraPosition = viewState.scaledCameraPosition,
+        .horizonDistance2 = viewState.horizonDistance2,
+        .inverseRadii = viewState.inverseRadii,
+        .objectCount = static_cast<uint32_t>(m_ObjectCount),
+        .occlusionEnabled = viewState.occlusionEnabled ? 1u : 0u,
+        ._padding0 = 0,
+        ._padding1 = 0,
+        ._padding2 = 0
+    };
+
+    // The queue writes land before the pass runs, so the vertex count starts from zero every frame.
+    const DrawArgumentsData drawArguments{
+        .vertexCount = 0,
+        .instanceCount = 1,
+        .firstVertex = 0,
+        .firstInstance = 0
+    };
+
+    wgpu::Queue queue = m_Device.GetQueue();
+    queue.WriteBuffer(m_CullingUniformBuffer, 0, &data, sizeof(CullingUniformData));
+    queue.WriteBuffer(m_DrawArgumentsBuffer, 0, &drawArguments, sizeof(DrawArgumentsData));
+
+    computePass.SetPipeline(m_CullingPipeline);
+    computePass.SetBindGroup(0, m_CullingBindGroup);
+    computePass.DispatchWorkgroups(static_cast<uint32_t>((m_ObjectCount + kWorkgroupSize - 1) / kWorkgroupSize));
+    return true;
+}
+
+void GpuPointCloud::UploadMeanAnomalies(double referenceTime, WorkerPool& workerPool)
+{
+    m_ReferenceTime = referenceTime;
+    m_MeanAnomalies.resize(m_ObjectCount);
+    workerPool.ParallelFor(m_ObjectCount, kUploadGrainSize, [this](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+        {
+            const double meanAnomaly = m_MeanAnomalyAtEpoch[index] + m_MeanMotion[index] * (m_ReferenceTime - m_Epoch[index]);
+            m_MeanAnomalies[index] = static_cast<float>(std::fmod(meanAnomaly, 2.0 * glm::pi<double>()));
+        }
+    });
+    m_Device.GetQueue().WriteBuffer(m_MeanAnomalyBuffer, 0, m_MeanAnomalies.data(), m_ObjectCount * sizeof(float));
+}
+
+void GpuPointCloud::CreateBindGroupLayouts()
+{
+    std::array<wgpu::BindGroupLayoutEntry, 4> entries = { { { .binding = 0,
+                                                                .visibility = wgpu::ShaderStage::Compute,
+                                                                .buffer = { .type = wgpu::BufferBindingType::Uniform } },
+        { .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = { .type = wgpu::BufferBindingType::ReadOnlyStorage } },
+        { .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = { .type = wgpu::BufferBindingType::ReadOnlyStorage } },
+        { .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = { .type = wgpu::BufferBindingType::Storage } } } };
+
+    wgpu::BindGroupLayoutDescriptor layoutDescriptor{
+        .label = "GPU propagation bind group layout",
+        .entryCount = static_cast<uint32_t>(entries.size()),
+        .entries = entries.data()
+    };
+    m_BindGroupLayout = m_Device.CreateBindGroupLayout(&layoutDescriptor);
+
+    std::array<wgpu::BindGroupLayoutEntry, 4> cullingEntries = { { { .binding = 0,
+                                                                       .visibility = wgpu::ShaderStage::Compute,
+                                                                       .buffer = { .type = wgpu::BufferBindingType::Uniform } },
+        { .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = { .type = wgpu::BufferBindingType::ReadOnlyStorage } },
+        { .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = { .type = wgpu::BufferBindingType::Storage } },
+        { .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = { .type = wgpu::BufferBindingType::Storage } } } };
+
+    wgpu::BindGroupLayoutDescriptor cullingLayoutDescriptor{
+        .label = "GPU point cloud culling bind group layout",
+        .entryCount = static_cast<uint32_t>(cullingEntries.size()),
+        .entries = cullingEntries.data()
+    };
+    m_CullingBindGroupLayout = m_Device.CreateBindGroupLayout(&cullingLayoutDescriptor);
+}
+
+void GpuPointCloud::CreateBindGroups()
+{
+    std::array<wgpu::BindGroupEntry, 4> entries = { { { .binding = 0,
+                                                          .buffer = m_UniformBuffer,
+                                                          .size = sizeof(PropagationUniformData) },
+        { .binding = 1,
+            .buffer = m_OrbitBuffer,
+            .size = m_ObjectCount * sizeof(OrbitData) },
+        { .binding = 2,
+            .buffer = m_MeanAnomalyBuffer,
+            .size = m_ObjectCount * sizeof(float) },
+        { .binding = 3,
+            .buffer = m_PositionBuffer,
+            .size = m_ObjectCount * sizeof(glm::vec4) } } };
+
+    wgpu::BindGroupDescriptor bindGroupDescriptor{
+        .label = "GPU propagation bind group",
+        .layout = m_BindGroupLayout,
+        .entryCount = static_cast<uint32_t>(entries.size()),
+        .entries = entries.data()
+    };
+    m_BindGroup = m_Device.CreateBindGroup(&bindGroupDescriptor);
+
+    std::array<wgpu::BindGroupEntry, 4> cullingEntries = { { { .binding = 0,
+                                                                 .buffer = m_CullingUniformBuffer,
+                                                                 .size = sizeof(CullingUniformData) },
+        { .binding = 1,
+            .buffer = m_PositionBuffer,
+            .size = m_ObjectCount * sizeof(glm::vec4) },
+        { .binding = 2,
+            .buffer = m_VisiblePositionBuffer,
+            .size = m_ObjectCount * sizeof(glm::vec4) },
+        { .binding = 3,
+            .buffer = m_DrawArgumentsBuffer,
+            .size = sizeof(DrawArgumentsData) } } };
+
+    wgpu::BindGroupDescriptor cullingBindGroupDescriptor{
+        .label = "GPU point cloud culling bind group",
+        .layout = m_CullingBindGroupLayout,
+        .entryCount = static_cast<uint32_t>(cullingEntries.size()),
+        .entries = cullingEntries.data()
+    };
+    m_CullingBindGroup = m_Device.CreateBindGroup(&cullingBindGroupDescriptor);
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "propagation/sgp4.hpp"
+#include "render/view_culling.hpp"
+
+namespace WingsOfSteel
+{
+
+class WorkerPool;
+
+// The GPU side of GpuPropagationSystem: the buffers and compute pipelines which propagate a point cloud of
+// two-body orbits and cull it, on whichever device it is given. Nothing here depends on the scene, the window
+// or the resource system, so it also runs on a headless device, which is how the tests check it.
+class GpuPointCloud
+{
+public:
+    GpuPointCloud(wgpu::Device device);
+    ~GpuPointCloud();
+
+    // Create the pipelines from gpu_propagation.wgsl and gpu_point_cloud_cull.wgsl. Called again whenever the
+    // shaders are reloaded.
+    void SetPropagationShader(const wgpu::ShaderModule& shaderModule);
+    void SetCullingShader(const wgpu::ShaderModule& shaderModule);
+
+    // Replaces the point cloud, keeping at most kMaximumObjectCount objects. Propagation is two-body, from the
+    // mean elements, and the mean anomalies are referred to the given time (seconds since the Unix epoch).
+    void SetObjects(const std::vector<Sgp4Elements>& objects, double time, WorkerPool& workerPool);
+    void Clear();
+    size_t GetObjectCount() const { return m_ObjectCount; }
+
+    // Sets the time (seconds since the Unix epoch) the next propagation pass propagates to.
+    void SetTime(double time, WorkerPool& workerPool);
+
+    // Encodes nothing and returns false until there are objects and a pipeline to propagate them with.
+    bool EncodePropagation(wgpu::ComputePassEncoder& computePass) const;
+
+    // Culls the positions the propagation pass wrote, in the same pass, against the view CullPositions tests
+    // against. Encodes nothing and returns false until there are objects and a pipeline to cull them with.
+    bool EncodeCulling(wgpu::ComputePassEncoder& computePass, const CullingViewState& viewState) const;
+
+    // One vec4f per object: its ECI position (km), and 1.
+    const wgpu::Buffer& GetPositionBuffer() const { return m_PositionBuffer; }
+
+    // The positions which survived culling, compacted, and the arguments of the DrawIndirect() which draws
+    // them, whose vertex count is the number of them.
+    const wgpu::Buffer& GetVisiblePositionBuffer() const { return m_VisiblePositionBuffer; }
+    const wgpu::Buffer& GetDrawArgumentsBuffer() const { return m_DrawArgumentsBuffer; }
+
+    static constexpr size_t kMaximumObjectCount = 1 << 21;
+
+    // The shader works in single precision, so the time it propagates over is kept short by moving the
+    // reference time forward once it is this far (s) from the time being propagated to. Six hours keeps the
+    // rounding of the time offset to a few milliseconds, or a few tens of metres along track.
+    static constexpr double kMaximumTimeOffset = 6.0 * 3600.0;
+
+private:
+    void CreateBindGroupLayouts();
+    void CreateBindGroups();
+    void UploadMeanAnomalies(double referenceTime, WorkerPool& workerPool);
+
+    wgpu::Device m_Device;
+    wgpu::BindGroupLayout m_BindGroupLayout;
+    wgpu::BindGroupLayout m_CullingBindGroupLayout;
+    wgpu::BindGroup m_BindGroup;
+    wgpu::BindGroup m_CullingBindGroup;
+    wgpu::ComputePipeline m_ComputePipeline;
+    wgpu::ComputePipeline m_CullingPipeline;
+    wgpu::Buffer m_UniformBuffer;
+    wgpu::Buffer m_CullingUniformBuffer;
+    wgpu::Buffer m_OrbitBuffer;
+    wgpu::Buffer m_MeanAnomalyBuffer;
+    wgpu::Buffer m_PositionBuffer; // Written by the compute pass, read as a vertex buffer
+    wgpu::Buffer m_VisiblePositionBuffer; // Written by the culling pass, read as a vertex buffer
+    wgpu::Buffer m_DrawArgumentsBuffer; // Vertex count written by the culling pass
+
+    // Kept in double precision so the mean anomalies can be moved to a new reference time.
+    std::vector<double> m_Epoch; // Seconds since the Unix epoch
+    std::vector<double> m_MeanAnomalyAtEpoch; // rad
+    std::vector<double> m_MeanMotion; // rad/s
+    std::vector<float> m_MeanAnomalies; // Staging for the upload
+    double m_ReferenceTime{ 0.0 };
+
+    size_t m_ObjectCount{ 0 };
+};
+
+} // namespace WingsOfSteel
@@ -7,7 +7,12 @@
 #include <scene/systems/landscape_render_system.hpp>
 #include <scene/systems/model_render_system.hpp>
 
+#include "game.hpp"
+#include "render/upload_ring.hpp"
+#include "systems/gpu_propagation_system.hpp"
+#include "systems/orbit_path_system.hpp"
 #include "systems/planet_render_system.hpp"
+#include "systems/space_object_render_system.hpp"
 
 namespace WingsOfSteel
 {
@@ -19,6 +24,18 @@ SectorRenderPass::SectorRenderPass()
 
 void SectorRenderPass::Render(wgpu::CommandEncoder& encoder)
 {
+    // This is the first pass of the frame, so it starts the upload ring's frame for every pass after it.
+    UploadRing* pUploadRing = Game::Get()->GetUploadRing();
+    pUploadRing->BeginFrame();
+
+    // Compute passes can't be nested in a render pass, so GPU propagation is encoded first.
+    Scene* pScene = GetActiveScene();
+    GpuPropagationSystem* pGpuPropagationSystem = pScene ? pScene->GetSystem<GpuPropagationSystem>() : nullptr;
+    if (pGpuPropagationSystem)
+    {
+        pGpuPropagationSystem->Dispatch(encoder);
+    }
+
     wgpu::SurfaceTexture surfaceTexture;
     GetWindow()->GetSurface().GetCurrentTexture(&surfaceTexture);
 
@@ -46,7 +63,6 @@ void SectorRenderPass::Render(wgpu::CommandEncoder& encoder)
     wgpu::RenderPassEncoder renderPass = encoder.BeginRenderPass(&renderpass);
     GetRenderSystem()->UpdateGlobalUniforms(renderPass);
 
-    Scene* pScene = GetActiveScene();
     if (pScene)
     {
         LandscapeRenderSystem* pLandscapeRenderSystem = pScene->GetSystem<LandscapeRenderSystem>();
@@ -66,9 +82,29 @@ void SectorRenderPass::Render(wgpu::CommandEncoder& encoder)
         {
             pPlanetRenderSystem->Render(renderPass);
         }
+
+        // Orbits don't write depth, so the sprites drawn after them stay on top of their own paths.
+        OrbitPathSystem* pOrbitPathSystem = pScene->GetSystem<OrbitPathSystem>();
+        if (pOrbitPathSystem)
+        {
+            pOrbitPathSystem->Render(renderPass);
+        }
+
+        // After the Earth, so the sprites behind it are depth tested against it.
+        SpaceObjectRenderSystem* pSpaceObjectRenderSystem = pScene->GetSystem<SpaceObjectRenderSystem>();
+        if (pSpaceObjectRenderSystem)
+        {
+            pSpaceObjectRenderSystem->Render(renderPass);
+        }
+
+        if (pGpuPropagationSystem)
+        {
+            pGpuPropagationSystem->Render(renderPass);
+        }
     }
 
     renderPass.End();
+    pUploadRing->Flush();
 }
 
 } // namespace WingsOfSteel
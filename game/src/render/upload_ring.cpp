@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <core/log.hpp>
+#include <pandora.hpp>
+#include <render/rendersystem.hpp>
+
+#include "render/upload_ring.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr uint64_t kInitialFrameCapacity = 1024 * 1024;
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+UploadRing::UploadRing()
+{
+    CreateBuffer(kInitialFrameCapacity);
+}
+
+UploadRing::~UploadRing()
+{
+    if (m_Buffer)
+    {
+        m_Buffer.Destroy();
+    }
+}
+
+void UploadRing::BeginFrame()
+{
+    m_FrameIndex = (m_FrameIndex + 1) % kFramesInFlight;
+    m_Offset = 0;
+    m_FlushedOffset = 0;
+    m_RequiredCapacity = 0;
+}
+
+std::optional<UploadRing::Allocation> UploadRing::Allocate(uint64_t size, uint64_t alignment)
+{
+    // Regions start on a multiple of the uniform alignment, so aligning within the region is enough.
+    m_RequiredCapacity = AlignUp(m_RequiredCapacity, alignment) + size;
+    uint64_t offset = AlignUp(m_Offset, alignment);
+    if (offset + size > m_FrameCapacity)
+    {
+        const uint64_t frameCapacity = std::bit_ceil(m_RequiredCapacity);
+        if (frameCapacity > kMaximumFrameCapacity)
+        {
+            Log::Error() << "Upload ring can't grow to " << frameCapacity << " bytes per frame.";
+            return std::nullopt;
+        }
+
+        // What has been allocated so far goes to the old buffer, which the allocations keep alive for as long
+        // as the frames using them need it, and the rest of the frame starts over in the new one. The new
+        // buffer fits everything this frame has asked for, so the next frame won't have to grow it again.
+        Flush();
+        Log::Info() << "Upload ring grown from " << m_FrameCapacity << " to " << frameCapacity << " bytes per frame.";
+        CreateBuffer(frameCapacity);
+        m_Offset = 0;
+        m_FlushedOffset = 0;
+        offset = 0;
+    }
+
+    m_Offset = offset + size;
+    return Allocation{
+        .buffer = m_Buffer,
+        .offset = m_FrameIndex * m_FrameCapacity + offset,
+        .size = size,
+        .pData = m_Staging.data() + offset
+    };
+}
+
+std::optional<UploadRing::Allocation> UploadRing::Upload(const void* pData, uint64_t size, uint64_t alignment)
+{
+    std::optional<Allocation> allocation = Allocate(size, alignment);
+    if (allocation.has_value())
+    {
+        memcpy(allocation->pData, pData, size);
+    }
+    return allocation;
+}
+
+void UploadRing::Flush()
+{
+    if (m_Offset == m_FlushedOffset)
+    {
+        return;
+    }
+
+    // Writes must be a multiple of four bytes. Padding between allocations goes along with them, which is
+    // cheaper than a write per allocation.
+    m_Offset = AlignUp(m_Offset, 4);
+    GetRenderSystem()->GetDevice().GetQueue().WriteBuffer(
+        m_Buffer,
+        m_FrameIndex * m_FrameCapacity + m_FlushedOffset,
+        m_Staging.data() + m_FlushedOffset,
+        m_Offset - m_FlushedOffset);
+
+    m_FlushedOffset = m_Offset;
+}
+
+void UploadRing::CreateBuffer(uint64_t frameCapacity)
+{
+    m_FrameCapacity = AlignUp(frameCapacity, kUniformAlignment);
+
+    wgpu::BufferDescriptor bufferDescriptor{
+        .label = "Upload ring buffer",
+        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst,
+        .size = m_FrameCapacity * kFramesInFlight
+    };
+    m_Buffer = GetRenderSystem()->GetDevice().CreateBuffer(&bufferDescriptor);
+    m_Staging.resize(m_FrameCapacity);
+}
+
+} // namespace WingsOfSteel
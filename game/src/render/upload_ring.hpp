@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <core/smart_ptr.hpp>
+
+namespace WingsOfSteel
+{
+
+// Sub-allocates per-frame dynamic data, such as uniforms and streamed vertices, from one persistent GPU buffer
+// instead of every system writing to buffers of its own. The buffer is split into a region per frame in flight
+// and each frame bump-allocates from the next region, so it never writes to bytes the frames before it may
+// still be reading. Allocations are staged on the CPU and go to the GPU in a single write per Flush().
+//
+// Allocations are only valid for the frame they were made in. A frame which runs out of space writes what it
+// has allocated so far to the current buffer, and carries on in a new one large enough for everything the
+// frame has asked for, so no allocation is dropped. Allocations made before and after that refer to
+// different buffers, so bind groups must be created from each allocation's buffer rather than GetBuffer().
+DECLARE_SMART_PTR(UploadRing);
+class UploadRing
+{
+public:
+    struct Allocation
+    {
+        wgpu::Buffer buffer;
+        uint64_t offset{ 0 }; // In bytes, from the start of the buffer
+        uint64_t size{ 0 };
+        void* pData{ nullptr }; // Staging memory to write to, until the next Flush()
+    };
+
+    static constexpr size_t kFramesInFlight = 3;
+    static constexpr uint64_t kUniformAlignment = 256; // WebGPU's default minUniformBufferOffsetAlignment
+    static constexpr uint64_t kVertexAlignment = 4;
+    static constexpr uint64_t kMaximumFrameCapacity = 64 * 1024 * 1024; // Keeps the buffer within WebGPU's default maxBufferSize of 256 MiB
+
+    UploadRing();
+    ~UploadRing();
+
+    // Moves on to the next frame's region. Must be called once per frame, before any allocation is made.
+    void BeginFrame();
+
+    // Only fails if the frame would need more than kMaximumFrameCapacity.
+    std::optional<Allocation> Allocate(uint64_t size, uint64_t alignment);
+    std::optional<Allocation> Upload(const void* pData, uint64_t size, uint64_t alignment);
+
+    // Writes everything allocated since the last flush to the GPU. Must be called before the commands
+    // using the allocations are submitted.
+    void Flush();
+
+    const wgpu::Buffer& GetBuffer() const { return m_Buffer; }
+    uint64_t GetFrameCapacity() const { return m_FrameCapacity; }
+    uint64_t GetFrameUsage() const { return m_Offset; }
+
+private:
+    void CreateBuffer(uint64_t frameCapacity);
+
+    wgpu::Buffer m_Buffer;
+    std::vector<uint8_t> m_Staging; // Mirrors the current frame's region
+    uint64_t m_FrameCapacity{ 0 };
+    uint64_t m_Offset{ 0 }; // From the start of the current frame's region
+    uint64_t m_FlushedOffset{ 0 };
+    uint64_t m_RequiredCapacity{ 0 }; // Everything asked for so far this frame, as if it had all fit in one region
+    size_t m_FrameIndex{ 0 };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,44 @@
+#include "render/view_culling.hpp"
+#include "propagation/simd_lanes.hpp"
+
+namespace WingsOfSteel
+{
+
+void CullPositions(const CullingViewState& viewState, const float* pX, const float* pY, const float* pZ, float* pVisibility, size_t begin, size_t end)
+{
+    const F32Lanes zero = F32Lanes::Broadcast(0.0f);
+    const F32Lanes one = F32Lanes::Broadcast(1.0f);
+
+    for (size_t index = begin; index < end; index += F32Lanes::kWidth)
+    {
+        const F32Lanes x = F32Lanes::Load(&pX[index]);
+        const F32Lanes y = F32Lanes::Load(&pY[index]);
+        const F32Lanes z = F32Lanes::Load(&pZ[index]);
+
+        F32Mask culled = (x * viewState.planes[0].x + y * viewState.planes[0].y + z * viewState.planes[0].z + viewState.planes[0].w) < zero;
+        for (size_t plane = 1; plane < CullingViewState::kPlaneCount; ++plane)
+        {
+            const glm::vec4& p = viewState.planes[plane];
+            culled = culled | ((x * p.x + y * p.y + z * p.z + p.w) < zero);
+        }
+
+        if (viewState.occlusionEnabled)
+        {
+            // An object is hidden when it's further from the camera along the camera's direction to the
+            // centre than the horizon is, and inside the cone which grazes the horizon.
+            const glm::vec3& c = viewState.scaledCameraPosition;
+            const F32Lanes toObjectX = x * viewState.inverseRadii.x - c.x;
+            const F32Lanes toObjectY = y * viewState.inverseRadii.y - c.y;
+            const F32Lanes toObjectZ = z * viewState.inverseRadii.z - c.z;
+            const F32Lanes alongCentre = -(toObjectX * c.x + toObjectY * c.y + toObjectZ * c.z);
+            const F32Lanes toObjectLength2 = toObjectX * toObjectX + toObjectY * toObjectY + toObjectZ * toObjectZ;
+            const F32Lanes insideCone = alongCentre * alongCentre - toObjectLength2 * viewState.horizonDistance2;
+            const F32Lanes beyondHorizon = alongCentre - viewState.horizonDistance2;
+            culled = culled | (Select(beyondHorizon > zero, insideCone, zero) > zero);
+        }
+
+        Select(culled, zero, one).Store(&pVisibility[index]);
+    }
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace WingsOfSteel
+{
+
+// The volume space objects are culled against: the sides and near plane of the view frustum, and the cone of
+// the Earth's shadow from the camera. SpaceObjectCullingSystem builds it from the camera once per frame, and
+// both it and GpuPointCloud's culling pass test positions against it.
+//
+// The Earth is tested as the spheroid it is: positions are scaled so that it becomes the unit sphere, where
+// an object is hidden if it is both inside the cone tangent to the sphere and beyond the horizon plane.
+struct CullingViewState
+{
+    // Four sides and the near plane. There is no far plane, as it lies beyond everything in orbit.
+    static constexpr size_t kPlaneCount = 5;
+
+    std::array<glm::vec4, kPlaneCount> planes; // Normal pointing inwards, and distance
+    glm::vec3 scaledCameraPosition{ 0.0f }; // In the space where the Earth is the unit sphere
+    glm::vec3 inverseRadii{ 0.0f };
+    float horizonDistance2{ 0.0f }; // Squared distance from the camera to the horizon, in the same space
+    bool occlusionEnabled{ false }; // Only with a planet to occlude, and the camera outside it
+};
+
+// Tests positions [begin, end), given as a structure of arrays, against the view, several at a time, and
+// writes 1 to pVisibility for the visible ones and 0 for the culled ones. Both ends must be multiples of
+// F32Lanes::kWidth, so the arrays are padded to a whole number of lanes.
+void CullPositions(const CullingViewState& viewState, const float* pX, const float* pY, const float* pZ, float* pVisibility, size_t begin, size_t end);
+
+} // namespace WingsOfSteel
@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+
 #include <imgui.h>
 
 #include <core/log.hpp>
@@ -19,20 +26,86 @@
 #include "components/planet_component.hpp"
 #include "components/sector_camera_component.hpp"
 #include "components/space_object_component.hpp"
+#include "game.hpp"
 #include "sector/sector.hpp"
 #include "resources/resource.fwd.hpp"
+#include "space_objects/catalogue_file.hpp"
+#include "space_objects/flat_id_map.hpp"
 #include "space_objects/space_object.hpp"
 #include "space_objects/space_object_catalogue.hpp"
 #include "systems/camera_system.hpp"
 #include "systems/debug_render_system.hpp"
+#include "systems/gpu_propagation_system.hpp"
 #include "systems/label_system.hpp"
+#include "systems/orbit_path_system.hpp"
 #include "systems/orbit_simulation_system.hpp"
 #include "systems/planet_render_system.hpp"
+#include "systems/space_object_culling_system.hpp"
 #include "systems/space_object_render_system.hpp"
 
 namespace WingsOfSteel
 {
 
+namespace
+{
+
+// Celestrak GP groups, by the names Celestrak publishes them under, and the files they're read from. Only
+// stations.json ships with the game; the others are Celestrak's downloads saved under the same names, and
+// show up in the Catalogue menu as failing to load until they're there. Native builds also pick up any other
+// catalogue file in the directory. Groups overlap: "active" includes most of the others. Only the first is
+// loaded when the sector is created; the rest are loaded on request.
+struct CatalogueGroupSource
+{
+    const char* pName;
+    const char* pFileName; // In the celestrak directory. The format follows from the extension.
+};
+constexpr std::array<CatalogueGroupSource, 10> kCatalogueGroupSources = { {
+    { "stations", "stations.json" },
+    { "active", "active.json" },
+    { "starlink", "starlink.json" },
+    { "oneweb", "oneweb.json" },
+    { "gps-ops", "gps-ops.json" },
+    { "galileo", "galileo.json" },
+    { "cosmos-1408-debris", "cosmos-1408-debris.json" },
+    { "fengyun-1c-debris", "fengyun-1c-debris.json" },
+    { "iridium-33-debris", "iridium-33-debris.json" },
+    { "cosmos-2251-debris", "cosmos-2251-debris.json" }
+} };
+static_assert(kCatalogueGroupSources.size() <= SpaceObjectCatalogue::kMaximumGroupCount);
+
+// Small enough that a batch doesn't overshoot the frame's ingestion budget by much.
+constexpr size_t kSpaceObjectEntityBatchSize = 512;
+constexpr size_t kCatalogueMergeBatchSize = 2048; // Records are copied rather than unpacked, so these are cheaper
+
+constexpr const char* kCatalogueGroupDirectory = "/celestrak";
+
+std::string GetCatalogueGroupResourcePath(const std::string& fileName)
+{
+    return std::string(kCatalogueGroupDirectory) + "/" + fileName;
+}
+
+#if defined(TARGET_PLATFORM_NATIVE)
+std::string GetCatalogueGroupFilePath(const std::string& fileName)
+{
+    return Game::Get()->GetResourceFilePath(GetCatalogueGroupResourcePath(fileName)).string();
+}
+
+// Written after the group has been loaded, and used instead of its file for as long as it is newer.
+std::string GetCatalogueGroupSnapshotFilePath(const std::string& fileName)
+{
+    return Game::Get()->GetResourceFilePath(GetCatalogueGroupResourcePath(fileName)).replace_extension(".snapshot").string();
+}
+#endif
+
+// Element set numbers increase with every new set published for an object, but aren't present in every
+// source, so the epoch is compared as well.
+bool HasNewElementSet(const SpaceObjectView& current, const SpaceObject& reloaded)
+{
+    return current.GetEpoch() != reloaded.GetEpoch() || current.GetElementSetNumber() != reloaded.GetElementSetNumber() || current.GetObjectName() != reloaded.GetObjectName();
+}
+
+} // anonymous namespace
+
 Sector::Sector()
 {
 }
@@ -49,11 +122,14 @@ void Sector::Initialize()
     AddSystem<PhysicsSimulationSystem>();
     AddSystem<PlanetRenderSystem>();
     AddSystem<OrbitSimulationSystem>();
-    AddSystem<SpaceObjectRenderSystem>();
+    AddSystem<GpuPropagationSystem>();
 
     // Make sure these systems are added after everything else that might modify transforms,
     // otherwise the camera and debug rendering will be offset by a frame.
     AddSystem<CameraSystem>();
+    AddSystem<SpaceObjectCullingSystem>(); // Before anything drawing space objects, which only draw the visible ones
+    AddSystem<SpaceObjectRenderSystem>();
+    AddSystem<OrbitPathSystem>();
     AddSystem<DebugRenderSystem>();
     AddSystem<LabelSystem>();
 
@@ -94,6 +170,46 @@ void Sector::Initialize()
 
 void Sector::Update(float delta)
 {
+    // The clock must be advanced before the systems are updated, so they all see this frame's time.
+    m_SimulationClock.Advance(delta);
+
+#if defined(TARGET_PLATFORM_NATIVE)
+    for (size_t group = 0; group < m_CatalogueGroups.size(); ++group)
+    {
+        std::optional<CatalogueLoader::Result> load = m_CatalogueGroups[group]->loader.Poll();
+        if (load.has_value())
+        {
+            OnCatalogueGroupLoaded(group, load.value());
+        }
+    }
+
+    // Applied before the systems are updated, so the orbit simulation picks up the new element sets this frame.
+    // Reloads are diffed against the entities, so they wait until every merged object has one. Groups which
+    // are still being read don't hold them up.
+    if (!IsIngestingSpaceObjects())
+    {
+        for (size_t group = 0; group < m_CatalogueGroups.size(); ++group)
+        {
+            CatalogueGroup& catalogueGroup = *m_CatalogueGroups[group];
+            if (catalogueGroup.state != CatalogueGroupState::Loaded)
+            {
+                continue;
+            }
+
+            std::optional<CatalogueReloader::Result> reload = catalogueGroup.reloader.Poll(*Game::Get()->GetWorkerPool());
+            if (reload.has_value())
+            {
+                ApplyCatalogueReload(group, reload.value());
+            }
+        }
+    }
+#endif
+
+    // Merging and entity creation share the frame's ingestion budget.
+    const auto ingestionStartTime = std::chrono::steady_clock::now();
+    MergePendingCatalogueGroups(ingestionStartTime);
+    CreatePendingSpaceObjectEntities(ingestionStartTime);
+
     Scene::Update(delta);
 
     if (m_ShowGrid)
@@ -108,24 +224,150 @@ void Sector::Update(float delta)
 void Sector::InitializeSpaceObjectCatalogue()
 {
     m_pSpaceObjectCatalogue = std::make_unique<SpaceObjectCatalogue>();
-    
-    GetResourceSystem()->RequestResource("/celestrak/stations.json", [this](ResourceSharedPtr pResource) {
+
+    for (const CatalogueGroupSource& source : kCatalogueGroupSources)
+    {
+        RegisterCatalogueGroup(source.pName, source.pFileName);
+    }
+
+#if defined(TARGET_PLATFORM_NATIVE)
+    // Any other catalogue file in the directory, such as a TLE or CSV export, becomes a group named after it.
+    std::vector<std::filesystem::path> filePaths;
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(Game::Get()->GetResourceFilePath(kCatalogueGroupDirectory), error))
+    {
+        if (entry.is_regular_file(error) && IsCatalogueFile(entry.path().string()))
+        {
+            filePaths.push_back(entry.path());
+        }
+    }
+
+    std::sort(filePaths.begin(), filePaths.end());
+    for (const std::filesystem::path& filePath : filePaths)
+    {
+        const std::string name = filePath.stem().string();
+        const bool registered = std::any_of(m_CatalogueGroups.begin(), m_CatalogueGroups.end(), [&name](const std::unique_ptr<CatalogueGroup>& pCatalogueGroup) {
+            return pCatalogueGroup->name == name;
+        });
+        if (!registered)
+        {
+            RegisterCatalogueGroup(name, filePath.filename().string());
+        }
+    }
+#endif
+
+    LoadCatalogueGroup(0);
+}
+
+std::optional<size_t> Sector::RegisterCatalogueGroup(const std::string& name, const std::string& fileName)
+{
+    if (m_CatalogueGroups.size() == SpaceObjectCatalogue::kMaximumGroupCount)
+    {
+        Log::Error() << "Unable to register catalogue group " << name << ", as there are already " << m_CatalogueGroups.size() << ".";
+        return std::nullopt;
+    }
+
+    m_CatalogueGroups.push_back(std::make_unique<CatalogueGroup>());
+    m_CatalogueGroups.back()->name = name;
+    m_CatalogueGroups.back()->fileName = fileName;
+    return m_CatalogueGroups.size() - 1;
+}
+
+void Sector::LoadCatalogueGroup(size_t group)
+{
+    CatalogueGroup& catalogueGroup = *m_CatalogueGroups[group];
+    if (catalogueGroup.state != CatalogueGroupState::Unloaded && catalogueGroup.state != CatalogueGroupState::Failed)
+    {
+        return;
+    }
+
+    catalogueGroup.state = CatalogueGroupState::Loading;
+#if defined(TARGET_PLATFORM_NATIVE)
+    // Native builds read the file on a worker thread, streaming it straight into a catalogue of its own
+    // rather than building a DOM first, which matters for the larger groups.
+    catalogueGroup.loader.Start(*Game::Get()->GetWorkerPool(), GetCatalogueGroupFilePath(catalogueGroup.fileName), GetCatalogueGroupSnapshotFilePath(catalogueGroup.fileName));
+#else
+    RequestCatalogueGroup(group);
+#endif
+}
+
+void Sector::UnloadCatalogueGroup(size_t group)
+{
+    CatalogueGroup& catalogueGroup = *m_CatalogueGroups[group];
+    const CatalogueGroupState state = catalogueGroup.state;
+    catalogueGroup.state = CatalogueGroupState::Unloaded;
+    catalogueGroup.loader.Cancel();
+    catalogueGroup.reloader.Stop();
+    GetSystem<OrbitPathSystem>()->HideGroupOrbits(GetCatalogueGroupMask(group));
+
+    // A group which is still being merged may already have some of its objects in the catalogue.
+    const auto mergeIt = std::find_if(m_PendingMerges.begin(), m_PendingMerges.end(), [group](const PendingMerge& merge) {
+        return merge.group == group;
+    });
+    const bool merging = mergeIt != m_PendingMerges.end();
+    if (merging)
+    {
+        m_PendingMerges.erase(mergeIt);
+    }
+    if (state != CatalogueGroupState::Loaded && !merging)
+    {
+        return;
+    }
+
+    // Objects which are also in another loaded group stay, with that group's element sets.
+    std::vector<uint32_t> removed;
+    m_pSpaceObjectCatalogue->ReleaseGroups(GetCatalogueGroupMask(group), removed);
+    RetireSpaceObjectEntities(removed);
+    Log::Info() << "Unloaded catalogue group " << catalogueGroup.name << ", removing " << removed.size() << " space objects.";
+}
+
+const std::string& Sector::GetCatalogueGroupName(size_t group) const
+{
+    return m_CatalogueGroups[group]->name;
+}
+
+Sector::CatalogueGroupState Sector::GetCatalogueGroupState(size_t group) const
+{
+    return m_CatalogueGroups[group]->state;
+}
+
+SpaceObjectCatalogue::GroupMask Sector::GetCatalogueGroupMask(size_t group) const
+{
+    return SpaceObjectCatalogue::GroupMask(1) << group;
+}
+
+std::vector<uint32_t> Sector::GetCatalogueGroupNoradIds(size_t group) const
+{
+    return m_pSpaceObjectCatalogue->GetNoradIds(GetCatalogueGroupMask(group));
+}
+
+void Sector::RequestCatalogueGroup(size_t group)
+{
+    // There are no worker threads on the web, but merging and entity creation are still spread over several
+    // frames. Only OMM JSON can be read from a resource.
+    const std::string resourcePath = GetCatalogueGroupResourcePath(m_CatalogueGroups[group]->fileName);
+    GetResourceSystem()->RequestResource(resourcePath, [this, group, resourcePath](ResourceSharedPtr pResource) {
+        CatalogueGroup& catalogueGroup = *m_CatalogueGroups[group];
+        if (catalogueGroup.state != CatalogueGroupState::Loading)
+        {
+            return;
+        }
+
         ResourceDataStoreSharedPtr pResourceDataStore = std::dynamic_pointer_cast<ResourceDataStore>(pResource);
-        SpaceObjectCatalogue* pCatalogue = GetSpaceObjectCatalogue();
-        size_t successfulEntries = 0;
+        if (!pResourceDataStore)
+        {
+            Log::Error() << "Unable to load catalogue group " << catalogueGroup.name << " from " << resourcePath << ".";
+            catalogueGroup.state = CatalogueGroupState::Failed;
+            return;
+        }
+
+        SpaceObjectCatalogueUniquePtr pCatalogue = std::make_unique<SpaceObjectCatalogue>();
         for (const Json::Data& data : pResourceDataStore->Data())
         {
             SpaceObject spaceObject;
             if (spaceObject.DeserializeOMM(data))
             {
                 pCatalogue->Add(spaceObject);
-                successfulEntries++;
-
-                EntitySharedPtr pEntity = CreateEntity();
-                SpaceObjectComponent& spaceObjectComponent = pEntity->AddComponent<SpaceObjectComponent>();
-                spaceObjectComponent.AssignSpaceObject(spaceObject);
-                pEntity->AddComponent<TransformComponent>();
-                pEntity->AddComponent<LabelComponent>(spaceObject.GetObjectName());
             }
             else
             {
@@ -133,8 +375,296 @@ void Sector::InitializeSpaceObjectCatalogue()
             }
         }
 
-        Log::Info() << "Added " << successfulEntries << " to space object catalogue.";
+        MergeCatalogueGroup(group, std::move(pCatalogue));
+    });
+}
+
+void Sector::OnCatalogueGroupLoaded(size_t group, CatalogueLoader::Result& result)
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    const std::string& fileName = m_CatalogueGroups[group]->fileName;
+    if (result.mappedSnapshot)
+    {
+        Log::Info() << "Mapped " << result.pCatalogue->GetCount() << " space objects from " << GetCatalogueGroupSnapshotFilePath(fileName) << " in " << result.milliseconds << " ms.";
+    }
+    else if (!result.file.opened)
+    {
+        RequestCatalogueGroup(group);
+        return;
+    }
+    else
+    {
+        const std::string filePath = GetCatalogueGroupFilePath(fileName);
+        if (result.file.rejected > 0)
+        {
+            Log::Warning() << "Failed to deserialize " << result.file.rejected << " element sets from " << filePath;
+        }
+        if (!result.file.valid)
+        {
+            Log::Error() << "Malformed catalogue " << filePath << ", stopped after " << result.file.records << " records.";
+        }
+        else if (!result.wroteSnapshot)
+        {
+            Log::Warning() << "Failed to write space object catalogue snapshot to " << GetCatalogueGroupSnapshotFilePath(fileName);
+        }
+        Log::Info() << "Read " << result.file.records << " element sets from " << filePath << " in " << result.milliseconds << " ms.";
+    }
+
+    // Edits to the group's file while the game is running are picked up without restarting it.
+    if (!m_CatalogueGroups[group]->reloader.Watch(GetCatalogueGroupFilePath(fileName), GetCatalogueGroupSnapshotFilePath(fileName)))
+    {
+        Log::Warning() << "Unable to watch " << GetCatalogueGroupFilePath(fileName) << " for changes.";
+    }
+#endif
+
+    MergeCatalogueGroup(group, std::move(result.pCatalogue));
+}
+
+void Sector::MergeCatalogueGroup(size_t group, SpaceObjectCatalogueUniquePtr pCatalogue)
+{
+    PendingMerge& merge = m_PendingMerges.emplace_back();
+    merge.group = group;
+    merge.pCatalogue = std::move(pCatalogue);
+}
+
+void Sector::MergePendingCatalogueGroups(std::chrono::steady_clock::time_point startTime)
+{
+    // Groups are merged a batch of records at a time, one after another, until the frame's budget is spent.
+    // Objects already loaded by another group only gain this group's membership and element sets, so each
+    // still has a single entity. New objects are queued for one as soon as they're merged.
+    while (!m_PendingMerges.empty())
+    {
+        PendingMerge& merge = m_PendingMerges.front();
+        const auto batchStartTime = std::chrono::steady_clock::now();
+        const size_t pendingCount = m_PendingSpaceObjectEntities.size();
+        const size_t end = std::min(merge.cursor + kCatalogueMergeBatchSize, merge.pCatalogue->GetCount());
+        m_pSpaceObjectCatalogue->Merge(*merge.pCatalogue, merge.cursor, end, GetCatalogueGroupMask(merge.group), m_PendingSpaceObjectEntities, merge.updated);
+        merge.cursor = end;
+        merge.added += m_PendingSpaceObjectEntities.size() - pendingCount;
+        merge.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStartTime).count();
+
+        if (merge.cursor == merge.pCatalogue->GetCount())
+        {
+            CompleteCatalogueGroupMerge(merge);
+            m_PendingMerges.erase(m_PendingMerges.begin());
+        }
+
+        if (std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= m_IngestionBudget)
+        {
+            break;
+        }
+    }
+}
+
+void Sector::CompleteCatalogueGroupMerge(const PendingMerge& merge)
+{
+    // Entities of objects which gained element sets are patched once the whole group is in, so the orbit
+    // simulation picks them up.
+    const auto startTime = std::chrono::steady_clock::now();
+    if (!merge.updated.empty())
+    {
+        FlatIdMap updatedIds;
+        updatedIds.Reserve(merge.updated.size());
+        for (uint32_t noradCatalogueId : merge.updated)
+        {
+            updatedIds.Set(noradCatalogueId, 0);
+        }
+
+        entt::registry& registry = GetRegistry();
+        registry.view<const SpaceObjectComponent>().each([&registry, &updatedIds](const auto entity, const SpaceObjectComponent& spaceObjectComponent) {
+            if (updatedIds.Find(spaceObjectComponent.GetNoradCatalogueId()) != FlatIdMap::kNotFound)
+            {
+                registry.patch<SpaceObjectComponent>(entity);
+            }
+        });
+    }
+
+    CatalogueGroup& catalogueGroup = *m_CatalogueGroups[merge.group];
+    catalogueGroup.state = CatalogueGroupState::Loaded;
+    const double milliseconds = merge.milliseconds + std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    Log::Info() << "Loaded catalogue group " << catalogueGroup.name << ": " << merge.pCatalogue->GetCount() << " space objects, " << merge.added << " new, "
+                << merge.updated.size() << " updated, merged in " << milliseconds << " ms.";
+}
+
+void Sector::RetireSpaceObjectEntities(const std::vector<uint32_t>& noradCatalogueIds)
+{
+    if (noradCatalogueIds.empty())
+    {
+        return;
+    }
+
+    FlatIdMap retiredIds;
+    retiredIds.Reserve(noradCatalogueIds.size());
+    for (uint32_t noradCatalogueId : noradCatalogueIds)
+    {
+        retiredIds.Set(noradCatalogueId, 0);
+    }
+
+    // Objects still waiting for an entity no longer need one.
+    auto pendingBegin = m_PendingSpaceObjectEntities.begin() + m_PendingSpaceObjectEntityCursor;
+    m_PendingSpaceObjectEntities.erase(std::remove_if(pendingBegin, m_PendingSpaceObjectEntities.end(), [&retiredIds](uint32_t noradCatalogueId) {
+        return retiredIds.Find(noradCatalogueId) != FlatIdMap::kNotFound;
+    }), m_PendingSpaceObjectEntities.end());
+
+    const size_t retiredCount = m_RetiredSpaceObjectEntities.size();
+    entt::registry& registry = GetRegistry();
+    registry.view<const SpaceObjectComponent>().each([this, &retiredIds](const auto entity, const SpaceObjectComponent& spaceObjectComponent) {
+        if (retiredIds.Find(spaceObjectComponent.GetNoradCatalogueId()) != FlatIdMap::kNotFound)
+        {
+            m_RetiredSpaceObjectEntities.push_back(entity);
+        }
+    });
+
+    // Removed once the view is done with them.
+    for (size_t index = retiredCount; index < m_RetiredSpaceObjectEntities.size(); ++index)
+    {
+        registry.remove<LabelComponent>(m_RetiredSpaceObjectEntities[index]);
+        registry.remove<SpaceObjectComponent>(m_RetiredSpaceObjectEntities[index]);
+    }
+}
+
+void Sector::AddSpaceObject(const SpaceObject& spaceObject, SpaceObjectCatalogue::GroupMask groups)
+{
+    // Files with several element sets per object only create its entity once; the rest go into its history.
+    if (GetSpaceObjectCatalogue()->Add(spaceObject, groups))
+    {
+        m_PendingSpaceObjectEntities.push_back(spaceObject.GetNoradCatalogueId());
+    }
+}
+
+bool Sector::IsIngestingSpaceObjects() const
+{
+    return !m_PendingMerges.empty() || m_PendingSpaceObjectEntityCursor < m_PendingSpaceObjectEntities.size();
+}
+
+bool Sector::IsLoadingCatalogueGroups() const
+{
+    return std::any_of(m_CatalogueGroups.begin(), m_CatalogueGroups.end(), [](const std::unique_ptr<CatalogueGroup>& pCatalogueGroup) {
+        return pCatalogueGroup->state == CatalogueGroupState::Loading;
+    });
+}
+
+Sector::IngestionProgress Sector::GetIngestionProgress() const
+{
+    IngestionProgress progress;
+    progress.loading = IsLoadingCatalogueGroups();
+    progress.created = m_PendingSpaceObjectEntityCursor;
+    progress.total = m_PendingSpaceObjectEntities.size();
+    return progress;
+}
+
+void Sector::CreatePendingSpaceObjectEntities(std::chrono::steady_clock::time_point startTime)
+{
+    if (m_PendingSpaceObjectEntityCursor == m_PendingSpaceObjectEntities.size())
+    {
+        return;
+    }
+
+    // Entities are created in batches with one bulk insert per component, until the frame's budget is spent.
+    // Labels are left without text, as LabelSystem only draws a marker for them. Names stay in the catalogue,
+    // where SpaceObjectCatalogue::GetObjectName() reads them, rather than being copied into every entity.
+    entt::registry& registry = GetRegistry();
+    std::vector<entt::entity> entities;
+    std::vector<SpaceObjectComponent> spaceObjectComponents;
+    while (m_PendingSpaceObjectEntityCursor < m_PendingSpaceObjectEntities.size())
+    {
+        const size_t count = std::min(kSpaceObjectEntityBatchSize, m_PendingSpaceObjectEntities.size() - m_PendingSpaceObjectEntityCursor);
+        const uint32_t* pNoradIds = m_PendingSpaceObjectEntities.data() + m_PendingSpaceObjectEntityCursor;
+        m_PendingSpaceObjectEntityCursor += count;
+
+        // Retired entities already have a transform, and are used up first.
+        size_t reused = 0;
+        for (; reused < count && !m_RetiredSpaceObjectEntities.empty(); ++reused)
+        {
+            const entt::entity entity = m_RetiredSpaceObjectEntities.back();
+            m_RetiredSpaceObjectEntities.pop_back();
+            registry.emplace<SpaceObjectComponent>(entity, pNoradIds[reused]);
+            registry.emplace<LabelComponent>(entity, std::string());
+        }
+
+        entities.resize(count - reused);
+        spaceObjectComponents.assign(pNoradIds + reused, pNoradIds + count);
+        registry.create(entities.begin(), entities.end());
+        registry.insert<TransformComponent>(entities.begin(), entities.end());
+        registry.insert<LabelComponent>(entities.begin(), entities.end(), LabelComponent(std::string()));
+        registry.insert<SpaceObjectComponent>(entities.begin(), entities.end(), spaceObjectComponents.begin());
+
+        if (std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= m_IngestionBudget)
+        {
+            break;
+        }
+    }
+
+    if (m_PendingSpaceObjectEntityCursor == m_PendingSpaceObjectEntities.size())
+    {
+        Log::Info() << "Created " << m_PendingSpaceObjectEntities.size() << " space object entities.";
+        m_PendingSpaceObjectEntities.clear();
+        m_PendingSpaceObjectEntityCursor = 0;
+    }
+}
+
+void Sector::ApplyCatalogueReload(size_t group, const CatalogueReloader::Result& result)
+{
+    if (!result.file.opened || !result.file.valid)
+    {
+        Log::Warning() << "Ignoring reload of catalogue group " << m_CatalogueGroups[group]->name << ", as the file couldn't be read in full.";
+        return;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const SpaceObjectCatalogue::GroupMask groupMask = GetCatalogueGroupMask(group);
+    entt::registry& registry = GetRegistry();
+
+    m_ReloadEntries.clear();
+    registry.view<const SpaceObjectComponent>().each([this](const auto entity, const SpaceObjectComponent& spaceObjectComponent) {
+        m_ReloadEntries[spaceObjectComponent.GetNoradCatalogueId()] = { entity, false };
     });
+
+    // Only objects with a new element set are touched. Their records are replaced in place, and patching the
+    // component lets the orbit simulation update that object's slot alone.
+    size_t created = 0;
+    size_t updated = 0;
+    for (const SpaceObject& spaceObject : result.spaceObjects)
+    {
+        auto it = m_ReloadEntries.find(spaceObject.GetNoradCatalogueId());
+        if (it == m_ReloadEntries.end())
+        {
+            AddSpaceObject(spaceObject, groupMask);
+            created++;
+            continue;
+        }
+
+        it->second.seen = true;
+        const std::optional<SpaceObjectView> current = m_pSpaceObjectCatalogue->GetByNoradId(spaceObject.GetNoradCatalogueId());
+        const bool changed = !current.has_value() || HasNewElementSet(current.value(), spaceObject);
+
+        // Objects which were only in other groups until now join this one, even if their element set is the same.
+        if (changed || (m_pSpaceObjectCatalogue->GetGroups(spaceObject.GetNoradCatalogueId()) & groupMask) == 0)
+        {
+            m_pSpaceObjectCatalogue->Add(spaceObject, groupMask);
+        }
+        if (changed)
+        {
+            registry.patch<SpaceObjectComponent>(it->second.entity);
+            updated++;
+        }
+    }
+
+    // Objects which are no longer listed have decayed or been dropped from the group. Those which are still
+    // in another group are kept.
+    std::vector<uint32_t> removed;
+    for (const auto& [noradCatalogueId, entry] : m_ReloadEntries)
+    {
+        if (!entry.seen && m_pSpaceObjectCatalogue->Release(noradCatalogueId, groupMask))
+        {
+            removed.push_back(noradCatalogueId);
+        }
+    }
+    RetireSpaceObjectEntities(removed);
+
+    const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    Log::Info() << "Reloaded catalogue group " << m_CatalogueGroups[group]->name << ": " << created << " added, " << updated << " updated, " << removed.size() << " removed in "
+                << milliseconds << " ms (" << result.milliseconds << " ms reading in the background).";
 }
 
 void Sector::ShowCameraDebugUI(bool state)
@@ -1,15 +1,28 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <glm/vec3.hpp>
 
 #include <core/signal.hpp>
 #include <core/smart_ptr.hpp>
 #include <scene/scene.hpp>
 
+#include "sector/simulation_clock.hpp"
+#include "space_objects/catalogue_loader.hpp"
+#include "space_objects/catalogue_reloader.hpp"
+#include "space_objects/space_object_catalogue.hpp"
+
 namespace WingsOfSteel
 {
 
-DECLARE_SMART_PTR(SpaceObjectCatalogue);
+class SpaceObject;
 
 DECLARE_SMART_PTR(Sector);
 class Sector : public Scene
@@ -25,13 +38,98 @@ public:
     void ShowGrid(bool state);
 
     SpaceObjectCatalogue* GetSpaceObjectCatalogue() { return m_pSpaceObjectCatalogue.get(); }
+    SimulationClock& GetSimulationClock() { return m_SimulationClock; }
+    const SimulationClock& GetSimulationClock() const { return m_SimulationClock; }
+
+    // The catalogue is loaded in the background, and entities are then created for its objects a batch at a
+    // time, spending at most the ingestion budget each frame.
+    struct IngestionProgress
+    {
+        bool loading{ false }; // Still reading the catalogue
+        size_t created{ 0 };
+        size_t total{ 0 }; // Entities waiting to be created, including those already created
+    };
+
+    // Catalogue groups are sources of space objects, such as Celestrak's "starlink" group, which are loaded
+    // and unloaded as they're needed. Objects listed in several groups are only loaded once, and are
+    // removed when the last group they're in is unloaded.
+    enum class CatalogueGroupState
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+        Failed // The file couldn't be read, e.g. because it hasn't been downloaded. Loading it again retries.
+    };
+    // The file is in the celestrak directory, and may be OMM JSON, OMM CSV or TLE/3LE.
+    std::optional<size_t> RegisterCatalogueGroup(const std::string& name, const std::string& fileName);
+    void LoadCatalogueGroup(size_t group);
+    void UnloadCatalogueGroup(size_t group);
+    size_t GetCatalogueGroupCount() const { return m_CatalogueGroups.size(); }
+    const std::string& GetCatalogueGroupName(size_t group) const;
+    CatalogueGroupState GetCatalogueGroupState(size_t group) const;
+    SpaceObjectCatalogue::GroupMask GetCatalogueGroupMask(size_t group) const; // The group's bit in the catalogue's masks
+    std::vector<uint32_t> GetCatalogueGroupNoradIds(size_t group) const; // Objects loaded from the group so far
+
+    bool IsIngestingSpaceObjects() const;
+    IngestionProgress GetIngestionProgress() const;
+    float GetIngestionBudget() const { return m_IngestionBudget; }
+    void SetIngestionBudget(float milliseconds) { m_IngestionBudget = milliseconds; }
 
 private:
     void DrawCameraDebugUI();
     void SpawnLight();
     void InitializeSpaceObjectCatalogue();
+    bool IsLoadingCatalogueGroups() const;
+    void RequestCatalogueGroup(size_t group);
+    void OnCatalogueGroupLoaded(size_t group, CatalogueLoader::Result& result);
+    void MergeCatalogueGroup(size_t group, SpaceObjectCatalogueUniquePtr pCatalogue);
+    void MergePendingCatalogueGroups(std::chrono::steady_clock::time_point startTime);
+    void AddSpaceObject(const SpaceObject& spaceObject, SpaceObjectCatalogue::GroupMask groups);
+    void CreatePendingSpaceObjectEntities(std::chrono::steady_clock::time_point startTime);
+    void RetireSpaceObjectEntities(const std::vector<uint32_t>& noradCatalogueIds);
+    void ApplyCatalogueReload(size_t group, const CatalogueReloader::Result& result);
 
     SpaceObjectCatalogueUniquePtr m_pSpaceObjectCatalogue;
+    SimulationClock m_SimulationClock;
+
+    struct CatalogueGroup
+    {
+        std::string name;
+        std::string fileName;
+        CatalogueGroupState state{ CatalogueGroupState::Unloaded };
+        CatalogueLoader loader;
+        CatalogueReloader reloader; // Watches the group's file once it's loaded
+    };
+    std::vector<std::unique_ptr<CatalogueGroup>> m_CatalogueGroups; // Indexed by the group's bit in the catalogue's masks
+
+    // Groups which have been read, waiting to be merged into the catalogue, in the order they were read.
+    struct PendingMerge
+    {
+        size_t group{ 0 };
+        SpaceObjectCatalogueUniquePtr pCatalogue;
+        size_t cursor{ 0 }; // Records merged so far
+        size_t added{ 0 };
+        std::vector<uint32_t> updated;
+        double milliseconds{ 0.0 };
+    };
+    void CompleteCatalogueGroupMerge(const PendingMerge& merge);
+    std::vector<PendingMerge> m_PendingMerges;
+
+    // NORAD catalogue IDs of the objects waiting for an entity, and how many of them already have one.
+    std::vector<uint32_t> m_PendingSpaceObjectEntities;
+    size_t m_PendingSpaceObjectEntityCursor{ 0 };
+    float m_IngestionBudget{ 4.0f }; // ms per frame
+
+    // Entities whose space objects are no longer in the catalogue. They keep their transform and are handed
+    // to the next new space object, rather than being destroyed and created again.
+    std::vector<entt::entity> m_RetiredSpaceObjectEntities;
+
+    struct ReloadEntry
+    {
+        entt::entity entity;
+        bool seen;
+    };
+    std::unordered_map<uint32_t, ReloadEntry> m_ReloadEntries; // By NORAD catalogue ID, kept to reuse its buckets
     EntitySharedPtr m_pCamera;
     EntitySharedPtr m_pLight;
     EntitySharedPtr m_pEarth;
@@ -0,0 +1,50 @@
+#include <algorithm>
+
+#include "sector/simulation_clock.hpp"
+
+namespace WingsOfSteel
+{
+
+SimulationClock::SimulationClock()
+{
+    JumpToNow();
+}
+
+SimulationClock::~SimulationClock()
+{
+}
+
+void SimulationClock::Advance(float delta)
+{
+    if (!m_Paused)
+    {
+        m_Time += static_cast<double>(delta) * m_TimeScale;
+    }
+}
+
+std::chrono::system_clock::time_point SimulationClock::GetTimePoint() const
+{
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(m_Time)));
+}
+
+void SimulationClock::JumpTo(double time)
+{
+    m_Time = time;
+}
+
+void SimulationClock::JumpTo(std::chrono::system_clock::time_point timePoint)
+{
+    m_Time = std::chrono::duration<double>(timePoint.time_since_epoch()).count();
+}
+
+void SimulationClock::JumpToNow()
+{
+    JumpTo(std::chrono::system_clock::now());
+}
+
+void SimulationClock::SetTimeScale(double timeScale)
+{
+    m_TimeScale = std::clamp(timeScale, kMinimumTimeScale, kMaximumTimeScale);
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+
+namespace WingsOfSteel
+{
+
+// Shared simulation time for a sector.
+// The clock is advanced exactly once per frame, before any systems are updated, so every time-dependent
+// system sees the same instant for the whole frame. It starts at the current wall-clock time and can be
+// accelerated, paused or moved to an arbitrary instant, which allows the catalogue to be replayed or
+// fast-forwarded.
+class SimulationClock
+{
+public:
+    static constexpr double kMinimumTimeScale = 1.0;
+    static constexpr double kMaximumTimeScale = 100000.0;
+
+    SimulationClock();
+    ~SimulationClock();
+
+    // Advances the simulation by the given amount of real time, scaled by the time scale.
+    void Advance(float delta);
+
+    // Seconds since the Unix epoch.
+    double GetTime() const { return m_Time; }
+    std::chrono::system_clock::time_point GetTimePoint() const;
+
+    void JumpTo(double time);
+    void JumpTo(std::chrono::system_clock::time_point timePoint);
+    void JumpToNow();
+
+    double GetTimeScale() const { return m_TimeScale; }
+    void SetTimeScale(double timeScale);
+
+    bool IsPaused() const { return m_Paused; }
+    void SetPaused(bool paused) { m_Paused = paused; }
+
+private:
+    double m_Time{ 0.0 };
+    double m_TimeScale{ 1.0 };
+    bool m_Paused{ false };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,81 @@
+#include <filesystem>
+#include <optional>
+
+#include "space_objects/catalogue_file.hpp"
+#include "space_objects/mapped_file.hpp"
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/omm_json_reader.hpp"
+#include "space_objects/tle_reader.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+enum class CatalogueFileFormat
+{
+    OmmJson,
+    OmmCsv,
+    Tle
+};
+
+std::optional<CatalogueFileFormat> GetCatalogueFileFormat(const std::string& filePath)
+{
+    const std::string extension = std::filesystem::path(filePath).extension().string();
+    if (extension == ".tle" || extension == ".3le" || extension == ".txt")
+    {
+        return CatalogueFileFormat::Tle;
+    }
+    else if (extension == ".csv")
+    {
+        return CatalogueFileFormat::OmmCsv;
+    }
+    else if (extension == ".json")
+    {
+        return CatalogueFileFormat::OmmJson;
+    }
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
+CatalogueFileResult ReadCatalogueFile(const std::string& filePath, WorkerPool* pWorkerPool, const ElementSetCallback& onRecord)
+{
+    CatalogueFileResult result;
+    MappedFile file;
+    if (!file.Open(filePath))
+    {
+        return result;
+    }
+    result.opened = true;
+
+    // Files with an unknown extension are read as JSON, as they always were.
+    const CatalogueFileFormat format = GetCatalogueFileFormat(filePath).value_or(CatalogueFileFormat::OmmJson);
+    ElementSetReadResult readResult;
+    if (format == CatalogueFileFormat::Tle)
+    {
+        readResult = pWorkerPool ? TleReader::ReadParallel(file.GetText(), *pWorkerPool, onRecord) : TleReader::Read(file.GetText(), onRecord);
+    }
+    else if (format == CatalogueFileFormat::OmmCsv)
+    {
+        readResult = pWorkerPool ? OmmCsvReader::ReadParallel(file.GetText(), *pWorkerPool, onRecord) : OmmCsvReader::Read(file.GetText(), onRecord);
+    }
+    else
+    {
+        const OmmJsonReader::Result jsonResult = OmmJsonReader::Read(file.GetText(), onRecord);
+        readResult = { jsonResult.records, jsonResult.rejected };
+        result.valid = jsonResult.valid;
+    }
+
+    result.records = readResult.records;
+    result.rejected = readResult.rejected;
+    return result;
+}
+
+bool IsCatalogueFile(const std::string& filePath)
+{
+    return GetCatalogueFileFormat(filePath).has_value();
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "space_objects/element_set_parsing.hpp"
+
+namespace WingsOfSteel
+{
+
+struct CatalogueFileResult
+{
+    size_t records{ 0 }; // Records passed to the callback
+    size_t rejected{ 0 }; // Records which were malformed or missing a required field
+    bool opened{ false };
+    bool valid{ true }; // False if the file is malformed past the point of recovering further records
+};
+
+// Reads a catalogue file in any of the supported formats, picked from its extension: OMM JSON, OMM CSV,
+// or TLE/3LE (.tle, .3le or .txt). The file is memory mapped rather than read into a buffer. CSV and TLE
+// files are read in parallel when a worker pool is given.
+CatalogueFileResult ReadCatalogueFile(const std::string& filePath, WorkerPool* pWorkerPool, const ElementSetCallback& onRecord);
+
+// Whether the file's extension is one ReadCatalogueFile() reads.
+bool IsCatalogueFile(const std::string& filePath);
+
+} // namespace WingsOfSteel
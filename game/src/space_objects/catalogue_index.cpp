@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+#include "space_objects/catalogue_index.hpp"
+#include "space_objects/space_object.hpp"
+#include "space_objects/space_object_view.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr double kMu = 398600.4418; // km³/s²
+constexpr double kEarthRadius = 6378.137; // km
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr float kLowEarthOrbitCeiling = 2000.0f; // km
+constexpr float kGeostationaryBandFloor = 35286.0f; // km
+constexpr float kGeostationaryBandCeiling = 36286.0f; // km
+
+std::string ToUpper(std::string_view text)
+{
+    std::string result(text);
+    for (char& c : result)
+    {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+// The semi-major axis follows from the mean motion by Kepler's third law.
+void GetApsisAltitudes(float meanMotionRevolutionsPerDay, float eccentricity, float& perigeeAltitude, float& apogeeAltitude)
+{
+    const double meanMotion = meanMotionRevolutionsPerDay * 2.0 * kPi / 86400.0; // rad/s
+    if (meanMotion <= 0.0)
+    {
+        perigeeAltitude = std::numeric_limits<float>::max();
+        apogeeAltitude = std::numeric_limits<float>::max();
+        return;
+    }
+
+    const double semiMajorAxis = std::cbrt(kMu / (meanMotion * meanMotion));
+    perigeeAltitude = static_cast<float>(semiMajorAxis * (1.0 - eccentricity) - kEarthRadius);
+    apogeeAltitude = static_cast<float>(semiMajorAxis * (1.0 + eccentricity) - kEarthRadius);
+}
+
+} // anonymous namespace
+
+CatalogueIndex::CatalogueIndex()
+{
+}
+
+CatalogueIndex::~CatalogueIndex()
+{
+}
+
+void CatalogueIndex::Insert(const SpaceObject& spaceObject)
+{
+    InsertEntry(spaceObject.GetNoradCatalogueId(), spaceObject.GetObjectName(), spaceObject.GetObjectId(), spaceObject.GetInclination(), spaceObject.GetMeanMotion(), spaceObject.GetEccentricity());
+}
+
+void CatalogueIndex::Insert(const SpaceObjectView& spaceObject)
+{
+    InsertEntry(spaceObject.GetNoradCatalogueId(), spaceObject.GetObjectName(), spaceObject.GetObjectId(), spaceObject.GetInclination(), spaceObject.GetMeanMotion(), spaceObject.GetEccentricity());
+}
+
+void CatalogueIndex::InsertEntry(uint32_t noradId, std::string_view name, std::string_view objectId, float inclination, float meanMotion, float eccentricity)
+{
+    Erase(noradId);
+
+    Entry entry;
+    entry.name = ToUpper(name);
+    entry.objectId = objectId;
+    entry.inclination = inclination;
+    GetApsisAltitudes(meanMotion, eccentricity, entry.perigeeAltitude, entry.apogeeAltitude);
+
+    m_Names.emplace(entry.name, noradId);
+    m_ObjectIds[entry.objectId] = noradId;
+    m_PerigeeAltitudes.emplace(entry.perigeeAltitude, noradId);
+    m_ApogeeAltitudes.emplace(entry.apogeeAltitude, noradId);
+    m_Inclinations.emplace(entry.inclination, noradId);
+    m_Entries.emplace(noradId, std::move(entry));
+}
+
+void CatalogueIndex::Erase(uint32_t noradId)
+{
+    auto it = m_Entries.find(noradId);
+    if (it == m_Entries.end())
+    {
+        return;
+    }
+
+    const Entry& entry = it->second;
+    m_Names.erase({ entry.name, noradId });
+    m_PerigeeAltitudes.erase({ entry.perigeeAltitude, noradId });
+    m_ApogeeAltitudes.erase({ entry.apogeeAltitude, noradId });
+    m_Inclinations.erase({ entry.inclination, noradId });
+
+    // COSPAR IDs aren't guaranteed to be unique, so another object may have taken this one over since.
+    auto objectIdIt = m_ObjectIds.find(entry.objectId);
+    if (objectIdIt != m_ObjectIds.end() && objectIdIt->second == noradId)
+    {
+        m_ObjectIds.erase(objectIdIt);
+    }
+
+    m_Entries.erase(it);
+}
+
+void CatalogueIndex::Clear()
+{
+    m_Entries.clear();
+    m_Names.clear();
+    m_ObjectIds.clear();
+    m_PerigeeAltitudes.clear();
+    m_ApogeeAltitudes.clear();
+    m_Inclinations.clear();
+}
+
+void CatalogueIndex::FindByNamePrefix(std::string_view prefix, size_t maximumCount, std::vector<uint32_t>& noradIds) const
+{
+    const std::string key = ToUpper(prefix);
+    for (auto it = m_Names.lower_bound({ key, 0 }); it != m_Names.end() && noradIds.size() < maximumCount; ++it)
+    {
+        if (it->first.compare(0, key.size(), key) != 0)
+        {
+            break;
+        }
+        noradIds.push_back(it->second);
+    }
+}
+
+std::optional<uint32_t> CatalogueIndex::FindByObjectId(std::string_view objectId) const
+{
+    auto it = m_ObjectIds.find(std::string(objectId));
+    if (it == m_ObjectIds.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void CatalogueIndex::FindByRegime(OrbitalRegime regime, std::vector<uint32_t>& noradIds) const
+{
+    // The ranges are inclusive and Other's include GEO's, so the candidates are classified again.
+    const size_t begin = noradIds.size();
+    FindInRanges(GetRegimeQuery(regime), noradIds);
+    noradIds.erase(std::remove_if(noradIds.begin() + begin, noradIds.end(), [this, regime](uint32_t noradId) {
+        const Entry& entry = m_Entries.at(noradId);
+        return GetRegimeByAltitude(entry.perigeeAltitude, entry.apogeeAltitude) != regime;
+    }), noradIds.end());
+}
+
+void CatalogueIndex::FindInRanges(const RangeQuery& query, std::vector<uint32_t>& noradIds) const
+{
+    struct Candidates
+    {
+        OrderedIndex::const_iterator begin;
+        OrderedIndex::const_iterator end;
+    };
+
+    std::array<Candidates, 3> candidates;
+    size_t candidateCount = 0;
+    auto addCandidates = [&candidates, &candidateCount](const OrderedIndex& index, const std::optional<Range>& range) {
+        if (range.has_value())
+        {
+            candidates[candidateCount++] = { index.lower_bound({ range->minimum, 0 }), index.upper_bound({ range->maximum, std::numeric_limits<uint32_t>::max() }) };
+        }
+    };
+    addCandidates(m_PerigeeAltitudes, query.perigeeAltitude);
+    addCandidates(m_ApogeeAltitudes, query.apogeeAltitude);
+    addCandidates(m_Inclinations, query.inclination);
+    if (candidateCount == 0)
+    {
+        return;
+    }
+
+    // Tree iterators can't be subtracted, so the smallest range is found by stepping through all of them
+    // together until one runs out. That costs no more than walking the smallest range again.
+    size_t smallest = 0;
+    std::array<OrderedIndex::const_iterator, 3> cursors;
+    for (size_t i = 0; i < candidateCount; ++i)
+    {
+        cursors[i] = candidates[i].begin;
+    }
+    for (bool exhausted = false; !exhausted;)
+    {
+        for (size_t i = 0; i < candidateCount; ++i)
+        {
+            if (cursors[i] == candidates[i].end)
+            {
+                smallest = i;
+                exhausted = true;
+                break;
+            }
+            ++cursors[i];
+        }
+    }
+
+    auto inRange = [](float value, const std::optional<Range>& range) {
+        return !range.has_value() || (value >= range->minimum && value <= range->maximum);
+    };
+    for (auto it = candidates[smallest].begin; it != candidates[smallest].end; ++it)
+    {
+        const Entry& entry = m_Entries.at(it->second);
+        if (inRange(entry.perigeeAltitude, query.perigeeAltitude) && inRange(entry.apogeeAltitude, query.apogeeAltitude) && inRange(entry.inclination, query.inclination))
+        {
+            noradIds.push_back(it->second);
+        }
+    }
+}
+
+CatalogueIndex::RangeQuery CatalogueIndex::GetRegimeQuery(OrbitalRegime regime)
+{
+    constexpr float kLowest = std::numeric_limits<float>::lowest();
+    constexpr float kHighest = std::numeric_limits<float>::max();
+
+    RangeQuery query;
+    switch (regime)
+    {
+    case OrbitalRegime::LEO:
+        query.apogeeAltitude = Range{ kLowest, kLowEarthOrbitCeiling };
+        break;
+    case OrbitalRegime::MEO:
+        query.perigeeAltitude = Range{ kLowEarthOrbitCeiling, kHighest };
+        query.apogeeAltitude = Range{ kLowest, kGeostationaryBandFloor };
+        break;
+    case OrbitalRegime::GEO:
+        query.perigeeAltitude = Range{ kGeostationaryBandFloor, kGeostationaryBandCeiling };
+        query.apogeeAltitude = Range{ kGeostationaryBandFloor, kGeostationaryBandCeiling };
+        break;
+    case OrbitalRegime::HEO:
+        query.perigeeAltitude = Range{ kLowest, kLowEarthOrbitCeiling };
+        query.apogeeAltitude = Range{ kLowEarthOrbitCeiling, kHighest };
+        break;
+    case OrbitalRegime::Other:
+        query.perigeeAltitude = Range{ kLowEarthOrbitCeiling, kHighest };
+        query.apogeeAltitude = Range{ kGeostationaryBandFloor, kHighest };
+        break;
+    }
+    return query;
+}
+
+OrbitalRegime CatalogueIndex::GetRegime(const SpaceObject& spaceObject)
+{
+    return GetRegime(spaceObject.GetMeanMotion(), spaceObject.GetEccentricity());
+}
+
+OrbitalRegime CatalogueIndex::GetRegime(float meanMotion, float eccentricity)
+{
+    float perigeeAltitude;
+    float apogeeAltitude;
+    GetApsisAltitudes(meanMotion, eccentricity, perigeeAltitude, apogeeAltitude);
+    return GetRegimeByAltitude(perigeeAltitude, apogeeAltitude);
+}
+
+OrbitalRegime CatalogueIndex::GetRegimeByAltitude(float perigeeAltitude, float apogeeAltitude)
+{
+    // Each test only sees the orbits which all of the earlier ones let through, so there are no gaps.
+    if (apogeeAltitude < kLowEarthOrbitCeiling)
+    {
+        return OrbitalRegime::LEO;
+    }
+    else if (perigeeAltitude < kLowEarthOrbitCeiling)
+    {
+        return OrbitalRegime::HEO;
+    }
+    else if (apogeeAltitude < kGeostationaryBandFloor)
+    {
+        return OrbitalRegime::MEO;
+    }
+    else if (perigeeAltitude >= kGeostationaryBandFloor && apogeeAltitude <= kGeostationaryBandCeiling)
+    {
+        return OrbitalRegime::GEO;
+    }
+    return OrbitalRegime::Other;
+}
+
+} // namespace WingsOfSteel
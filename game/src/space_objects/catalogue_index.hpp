@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+class SpaceObjectView;
+
+// Broad classes of orbit, by perigee and apogee altitude. Every orbit is in exactly one of them.
+enum class OrbitalRegime
+{
+    LEO, // Apogee below 2000 km
+    MEO, // Perigee above 2000 km, apogee below the GEO band
+    GEO, // Perigee and apogee within the GEO band, 35286 to 36286 km
+    HEO, // Perigee below 2000 km, apogee above it (Molniya, GTO)
+    Other // Perigee above 2000 km, apogee in or beyond the GEO band, but not both in it (graveyard orbits)
+};
+
+// Secondary indexes over a space object catalogue, mapping to NORAD catalogue IDs:
+// - names, upper-cased and sorted, for prefix searches;
+// - COSPAR IDs, hashed;
+// - perigee altitude, apogee altitude and inclination, sorted, for range queries.
+// Ordered indexes are balanced trees rather than sorted arrays, so objects can be inserted, replaced and
+// erased one at a time in logarithmic time as new element sets arrive.
+class CatalogueIndex
+{
+public:
+    struct Range
+    {
+        float minimum;
+        float maximum; // Inclusive
+    };
+
+    // Objects must fall within every range which is set.
+    struct RangeQuery
+    {
+        std::optional<Range> perigeeAltitude; // km
+        std::optional<Range> apogeeAltitude; // km
+        std::optional<Range> inclination; // deg
+    };
+
+    CatalogueIndex();
+    ~CatalogueIndex();
+
+    // Adds an object, or replaces the one with the same NORAD catalogue ID.
+    void Insert(const SpaceObject& spaceObject);
+    void Insert(const SpaceObjectView& spaceObject);
+    void Erase(uint32_t noradId);
+    void Clear();
+    size_t GetCount() const { return m_Entries.size(); }
+
+    // Case-insensitive. Results are in name order, and stop after maximumCount.
+    void FindByNamePrefix(std::string_view prefix, size_t maximumCount, std::vector<uint32_t>& noradIds) const;
+    std::optional<uint32_t> FindByObjectId(std::string_view objectId) const;
+    void FindByRegime(OrbitalRegime regime, std::vector<uint32_t>& noradIds) const;
+    void FindInRanges(const RangeQuery& query, std::vector<uint32_t>& noradIds) const;
+
+    // The ranges of a regime. GEO is carved out of Other's ranges, so objects in them still have to be
+    // checked with GetRegime(), as FindByRegime() does.
+    static RangeQuery GetRegimeQuery(OrbitalRegime regime);
+
+    static OrbitalRegime GetRegime(const SpaceObject& spaceObject);
+    static OrbitalRegime GetRegime(float meanMotion, float eccentricity); // rev/day
+
+private:
+    void InsertEntry(uint32_t noradId, std::string_view name, std::string_view objectId, float inclination, float meanMotion, float eccentricity);
+    static OrbitalRegime GetRegimeByAltitude(float perigeeAltitude, float apogeeAltitude);
+
+    using OrderedIndex = std::set<std::pair<float, uint32_t>>;
+
+    struct Entry
+    {
+        std::string name; // Upper-cased
+        std::string objectId;
+        float perigeeAltitude;
+        float apogeeAltitude;
+        float inclination;
+    };
+
+    std::unordered_map<uint32_t, Entry> m_Entries;
+    std::set<std::pair<std::string, uint32_t>> m_Names;
+    std::unordered_map<std::string, uint32_t> m_ObjectIds;
+    OrderedIndex m_PerigeeAltitudes;
+    OrderedIndex m_ApogeeAltitudes;
+    OrderedIndex m_Inclinations;
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <filesystem>
+
+#include "jobs/worker_pool.hpp"
+#include "space_objects/catalogue_loader.hpp"
+
+namespace WingsOfSteel
+{
+
+CatalogueLoader::CatalogueLoader()
+{
+}
+
+CatalogueLoader::~CatalogueLoader()
+{
+}
+
+void CatalogueLoader::Start(WorkerPool& workerPool, const std::string& filePath, const std::string& snapshotFilePath)
+{
+    m_pPendingLoad = std::make_shared<PendingLoad>();
+    workerPool.Submit([&workerPool, pPendingLoad = m_pPendingLoad, filePath, snapshotFilePath]() {
+        Load(workerPool, filePath, snapshotFilePath, *pPendingLoad);
+    });
+}
+
+void CatalogueLoader::Cancel()
+{
+    m_pPendingLoad.reset();
+}
+
+std::optional<CatalogueLoader::Result> CatalogueLoader::Poll()
+{
+    if (!m_pPendingLoad)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<Result> result;
+    {
+        std::lock_guard<std::mutex> lock(m_pPendingLoad->mutex);
+        result = std::move(m_pPendingLoad->result);
+    }
+
+    if (result.has_value())
+    {
+        m_pPendingLoad.reset();
+    }
+    return result;
+}
+
+void CatalogueLoader::Load(WorkerPool& workerPool, const std::string& filePath, const std::string& snapshotFilePath, PendingLoad& pendingLoad)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    Result result;
+    result.pCatalogue = std::make_unique<SpaceObjectCatalogue>();
+    result.mappedSnapshot = IsSnapshotCurrent(snapshotFilePath, filePath) && result.pCatalogue->MapSnapshot(snapshotFilePath);
+    if (!result.mappedSnapshot)
+    {
+        // Tasks may use the pool themselves: ParallelFor() callers run chunks, so this can't deadlock.
+        SpaceObjectCatalogue* pCatalogue = result.pCatalogue.get();
+        result.file = ReadCatalogueFile(filePath, &workerPool, [pCatalogue](const SpaceObject& spaceObject) {
+            pCatalogue->Add(spaceObject);
+        });
+
+        if (result.file.opened && result.file.valid && !snapshotFilePath.empty())
+        {
+            result.wroteSnapshot = result.pCatalogue->WriteSnapshot(snapshotFilePath);
+        }
+    }
+
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::lock_guard<std::mutex> lock(pendingLoad.mutex);
+    pendingLoad.result = std::move(result);
+}
+
+bool CatalogueLoader::IsSnapshotCurrent(const std::string& snapshotFilePath, const std::string& sourceFilePath)
+{
+    // A snapshot is only trusted while it's newer than the file it was built from.
+    std::error_code error;
+    const std::filesystem::file_time_type snapshotTime = std::filesystem::last_write_time(snapshotFilePath, error);
+    if (error)
+    {
+        return false;
+    }
+    const std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourceFilePath, error);
+    return error || sourceTime < snapshotTime;
+}
+
+} // namespace WingsOfSteel
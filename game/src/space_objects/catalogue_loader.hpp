@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "space_objects/catalogue_file.hpp"
+#include "space_objects/space_object_catalogue.hpp"
+
+namespace WingsOfSteel
+{
+
+class WorkerPool;
+
+// Builds a space object catalogue on a background task, so the main thread only has to take it over once
+// it's ready. The snapshot is mapped if it's newer than the catalogue file; otherwise the file is read and
+// a new snapshot written from it, both on the same task.
+class CatalogueLoader
+{
+public:
+    struct Result
+    {
+        SpaceObjectCatalogueUniquePtr pCatalogue;
+        CatalogueFileResult file; // Empty if the snapshot was mapped
+        bool mappedSnapshot{ false };
+        bool wroteSnapshot{ false };
+        double milliseconds{ 0.0 }; // Time taken to load, off the main thread
+    };
+
+    CatalogueLoader();
+    ~CatalogueLoader();
+
+    void Start(WorkerPool& workerPool, const std::string& filePath, const std::string& snapshotFilePath);
+
+    // Forgets the load in progress. The task runs to completion, but its result is dropped.
+    void Cancel();
+
+    // Returns the catalogue once the load is done, exactly once.
+    std::optional<Result> Poll();
+    bool IsLoading() const { return m_pPendingLoad != nullptr; }
+
+private:
+    struct PendingLoad
+    {
+        std::mutex mutex;
+        std::optional<Result> result; // Set by the background task when it is done
+    };
+
+    static void Load(WorkerPool& workerPool, const std::string& filePath, const std::string& snapshotFilePath, PendingLoad& pendingLoad);
+    static bool IsSnapshotCurrent(const std::string& snapshotFilePath, const std::string& sourceFilePath);
+
+    // Shared with the task, which may still be running after the loader is gone.
+    std::shared_ptr<PendingLoad> m_pPendingLoad;
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+
+#include "jobs/worker_pool.hpp"
+#include "space_objects/catalogue_reloader.hpp"
+#include "space_objects/catalogue_snapshot.hpp"
+
+namespace WingsOfSteel
+{
+
+CatalogueReloader::CatalogueReloader()
+{
+}
+
+CatalogueReloader::~CatalogueReloader()
+{
+}
+
+bool CatalogueReloader::Watch(const std::string& filePath, const std::string& snapshotFilePath)
+{
+    m_FilePath = filePath;
+    m_SnapshotFilePath = snapshotFilePath;
+    return m_Watcher.Watch(filePath);
+}
+
+void CatalogueReloader::Stop()
+{
+    m_Watcher.Stop();
+    m_pPendingReload.reset();
+    m_ChangedDuringReload = false;
+}
+
+std::optional<CatalogueReloader::Result> CatalogueReloader::Poll(WorkerPool& workerPool)
+{
+    const bool changed = m_Watcher.HasChanged();
+    std::optional<Result> result;
+    if (m_pPendingReload)
+    {
+        std::lock_guard<std::mutex> lock(m_pPendingReload->mutex);
+        if (!m_pPendingReload->result.has_value())
+        {
+            m_ChangedDuringReload = m_ChangedDuringReload || changed;
+            return std::nullopt;
+        }
+        result = std::move(m_pPendingReload->result);
+    }
+
+    if (result.has_value())
+    {
+        m_pPendingReload.reset();
+    }
+
+    if (changed || m_ChangedDuringReload)
+    {
+        m_ChangedDuringReload = false;
+        m_pPendingReload = std::make_shared<PendingReload>();
+        workerPool.Submit([pPendingReload = m_pPendingReload, filePath = m_FilePath, snapshotFilePath = m_SnapshotFilePath]() {
+            Reload(filePath, snapshotFilePath, *pPendingReload);
+        });
+    }
+
+    return result;
+}
+
+void CatalogueReloader::Reload(const std::string& filePath, const std::string& snapshotFilePath, PendingReload& pendingReload)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    Result result;
+    result.file = ReadCatalogueFile(filePath, nullptr, [&result](const SpaceObject& spaceObject) {
+        result.spaceObjects.push_back(spaceObject);
+    });
+
+    // Later element sets for the same object replace earlier ones, as they would in the catalogue.
+    std::stable_sort(result.spaceObjects.begin(), result.spaceObjects.end(), [](const SpaceObject& a, const SpaceObject& b) {
+        return a.GetNoradCatalogueId() < b.GetNoradCatalogueId();
+    });
+    auto last = std::unique(result.spaceObjects.rbegin(), result.spaceObjects.rend(), [](const SpaceObject& a, const SpaceObject& b) {
+        return a.GetNoradCatalogueId() == b.GetNoradCatalogueId();
+    });
+    result.spaceObjects.erase(result.spaceObjects.begin(), last.base());
+
+    if (result.file.opened && result.file.valid && !snapshotFilePath.empty())
+    {
+        std::vector<const SpaceObject*> spaceObjects;
+        spaceObjects.reserve(result.spaceObjects.size());
+        for (const SpaceObject& spaceObject : result.spaceObjects)
+        {
+            spaceObjects.push_back(&spaceObject);
+        }
+        CatalogueSnapshot::Write(snapshotFilePath, spaceObjects);
+    }
+
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::lock_guard<std::mutex> lock(pendingReload.mutex);
+    pendingReload.result = std::move(result);
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "space_objects/catalogue_file.hpp"
+#include "space_objects/file_watcher.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+class WorkerPool;
+
+// Watches a catalogue file and re-reads it on a background task whenever it changes, so only applying the
+// differences is left to the main thread. The snapshot, if there is one, is rewritten from the new records
+// on the same task.
+class CatalogueReloader
+{
+public:
+    struct Result
+    {
+        std::vector<SpaceObject> spaceObjects; // One per NORAD catalogue ID, the last one in the file
+        CatalogueFileResult file;
+        double milliseconds{ 0.0 }; // Time taken to read the file, off the main thread
+    };
+
+    CatalogueReloader();
+    ~CatalogueReloader();
+
+    bool Watch(const std::string& filePath, const std::string& snapshotFilePath);
+    void Stop();
+
+    // Called every frame. Starts a reload when the file has changed, and returns its result once it is done.
+    // Changes made while a reload is running trigger another as soon as it finishes.
+    std::optional<Result> Poll(WorkerPool& workerPool);
+
+private:
+    struct PendingReload
+    {
+        std::mutex mutex;
+        std::optional<Result> result; // Set by the background task when it is done
+    };
+
+    static void Reload(const std::string& filePath, const std::string& snapshotFilePath, PendingReload& pendingReload);
+
+    FileWatcher m_Watcher;
+    std::string m_FilePath;
+    std::string m_SnapshotFilePath;
+
+    // Shared with the task, which may still be running after the reloader is gone.
+    std::shared_ptr<PendingReload> m_pPendingReload;
+    bool m_ChangedDuringReload{ false };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+#include "space_objects/catalogue_snapshot.hpp"
+#include "space_objects/space_object.hpp"
+#include "space_objects/space_object_view.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr uint32_t kAbsentInteger = std::numeric_limits<uint32_t>::max();
+constexpr float kAbsentFloat = std::numeric_limits<float>::quiet_NaN();
+
+// Records start on a cache line of their own.
+constexpr uint64_t kRecordsOffset = 64;
+static_assert(sizeof(CatalogueSnapshot::Header) <= kRecordsOffset);
+
+} // anonymous namespace
+
+CatalogueSnapshot::CatalogueSnapshot()
+{
+}
+
+CatalogueSnapshot::~CatalogueSnapshot()
+{
+}
+
+bool CatalogueSnapshot::Open(const std::string& filePath)
+{
+    Close();
+
+    if (!m_File.Open(filePath))
+    {
+        return false;
+    }
+
+    const uint8_t* pData = m_File.GetData();
+    const uint64_t size = m_File.GetSize();
+    if (size < sizeof(Header))
+    {
+        m_File.Close();
+        return false;
+    }
+
+    // Only the section bounds are checked here; records aren't touched until they're used.
+    const Header* pHeader = reinterpret_cast<const Header*>(pData);
+    const uint64_t recordsSize = static_cast<uint64_t>(pHeader->recordCount) * sizeof(Record);
+    const uint64_t indexSize = static_cast<uint64_t>(pHeader->recordCount) * sizeof(IndexEntry);
+    const bool valid = pHeader->magic == kMagic &&
+        pHeader->version == kVersion &&
+        pHeader->recordSize == sizeof(Record) &&
+        pHeader->recordsOffset % alignof(Record) == 0 &&
+        pHeader->indexOffset % alignof(IndexEntry) == 0 &&
+        pHeader->recordsOffset <= size && recordsSize <= size - pHeader->recordsOffset &&
+        pHeader->indexOffset <= size && indexSize <= size - pHeader->indexOffset &&
+        pHeader->stringTableOffset <= size && pHeader->stringTableSize <= size - pHeader->stringTableOffset &&
+        pHeader->stringTableSize > 0 && pData[pHeader->stringTableOffset + pHeader->stringTableSize - 1] == '\0';
+    if (!valid)
+    {
+        m_File.Close();
+        return false;
+    }
+
+    m_pHeader = pHeader;
+    m_pRecords = reinterpret_cast<const Record*>(pData + pHeader->recordsOffset);
+    m_pIndex = reinterpret_cast<const IndexEntry*>(pData + pHeader->indexOffset);
+    m_pStringTable = reinterpret_cast<const char*>(pData + pHeader->stringTableOffset);
+    return true;
+}
+
+void CatalogueSnapshot::Close()
+{
+    m_File.Close();
+    m_pHeader = nullptr;
+    m_pRecords = nullptr;
+    m_pIndex = nullptr;
+    m_pStringTable = nullptr;
+}
+
+const CatalogueSnapshot::Record* CatalogueSnapshot::FindByNoradId(uint32_t noradCatalogueId) const
+{
+    const IndexEntry* pBegin = m_pIndex;
+    const IndexEntry* pEnd = m_pIndex + GetCount();
+    const IndexEntry* pEntry = std::lower_bound(pBegin, pEnd, noradCatalogueId, [](const IndexEntry& entry, uint32_t id) {
+        return entry.noradCatalogueId < id;
+    });
+
+    if (pEntry == pEnd || pEntry->noradCatalogueId != noradCatalogueId || pEntry->record >= GetCount())
+    {
+        return nullptr;
+    }
+    return &m_pRecords[pEntry->record];
+}
+
+std::string_view CatalogueSnapshot::GetString(uint32_t offset) const
+{
+    // The table is known to end with a NUL, so any offset inside it yields a terminated string.
+    if (m_pHeader == nullptr || offset >= m_pHeader->stringTableSize)
+    {
+        return std::string_view();
+    }
+    return std::string_view(m_pStringTable + offset);
+}
+
+std::string_view CatalogueSnapshot::GetStringTable() const
+{
+    return m_pHeader ? std::string_view(m_pStringTable, m_pHeader->stringTableSize) : std::string_view();
+}
+
+void CatalogueSnapshot::Unpack(const Record& record, SpaceObject& spaceObject) const
+{
+    Unpack(record, GetString(record.objectName), GetString(record.objectId), spaceObject);
+}
+
+void CatalogueSnapshot::Pack(const SpaceObject& spaceObject, StringArena& strings, Record& record)
+{
+    record.epoch = std::chrono::duration_cast<std::chrono::microseconds>(spaceObject.GetEpoch().time_since_epoch()).count();
+    record.noradCatalogueId = spaceObject.GetNoradCatalogueId();
+    record.elementSetNumber = spaceObject.GetElementSetNumber().value_or(kAbsentInteger);
+    record.revolutionsAtEpoch = spaceObject.GetRevolutionsAtEpoch().value_or(kAbsentInteger);
+    record.meanMotion = spaceObject.GetMeanMotion();
+    record.eccentricity = spaceObject.GetEccentricity();
+    record.inclination = spaceObject.GetInclination();
+    record.rightAscensionOfAscendingNode = spaceObject.GetRightAscensionOfAscendingNode();
+    record.argumentOfPericenter = spaceObject.GetArgumentOfPericenter();
+    record.meanAnomaly = spaceObject.GetMeanAnomaly();
+    record.bstar = spaceObject.GetBstar().value_or(kAbsentFloat);
+    record.meanMotionFirstDerivative = spaceObject.GetMeanMotionFirstDerivative().value_or(kAbsentFloat);
+    record.meanMotionSecondDerivative = spaceObject.GetMeanMotionSecondDerivative().value_or(kAbsentFloat);
+    record.objectName = strings.Intern(spaceObject.GetObjectName());
+    record.objectId = strings.Intern(spaceObject.GetObjectId());
+}
+
+void CatalogueSnapshot::Unpack(const Record& record, std::string_view objectName, std::string_view objectId, SpaceObject& spaceObject)
+{
+    const SpaceObjectView view(record, objectName, objectId);
+    spaceObject.m_ObjectName = objectName;
+    spaceObject.m_ObjectId = objectId;
+    spaceObject.m_Epoch = view.GetEpoch();
+    spaceObject.m_MeanMotion = record.meanMotion;
+    spaceObject.m_Eccentricity = record.eccentricity;
+    spaceObject.m_Inclination = record.inclination;
+    spaceObject.m_RightAscensionOfAscendingNode = record.rightAscensionOfAscendingNode;
+    spaceObject.m_ArgumentOfPericenter = record.argumentOfPericenter;
+    spaceObject.m_MeanAnomaly = record.meanAnomaly;
+    spaceObject.m_NoradCatalogueId = record.noradCatalogueId;
+    spaceObject.m_ElementSetNumber = view.GetElementSetNumber();
+    spaceObject.m_RevolutionsAtEpoch = view.GetRevolutionsAtEpoch();
+    spaceObject.m_Bstar = view.GetBstar();
+    spaceObject.m_MeanMotionFirstDerivative = view.GetMeanMotionFirstDerivative();
+    spaceObject.m_MeanMotionSecondDerivative = view.GetMeanMotionSecondDerivative();
+}
+
+bool CatalogueSnapshot::Write(const std::string& filePath, const std::vector<const SpaceObject*>& spaceObjects)
+{
+    StringArena strings;
+    std::vector<Record> records(spaceObjects.size());
+    for (size_t index = 0; index < spaceObjects.size(); ++index)
+    {
+        Pack(*spaceObjects[index], strings, records[index]);
+    }
+    return Write(filePath, std::move(records), strings.GetData());
+}
+
+bool CatalogueSnapshot::Write(const std::string& filePath, std::vector<Record> records, std::string_view stringTable)
+{
+    std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.noradCatalogueId < b.noradCatalogueId;
+    });
+
+    std::vector<IndexEntry> index;
+    index.reserve(records.size());
+    for (const Record& record : records)
+    {
+        index.push_back({ record.noradCatalogueId, static_cast<uint32_t>(index.size()) });
+    }
+
+    Header header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.recordSize = sizeof(Record);
+    header.recordCount = static_cast<uint32_t>(records.size());
+    header.recordsOffset = kRecordsOffset;
+    header.indexOffset = header.recordsOffset + records.size() * sizeof(Record);
+    header.stringTableOffset = header.indexOffset + index.size() * sizeof(IndexEntry);
+    header.stringTableSize = stringTable.size();
+
+    const std::string temporaryFilePath = filePath + ".tmp";
+    {
+        std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+        const char padding[kRecordsOffset] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(padding, kRecordsOffset - sizeof(Header));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+        file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+        file.write(stringTable.data(), stringTable.size());
+        if (!file.flush())
+        {
+            std::error_code error;
+            std::filesystem::remove(temporaryFilePath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryFilePath, filePath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryFilePath, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace WingsOfSteel
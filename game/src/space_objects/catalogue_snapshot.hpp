@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "space_objects/mapped_file.hpp"
+#include "space_objects/string_arena.hpp"
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+
+// Binary image of a space object catalogue, laid out so it can be memory mapped and used in place.
+// The file is a header followed by three sections:
+// - fixed-size element records, in NORAD catalogue ID order;
+// - an index of (NORAD catalogue ID, record) pairs sorted by ID, searched with a binary search;
+// - a string table of NUL-terminated names and COSPAR IDs, which records refer to by offset.
+// Records are also the catalogue's in-memory representation, so a snapshot is little more than a copy of it.
+// All values are little-endian. Optional OMM fields which were absent are stored as NaN or ~0u.
+// Any change to the layout must bump kVersion, so stale snapshots are rejected rather than misread.
+class CatalogueSnapshot
+{
+public:
+    static constexpr uint32_t kMagic = 0x4342524F; // "ORBC"
+    static constexpr uint32_t kVersion = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t recordCount;
+        uint64_t recordsOffset;
+        uint64_t indexOffset;
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+    };
+
+    struct alignas(64) Record
+    {
+        int64_t epoch; // Microseconds since the Unix epoch
+        uint32_t noradCatalogueId;
+        uint32_t elementSetNumber;
+        uint32_t revolutionsAtEpoch;
+        float meanMotion; // rev/day
+        float eccentricity;
+        float inclination; // deg
+        float rightAscensionOfAscendingNode; // deg
+        float argumentOfPericenter; // deg
+        float meanAnomaly; // deg
+        float bstar; // 1/earth radii
+        float meanMotionFirstDerivative; // rev/day²
+        float meanMotionSecondDerivative; // rev/day³
+        uint32_t objectName; // String table offset
+        uint32_t objectId; // String table offset
+    };
+    static_assert(sizeof(Record) == 64);
+
+    struct IndexEntry
+    {
+        uint32_t noradCatalogueId;
+        uint32_t record;
+    };
+
+    CatalogueSnapshot();
+    ~CatalogueSnapshot();
+
+    // Maps a snapshot written by Write(). Fails if the file is missing, from another version, or truncated.
+    bool Open(const std::string& filePath);
+    void Close();
+    bool IsOpen() const { return m_pHeader != nullptr; }
+
+    size_t GetCount() const { return m_pHeader ? m_pHeader->recordCount : 0; }
+    const Record& GetRecord(size_t index) const { return m_pRecords[index]; }
+    const Record* GetRecords() const { return m_pRecords; }
+    const Record* FindByNoradId(uint32_t noradCatalogueId) const;
+    std::string_view GetString(uint32_t offset) const;
+    std::string_view GetStringTable() const;
+
+    // Fills in a SpaceObject from one of the snapshot's records.
+    void Unpack(const Record& record, SpaceObject& spaceObject) const;
+
+    // Conversions between SpaceObjects and records, whose strings live in a StringArena or a string table.
+    static void Pack(const SpaceObject& spaceObject, StringArena& strings, Record& record);
+    static void Unpack(const Record& record, std::string_view objectName, std::string_view objectId, SpaceObject& spaceObject);
+
+    // Records are written to a temporary file which then replaces filePath, so a snapshot being mapped by
+    // another instance is never seen half-written.
+    static bool Write(const std::string& filePath, const std::vector<const SpaceObject*>& spaceObjects);
+
+    // As above, for records which are already packed. stringTable is the StringArena they refer to.
+    static bool Write(const std::string& filePath, std::vector<Record> records, std::string_view stringTable);
+
+private:
+    MappedFile m_File;
+    const Header* m_pHeader{ nullptr };
+    const Record* m_pRecords{ nullptr };
+    const IndexEntry* m_pIndex{ nullptr };
+    const char* m_pStringTable{ nullptr };
+};
+
+} // namespace WingsOfSteel
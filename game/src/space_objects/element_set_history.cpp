@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#include "space_objects/element_set_history.hpp"
+#include "space_objects/space_object.hpp"
+#include "space_objects/space_object_view.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// B* is optional in OMM, and stored as NaN when it's absent, as in catalogue records.
+constexpr float kAbsentBstar = std::numeric_limits<float>::quiet_NaN();
+
+int64_t ToMicroseconds(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+double ToSeconds(int64_t microseconds)
+{
+    return static_cast<double>(microseconds) * 1.0e-6;
+}
+
+} // anonymous namespace
+
+ElementSetHistory::ElementSetHistory()
+{
+}
+
+ElementSetHistory::~ElementSetHistory()
+{
+}
+
+void ElementSetHistory::Append(const SpaceObject& spaceObject)
+{
+    Write(FindOrAddRow(spaceObject.GetNoradCatalogueId(), ToMicroseconds(spaceObject.GetEpoch())), spaceObject);
+}
+
+void ElementSetHistory::Append(const SpaceObjectView& spaceObject)
+{
+    Write(FindOrAddRow(spaceObject.GetNoradCatalogueId(), ToMicroseconds(spaceObject.GetEpoch())), spaceObject);
+}
+
+void ElementSetHistory::Append(uint32_t noradId, const ElementSetHistory& source, uint32_t row)
+{
+    const uint32_t target = FindOrAddRow(noradId, source.m_Epochs[row]);
+    m_MeanMotions[target] = source.m_MeanMotions[row];
+    m_Eccentricities[target] = source.m_Eccentricities[row];
+    m_Inclinations[target] = source.m_Inclinations[row];
+    m_RightAscensionsOfAscendingNode[target] = source.m_RightAscensionsOfAscendingNode[row];
+    m_ArgumentsOfPericenter[target] = source.m_ArgumentsOfPericenter[row];
+    m_MeanAnomalies[target] = source.m_MeanAnomalies[row];
+    m_Bstars[target] = source.m_Bstars[row];
+}
+
+void ElementSetHistory::Erase(uint32_t noradId)
+{
+    const uint32_t object = m_Objects.Find(noradId);
+    if (object == FlatIdMap::kNotFound)
+    {
+        return;
+    }
+
+    // The last object's rows move into the gap, as records do in the catalogue.
+    m_ErasedRowCount += m_ObjectRows[object].size();
+    if (object + 1 != m_ObjectRows.size())
+    {
+        m_ObjectRows[object] = std::move(m_ObjectRows.back());
+        m_ObjectIds[object] = m_ObjectIds.back();
+        m_Objects.Set(m_ObjectIds[object], object);
+    }
+    m_ObjectRows.pop_back();
+    m_ObjectIds.pop_back();
+    m_Objects.Erase(noradId);
+
+    // Unloading a large group erases most of the store at once, so its memory is given back rather than
+    // kept for element sets which may never be added again.
+    if (m_ErasedRowCount * 2 > m_Epochs.size())
+    {
+        Compact();
+    }
+}
+
+void ElementSetHistory::Clear()
+{
+    m_Epochs.clear();
+    m_MeanMotions.clear();
+    m_Eccentricities.clear();
+    m_Inclinations.clear();
+    m_RightAscensionsOfAscendingNode.clear();
+    m_ArgumentsOfPericenter.clear();
+    m_MeanAnomalies.clear();
+    m_Bstars.clear();
+    m_Objects.Clear();
+    m_ObjectRows.clear();
+    m_ObjectIds.clear();
+    m_ErasedRowCount = 0;
+}
+
+size_t ElementSetHistory::GetElementSetCount(uint32_t noradId) const
+{
+    const std::vector<uint32_t>* pRows = FindRows(noradId);
+    return pRows ? pRows->size() : 0;
+}
+
+std::span<const uint32_t> ElementSetHistory::GetElementSets(uint32_t noradId) const
+{
+    const std::vector<uint32_t>* pRows = FindRows(noradId);
+    return pRows ? std::span<const uint32_t>(*pRows) : std::span<const uint32_t>();
+}
+
+uint32_t ElementSetHistory::FindClosest(uint32_t noradId, double time, Validity& validity) const
+{
+    const std::vector<uint32_t>* pRows = FindRows(noradId);
+    if (pRows == nullptr || pRows->empty())
+    {
+        return kNoElementSet;
+    }
+
+    // The closest epoch is either the first one after time or the one before it. Each element set is the
+    // closest one until halfway to its neighbours.
+    const std::vector<uint32_t>& rows = *pRows;
+    const auto it = std::lower_bound(rows.begin(), rows.end(), time, [this](uint32_t row, double value) {
+        return ToSeconds(m_Epochs[row]) < value;
+    });
+    size_t index = static_cast<size_t>(it - rows.begin());
+    if (index == rows.size() || (index > 0 && time - ToSeconds(m_Epochs[rows[index - 1]]) < ToSeconds(m_Epochs[rows[index]]) - time))
+    {
+        index--;
+    }
+
+    const double epoch = ToSeconds(m_Epochs[rows[index]]);
+    validity.from = index > 0 ? 0.5 * (ToSeconds(m_Epochs[rows[index - 1]]) + epoch) : -std::numeric_limits<double>::infinity();
+    validity.until = index + 1 < rows.size() ? 0.5 * (epoch + ToSeconds(m_Epochs[rows[index + 1]])) : std::numeric_limits<double>::infinity();
+    return rows[index];
+}
+
+void ElementSetHistory::Apply(uint32_t row, SpaceObject& spaceObject) const
+{
+    spaceObject.m_Epoch = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(m_Epochs[row])));
+    spaceObject.m_MeanMotion = m_MeanMotions[row];
+    spaceObject.m_Eccentricity = m_Eccentricities[row];
+    spaceObject.m_Inclination = m_Inclinations[row];
+    spaceObject.m_RightAscensionOfAscendingNode = m_RightAscensionsOfAscendingNode[row];
+    spaceObject.m_ArgumentOfPericenter = m_ArgumentsOfPericenter[row];
+    spaceObject.m_MeanAnomaly = m_MeanAnomalies[row];
+    spaceObject.m_Bstar = std::isnan(m_Bstars[row]) ? std::nullopt : std::optional<float>(m_Bstars[row]);
+}
+
+std::vector<uint32_t>* ElementSetHistory::FindRows(uint32_t noradId)
+{
+    const uint32_t object = m_Objects.Find(noradId);
+    return object == FlatIdMap::kNotFound ? nullptr : &m_ObjectRows[object];
+}
+
+const std::vector<uint32_t>* ElementSetHistory::FindRows(uint32_t noradId) const
+{
+    const uint32_t object = m_Objects.Find(noradId);
+    return object == FlatIdMap::kNotFound ? nullptr : &m_ObjectRows[object];
+}
+
+uint32_t ElementSetHistory::FindOrAddRow(uint32_t noradId, int64_t epoch)
+{
+    std::vector<uint32_t>* pRows = FindRows(noradId);
+    if (pRows == nullptr)
+    {
+        m_Objects.Set(noradId, static_cast<uint32_t>(m_ObjectRows.size()));
+        m_ObjectIds.push_back(noradId);
+        pRows = &m_ObjectRows.emplace_back();
+    }
+
+    // Element sets almost always arrive in epoch order, so this is usually an append. An element set with
+    // the same epoch as one already in the history is written over it.
+    auto it = std::lower_bound(pRows->begin(), pRows->end(), epoch, [this](uint32_t row, int64_t value) {
+        return m_Epochs[row] < value;
+    });
+    if (it != pRows->end() && m_Epochs[*it] == epoch)
+    {
+        return *it;
+    }
+
+    const uint32_t row = static_cast<uint32_t>(m_Epochs.size());
+    m_Epochs.push_back(epoch);
+    m_MeanMotions.emplace_back();
+    m_Eccentricities.emplace_back();
+    m_Inclinations.emplace_back();
+    m_RightAscensionsOfAscendingNode.emplace_back();
+    m_ArgumentsOfPericenter.emplace_back();
+    m_MeanAnomalies.emplace_back();
+    m_Bstars.emplace_back();
+    pRows->insert(it, row);
+    return row;
+}
+
+template <typename ElementSet>
+void ElementSetHistory::Write(uint32_t row, const ElementSet& elementSet)
+{
+    m_MeanMotions[row] = elementSet.GetMeanMotion();
+    m_Eccentricities[row] = elementSet.GetEccentricity();
+    m_Inclinations[row] = elementSet.GetInclination();
+    m_RightAscensionsOfAscendingNode[row] = elementSet.GetRightAscensionOfAscendingNode();
+    m_ArgumentsOfPericenter[row] = elementSet.GetArgumentOfPericenter();
+    m_MeanAnomalies[row] = elementSet.GetMeanAnomaly();
+    m_Bstars[row] = elementSet.GetBstar().value_or(kAbsentBstar);
+}
+
+void ElementSetHistory::Compact()
+{
+    // Rows are copied into new columns object by object, which also leaves each object's rows adjacent.
+    const size_t rowCount = m_Epochs.size() - m_ErasedRowCount;
+    std::vector<int64_t> epochs;
+    std::vector<float> meanMotions;
+    std::vector<float> eccentricities;
+    std::vector<float> inclinations;
+    std::vector<float> rightAscensionsOfAscendingNode;
+    std::vector<float> argumentsOfPericenter;
+    std::vector<float> meanAnomalies;
+    std::vector<float> bstars;
+    epochs.reserve(rowCount);
+    meanMotions.reserve(rowCount);
+    eccentricities.reserve(rowCount);
+    inclinations.reserve(rowCount);
+    rightAscensionsOfAscendingNode.reserve(rowCount);
+    argumentsOfPericenter.reserve(rowCount);
+    meanAnomalies.reserve(rowCount);
+    bstars.reserve(rowCount);
+
+    for (std::vector<uint32_t>& rows : m_ObjectRows)
+    {
+        for (uint32_t& row : rows)
+        {
+            const uint32_t newRow = static_cast<uint32_t>(epochs.size());
+            epochs.push_back(m_Epochs[row]);
+            meanMotions.push_back(m_MeanMotions[row]);
+            eccentricities.push_back(m_Eccentricities[row]);
+            inclinations.push_back(m_Inclinations[row]);
+            rightAscensionsOfAscendingNode.push_back(m_RightAscensionsOfAscendingNode[row]);
+            argumentsOfPericenter.push_back(m_ArgumentsOfPericenter[row]);
+            meanAnomalies.push_back(m_MeanAnomalies[row]);
+            bstars.push_back(m_Bstars[row]);
+            row = newRow;
+        }
+    }
+
+    m_Epochs.swap(epochs);
+    m_MeanMotions.swap(meanMotions);
+    m_Eccentricities.swap(eccentricities);
+    m_Inclinations.swap(inclinations);
+    m_RightAscensionsOfAscendingNode.swap(rightAscensionsOfAscendingNode);
+    m_ArgumentsOfPericenter.swap(argumentsOfPericenter);
+    m_MeanAnomalies.swap(meanAnomalies);
+    m_Bstars.swap(bstars);
+    m_ObjectRows.shrink_to_fit();
+    m_ObjectIds.shrink_to_fit();
+    m_ErasedRowCount = 0;
+}
+
+} // namespace WingsOfSteel
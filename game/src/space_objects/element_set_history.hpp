@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "space_objects/flat_id_map.hpp"
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+class SpaceObjectView;
+
+// Every element set seen for each object, so objects can be propagated from the one published closest to
+// the simulation time rather than always from the latest.
+// Element sets are appended to a columnar store which only keeps what propagation needs: the epoch, the
+// six mean elements and B*, 36 bytes each. Each object has a list of its rows sorted by epoch, searched
+// with a binary search. Names, COSPAR IDs and the remaining OMM fields only live in the catalogue's
+// latest record.
+class ElementSetHistory
+{
+public:
+    static constexpr uint32_t kNoElementSet = ~0u;
+
+    // Time around an element set's epoch during which it is the closest one (seconds since the Unix epoch).
+    struct Validity
+    {
+        double from;
+        double until;
+    };
+
+    ElementSetHistory();
+    ~ElementSetHistory();
+
+    // Adds the object's element set, replacing the one with the same epoch if there is one.
+    void Append(const SpaceObject& spaceObject);
+    void Append(const SpaceObjectView& spaceObject);
+
+    // Adds a row of another history to the object's element sets, as Append() does.
+    void Append(uint32_t noradId, const ElementSetHistory& source, uint32_t row);
+
+    // Forgets the object's element sets. Their rows are reclaimed once enough of the store is unused.
+    void Erase(uint32_t noradId);
+    void Clear();
+
+    size_t GetElementSetCount() const { return m_Epochs.size(); }
+    size_t GetElementSetCount(uint32_t noradId) const;
+
+    // The object's rows, in epoch order. Only valid until the history is changed.
+    std::span<const uint32_t> GetElementSets(uint32_t noradId) const;
+
+    // Returns the row of the element set whose epoch is closest to time, or kNoElementSet if the object has
+    // no history.
+    uint32_t FindClosest(uint32_t noradId, double time, Validity& validity) const;
+
+    // Overwrites the epoch, mean elements and B* of spaceObject with those of a row. B* is left absent if it
+    // was absent from the element set the row was written from.
+    void Apply(uint32_t row, SpaceObject& spaceObject) const;
+
+private:
+    std::vector<uint32_t>* FindRows(uint32_t noradId);
+    const std::vector<uint32_t>* FindRows(uint32_t noradId) const;
+    uint32_t FindOrAddRow(uint32_t noradId, int64_t epoch);
+    template <typename ElementSet>
+    void Write(uint32_t row, const ElementSet& elementSet);
+    void Compact();
+
+    // Columns, one entry per element set.
+    std::vector<int64_t> m_Epochs; // Microseconds since the Unix epoch
+    std::vector<float> m_MeanMotions; // rev/day
+    std::vector<float> m_Eccentricities;
+    std::vector<float> m_Inclinations; // deg
+    std::vector<float> m_RightAscensionsOfAscendingNode; // deg
+    std::vector<float> m_ArgumentsOfPericenter; // deg
+    std::vector<float> m_MeanAnomalies; // deg
+    std::vector<float> m_Bstars; // 1/earth radii
+
+    FlatIdMap m_Objects; // NORAD catalogue ID to index in m_ObjectRows
+    std::vector<std::vector<uint32_t>> m_ObjectRows; // Rows of each object, in epoch order
+    std::vector<uint32_t> m_ObjectIds; // NORAD catalogue ID of each entry in m_ObjectRows
+    size_t m_ErasedRowCount{ 0 };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#include "jobs/worker_pool.hpp"
+#include "space_objects/element_set_parsing.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Powers of ten which are exactly representable as doubles.
+constexpr std::array<double, 23> kPowersOfTen = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+} // anonymous namespace
+
+// Whenever the significand fits in 53 bits and the decimal exponent is small, both are exact doubles and a
+// single multiplication or division gives the correctly rounded result (Clinger's fast path). Element set
+// values always qualify; anything else goes through strtod().
+bool ParseDouble(std::string_view token, double& value)
+{
+    const char* pCursor = token.data();
+    const char* pEnd = pCursor + token.size();
+
+    bool negative = false;
+    if (pCursor < pEnd && (*pCursor == '-' || *pCursor == '+'))
+    {
+        negative = *pCursor == '-';
+        ++pCursor;
+    }
+
+    uint64_t significand = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    bool truncated = false;
+    while (pCursor < pEnd && IsDigit(*pCursor))
+    {
+        if (significantDigits < 19)
+        {
+            significand = significand * 10 + (*pCursor - '0');
+            significantDigits += significand != 0 ? 1 : 0;
+        }
+        else
+        {
+            exponent++;
+            truncated = true;
+        }
+        hasDigits = true;
+        ++pCursor;
+    }
+
+    if (pCursor < pEnd && *pCursor == '.')
+    {
+        ++pCursor;
+        while (pCursor < pEnd && IsDigit(*pCursor))
+        {
+            if (significantDigits < 19)
+            {
+                significand = significand * 10 + (*pCursor - '0');
+                significantDigits += significand != 0 ? 1 : 0;
+                exponent--;
+            }
+            else
+            {
+                truncated = true;
+            }
+            hasDigits = true;
+            ++pCursor;
+        }
+    }
+
+    if (!hasDigits)
+    {
+        return false;
+    }
+
+    if (pCursor < pEnd && (*pCursor == 'e' || *pCursor == 'E'))
+    {
+        ++pCursor;
+        int exponentSign = 1;
+        if (pCursor < pEnd && (*pCursor == '-' || *pCursor == '+'))
+        {
+            exponentSign = *pCursor == '-' ? -1 : 1;
+            ++pCursor;
+        }
+
+        int explicitExponent = 0;
+        bool hasExponentDigits = false;
+        while (pCursor < pEnd && IsDigit(*pCursor))
+        {
+            explicitExponent = std::min(explicitExponent * 10 + (*pCursor - '0'), 100000);
+            hasExponentDigits = true;
+            ++pCursor;
+        }
+
+        if (!hasExponentDigits)
+        {
+            return false;
+        }
+        exponent += exponentSign * explicitExponent;
+    }
+
+    if (pCursor != pEnd)
+    {
+        return false;
+    }
+
+    if (!truncated && significand <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        const double magnitude = exponent < 0 ? static_cast<double>(significand) / kPowersOfTen[-exponent] : static_cast<double>(significand) * kPowersOfTen[exponent];
+        value = negative ? -magnitude : magnitude;
+        return true;
+    }
+
+    // strtod() needs a terminated string, and tokens are slices of a larger buffer.
+    std::array<char, 64> buffer;
+    if (token.size() >= buffer.size())
+    {
+        return false;
+    }
+    std::memcpy(buffer.data(), token.data(), token.size());
+    buffer[token.size()] = '\0';
+    value = std::strtod(buffer.data(), nullptr);
+    return true;
+}
+
+bool ParseUnsigned(std::string_view token, uint32_t& value)
+{
+    if (token.empty() || token.size() > 10)
+    {
+        return false;
+    }
+
+    uint64_t result = 0;
+    for (char c : token)
+    {
+        if (!IsDigit(c))
+        {
+            return false;
+        }
+        result = result * 10 + (c - '0');
+    }
+
+    if (result > UINT32_MAX)
+    {
+        return false;
+    }
+    value = static_cast<uint32_t>(result);
+    return true;
+}
+
+std::string_view NextLine(std::string_view text, size_t& offset)
+{
+    const size_t begin = offset;
+    const size_t newline = text.find('\n', begin);
+    const size_t end = newline == std::string_view::npos ? text.size() : newline;
+    offset = newline == std::string_view::npos ? text.size() : newline + 1;
+
+    std::string_view line = text.substr(begin, end - begin);
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+int64_t DaysFromCivil(int64_t year, int64_t month, int64_t day)
+{
+    // Howard Hinnant's algorithm, counting from 1970-01-01 in the proleptic Gregorian calendar.
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+std::vector<std::string_view> SplitIntoChunks(std::string_view text, size_t chunkSize, const RecordStartFunction& findRecordStart)
+{
+    std::vector<std::string_view> chunks;
+    size_t begin = findRecordStart(text, 0);
+    while (begin < text.size())
+    {
+        size_t end = begin + chunkSize < text.size() ? findRecordStart(text, begin + chunkSize) : text.size();
+
+        // Records can start a little before the offset they're searched from, which only matters if a single
+        // record is longer than a chunk.
+        if (end <= begin)
+        {
+            end = text.size();
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+ElementSetReadResult ReadChunksInParallel(const std::vector<std::string_view>& chunks, WorkerPool& workerPool, const ChunkReadFunction& readChunk, const ElementSetCallback& onRecord)
+{
+    std::vector<std::vector<SpaceObject>> chunkRecords(chunks.size());
+    std::vector<ElementSetReadResult> chunkResults(chunks.size());
+    workerPool.ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            std::vector<SpaceObject>& records = chunkRecords[chunk];
+            chunkResults[chunk] = readChunk(chunks[chunk], [&records](const SpaceObject& spaceObject) {
+                records.push_back(spaceObject);
+            });
+        }
+    });
+
+    ElementSetReadResult result;
+    for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+    {
+        for (const SpaceObject& spaceObject : chunkRecords[chunk])
+        {
+            onRecord(spaceObject);
+        }
+        result.records += chunkResults[chunk].records;
+        result.rejected += chunkResults[chunk].rejected;
+    }
+    return result;
+}
+
+} // namespace WingsOfSteel
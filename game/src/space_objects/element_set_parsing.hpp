@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+class WorkerPool;
+
+// Helpers shared by the element set readers.
+
+inline bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Parses a decimal number as written in JSON, CSV or a TLE field, with an optional sign and exponent.
+bool ParseDouble(std::string_view token, double& value);
+bool ParseUnsigned(std::string_view token, uint32_t& value);
+
+// Returns the line starting at offset without its line ending, and moves offset to the start of the next one.
+std::string_view NextLine(std::string_view text, size_t& offset);
+
+// Days from 1970-01-01 to the given date of the proleptic Gregorian calendar.
+int64_t DaysFromCivil(int64_t year, int64_t month, int64_t day);
+
+struct ElementSetReadResult
+{
+    size_t records{ 0 }; // Records passed to the callback
+    size_t rejected{ 0 }; // Records which were malformed or missing a required field
+};
+
+using ElementSetCallback = std::function<void(const SpaceObject& spaceObject)>;
+
+// Returns the offset of the first record which starts at or after offset, or text.size() if there is none.
+using RecordStartFunction = std::function<size_t(std::string_view text, size_t offset)>;
+using ChunkReadFunction = std::function<ElementSetReadResult(std::string_view chunk, const ElementSetCallback& onRecord)>;
+
+// Cuts text into chunks of about chunkSize bytes, each of which starts on a record boundary.
+std::vector<std::string_view> SplitIntoChunks(std::string_view text, size_t chunkSize, const RecordStartFunction& findRecordStart);
+
+// Reads every chunk on the worker pool, each into a buffer of its own, then passes the records to onRecord
+// on the calling thread in the order they appear in the text.
+ElementSetReadResult ReadChunksInParallel(const std::vector<std::string_view>& chunks, WorkerPool& workerPool, const ChunkReadFunction& readChunk, const ElementSetCallback& onRecord);
+
+} // namespace WingsOfSteel
@@ -0,0 +1,144 @@
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <array>
+
+#include "space_objects/file_watcher.hpp"
+
+namespace WingsOfSteel
+{
+
+#if !defined(__linux__)
+namespace
+{
+
+constexpr std::chrono::seconds kPollInterval(1);
+
+} // anonymous namespace
+#endif
+
+FileWatcher::FileWatcher()
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+#if defined(__linux__)
+
+bool FileWatcher::Watch(const std::string& filePath)
+{
+    Stop();
+
+    // The directory is watched rather than the file, as a file renamed over the original is a new inode.
+    const std::filesystem::path path(filePath);
+    const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+    m_InotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_InotifyDescriptor < 0)
+    {
+        return false;
+    }
+
+    if (inotify_add_watch(m_InotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        Stop();
+        return false;
+    }
+
+    m_FilePath = filePath;
+    m_FileName = path.filename().string();
+    return true;
+}
+
+void FileWatcher::Stop()
+{
+    if (m_InotifyDescriptor >= 0)
+    {
+        close(m_InotifyDescriptor);
+    }
+    m_InotifyDescriptor = -1;
+    m_FilePath.clear();
+    m_FileName.clear();
+}
+
+bool FileWatcher::HasChanged()
+{
+    if (m_InotifyDescriptor < 0)
+    {
+        return false;
+    }
+
+    // Drain every queued event, as a single update can produce several.
+    bool changed = false;
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    while (true)
+    {
+        const ssize_t length = read(m_InotifyDescriptor, buffer.data(), buffer.size());
+        if (length <= 0)
+        {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+            if (pEvent->len > 0 && m_FileName == pEvent->name)
+            {
+                changed = true;
+            }
+            offset += sizeof(inotify_event) + pEvent->len;
+        }
+    }
+    return changed;
+}
+
+#else
+
+bool FileWatcher::Watch(const std::string& filePath)
+{
+    Stop();
+
+    std::error_code error;
+    m_LastWriteTime = std::filesystem::last_write_time(filePath, error);
+    if (error)
+    {
+        return false;
+    }
+
+    m_FilePath = filePath;
+    m_NextPollTime = std::chrono::steady_clock::now() + kPollInterval;
+    return true;
+}
+
+void FileWatcher::Stop()
+{
+    m_FilePath.clear();
+}
+
+bool FileWatcher::HasChanged()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (m_FilePath.empty() || now < m_NextPollTime)
+    {
+        return false;
+    }
+    m_NextPollTime = now + kPollInterval;
+
+    // The file briefly disappears while it's being replaced on some platforms, which isn't a change yet.
+    std::error_code error;
+    const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(m_FilePath, error);
+    if (error || writeTime == m_LastWriteTime)
+    {
+        return false;
+    }
+    m_LastWriteTime = writeTime;
+    return true;
+}
+
+#endif
+
+} // namespace WingsOfSteel
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace WingsOfSteel
+{
+
+// Reports changes to a single file, including it being replaced by another file renamed over it, which is
+// how most tools publish updates atomically. Linux is told about changes by inotify; other platforms poll
+// the file's modification time once a second.
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool Watch(const std::string& filePath);
+    void Stop();
+    bool IsWatching() const { return !m_FilePath.empty(); }
+
+    // Returns true once for all the changes made since the previous call. Never blocks.
+    bool HasChanged();
+
+private:
+    std::string m_FilePath;
+#if defined(__linux__)
+    std::string m_FileName;
+    int m_InotifyDescriptor{ -1 };
+#else
+    std::filesystem::file_time_type m_LastWriteTime;
+    std::chrono::steady_clock::time_point m_NextPollTime;
+#endif
+};
+
+} // namespace WingsOfSteel
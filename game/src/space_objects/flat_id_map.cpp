@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <bit>
+
+#include "space_objects/flat_id_map.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr size_t kMinimumCapacity = 16;
+
+// Slots are rehashed into a larger array once they're 70% full, past which linear probing degrades quickly.
+bool IsOverloaded(size_t count, size_t capacity)
+{
+    return count * 10 > capacity * 7;
+}
+
+} // anonymous namespace
+
+FlatIdMap::FlatIdMap()
+{
+}
+
+FlatIdMap::~FlatIdMap()
+{
+}
+
+void FlatIdMap::Reserve(size_t count)
+{
+    size_t capacity = std::max(m_Slots.size(), kMinimumCapacity);
+    while (IsOverloaded(count, capacity))
+    {
+        capacity *= 2;
+    }
+
+    if (capacity != m_Slots.size())
+    {
+        Rehash(capacity);
+    }
+}
+
+void FlatIdMap::Clear()
+{
+    m_Slots.clear();
+    m_Count = 0;
+}
+
+uint32_t FlatIdMap::Find(uint32_t key) const
+{
+    if (m_Slots.empty())
+    {
+        return kNotFound;
+    }
+
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t index = GetHome(key);; index = (index + 1) & mask)
+    {
+        const Slot& slot = m_Slots[index];
+        if (slot.key == key)
+        {
+            return slot.value;
+        }
+        else if (slot.key == kEmpty)
+        {
+            return kNotFound;
+        }
+    }
+}
+
+void FlatIdMap::Set(uint32_t key, uint32_t value)
+{
+    Reserve(m_Count + 1);
+
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t index = GetHome(key);; index = (index + 1) & mask)
+    {
+        Slot& slot = m_Slots[index];
+        if (slot.key == key)
+        {
+            slot.value = value;
+            return;
+        }
+        else if (slot.key == kEmpty)
+        {
+            slot = { key, value };
+            m_Count++;
+            return;
+        }
+    }
+}
+
+bool FlatIdMap::Erase(uint32_t key)
+{
+    if (m_Slots.empty())
+    {
+        return false;
+    }
+
+    const size_t mask = m_Slots.size() - 1;
+    size_t hole = GetHome(key);
+    while (m_Slots[hole].key != key)
+    {
+        if (m_Slots[hole].key == kEmpty)
+        {
+            return false;
+        }
+        hole = (hole + 1) & mask;
+    }
+
+    // Entries further along the run move back into the hole unless that would put them before their home
+    // slot, which would make them unreachable.
+    for (size_t index = (hole + 1) & mask; m_Slots[index].key != kEmpty; index = (index + 1) & mask)
+    {
+        const size_t home = GetHome(m_Slots[index].key);
+        if (((index - home) & mask) >= ((index - hole) & mask))
+        {
+            m_Slots[hole] = m_Slots[index];
+            hole = index;
+        }
+    }
+
+    m_Slots[hole].key = kEmpty;
+    m_Count--;
+    return true;
+}
+
+size_t FlatIdMap::GetHome(uint32_t key) const
+{
+    // Fibonacci hashing spreads sequential IDs, which NORAD IDs mostly are, across the whole table.
+    const uint32_t hash = key * 2654435769u;
+    return hash >> (32 - std::countr_zero(m_Slots.size()));
+}
+
+void FlatIdMap::Rehash(size_t capacity)
+{
+    std::vector<Slot> slots(capacity, Slot{ kEmpty, 0 });
+    slots.swap(m_Slots);
+    m_Count = 0;
+
+    for (const Slot& slot : slots)
+    {
+        if (slot.key != kEmpty)
+        {
+            Set(slot.key, slot.value);
+        }
+    }
+}
+
+} // namespace WingsOfSteel
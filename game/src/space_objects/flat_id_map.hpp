@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WingsOfSteel
+{
+
+// Open-addressing hash map from 32-bit IDs to 32-bit values, such as NORAD catalogue IDs to record
+// indexes. Keys and values sit side by side in one array and collisions are resolved by linear probing,
+// so a lookup is usually a single cache line. Erasing shifts the following entries back rather than
+// leaving tombstones, so lookups don't slow down as objects come and go.
+// ~0u can't be used as a key.
+class FlatIdMap
+{
+public:
+    static constexpr uint32_t kNotFound = ~0u;
+
+    FlatIdMap();
+    ~FlatIdMap();
+
+    void Reserve(size_t count);
+    void Clear();
+    size_t GetCount() const { return m_Count; }
+
+    uint32_t Find(uint32_t key) const;
+    void Set(uint32_t key, uint32_t value);
+    bool Erase(uint32_t key);
+
+private:
+    static constexpr uint32_t kEmpty = ~0u;
+
+    struct Slot
+    {
+        uint32_t key;
+        uint32_t value;
+    };
+
+    size_t GetHome(uint32_t key) const;
+    void Rehash(size_t capacity);
+
+    std::vector<Slot> m_Slots; // Capacity is a power of two
+    size_t m_Count{ 0 };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,145 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "space_objects/mapped_file.hpp"
+
+namespace WingsOfSteel
+{
+
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    // Sharing delete access lets another process rename a new file over this one, as snapshots are written.
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle = file;
+    m_Size = static_cast<size_t>(size.QuadPart);
+    m_IsOpen = true;
+
+    // Zero-length files can't be mapped.
+    if (m_Size == 0)
+    {
+        return true;
+    }
+
+    m_MappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_MappingHandle != nullptr)
+    {
+        m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    if (m_pData == nullptr)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+    {
+        UnmapViewOfFile(m_pData);
+    }
+    if (m_MappingHandle != nullptr)
+    {
+        CloseHandle(m_MappingHandle);
+    }
+    if (m_FileHandle != nullptr)
+    {
+        CloseHandle(m_FileHandle);
+    }
+
+    m_pData = nullptr;
+    m_MappingHandle = nullptr;
+    m_FileHandle = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    const int file = open(filePath.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping keeps its own reference to the file, so the descriptor isn't needed past this point.
+    const size_t size = static_cast<size_t>(status.st_size);
+    void* pData = nullptr;
+    if (size > 0)
+    {
+        pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file);
+
+    if (pData == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_pData = static_cast<const uint8_t*>(pData);
+    m_Size = size;
+    m_IsOpen = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(m_pData), m_Size);
+    }
+
+    m_pData = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
+
+#endif
+
+} // namespace WingsOfSteel
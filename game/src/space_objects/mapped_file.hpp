@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace WingsOfSteel
+{
+
+// Read-only memory mapping of a whole file. The contents are paged in by the OS as they are touched, so
+// opening even a large file costs next to nothing. Empty files open successfully with no data.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    bool IsOpen() const { return m_IsOpen; }
+    const uint8_t* GetData() const { return m_pData; }
+    size_t GetSize() const { return m_Size; }
+    std::string_view GetText() const { return std::string_view(reinterpret_cast<const char*>(m_pData), m_Size); }
+
+private:
+    const uint8_t* m_pData{ nullptr };
+    size_t m_Size{ 0 };
+    bool m_IsOpen{ false };
+#ifdef _WIN32
+    void* m_FileHandle{ nullptr };
+    void* m_MappingHandle{ nullptr };
+#endif
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,160 @@
+#include <string>
+#include <vector>
+
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/omm_fields.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// About 1500 Celestrak rows.
+constexpr size_t kChunkSize = 256 * 1024;
+
+constexpr std::string_view kByteOrderMark = "\xEF\xBB\xBF";
+
+// Reads the field starting at offset and moves offset past the comma which ends it. Quoted fields have their
+// quotes removed; if they contain doubled quotes, they are unescaped into decoded, which the result then
+// points to.
+std::string_view NextField(std::string_view line, size_t& offset, std::string& decoded)
+{
+    std::string_view field;
+    if (offset < line.size() && line[offset] == '"')
+    {
+        const size_t begin = offset + 1;
+        size_t end = line.find('"', begin);
+        bool escaped = false;
+        while (end != std::string_view::npos && end + 1 < line.size() && line[end + 1] == '"')
+        {
+            escaped = true;
+            end = line.find('"', end + 2);
+        }
+        end = end == std::string_view::npos ? line.size() : end;
+        field = line.substr(begin, end - begin);
+
+        if (escaped)
+        {
+            decoded.clear();
+            for (size_t i = 0; i < field.size(); ++i)
+            {
+                decoded.push_back(field[i]);
+                i += field[i] == '"' ? 1 : 0;
+            }
+            field = decoded;
+        }
+
+        offset = line.find(',', end);
+    }
+    else
+    {
+        const size_t end = line.find(',', offset);
+        field = line.substr(offset, (end == std::string_view::npos ? line.size() : end) - offset);
+        offset = end;
+    }
+
+    offset = offset == std::string_view::npos ? line.size() + 1 : offset + 1;
+    return field;
+}
+
+std::vector<OmmField> ReadHeader(std::string_view line)
+{
+    std::vector<OmmField> columns;
+    std::string decoded;
+    size_t offset = 0;
+    while (offset <= line.size())
+    {
+        columns.push_back(LookupOmmField(NextField(line, offset, decoded)));
+    }
+    return columns;
+}
+
+ElementSetReadResult ReadRows(const std::vector<OmmField>& columns, std::string_view text, const ElementSetCallback& onRecord)
+{
+    ElementSetReadResult result;
+    SpaceObject spaceObject;
+    std::string decoded;
+    size_t offset = 0;
+    while (offset < text.size())
+    {
+        const std::string_view line = NextLine(text, offset);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        OmmFieldWriter::ResetOptionalFields(spaceObject);
+
+        // Empty fields are absent ones.
+        uint32_t fields = 0;
+        size_t fieldOffset = 0;
+        for (size_t column = 0; column < columns.size() && fieldOffset <= line.size(); ++column)
+        {
+            const std::string_view field = NextField(line, fieldOffset, decoded);
+            if (!field.empty() && columns[column] != OmmField::Unknown && OmmFieldWriter::Write(columns[column], field, spaceObject))
+            {
+                fields |= OmmFieldBit(columns[column]);
+            }
+        }
+
+        if ((fields & kRequiredOmmFields) == kRequiredOmmFields)
+        {
+            onRecord(spaceObject);
+            result.records++;
+        }
+        else
+        {
+            result.rejected++;
+        }
+    }
+    return result;
+}
+
+size_t FindRowStart(std::string_view text, size_t offset)
+{
+    if (offset == 0)
+    {
+        return 0;
+    }
+    const size_t newline = text.find('\n', offset - 1);
+    return newline == std::string_view::npos ? text.size() : newline + 1;
+}
+
+} // anonymous namespace
+
+OmmCsvReader::Result OmmCsvReader::Read(std::string_view text, const ElementSetCallback& onRecord)
+{
+    if (text.starts_with(kByteOrderMark))
+    {
+        text.remove_prefix(kByteOrderMark.size());
+    }
+
+    size_t offset = 0;
+    const std::vector<OmmField> columns = ReadHeader(NextLine(text, offset));
+    return ReadRows(columns, text.substr(offset), onRecord);
+}
+
+OmmCsvReader::Result OmmCsvReader::ReadParallel(std::string_view text, WorkerPool& workerPool, const ElementSetCallback& onRecord)
+{
+    if (text.starts_with(kByteOrderMark))
+    {
+        text.remove_prefix(kByteOrderMark.size());
+    }
+
+    size_t offset = 0;
+    const std::vector<OmmField> columns = ReadHeader(NextLine(text, offset));
+    const std::string_view rows = text.substr(offset);
+    const std::vector<std::string_view> chunks = SplitIntoChunks(rows, kChunkSize, FindRowStart);
+    if (chunks.size() <= 1)
+    {
+        return ReadRows(columns, rows, onRecord);
+    }
+
+    return ReadChunksInParallel(chunks, workerPool, [&columns](std::string_view chunk, const ElementSetCallback& onChunkRecord) {
+        return ReadRows(columns, chunk, onChunkRecord);
+    }, onRecord);
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string_view>
+
+#include "space_objects/element_set_parsing.hpp"
+
+namespace WingsOfSteel
+{
+
+// Reader for OMM in CSV form, as published by Celestrak: a header row of OMM keywords, then one record per
+// row. Columns may come in any order and unknown ones are ignored. Fields are sliced out of the text in
+// place; quoted fields are supported, but mustn't span lines.
+class OmmCsvReader
+{
+public:
+    using Result = ElementSetReadResult;
+
+    static Result Read(std::string_view text, const ElementSetCallback& onRecord);
+
+    // Reads the rows in chunks spread over the worker pool. Records still reach onRecord in file order, on
+    // the calling thread.
+    static Result ReadParallel(std::string_view text, WorkerPool& workerPool, const ElementSetCallback& onRecord);
+};
+
+} // namespace WingsOfSteel
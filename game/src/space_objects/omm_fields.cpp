@@ -0,0 +1,195 @@
+#include <array>
+
+#include "space_objects/element_set_parsing.hpp"
+#include "space_objects/omm_fields.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+struct FieldName
+{
+    std::string_view name;
+    OmmField field;
+};
+
+constexpr std::array<FieldName, 15> kFieldNames = { {
+    { "OBJECT_NAME", OmmField::ObjectName },
+    { "OBJECT_ID", OmmField::ObjectId },
+    { "EPOCH", OmmField::Epoch },
+    { "MEAN_MOTION", OmmField::MeanMotion },
+    { "ECCENTRICITY", OmmField::Eccentricity },
+    { "INCLINATION", OmmField::Inclination },
+    { "RA_OF_ASC_NODE", OmmField::RightAscensionOfAscendingNode },
+    { "ARG_OF_PERICENTER", OmmField::ArgumentOfPericenter },
+    { "MEAN_ANOMALY", OmmField::MeanAnomaly },
+    { "NORAD_CAT_ID", OmmField::NoradCatalogueId },
+    { "ELEMENT_SET_NO", OmmField::ElementSetNumber },
+    { "REV_AT_EPOCH", OmmField::RevolutionsAtEpoch },
+    { "BSTAR", OmmField::Bstar },
+    { "MEAN_MOTION_DOT", OmmField::MeanMotionDot },
+    { "MEAN_MOTION_DDOT", OmmField::MeanMotionDdot },
+} };
+
+bool ParseFloat(std::string_view value, float& output)
+{
+    double result = 0.0;
+    if (!ParseDouble(value, result))
+    {
+        return false;
+    }
+    output = static_cast<float>(result);
+    return true;
+}
+
+template <typename T, typename ParseFunction>
+bool ParseOptional(std::string_view value, std::optional<T>& output, ParseFunction parse)
+{
+    T result{};
+    if (!parse(value, result))
+    {
+        return false;
+    }
+    output = result;
+    return true;
+}
+
+} // anonymous namespace
+
+OmmField LookupOmmField(std::string_view key)
+{
+    // Every key starts with a different letter or length, so most mismatches fail on the first comparison.
+    for (const FieldName& fieldName : kFieldNames)
+    {
+        if (fieldName.name.size() == key.size() && fieldName.name[0] == key[0] && fieldName.name == key)
+        {
+            return fieldName.field;
+        }
+    }
+    return OmmField::Unknown;
+}
+
+std::optional<std::chrono::system_clock::time_point> ParseOmmEpoch(std::string_view text)
+{
+    // Fixed layout: YYYY-MM-DDTHH:MM:SS, then optionally a fraction and a 'Z'.
+    constexpr size_t kFixedLength = 19;
+    if (text.size() < kFixedLength)
+    {
+        return std::nullopt;
+    }
+
+    auto readDigits = [text](size_t offset, size_t count, int& value) {
+        value = 0;
+        for (size_t i = offset; i < offset + count; ++i)
+        {
+            if (!IsDigit(text[i]))
+            {
+                return false;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    };
+
+    int year, month, day, hour, minute, second;
+    if (!readDigits(0, 4, year) || text[4] != '-' || !readDigits(5, 2, month) || text[7] != '-' || !readDigits(8, 2, day)
+        || (text[10] != 'T' && text[10] != ' ') || !readDigits(11, 2, hour) || text[13] != ':' || !readDigits(14, 2, minute)
+        || text[16] != ':' || !readDigits(17, 2, second))
+    {
+        return std::nullopt;
+    }
+
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+    {
+        return std::nullopt;
+    }
+
+    int64_t microseconds = 0;
+    size_t offset = kFixedLength;
+    if (offset < text.size() && text[offset] == '.')
+    {
+        int64_t scale = 100000;
+        for (++offset; offset < text.size() && IsDigit(text[offset]); ++offset)
+        {
+            microseconds += (text[offset] - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    if (offset < text.size() && text[offset] == 'Z')
+    {
+        ++offset;
+    }
+
+    if (offset != text.size())
+    {
+        return std::nullopt;
+    }
+
+    const int64_t seconds = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::seconds(seconds) + std::chrono::microseconds(microseconds)));
+}
+
+void OmmFieldWriter::ResetOptionalFields(SpaceObject& spaceObject)
+{
+    spaceObject.m_ElementSetNumber.reset();
+    spaceObject.m_RevolutionsAtEpoch.reset();
+    spaceObject.m_MeanMotionFirstDerivative.reset();
+    spaceObject.m_MeanMotionSecondDerivative.reset();
+    spaceObject.m_Bstar.reset();
+}
+
+bool OmmFieldWriter::Write(OmmField field, std::string_view value, SpaceObject& spaceObject)
+{
+    switch (field)
+    {
+    case OmmField::ObjectName:
+        spaceObject.m_ObjectName.assign(value);
+        return true;
+    case OmmField::ObjectId:
+        spaceObject.m_ObjectId.assign(value);
+        return true;
+    case OmmField::Epoch:
+    {
+        const std::optional<std::chrono::system_clock::time_point> epoch = ParseOmmEpoch(value);
+        if (epoch.has_value())
+        {
+            spaceObject.m_Epoch = epoch.value();
+        }
+        return epoch.has_value();
+    }
+    case OmmField::MeanMotion:
+        return ParseFloat(value, spaceObject.m_MeanMotion);
+    case OmmField::Eccentricity:
+        return ParseFloat(value, spaceObject.m_Eccentricity);
+    case OmmField::Inclination:
+        return ParseFloat(value, spaceObject.m_Inclination);
+    case OmmField::RightAscensionOfAscendingNode:
+        return ParseFloat(value, spaceObject.m_RightAscensionOfAscendingNode);
+    case OmmField::ArgumentOfPericenter:
+        return ParseFloat(value, spaceObject.m_ArgumentOfPericenter);
+    case OmmField::MeanAnomaly:
+        return ParseFloat(value, spaceObject.m_MeanAnomaly);
+    case OmmField::NoradCatalogueId:
+        return ParseUnsigned(value, spaceObject.m_NoradCatalogueId);
+    case OmmField::ElementSetNumber:
+        return ParseOptional(value, spaceObject.m_ElementSetNumber, ParseUnsigned);
+    case OmmField::RevolutionsAtEpoch:
+        return ParseOptional(value, spaceObject.m_RevolutionsAtEpoch, ParseUnsigned);
+    case OmmField::Bstar:
+        return ParseOptional(value, spaceObject.m_Bstar, ParseFloat);
+    case OmmField::MeanMotionDot:
+        return ParseOptional(value, spaceObject.m_MeanMotionFirstDerivative, ParseFloat);
+    case OmmField::MeanMotionDdot:
+        return ParseOptional(value, spaceObject.m_MeanMotionSecondDerivative, ParseFloat);
+    case OmmField::Unknown:
+        break;
+    }
+    return false;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+
+// The OMM (CCSDS 502.0) keywords the catalogue keeps, shared by the readers of each format OMM is
+// published in.
+enum class OmmField
+{
+    ObjectName,
+    ObjectId,
+    Epoch,
+    MeanMotion,
+    Eccentricity,
+    Inclination,
+    RightAscensionOfAscendingNode,
+    ArgumentOfPericenter,
+    MeanAnomaly,
+    NoradCatalogueId,
+    ElementSetNumber,
+    RevolutionsAtEpoch,
+    Bstar,
+    MeanMotionDot,
+    MeanMotionDdot,
+    Unknown
+};
+
+constexpr uint32_t OmmFieldBit(OmmField field)
+{
+    return 1u << static_cast<uint32_t>(field);
+}
+
+// Fields a record must have to be accepted, as in SpaceObject::DeserializeOMM().
+constexpr uint32_t kRequiredOmmFields = OmmFieldBit(OmmField::ObjectName) | OmmFieldBit(OmmField::ObjectId) | OmmFieldBit(OmmField::Epoch)
+    | OmmFieldBit(OmmField::MeanMotion) | OmmFieldBit(OmmField::Eccentricity) | OmmFieldBit(OmmField::Inclination)
+    | OmmFieldBit(OmmField::RightAscensionOfAscendingNode) | OmmFieldBit(OmmField::ArgumentOfPericenter) | OmmFieldBit(OmmField::MeanAnomaly)
+    | OmmFieldBit(OmmField::NoradCatalogueId);
+
+OmmField LookupOmmField(std::string_view key);
+
+// Parses an ISO 8601 UTC timestamp of the fixed form OMM epochs use, "2026-01-14T15:04:24.142944", with
+// or without the fractional seconds. Fractions are kept to the microsecond.
+std::optional<std::chrono::system_clock::time_point> ParseOmmEpoch(std::string_view text);
+
+class OmmFieldWriter
+{
+public:
+    // Optional fields which a record doesn't have mustn't carry over from the previous one.
+    static void ResetOptionalFields(SpaceObject& spaceObject);
+
+    // Stores the value of a field, once any quoting or escaping has been removed. Returns false if the value
+    // isn't valid for the field, or the field is unknown.
+    static bool Write(OmmField field, std::string_view value, SpaceObject& spaceObject);
+};
+
+} // namespace WingsOfSteel
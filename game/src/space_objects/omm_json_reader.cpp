@@ -0,0 +1,388 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "space_objects/element_set_parsing.hpp"
+#include "space_objects/omm_fields.hpp"
+#include "space_objects/omm_json_reader.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+enum class ValueKind
+{
+    String,
+    Number, // Also true and false, which are never valid for OMM fields and fail to parse as numbers
+    Null,
+    Composite // Objects and arrays, which are skipped
+};
+
+struct Value
+{
+    ValueKind kind{ ValueKind::Null };
+    std::string_view raw; // Contents of a string, without the quotes, or the token of a bare value
+    bool escaped{ false }; // Strings only: raw contains escape sequences
+};
+
+void AppendUtf8(uint32_t codePoint, std::string& output)
+{
+    if (codePoint < 0x80)
+    {
+        output.push_back(static_cast<char>(codePoint));
+    }
+    else if (codePoint < 0x800)
+    {
+        output.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        output.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if (codePoint < 0x10000)
+    {
+        output.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else
+    {
+        output.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        output.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool ParseHex4(std::string_view text, size_t offset, uint32_t& value)
+{
+    if (offset + 4 > text.size())
+    {
+        return false;
+    }
+
+    value = 0;
+    for (size_t i = offset; i < offset + 4; ++i)
+    {
+        const char c = text[i];
+        value <<= 4;
+        if (IsDigit(c))
+        {
+            value |= c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            value |= c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            value |= c - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decodes the escape sequences in the raw contents of a string. Object names are the only values which
+// ever have them, and then rarely, so this is kept off the common path.
+bool DecodeString(std::string_view raw, std::string& output)
+{
+    output.clear();
+    for (size_t i = 0; i < raw.size(); ++i)
+    {
+        if (raw[i] != '\\')
+        {
+            output.push_back(raw[i]);
+            continue;
+        }
+
+        if (++i == raw.size())
+        {
+            return false;
+        }
+
+        switch (raw[i])
+        {
+        case '"':
+        case '\\':
+        case '/':
+            output.push_back(raw[i]);
+            break;
+        case 'b':
+            output.push_back('\b');
+            break;
+        case 'f':
+            output.push_back('\f');
+            break;
+        case 'n':
+            output.push_back('\n');
+            break;
+        case 'r':
+            output.push_back('\r');
+            break;
+        case 't':
+            output.push_back('\t');
+            break;
+        case 'u':
+        {
+            uint32_t codePoint = 0;
+            if (!ParseHex4(raw, i + 1, codePoint))
+            {
+                return false;
+            }
+            i += 4;
+
+            // Characters outside the basic multilingual plane are escaped as surrogate pairs.
+            uint32_t lowSurrogate = 0;
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u'
+                && ParseHex4(raw, i + 3, lowSurrogate) && lowSurrogate >= 0xDC00 && lowSurrogate < 0xE000)
+            {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                i += 6;
+            }
+            AppendUtf8(codePoint, output);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+class Tokenizer
+{
+public:
+    explicit Tokenizer(std::string_view text)
+        : m_pCursor(text.data())
+        , m_pEnd(text.data() + text.size())
+    {
+    }
+
+    bool Consume(char c)
+    {
+        SkipWhitespace();
+        if (m_pCursor < m_pEnd && *m_pCursor == c)
+        {
+            ++m_pCursor;
+            return true;
+        }
+        return false;
+    }
+
+    bool AtEnd()
+    {
+        SkipWhitespace();
+        return m_pCursor == m_pEnd;
+    }
+
+    bool ReadString(Value& value)
+    {
+        if (!Consume('"'))
+        {
+            return false;
+        }
+
+        // Jump to the next quote, and only walk the string byte by byte if it turns out to have escapes,
+        // as one of them might be an escaped quote.
+        const char* pBegin = m_pCursor;
+        const char* pQuote = static_cast<const char*>(std::memchr(pBegin, '"', m_pEnd - pBegin));
+        value.kind = ValueKind::String;
+        value.escaped = pQuote != nullptr && std::memchr(pBegin, '\\', pQuote - pBegin) != nullptr;
+        if (value.escaped)
+        {
+            pQuote = pBegin;
+            while (pQuote < m_pEnd && *pQuote != '"')
+            {
+                pQuote += *pQuote == '\\' ? 2 : 1;
+            }
+        }
+
+        if (pQuote == nullptr || pQuote >= m_pEnd)
+        {
+            return false;
+        }
+        value.raw = std::string_view(pBegin, pQuote - pBegin);
+        m_pCursor = pQuote + 1;
+        return true;
+    }
+
+    bool ReadValue(Value& value)
+    {
+        SkipWhitespace();
+        if (m_pCursor == m_pEnd)
+        {
+            return false;
+        }
+
+        switch (*m_pCursor)
+        {
+        case '"':
+            return ReadString(value);
+        case '{':
+        case '[':
+            value.kind = ValueKind::Composite;
+            return SkipComposite();
+        default:
+        {
+            // Numbers and literals run until the next delimiter, and are validated when they are parsed.
+            const char* pBegin = m_pCursor;
+            while (m_pCursor < m_pEnd && !IsDelimiter(*m_pCursor))
+            {
+                ++m_pCursor;
+            }
+            value.raw = std::string_view(pBegin, m_pCursor - pBegin);
+            value.kind = value.raw == "null" ? ValueKind::Null : ValueKind::Number;
+            value.escaped = false;
+            return !value.raw.empty();
+        }
+        }
+    }
+
+private:
+    static bool IsDelimiter(char c)
+    {
+        return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void SkipWhitespace()
+    {
+        while (m_pCursor < m_pEnd && (*m_pCursor == ' ' || *m_pCursor == '\n' || *m_pCursor == '\r' || *m_pCursor == '\t'))
+        {
+            ++m_pCursor;
+        }
+    }
+
+    // Skips a nested object or array. Only the nesting and the strings matter, so the contents aren't checked.
+    bool SkipComposite()
+    {
+        size_t depth = 0;
+        do
+        {
+            const char c = *m_pCursor;
+            if (c == '"')
+            {
+                Value ignored;
+                if (!ReadString(ignored))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if (c == '{' || c == '[')
+            {
+                depth++;
+            }
+            else if (c == '}' || c == ']')
+            {
+                depth--;
+            }
+            ++m_pCursor;
+        } while (depth > 0 && m_pCursor < m_pEnd);
+        return depth == 0;
+    }
+
+    const char* m_pCursor;
+    const char* m_pEnd;
+};
+
+} // anonymous namespace
+
+OmmJsonReader::Result OmmJsonReader::Read(std::string_view text, const RecordCallback& onRecord)
+{
+    Result result;
+    Tokenizer tokenizer(text);
+
+    // Files hold either an array of records or a single record.
+    const bool isArray = tokenizer.Consume('[');
+    if (isArray && tokenizer.Consume(']'))
+    {
+        return result;
+    }
+
+    SpaceObject spaceObject;
+    std::string decoded;
+    Value key;
+    Value value;
+    while (true)
+    {
+        if (!tokenizer.Consume('{'))
+        {
+            result.valid = false;
+            return result;
+        }
+
+        OmmFieldWriter::ResetOptionalFields(spaceObject);
+
+        uint32_t fields = 0;
+        if (!tokenizer.Consume('}'))
+        {
+            do
+            {
+                if (!tokenizer.ReadString(key) || !tokenizer.Consume(':') || !tokenizer.ReadValue(value))
+                {
+                    result.valid = false;
+                    return result;
+                }
+
+                if (value.kind == ValueKind::Null || value.kind == ValueKind::Composite)
+                {
+                    continue;
+                }
+
+                // Names, IDs and epochs must be strings; numbers may be quoted or not.
+                const OmmField field = LookupOmmField(key.raw);
+                const bool isText = field == OmmField::ObjectName || field == OmmField::ObjectId || field == OmmField::Epoch;
+                if (field == OmmField::Unknown || (isText && value.kind != ValueKind::String))
+                {
+                    continue;
+                }
+
+                std::string_view text = value.raw;
+                if (value.escaped)
+                {
+                    if (!DecodeString(value.raw, decoded))
+                    {
+                        continue;
+                    }
+                    text = decoded;
+                }
+
+                if (OmmFieldWriter::Write(field, text, spaceObject))
+                {
+                    fields |= OmmFieldBit(field);
+                }
+            } while (tokenizer.Consume(','));
+
+            if (!tokenizer.Consume('}'))
+            {
+                result.valid = false;
+                return result;
+            }
+        }
+
+        if ((fields & kRequiredOmmFields) == kRequiredOmmFields)
+        {
+            onRecord(spaceObject);
+            result.records++;
+        }
+        else
+        {
+            result.rejected++;
+        }
+
+        if (!isArray || !tokenizer.Consume(','))
+        {
+            break;
+        }
+    }
+
+    result.valid = isArray ? tokenizer.Consume(']') && tokenizer.AtEnd() : tokenizer.AtEnd();
+    return result;
+}
+
+} // namespace WingsOfSteel
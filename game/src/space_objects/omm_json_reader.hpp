@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+
+// Streaming reader for OMM JSON (CCSDS 502.0), as published by Celestrak and Space-Track.
+// The text is tokenised in a single pass without building a DOM: each record's fields are written straight
+// into a SpaceObject, which is handed to the callback once the record closes and then reused for the next
+// one. Numbers are accepted either bare or quoted, as Space-Track quotes every value.
+class OmmJsonReader
+{
+public:
+    using RecordCallback = std::function<void(const SpaceObject& spaceObject)>;
+
+    struct Result
+    {
+        size_t records{ 0 }; // Records passed to the callback
+        size_t rejected{ 0 }; // Records missing a required field
+        bool valid{ true }; // False if the text isn't well-formed JSON, in which case reading stops there
+    };
+
+    static Result Read(std::string_view text, const RecordCallback& onRecord);
+};
+
+} // namespace WingsOfSteel
@@ -1,49 +1,10 @@
-#include <ctime>
-#include <iomanip>
-#include <sstream>
-
 #include "core/serialization.hpp"
+#include "space_objects/omm_fields.hpp"
 #include "space_objects/space_object.hpp"
 
 namespace WingsOfSteel
 {
 
-namespace
-{
-
-// Parse ISO 8601 timestamp: "2026-01-14T15:04:24.142944"
-std::chrono::system_clock::time_point ParseEpoch(const std::string& epochStr)
-{
-    std::tm tm = {};
-    std::istringstream ss(epochStr);
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-
-    // Convert to time_t (UTC)
-#ifdef _WIN32
-    std::time_t time = _mkgmtime(&tm);
-#else
-    std::time_t time = timegm(&tm);
-#endif
-
-    auto tp = std::chrono::system_clock::from_time_t(time);
-
-    // Parse fractional seconds if present
-    if (ss.peek() == '.')
-    {
-        ss.get(); // consume the '.'
-        std::string fractional;
-        ss >> fractional;
-        // Pad or truncate to 6 digits (microseconds)
-        fractional.resize(6, '0');
-        int microseconds = std::stoi(fractional);
-        tp += std::chrono::microseconds(microseconds);
-    }
-
-    return tp;
-}
-
-} // anonymous namespace
-
 SpaceObject::SpaceObject()
 {
 }
@@ -64,6 +25,11 @@ bool SpaceObject::DeserializeOMM(const Json::Data& data)
     auto argOfPericenter = Json::TryDeserializeFloat(nullptr, data, "ARG_OF_PERICENTER");
     auto meanAnomaly = Json::TryDeserializeFloat(nullptr, data, "MEAN_ANOMALY");
     auto noradCatId = Json::TryDeserializeUnsignedInteger(nullptr, data, "NORAD_CAT_ID");
+    auto elementSetNo = Json::TryDeserializeUnsignedInteger(nullptr, data, "ELEMENT_SET_NO");
+    auto revAtEpoch = Json::TryDeserializeUnsignedInteger(nullptr, data, "REV_AT_EPOCH");
+    auto bstar = Json::TryDeserializeFloat(nullptr, data, "BSTAR");
+    auto meanMotionDot = Json::TryDeserializeFloat(nullptr, data, "MEAN_MOTION_DOT");
+    auto meanMotionDdot = Json::TryDeserializeFloat(nullptr, data, "MEAN_MOTION_DDOT");
 
     if (!objectName.has_value() || !objectId.has_value() || !epoch.has_value() ||
         !meanMotion.has_value() || !eccentricity.has_value() || !inclination.has_value() ||
@@ -73,9 +39,15 @@ bool SpaceObject::DeserializeOMM(const Json::Data& data)
         return false;
     }
 
+    const std::optional<std::chrono::system_clock::time_point> parsedEpoch = ParseOmmEpoch(epoch.value());
+    if (!parsedEpoch.has_value())
+    {
+        return false;
+    }
+
     m_ObjectName = objectName.value();
     m_ObjectId = objectId.value();
-    m_Epoch = ParseEpoch(epoch.value());
+    m_Epoch = parsedEpoch.value();
     m_MeanMotion = meanMotion.value();
     m_Eccentricity = eccentricity.value();
     m_Inclination = inclination.value();
@@ -84,6 +56,13 @@ bool SpaceObject::DeserializeOMM(const Json::Data& data)
     m_MeanAnomaly = meanAnomaly.value();
     m_NoradCatalogueId = noradCatId.value();
 
+    // Only needed by SGP4 and for bookkeeping, so element sets without them are still accepted.
+    m_ElementSetNumber = elementSetNo;
+    m_RevolutionsAtEpoch = revAtEpoch;
+    m_Bstar = bstar;
+    m_MeanMotionFirstDerivative = meanMotionDot;
+    m_MeanMotionSecondDerivative = meanMotionDdot;
+
     return true;
 }
 
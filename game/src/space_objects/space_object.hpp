@@ -27,8 +27,18 @@ public:
     float GetArgumentOfPericenter() const { return m_ArgumentOfPericenter; }
     float GetMeanAnomaly() const { return m_MeanAnomaly; }
     uint32_t GetNoradCatalogueId() const { return m_NoradCatalogueId; }
+    std::optional<uint32_t> GetElementSetNumber() const { return m_ElementSetNumber; }
+    std::optional<uint32_t> GetRevolutionsAtEpoch() const { return m_RevolutionsAtEpoch; }
+    std::optional<float> GetBstar() const { return m_Bstar; } // 1/earth radii
+    std::optional<float> GetMeanMotionFirstDerivative() const { return m_MeanMotionFirstDerivative; } // rev/day²
+    std::optional<float> GetMeanMotionSecondDerivative() const { return m_MeanMotionSecondDerivative; } // rev/day³
 
 private:
+    friend class CatalogueSnapshot;
+    friend class ElementSetHistory;
+    friend class OmmFieldWriter;
+    friend class TleReader;
+
     std::string m_ObjectName{ "UNKNOWN" };
     std::string m_ObjectId{ "0" };
     std::chrono::system_clock::time_point m_Epoch;
@@ -44,6 +54,7 @@ private:
     std::optional<uint32_t> m_RevolutionsAtEpoch{ 0 };
     std::optional<float> m_MeanMotionFirstDerivative{ 0.0f };
     std::optional<float> m_MeanMotionSecondDerivative{ 0.0f };
+    std::optional<float> m_Bstar{ 0.0f };
 };
 
 }
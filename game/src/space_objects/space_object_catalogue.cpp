@@ -1,3 +1,7 @@
+#include <chrono>
+#include <span>
+#include <vector>
+
 #include "space_objects/space_object_catalogue.hpp"
 
 namespace WingsOfSteel
@@ -11,19 +15,394 @@ SpaceObjectCatalogue::~SpaceObjectCatalogue()
 {
 }
 
-void SpaceObjectCatalogue::Add(const SpaceObject& spaceObject)
+bool SpaceObjectCatalogue::Add(const SpaceObject& spaceObject, GroupMask groups)
+{
+    UnpackSnapshot();
+
+    const uint32_t noradId = spaceObject.GetNoradCatalogueId();
+    const uint32_t recordIndex = m_RecordIndexes.Find(noradId);
+    const bool added = recordIndex == FlatIdMap::kNotFound;
+    bool replaced = added;
+    if (added)
+    {
+        m_RecordIndexes.Set(noradId, static_cast<uint32_t>(m_Records.size()));
+        CatalogueSnapshot::Pack(spaceObject, m_Strings, m_Records.emplace_back());
+        m_GroupMasks.push_back(groups);
+    }
+    else
+    {
+        m_GroupMasks[recordIndex] |= groups;
+
+        // Objects which came from a snapshot have no history yet, so the element set being replaced goes
+        // into it first.
+        Record& record = m_Records[recordIndex];
+        if (m_History.GetElementSetCount(noradId) == 0)
+        {
+            SpaceObject current;
+            Unpack(record, current);
+            m_History.Append(current);
+        }
+
+        const int64_t epoch = std::chrono::duration_cast<std::chrono::microseconds>(spaceObject.GetEpoch().time_since_epoch()).count();
+        if (epoch >= record.epoch)
+        {
+            CatalogueSnapshot::Pack(spaceObject, m_Strings, record);
+            replaced = true;
+        }
+    }
+
+    // Older element sets only go into the history, so they leave the record, and the indexes, as they were.
+    m_History.Append(spaceObject);
+    if (m_IndexBuilt && replaced)
+    {
+        m_Index.Insert(spaceObject);
+    }
+    return added;
+}
+
+void SpaceObjectCatalogue::Remove(uint32_t noradId)
+{
+    UnpackSnapshot();
+
+    // The last record moves into the gap, so records stay contiguous.
+    const uint32_t recordIndex = m_RecordIndexes.Find(noradId);
+    if (recordIndex == FlatIdMap::kNotFound)
+    {
+        return;
+    }
+    if (recordIndex + 1 != m_Records.size())
+    {
+        m_Records[recordIndex] = m_Records.back();
+        m_GroupMasks[recordIndex] = m_GroupMasks.back();
+        m_RecordIndexes.Set(m_Records[recordIndex].noradCatalogueId, recordIndex);
+    }
+    m_Records.pop_back();
+    m_GroupMasks.pop_back();
+    m_RecordIndexes.Erase(noradId);
+    m_History.Erase(noradId);
+
+    if (m_IndexBuilt)
+    {
+        m_Index.Erase(noradId);
+    }
+}
+
+std::optional<SpaceObjectView> SpaceObjectCatalogue::GetByNoradId(uint32_t noradId) const
+{
+    if (m_Snapshot.IsOpen())
+    {
+        const CatalogueSnapshot::Record* pRecord = m_Snapshot.FindByNoradId(noradId);
+        return pRecord ? std::optional<SpaceObjectView>(GetView(*pRecord)) : std::nullopt;
+    }
+
+    const uint32_t recordIndex = m_RecordIndexes.Find(noradId);
+    return recordIndex == FlatIdMap::kNotFound ? std::nullopt : std::optional<SpaceObjectView>(GetView(m_Records[recordIndex]));
+}
+
+SpaceObjectCatalogue::GroupMask SpaceObjectCatalogue::GetGroups(uint32_t noradId) const
+{
+    // Snapshots don't store groups, so a mapped catalogue's objects aren't in any.
+    const uint32_t recordIndex = m_Snapshot.IsOpen() ? FlatIdMap::kNotFound : m_RecordIndexes.Find(noradId);
+    return recordIndex == FlatIdMap::kNotFound ? 0 : m_GroupMasks[recordIndex];
+}
+
+void SpaceObjectCatalogue::Merge(const SpaceObjectCatalogue& source, size_t begin, size_t end, GroupMask groups, std::vector<uint32_t>& added, std::vector<uint32_t>& updated)
+{
+    UnpackSnapshot();
+
+    for (size_t index = begin; index < end; ++index)
+    {
+        const SpaceObjectView sourceObject = source.GetView(source.GetRecord(index));
+        const uint32_t noradId = sourceObject.GetNoradCatalogueId();
+        uint32_t recordIndex = m_RecordIndexes.Find(noradId);
+        const bool existed = recordIndex != FlatIdMap::kNotFound;
+        const size_t elementSetCount = m_History.GetElementSetCount(noradId);
+
+        bool replaced = !existed;
+        if (existed)
+        {
+            // As in Add(), objects which came from a snapshot have no history yet.
+            m_GroupMasks[recordIndex] |= groups;
+            if (elementSetCount == 0)
+            {
+                m_History.Append(GetView(m_Records[recordIndex]));
+            }
+            replaced = sourceObject.GetRecord().epoch >= m_Records[recordIndex].epoch;
+        }
+        else
+        {
+            recordIndex = static_cast<uint32_t>(m_Records.size());
+            m_RecordIndexes.Set(noradId, recordIndex);
+            m_Records.emplace_back();
+            m_GroupMasks.push_back(groups);
+        }
+
+        if (replaced)
+        {
+            Record& record = m_Records[recordIndex];
+            record = sourceObject.GetRecord();
+            record.objectName = m_Strings.Intern(sourceObject.GetObjectName());
+            record.objectId = m_Strings.Intern(sourceObject.GetObjectId());
+        }
+
+        // A mapped source has no history either, so its record is its only element set.
+        const std::span<const uint32_t> rows = source.m_History.GetElementSets(noradId);
+        if (rows.empty())
+        {
+            m_History.Append(sourceObject);
+        }
+        for (uint32_t row : rows)
+        {
+            m_History.Append(noradId, source.m_History, row);
+        }
+
+        if (m_IndexBuilt && replaced)
+        {
+            m_Index.Insert(GetView(m_Records[recordIndex]));
+        }
+
+        if (!existed)
+        {
+            added.push_back(noradId);
+        }
+        else if (m_History.GetElementSetCount(noradId) != elementSetCount)
+        {
+            updated.push_back(noradId);
+        }
+    }
+}
+
+bool SpaceObjectCatalogue::Release(uint32_t noradId, GroupMask groups)
+{
+    UnpackSnapshot();
+
+    const uint32_t recordIndex = m_RecordIndexes.Find(noradId);
+    if (recordIndex == FlatIdMap::kNotFound || (m_GroupMasks[recordIndex] & groups) == 0)
+    {
+        return false;
+    }
+
+    m_GroupMasks[recordIndex] &= ~groups;
+    if (m_GroupMasks[recordIndex] != 0)
+    {
+        return false;
+    }
+    Remove(noradId);
+    return true;
+}
+
+void SpaceObjectCatalogue::ReleaseGroups(GroupMask groups, std::vector<uint32_t>& removed)
+{
+    UnpackSnapshot();
+
+    // Walked backwards, so the records which Remove() moves into gaps have already been visited.
+    const size_t removedCount = removed.size();
+    for (size_t recordIndex = m_Records.size(); recordIndex-- > 0;)
+    {
+        const uint32_t noradId = m_Records[recordIndex].noradCatalogueId;
+        if (Release(noradId, groups))
+        {
+            removed.push_back(noradId);
+        }
+    }
+
+    if (removed.size() != removedCount)
+    {
+        Compact();
+    }
+}
+
+std::string_view SpaceObjectCatalogue::GetObjectName(uint32_t noradId) const
+{
+    const std::optional<SpaceObjectView> spaceObject = GetByNoradId(noradId);
+    return spaceObject.has_value() ? spaceObject->GetObjectName() : std::string_view();
+}
+
+size_t SpaceObjectCatalogue::GetCount() const
+{
+    return m_Snapshot.IsOpen() ? m_Snapshot.GetCount() : m_Records.size();
+}
+
+void SpaceObjectCatalogue::ForEach(const SpaceObjectCallback& callback) const
+{
+    if (m_Snapshot.IsOpen())
+    {
+        SpaceObject spaceObject;
+        for (size_t index = 0; index < m_Snapshot.GetCount(); ++index)
+        {
+            m_Snapshot.Unpack(m_Snapshot.GetRecord(index), spaceObject);
+            callback(spaceObject);
+        }
+        return;
+    }
+
+    SpaceObject spaceObject;
+    for (const Record& record : m_Records)
+    {
+        Unpack(record, spaceObject);
+        callback(spaceObject);
+    }
+}
+
+std::vector<uint32_t> SpaceObjectCatalogue::GetNoradIds() const
+{
+    std::vector<uint32_t> noradIds;
+    noradIds.reserve(GetCount());
+    if (m_Snapshot.IsOpen())
+    {
+        for (size_t index = 0; index < m_Snapshot.GetCount(); ++index)
+        {
+            noradIds.push_back(m_Snapshot.GetRecord(index).noradCatalogueId);
+        }
+    }
+    else
+    {
+        for (const Record& record : m_Records)
+        {
+            noradIds.push_back(record.noradCatalogueId);
+        }
+    }
+    return noradIds;
+}
+
+std::vector<uint32_t> SpaceObjectCatalogue::GetNoradIds(GroupMask groups) const
+{
+    std::vector<uint32_t> noradIds;
+    if (!m_Snapshot.IsOpen())
+    {
+        for (size_t index = 0; index < m_Records.size(); ++index)
+        {
+            if ((m_GroupMasks[index] & groups) != 0)
+            {
+                noradIds.push_back(m_Records[index].noradCatalogueId);
+            }
+        }
+    }
+    return noradIds;
+}
+
+std::vector<uint32_t> SpaceObjectCatalogue::FindByNamePrefix(std::string_view prefix, size_t maximumCount) const
+{
+    std::vector<uint32_t> noradIds;
+    GetIndex().FindByNamePrefix(prefix, maximumCount, noradIds);
+    return noradIds;
+}
+
+std::optional<SpaceObjectView> SpaceObjectCatalogue::FindByObjectId(std::string_view objectId) const
+{
+    const std::optional<uint32_t> noradId = GetIndex().FindByObjectId(objectId);
+    return noradId.has_value() ? GetByNoradId(noradId.value()) : std::nullopt;
+}
+
+std::vector<uint32_t> SpaceObjectCatalogue::FindByRegime(OrbitalRegime regime) const
+{
+    std::vector<uint32_t> noradIds;
+    GetIndex().FindByRegime(regime, noradIds);
+    return noradIds;
+}
+
+std::vector<uint32_t> SpaceObjectCatalogue::FindInRanges(const CatalogueIndex::RangeQuery& query) const
+{
+    std::vector<uint32_t> noradIds;
+    GetIndex().FindInRanges(query, noradIds);
+    return noradIds;
+}
+
+const CatalogueIndex& SpaceObjectCatalogue::GetIndex() const
+{
+    // Built on demand, so mapping a snapshot doesn't have to unpack every record up front.
+    if (!m_IndexBuilt)
+    {
+        m_Index.Clear();
+        ForEach([this](const SpaceObject& spaceObject) { m_Index.Insert(spaceObject); });
+        m_IndexBuilt = true;
+    }
+    return m_Index;
+}
+
+bool SpaceObjectCatalogue::MapSnapshot(const std::string& filePath)
+{
+    if (!m_Snapshot.Open(filePath))
+    {
+        return false;
+    }
+
+    m_Records.clear();
+    m_GroupMasks.clear();
+    m_RecordIndexes.Clear();
+    m_Strings.Clear();
+    m_History.Clear();
+    m_Index.Clear();
+    m_IndexBuilt = false;
+    return true;
+}
+
+bool SpaceObjectCatalogue::WriteSnapshot(const std::string& filePath) const
+{
+    // Records are written out as they are. The new snapshot replaces the file rather than being written into
+    // it, so on POSIX systems writing over the mapped file is safe. Windows may refuse to replace a file while
+    // it's mapped, in which case the write fails and the old snapshot is left as it was.
+    if (m_Snapshot.IsOpen())
+    {
+        std::vector<Record> records(m_Snapshot.GetRecords(), m_Snapshot.GetRecords() + m_Snapshot.GetCount());
+        return CatalogueSnapshot::Write(filePath, std::move(records), m_Snapshot.GetStringTable());
+    }
+    return CatalogueSnapshot::Write(filePath, m_Records, m_Strings.GetData());
+}
+
+void SpaceObjectCatalogue::UnpackSnapshot()
+{
+    if (!m_Snapshot.IsOpen())
+    {
+        return;
+    }
+
+    // The snapshot's records and string table are in the catalogue's own format, so they're copied as is.
+    m_Records.assign(m_Snapshot.GetRecords(), m_Snapshot.GetRecords() + m_Snapshot.GetCount());
+    m_Strings.Assign(m_Snapshot.GetStringTable());
+    m_GroupMasks.assign(m_Records.size(), 0);
+    m_RecordIndexes.Clear();
+    m_RecordIndexes.Reserve(m_Records.size());
+    for (size_t index = 0; index < m_Records.size(); ++index)
+    {
+        m_RecordIndexes.Set(m_Records[index].noradCatalogueId, static_cast<uint32_t>(index));
+    }
+    m_Snapshot.Close();
+}
+
+void SpaceObjectCatalogue::Compact()
+{
+    // Names and COSPAR IDs of removed objects are still interned, so the strings which are left are
+    // interned again into a new arena.
+    StringArena strings;
+    for (Record& record : m_Records)
+    {
+        record.objectName = strings.Intern(m_Strings.Get(record.objectName));
+        record.objectId = strings.Intern(m_Strings.Get(record.objectId));
+    }
+    m_Strings = std::move(strings);
+    m_Records.shrink_to_fit();
+    m_GroupMasks.shrink_to_fit();
+}
+
+void SpaceObjectCatalogue::Unpack(const Record& record, SpaceObject& spaceObject) const
+{
+    GetView(record).Unpack(spaceObject);
+}
+
+const SpaceObjectCatalogue::Record& SpaceObjectCatalogue::GetRecord(size_t index) const
 {
-    m_SpaceObjects[spaceObject.GetNoradCatalogueId()] = spaceObject;
+    return m_Snapshot.IsOpen() ? m_Snapshot.GetRecord(index) : m_Records[index];
 }
 
-const SpaceObject* SpaceObjectCatalogue::GetByNoradId(uint32_t noradId) const
+SpaceObjectView SpaceObjectCatalogue::GetView(const Record& record) const
 {
-    auto it = m_SpaceObjects.find(noradId);
-    if (it != m_SpaceObjects.end())
+    // Records in the mapped snapshot refer to its string table, and the catalogue's own to the arena.
+    if (m_Snapshot.IsOpen())
     {
-        return &it->second;
+        return SpaceObjectView(record, m_Snapshot.GetString(record.objectName), m_Snapshot.GetString(record.objectId));
     }
-    return nullptr;
+    return SpaceObjectView(record, m_Strings.Get(record.objectName), m_Strings.Get(record.objectId));
 }
 
 } // namespace WingsOfSteel
@@ -1,26 +1,106 @@
 #pragma once
 
-#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "core/smart_ptr.hpp"
+#include "space_objects/catalogue_index.hpp"
+#include "space_objects/catalogue_snapshot.hpp"
+#include "space_objects/element_set_history.hpp"
+#include "space_objects/flat_id_map.hpp"
 #include "space_objects/space_object.hpp"
+#include "space_objects/space_object_view.hpp"
+#include "space_objects/string_arena.hpp"
 
 namespace WingsOfSteel
 {
 
+// Objects are stored as packed 64 byte records, a cache line each, with their names and COSPAR IDs interned
+// in a string arena. They're found by NORAD catalogue ID through a flat hash map of record indexes, and read
+// in place through a SpaceObjectView when they're looked up; only visiting them unpacks SpaceObjects.
+// Each object also has a mask of the groups it was loaded from, such as Celestrak's "starlink" or
+// "gps-ops". Groups overlap, but an object listed in several of them still has a single record, which is
+// only removed once the last of its groups is released.
 DECLARE_SMART_PTR(SpaceObjectCatalogue);
 class SpaceObjectCatalogue
 {
 public:
+    using SpaceObjectCallback = std::function<void(const SpaceObject& spaceObject)>;
+    using GroupMask = uint64_t;
+    static constexpr size_t kMaximumGroupCount = 64;
+
     SpaceObjectCatalogue();
     ~SpaceObjectCatalogue();
 
-    void Add(const SpaceObject& spaceObject);
-    const SpaceObject* GetByNoradId(uint32_t noradId) const;
-    size_t GetCount() const { return m_SpaceObjects.size(); }
+    // Adds an element set to the object's history, and the object to groups. The object's record is replaced
+    // if the element set is at least as recent as the one it holds. Returns true if the object wasn't in the
+    // catalogue yet.
+    bool Add(const SpaceObject& spaceObject, GroupMask groups = 0);
+    void Remove(uint32_t noradId);
+    // The view is only valid until the next change.
+    std::optional<SpaceObjectView> GetByNoradId(uint32_t noradId) const;
+    GroupMask GetGroups(uint32_t noradId) const;
+
+    // Adds the objects and element sets of another catalogue, such as one loaded on a background task, from
+    // its record at begin up to end, so a large catalogue can be merged a batch at a time. Records are copied
+    // as they are, with only their names and COSPAR IDs interned again. The NORAD catalogue IDs of objects
+    // which weren't in this catalogue yet are appended to added, and those of objects which already were
+    // and gained an element set to updated.
+    void Merge(const SpaceObjectCatalogue& source, size_t begin, size_t end, GroupMask groups, std::vector<uint32_t>& added, std::vector<uint32_t>& updated);
+
+    // Takes an object out of groups, removing it if that leaves it in none. Objects added without a group
+    // are never removed this way. Returns true if the object was removed.
+    bool Release(uint32_t noradId, GroupMask groups);
+
+    // Takes every object out of groups. The NORAD catalogue IDs of those which were removed as a result are
+    // appended to removed.
+    void ReleaseGroups(GroupMask groups, std::vector<uint32_t>& removed);
+
+    // Reads the name without unpacking the rest of the record. The view is only valid until the next change.
+    std::string_view GetObjectName(uint32_t noradId) const;
+    size_t GetCount() const;
+    void ForEach(const SpaceObjectCallback& callback) const;
+    std::vector<uint32_t> GetNoradIds() const;
+    std::vector<uint32_t> GetNoradIds(GroupMask groups) const; // Objects in any of the groups
+
+    // Lookups through the secondary indexes, which return NORAD catalogue IDs. The indexes are built by the
+    // first lookup and kept up to date by Add() and Remove() from then on.
+    std::vector<uint32_t> FindByNamePrefix(std::string_view prefix, size_t maximumCount) const;
+    std::optional<SpaceObjectView> FindByObjectId(std::string_view objectId) const;
+    std::vector<uint32_t> FindByRegime(OrbitalRegime regime) const;
+    std::vector<uint32_t> FindInRanges(const CatalogueIndex::RangeQuery& query) const;
+
+    // Replaces the catalogue's contents with a snapshot, which is then used in place: records are only
+    // unpacked when they're looked up. Adding or removing an object afterwards unpacks the whole snapshot first.
+    bool MapSnapshot(const std::string& filePath);
+    bool WriteSnapshot(const std::string& filePath) const;
+    bool IsSnapshotMapped() const { return m_Snapshot.IsOpen(); }
+
+    // Every element set added for each object. Snapshots only hold the latest ones, so a mapped catalogue
+    // starts with an empty history.
+    const ElementSetHistory& GetHistory() const { return m_History; }
 
 private:
-    std::unordered_map<uint32_t, SpaceObject> m_SpaceObjects;
+    using Record = CatalogueSnapshot::Record;
+
+    void UnpackSnapshot();
+    void Unpack(const Record& record, SpaceObject& spaceObject) const;
+    const Record& GetRecord(size_t index) const;
+    SpaceObjectView GetView(const Record& record) const;
+    const CatalogueIndex& GetIndex() const;
+    void Compact();
+
+    std::vector<Record> m_Records;
+    std::vector<GroupMask> m_GroupMasks; // One per record
+    FlatIdMap m_RecordIndexes; // NORAD catalogue ID to index in m_Records
+    StringArena m_Strings;
+    ElementSetHistory m_History;
+    CatalogueSnapshot m_Snapshot;
+    mutable CatalogueIndex m_Index;
+    mutable bool m_IndexBuilt{ false };
 };
 
 }
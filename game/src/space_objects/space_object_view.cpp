@@ -0,0 +1,68 @@
+#include <cmath>
+#include <limits>
+
+#include "space_objects/space_object_view.hpp"
+#include "space_objects/space_object.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Records store absent optional fields as NaN or ~0u.
+std::optional<uint32_t> FromStored(uint32_t value)
+{
+    return value == std::numeric_limits<uint32_t>::max() ? std::nullopt : std::optional<uint32_t>(value);
+}
+
+std::optional<float> FromStored(float value)
+{
+    return std::isnan(value) ? std::nullopt : std::optional<float>(value);
+}
+
+} // anonymous namespace
+
+SpaceObjectView::SpaceObjectView(const Record& record, std::string_view objectName, std::string_view objectId)
+    : m_pRecord(&record)
+    , m_ObjectName(objectName)
+    , m_ObjectId(objectId)
+{
+}
+
+std::chrono::system_clock::time_point SpaceObjectView::GetEpoch() const
+{
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(m_pRecord->epoch)));
+}
+
+std::optional<uint32_t> SpaceObjectView::GetElementSetNumber() const
+{
+    return FromStored(m_pRecord->elementSetNumber);
+}
+
+std::optional<uint32_t> SpaceObjectView::GetRevolutionsAtEpoch() const
+{
+    return FromStored(m_pRecord->revolutionsAtEpoch);
+}
+
+std::optional<float> SpaceObjectView::GetBstar() const
+{
+    return FromStored(m_pRecord->bstar);
+}
+
+std::optional<float> SpaceObjectView::GetMeanMotionFirstDerivative() const
+{
+    return FromStored(m_pRecord->meanMotionFirstDerivative);
+}
+
+std::optional<float> SpaceObjectView::GetMeanMotionSecondDerivative() const
+{
+    return FromStored(m_pRecord->meanMotionSecondDerivative);
+}
+
+void SpaceObjectView::Unpack(SpaceObject& spaceObject) const
+{
+    CatalogueSnapshot::Unpack(*m_pRecord, m_ObjectName, m_ObjectId, spaceObject);
+}
+
+} // namespace WingsOfSteel
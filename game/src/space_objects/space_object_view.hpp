@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "space_objects/catalogue_snapshot.hpp"
+
+namespace WingsOfSteel
+{
+
+class SpaceObject;
+
+// Reads a catalogue record in place, with the same getters as SpaceObject, so looking an object up doesn't
+// copy its name and COSPAR ID into strings. Unpack() fills in a SpaceObject for callers which need one.
+// A view is only valid until the catalogue it came from next changes.
+class SpaceObjectView
+{
+public:
+    using Record = CatalogueSnapshot::Record;
+
+    SpaceObjectView(const Record& record, std::string_view objectName, std::string_view objectId);
+
+    std::string_view GetObjectName() const { return m_ObjectName; }
+    std::string_view GetObjectId() const { return m_ObjectId; }
+    std::chrono::system_clock::time_point GetEpoch() const;
+    float GetMeanMotion() const { return m_pRecord->meanMotion; }
+    float GetEccentricity() const { return m_pRecord->eccentricity; }
+    float GetInclination() const { return m_pRecord->inclination; }
+    float GetRightAscensionOfAscendingNode() const { return m_pRecord->rightAscensionOfAscendingNode; }
+    float GetArgumentOfPericenter() const { return m_pRecord->argumentOfPericenter; }
+    float GetMeanAnomaly() const { return m_pRecord->meanAnomaly; }
+    uint32_t GetNoradCatalogueId() const { return m_pRecord->noradCatalogueId; }
+    std::optional<uint32_t> GetElementSetNumber() const;
+    std::optional<uint32_t> GetRevolutionsAtEpoch() const;
+    std::optional<float> GetBstar() const; // 1/earth radii
+    std::optional<float> GetMeanMotionFirstDerivative() const; // rev/day²
+    std::optional<float> GetMeanMotionSecondDerivative() const; // rev/day³
+
+    const Record& GetRecord() const { return *m_pRecord; }
+    void Unpack(SpaceObject& spaceObject) const;
+
+private:
+    const Record* m_pRecord;
+    std::string_view m_ObjectName;
+    std::string_view m_ObjectId;
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,127 @@
+#include "space_objects/string_arena.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr size_t kMinimumCapacity = 64;
+
+} // anonymous namespace
+
+StringArena::StringArena()
+{
+    Clear();
+}
+
+StringArena::~StringArena()
+{
+}
+
+uint32_t StringArena::Intern(std::string_view text)
+{
+    if (text.empty())
+    {
+        return 0;
+    }
+
+    const uint32_t hash = Hash(text);
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t index = hash & mask; m_Slots[index].offset != 0; index = (index + 1) & mask)
+    {
+        const Slot& slot = m_Slots[index];
+        if (slot.hash == hash && Get(slot.offset) == text)
+        {
+            return slot.offset;
+        }
+    }
+
+    const uint32_t offset = static_cast<uint32_t>(m_Data.size());
+    m_Data.insert(m_Data.end(), text.begin(), text.end());
+    m_Data.push_back('\0');
+    Insert(offset, hash);
+    return offset;
+}
+
+std::string_view StringArena::Get(uint32_t offset) const
+{
+    return offset < m_Data.size() ? std::string_view(m_Data.data() + offset) : std::string_view();
+}
+
+void StringArena::Assign(std::string_view table)
+{
+    Clear();
+    if (table.size() <= 1)
+    {
+        return;
+    }
+
+    // Tables from snapshots also start with the empty string, and end with a NUL.
+    m_Data.assign(table.begin(), table.end());
+    for (size_t offset = 1; offset < m_Data.size();)
+    {
+        const std::string_view text(m_Data.data() + offset);
+        if (!text.empty())
+        {
+            Insert(static_cast<uint32_t>(offset), Hash(text));
+        }
+        offset += text.size() + 1;
+    }
+}
+
+void StringArena::Clear()
+{
+    m_Data.assign(1, '\0');
+    m_Slots.assign(kMinimumCapacity, Slot{ 0, 0 });
+    m_Count = 0;
+}
+
+uint32_t StringArena::Hash(std::string_view text)
+{
+    // FNV-1a, which is plenty for short names.
+    uint32_t hash = 2166136261u;
+    for (char c : text)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+void StringArena::Insert(uint32_t offset, uint32_t hash)
+{
+    if ((m_Count + 1) * 10 > m_Slots.size() * 7)
+    {
+        Rehash(m_Slots.size() * 2);
+    }
+
+    const size_t mask = m_Slots.size() - 1;
+    size_t index = hash & mask;
+    while (m_Slots[index].offset != 0)
+    {
+        index = (index + 1) & mask;
+    }
+    m_Slots[index] = { offset, hash };
+    m_Count++;
+}
+
+void StringArena::Rehash(size_t capacity)
+{
+    std::vector<Slot> slots(capacity, Slot{ 0, 0 });
+    const size_t mask = capacity - 1;
+    for (const Slot& slot : m_Slots)
+    {
+        if (slot.offset != 0)
+        {
+            size_t index = slot.hash & mask;
+            while (slots[index].offset != 0)
+            {
+                index = (index + 1) & mask;
+            }
+            slots[index] = slot;
+        }
+    }
+    m_Slots.swap(slots);
+}
+
+} // namespace WingsOfSteel
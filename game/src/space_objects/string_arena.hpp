@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace WingsOfSteel
+{
+
+// Interned, NUL-terminated strings packed into one buffer and referred to by their offset in it. Interning
+// the same text twice returns the same offset, so names and COSPAR IDs which don't change from one element
+// set to the next are only stored once. Strings are never freed; the arena only grows, and is replaced by
+// a new one to drop the strings which are no longer used.
+// Offset 0 is always the empty string. The buffer has the same layout as a snapshot's string table, so
+// one can be adopted as the other.
+class StringArena
+{
+public:
+    StringArena();
+    ~StringArena();
+    StringArena(StringArena&&) = default;
+    StringArena& operator=(StringArena&&) = default;
+
+    uint32_t Intern(std::string_view text);
+    std::string_view Get(uint32_t offset) const;
+
+    // Replaces the arena's contents with a string table, keeping its offsets.
+    void Assign(std::string_view table);
+    void Clear();
+
+    std::string_view GetData() const { return std::string_view(m_Data.data(), m_Data.size()); }
+
+private:
+    struct Slot
+    {
+        uint32_t offset; // 0 if the slot is empty
+        uint32_t hash;
+    };
+
+    static uint32_t Hash(std::string_view text);
+    void Insert(uint32_t offset, uint32_t hash);
+    void Rehash(size_t capacity);
+
+    std::vector<char> m_Data;
+    std::vector<Slot> m_Slots; // Open addressing, capacity is a power of two
+    size_t m_Count{ 0 };
+};
+
+} // namespace WingsOfSteel
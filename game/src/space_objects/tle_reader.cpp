@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "space_objects/space_object.hpp"
+#include "space_objects/tle_reader.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Both lines are 69 columns, the last of which is a checksum.
+constexpr size_t kLineLength = 69;
+
+// About 1500 element sets with titles.
+constexpr size_t kChunkSize = 256 * 1024;
+
+bool StartsLine(std::string_view line, char lineNumber)
+{
+    return line.size() >= 2 && line[0] == lineNumber && line[1] == ' ';
+}
+
+std::string_view Trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Columns are numbered from 1, as in the format's definition, and include both ends.
+std::string_view Column(std::string_view line, size_t first, size_t last)
+{
+    return Trim(line.substr(first - 1, last - first + 1));
+}
+
+bool HasValidChecksum(std::string_view line)
+{
+    // Digits count for their value and minus signs for one; everything else is ignored.
+    uint32_t sum = 0;
+    for (size_t i = 0; i < kLineLength - 1; ++i)
+    {
+        sum += IsDigit(line[i]) ? line[i] - '0' : (line[i] == '-' ? 1 : 0);
+    }
+    return IsDigit(line[kLineLength - 1]) && static_cast<uint32_t>(line[kLineLength - 1] - '0') == sum % 10;
+}
+
+// Catalogue numbers past 99999 use the Alpha-5 scheme, where the first digit is replaced by a letter
+// standing for 10 to 33. I and O are skipped, as they look too much like 1 and 0.
+bool ParseCatalogueNumber(std::string_view field, uint32_t& value)
+{
+    if (field.size() != 5)
+    {
+        return false;
+    }
+
+    uint32_t leading = 0;
+    const char first = field[0];
+    if (IsDigit(first))
+    {
+        leading = first - '0';
+    }
+    else if (first >= 'A' && first <= 'Z' && first != 'I' && first != 'O')
+    {
+        leading = 10 + (first - 'A') - (first > 'I' ? 1 : 0) - (first > 'O' ? 1 : 0);
+    }
+    else
+    {
+        return false;
+    }
+
+    uint32_t remainder = 0;
+    if (!ParseUnsigned(field.substr(1), remainder))
+    {
+        return false;
+    }
+    value = leading * 10000 + remainder;
+    return true;
+}
+
+// Fields such as B* are written as a signed five digit fraction with an exponent and no decimal point or
+// 'e', so " 12345-4" is 0.12345e-4.
+bool ParseImpliedDecimal(std::string_view field, float& value)
+{
+    field = Trim(field);
+    if (field.size() < 7)
+    {
+        return false;
+    }
+
+    bool negative = false;
+    if (field[0] == '-' || field[0] == '+')
+    {
+        negative = field[0] == '-';
+        field.remove_prefix(1);
+    }
+
+    const char exponentSign = field[field.size() - 2];
+    const char exponentDigit = field[field.size() - 1];
+    uint32_t mantissa = 0;
+    if ((exponentSign != '-' && exponentSign != '+') || !IsDigit(exponentDigit) || !ParseUnsigned(field.substr(0, field.size() - 2), mantissa))
+    {
+        return false;
+    }
+
+    const int exponent = (exponentSign == '-' ? -1 : 1) * (exponentDigit - '0');
+    const double magnitude = mantissa * 1.0e-5 * std::pow(10.0, exponent);
+    value = static_cast<float>(negative ? -magnitude : magnitude);
+    return true;
+}
+
+bool ParseFloat(std::string_view field, float& value)
+{
+    double result = 0.0;
+    if (!ParseDouble(field, result))
+    {
+        return false;
+    }
+    value = static_cast<float>(result);
+    return true;
+}
+
+// Two digit years from 57 onwards are in the 1900s, as the first satellite was launched in 1957.
+int32_t ExpandYear(uint32_t year)
+{
+    return year < 57 ? 2000 + year : 1900 + year;
+}
+
+// The epoch is a two digit year followed by the day of the year, where noon on the 1st of January is 1.5.
+bool ParseEpoch(std::string_view yearField, std::string_view dayField, std::chrono::system_clock::time_point& epoch)
+{
+    uint32_t year = 0;
+    double day = 0.0;
+    if (!ParseUnsigned(yearField, year) || !ParseDouble(dayField, day) || day < 1.0 || day >= 367.0)
+    {
+        return false;
+    }
+
+    const int64_t seconds = DaysFromCivil(ExpandYear(year), 1, 1) * 86400;
+    const int64_t microseconds = std::llround((day - 1.0) * 86400.0e6);
+    epoch = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::seconds(seconds) + std::chrono::microseconds(microseconds)));
+    return true;
+}
+
+// The international designator "98067A" becomes the COSPAR ID OMM uses, "1998-067A".
+void FormatObjectId(std::string_view designator, std::string& objectId)
+{
+    uint32_t year = 0;
+    if (designator.size() < 5 || !ParseUnsigned(designator.substr(0, 2), year))
+    {
+        objectId.assign(designator);
+        return;
+    }
+
+    const std::string_view launch = designator.substr(2);
+    std::array<char, 16> buffer;
+    const int32_t fullYear = ExpandYear(year);
+    buffer[0] = static_cast<char>('0' + fullYear / 1000);
+    buffer[1] = static_cast<char>('0' + fullYear / 100 % 10);
+    buffer[2] = designator[0];
+    buffer[3] = designator[1];
+    buffer[4] = '-';
+    const size_t length = std::min(launch.size(), buffer.size() - 5);
+    launch.copy(buffer.data() + 5, length);
+    objectId.assign(buffer.data(), 5 + length);
+}
+
+// Records start either at a first line which is followed by a second one, or at the title just before it.
+size_t FindRecordStart(std::string_view text, size_t offset)
+{
+    if (offset > 0)
+    {
+        const size_t newline = text.find('\n', offset - 1);
+        offset = newline == std::string_view::npos ? text.size() : newline + 1;
+    }
+
+    // The title of a record whose first line is the first one found may be just before offset.
+    size_t previousLineStart = std::string_view::npos;
+    std::string_view previousLine;
+    if (offset > 0 && offset < text.size())
+    {
+        const size_t newline = offset >= 2 ? text.rfind('\n', offset - 2) : std::string_view::npos;
+        previousLineStart = newline == std::string_view::npos ? 0 : newline + 1;
+        size_t end = previousLineStart;
+        previousLine = NextLine(text, end);
+    }
+
+    size_t lineStart = offset;
+    while (lineStart < text.size())
+    {
+        size_t next = lineStart;
+        const std::string_view line = NextLine(text, next);
+        if (StartsLine(line, '1'))
+        {
+            size_t afterPair = next;
+            if (StartsLine(NextLine(text, afterPair), '2'))
+            {
+                // Titles are never empty, and the line before a first line can only be a second line in 2LE files.
+                const bool hasTitle = previousLineStart != std::string_view::npos && !Trim(previousLine).empty() && !StartsLine(previousLine, '2');
+                return hasTitle ? previousLineStart : lineStart;
+            }
+        }
+
+        previousLineStart = lineStart;
+        previousLine = line;
+        lineStart = next;
+    }
+    return text.size();
+}
+
+} // anonymous namespace
+
+TleReader::Result TleReader::Read(std::string_view text, const ElementSetCallback& onRecord)
+{
+    Result result;
+    SpaceObject spaceObject;
+    std::string_view title;
+    size_t offset = 0;
+    while (offset < text.size())
+    {
+        const std::string_view line = NextLine(text, offset);
+        if (StartsLine(line, '1'))
+        {
+            size_t next = offset;
+            const std::string_view line2 = NextLine(text, next);
+            if (StartsLine(line2, '2'))
+            {
+                offset = next;
+                if (ParseElementSet(title, line, line2, spaceObject))
+                {
+                    onRecord(spaceObject);
+                    result.records++;
+                }
+                else
+                {
+                    result.rejected++;
+                }
+                title = std::string_view();
+                continue;
+            }
+        }
+
+        // Anything which isn't part of an element set is the title of the next one.
+        title = Trim(line);
+    }
+    return result;
+}
+
+TleReader::Result TleReader::ReadParallel(std::string_view text, WorkerPool& workerPool, const ElementSetCallback& onRecord)
+{
+    const std::vector<std::string_view> chunks = SplitIntoChunks(text, kChunkSize, FindRecordStart);
+    if (chunks.size() <= 1)
+    {
+        return Read(text, onRecord);
+    }
+    return ReadChunksInParallel(chunks, workerPool, Read, onRecord);
+}
+
+bool TleReader::ParseElementSet(std::string_view title, std::string_view line1, std::string_view line2, SpaceObject& spaceObject)
+{
+    if (line1.size() < kLineLength || line2.size() < kLineLength || !HasValidChecksum(line1) || !HasValidChecksum(line2))
+    {
+        return false;
+    }
+
+    uint32_t secondLineCatalogueNumber = 0;
+    if (!ParseCatalogueNumber(line1.substr(2, 5), spaceObject.m_NoradCatalogueId)
+        || !ParseCatalogueNumber(line2.substr(2, 5), secondLineCatalogueNumber)
+        || spaceObject.m_NoradCatalogueId != secondLineCatalogueNumber)
+    {
+        return false;
+    }
+
+    if (!ParseEpoch(Column(line1, 19, 20), Column(line1, 21, 32), spaceObject.m_Epoch)
+        || !ParseFloat(Column(line2, 9, 16), spaceObject.m_Inclination)
+        || !ParseFloat(Column(line2, 18, 25), spaceObject.m_RightAscensionOfAscendingNode)
+        || !ParseFloat(Column(line2, 35, 42), spaceObject.m_ArgumentOfPericenter)
+        || !ParseFloat(Column(line2, 44, 51), spaceObject.m_MeanAnomaly)
+        || !ParseFloat(Column(line2, 53, 63), spaceObject.m_MeanMotion))
+    {
+        return false;
+    }
+
+    // The eccentricity has an implied leading decimal point.
+    uint32_t eccentricity = 0;
+    const std::string_view eccentricityField = Column(line2, 27, 33);
+    if (!ParseUnsigned(eccentricityField, eccentricity))
+    {
+        return false;
+    }
+    spaceObject.m_Eccentricity = static_cast<float>(eccentricity * std::pow(10.0, -static_cast<double>(eccentricityField.size())));
+
+    // The remaining fields are optional in OMM, so they are left out rather than failing the element set.
+    float floatValue = 0.0f;
+    uint32_t unsignedValue = 0;
+    spaceObject.m_MeanMotionFirstDerivative = ParseFloat(Column(line1, 34, 43), floatValue) ? std::optional<float>(floatValue) : std::nullopt;
+    spaceObject.m_MeanMotionSecondDerivative = ParseImpliedDecimal(Column(line1, 45, 52), floatValue) ? std::optional<float>(floatValue) : std::nullopt;
+    spaceObject.m_Bstar = ParseImpliedDecimal(Column(line1, 54, 61), floatValue) ? std::optional<float>(floatValue) : std::nullopt;
+    spaceObject.m_ElementSetNumber = ParseUnsigned(Column(line1, 65, 68), unsignedValue) ? std::optional<uint32_t>(unsignedValue) : std::nullopt;
+    spaceObject.m_RevolutionsAtEpoch = ParseUnsigned(Column(line2, 64, 68), unsignedValue) ? std::optional<uint32_t>(unsignedValue) : std::nullopt;
+
+    if (title.size() >= 2 && title[0] == '0' && title[1] == ' ')
+    {
+        title.remove_prefix(2);
+    }
+    spaceObject.m_ObjectName.assign(title.empty() ? std::string_view("UNKNOWN") : title);
+    FormatObjectId(Column(line1, 10, 17), spaceObject.m_ObjectId);
+    return true;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view>
+
+#include "space_objects/element_set_parsing.hpp"
+
+namespace WingsOfSteel
+{
+
+// Reader for two-line element sets, with or without a title line before each one (3LE). The "0 " which
+// Space-Track puts in front of titles is dropped.
+// Lines are sliced out of the text in place and every field is read from its fixed columns, so the only
+// allocations are for the SpaceObject's strings. Element sets whose checksums don't match are rejected.
+class TleReader
+{
+public:
+    using Result = ElementSetReadResult;
+
+    static Result Read(std::string_view text, const ElementSetCallback& onRecord);
+
+    // Reads the text in chunks spread over the worker pool. Records still reach onRecord in file order, on
+    // the calling thread.
+    static Result ReadParallel(std::string_view text, WorkerPool& workerPool, const ElementSetCallback& onRecord);
+
+private:
+    static bool ParseElementSet(std::string_view title, std::string_view line1, std::string_view line2, SpaceObject& spaceObject);
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,213 @@
+#include <glm/glm.hpp>
+
+#include <pandora.hpp>
+#include <render/rendersystem.hpp>
+#include <render/window.hpp>
+#include <resources/resource_system.hpp>
+#include <scene/scene.hpp>
+
+#include "systems/gpu_propagation_system.hpp"
+#include "game.hpp"
+#include "jobs/worker_pool.hpp"
+#include "sector/sector.hpp"
+#include "systems/space_object_culling_system.hpp"
+
+namespace WingsOfSteel
+{
+
+GpuPropagationSystem::GpuPropagationSystem()
+{
+    m_pPointCloud = std::make_unique<GpuPointCloud>(GetRenderSystem()->GetDevice());
+
+    GetResourceSystem()->RequestResource("/shaders/gpu_propagation.wgsl", [this](ResourceSharedPtr pResource) {
+        m_pPropagationShader = std::dynamic_pointer_cast<ResourceShader>(pResource);
+        CreateComputePipeline();
+        HandleShaderInjection();
+    });
+
+    GetResourceSystem()->RequestResource("/shaders/gpu_point_cloud.wgsl", [this](ResourceSharedPtr pResource) {
+        m_pPointCloudShader = std::dynamic_pointer_cast<ResourceShader>(pResource);
+        CreateRenderPipeline();
+        HandleShaderInjection();
+    });
+
+    GetResourceSystem()->RequestResource("/shaders/gpu_point_cloud_cull.wgsl", [this](ResourceSharedPtr pResource) {
+        m_pCullingShader = std::dynamic_pointer_cast<ResourceShader>(pResource);
+        CreateCullingPipeline();
+        HandleShaderInjection();
+    });
+}
+
+GpuPropagationSystem::~GpuPropagationSystem()
+{
+    if (GetResourceSystem() && m_ShaderInjectionSignalId.has_value())
+    {
+        GetResourceSystem()->GetShaderInjectedSignal().Disconnect(m_ShaderInjectionSignalId.value());
+    }
+}
+
+void GpuPropagationSystem::Initialize(Scene* pScene)
+{
+}
+
+void GpuPropagationSystem::Update(float delta)
+{
+    m_pPointCloud->SetTime(Game::Get()->GetSector()->GetSimulationClock().GetTime(), *Game::Get()->GetWorkerPool());
+}
+
+void GpuPropagationSystem::Dispatch(wgpu::CommandEncoder& encoder)
+{
+    m_Dispatched = false;
+    m_Culled = false;
+    if (!m_Enabled || m_pPointCloud->GetObjectCount() == 0)
+    {
+        return;
+    }
+
+    wgpu::ComputePassEncoder computePass = encoder.BeginComputePass();
+    m_Dispatched = m_pPointCloud->EncodePropagation(computePass);
+    m_Culled = m_Dispatched && m_CullingEnabled && EncodeCulling(computePass);
+    computePass.End();
+}
+
+bool GpuPropagationSystem::EncodeCulling(wgpu::ComputePassEncoder& computePass)
+{
+    // Culls against the view the CPU culled against this frame, so both layers agree on what's visible.
+    SpaceObjectCullingSystem* pCullingSystem = GetActiveScene() ? GetActiveScene()->GetSystem<SpaceObjectCullingSystem>() : nullptr;
+    if (pCullingSystem == nullptr || !pCullingSystem->GetViewState().has_value())
+    {
+        return false;
+    }
+
+    return m_pPointCloud->EncodeCulling(computePass, pCullingSystem->GetViewState().value());
+}
+
+void GpuPropagationSystem::Render(wgpu::RenderPassEncoder& renderPass)
+{
+    if (!m_Dispatched || !m_RenderPipeline)
+    {
+        return;
+    }
+
+    renderPass.SetPipeline(m_RenderPipeline);
+    if (m_Culled)
+    {
+        renderPass.SetVertexBuffer(0, m_pPointCloud->GetVisiblePositionBuffer());
+        renderPass.DrawIndirect(m_pPointCloud->GetDrawArgumentsBuffer(), 0);
+    }
+    else
+    {
+        renderPass.SetVertexBuffer(0, m_pPointCloud->GetPositionBuffer());
+        renderPass.Draw(static_cast<uint32_t>(m_pPointCloud->GetObjectCount()));
+    }
+}
+
+void GpuPropagationSystem::SetObjects(const std::vector<Sgp4Elements>& objects)
+{
+    Clear();
+    m_pPointCloud->SetObjects(objects, Game::Get()->GetSector()->GetSimulationClock().GetTime(), *Game::Get()->GetWorkerPool());
+}
+
+void GpuPropagationSystem::Clear()
+{
+    m_pPointCloud->Clear();
+    m_Dispatched = false;
+    m_Culled = false;
+}
+
+void GpuPropagationSystem::CreateComputePipeline()
+{
+    if (m_pPropagationShader)
+    {
+        m_pPointCloud->SetPropagationShader(m_pPropagationShader->GetShaderModule());
+    }
+}
+
+void GpuPropagationSystem::CreateCullingPipeline()
+{
+    if (m_pCullingShader)
+    {
+        m_pPointCloud->SetCullingShader(m_pCullingShader->GetShaderModule());
+    }
+}
+
+void GpuPropagationSystem::CreateRenderPipeline()
+{
+    if (!m_pPointCloudShader)
+    {
+        return;
+    }
+
+    wgpu::ColorTargetState colorTargetState{
+        .format = GetWindow()->GetTextureFormat()
+    };
+
+    wgpu::FragmentState fragmentState{
+        .module = m_pPointCloudShader->GetShaderModule(),
+        .targetCount = 1,
+        .targets = &colorTargetState
+    };
+
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &GetRenderSystem()->GetGlobalUniformsLayout()
+    };
+    wgpu::PipelineLayout pipelineLayout = GetRenderSystem()->GetDevice().CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+    // One vec4f per point, exactly as the compute shader writes them.
+    wgpu::VertexAttribute positionAttribute;
+    positionAttribute.format = wgpu::VertexFormat::Float32x4;
+    positionAttribute.offset = 0;
+    positionAttribute.shaderLocation = 0;
+
+    wgpu::VertexBufferLayout vertexBufferLayout;
+    vertexBufferLayout.arrayStride = sizeof(glm::vec4);
+    vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
+    vertexBufferLayout.attributeCount = 1;
+    vertexBufferLayout.attributes = &positionAttribute;
+
+    // Points are hidden behind the Earth, but don't occlude each other.
+    wgpu::DepthStencilState depthState{
+        .format = wgpu::TextureFormat::Depth32Float,
+        .depthWriteEnabled = false,
+        .depthCompare = wgpu::CompareFunction::Less
+    };
+
+    wgpu::RenderPipelineDescriptor descriptor{
+        .label = "GPU point cloud render pipeline",
+        .layout = pipelineLayout,
+        .vertex = {
+            .module = m_pPointCloudShader->GetShaderModule(),
+            .bufferCount = 1,
+            .buffers = &vertexBufferLayout },
+        .primitive = { .topology = wgpu::PrimitiveTopology::PointList },
+        .depthStencil = &depthState,
+        .multisample = { .count = RenderSystem::MsaaSampleCount },
+        .fragment = &fragmentState
+    };
+    m_RenderPipeline = GetRenderSystem()->GetDevice().CreateRenderPipeline(&descriptor);
+}
+
+void GpuPropagationSystem::HandleShaderInjection()
+{
+    if (!m_ShaderInjectionSignalId.has_value())
+    {
+        m_ShaderInjectionSignalId = GetResourceSystem()->GetShaderInjectedSignal().Connect(
+            [this](ResourceShader* pResourceShader) {
+                if (m_pPropagationShader.get() == pResourceShader)
+                {
+                    CreateComputePipeline();
+                }
+                else if (m_pPointCloudShader.get() == pResourceShader)
+                {
+                    CreateRenderPipeline();
+                }
+                else if (m_pCullingShader.get() == pResourceShader)
+                {
+                    CreateCullingPipeline();
+                }
+            });
+    }
+}
+
+} // namespace WingsOfSteel
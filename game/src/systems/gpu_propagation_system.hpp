@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <core/signal.hpp>
+#include <resources/resource_shader.hpp>
+#include <scene/systems/system.hpp>
+
+#include "propagation/sgp4.hpp"
+#include "render/gpu_point_cloud.hpp"
+
+namespace WingsOfSteel
+{
+
+// Propagates a point cloud of objects entirely on the GPU, for populations far too large to go through
+// an entity each (synthetic mega-constellations, debris clouds). Orbits are uploaded once; every frame a
+// compute shader solves Kepler's equation for each object and writes its position straight into a buffer
+// which is then drawn as points, so nothing is read back and no transforms are touched.
+// Optionally, a second compute pass culls the points against the same view as SpaceObjectCullingSystem and
+// compacts the visible ones, whose count is left in an indirect draw's arguments, so the CPU never sees
+// which points are visible.
+// The shaders only rely on core WebGPU (f32 storage buffers, atomics, 64-wide workgroups), so they also run
+// on software adapters such as SwiftShader. The passes themselves live in GpuPointCloud, which the tests run
+// on one.
+class GpuPropagationSystem : public System
+{
+public:
+    GpuPropagationSystem();
+    ~GpuPropagationSystem();
+
+    void Initialize(Scene* pScene) override;
+    void Update(float delta) override;
+
+    // Encodes the propagation pass. Must come before the render pass which draws the points.
+    void Dispatch(wgpu::CommandEncoder& encoder);
+    void Render(wgpu::RenderPassEncoder& renderPass);
+
+    // Replaces the point cloud. Propagation is two-body, from the mean elements.
+    void SetObjects(const std::vector<Sgp4Elements>& objects);
+    void Clear();
+    size_t GetObjectCount() const { return m_pPointCloud->GetObjectCount(); }
+
+    bool IsEnabled() const { return m_Enabled; }
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+
+    bool IsCullingEnabled() const { return m_CullingEnabled; }
+    void SetCullingEnabled(bool enabled) { m_CullingEnabled = enabled; }
+
+    static constexpr size_t kMaximumObjectCount = GpuPointCloud::kMaximumObjectCount;
+
+private:
+    void CreateComputePipeline();
+    void CreateCullingPipeline();
+    void CreateRenderPipeline();
+    bool EncodeCulling(wgpu::ComputePassEncoder& computePass);
+    void HandleShaderInjection();
+
+    ResourceShaderSharedPtr m_pPropagationShader;
+    ResourceShaderSharedPtr m_pPointCloudShader;
+    ResourceShaderSharedPtr m_pCullingShader;
+    std::unique_ptr<GpuPointCloud> m_pPointCloud;
+    wgpu::RenderPipeline m_RenderPipeline;
+    std::optional<SignalId> m_ShaderInjectionSignalId;
+
+    bool m_Enabled{ true };
+    bool m_CullingEnabled{ true };
+    bool m_Dispatched{ false };
+    bool m_Culled{ false }; // The culling pass ran this frame, so the draw is indirect
+};
+
+} // namespace WingsOfSteel
@@ -1,3 +1,5 @@
+#include <optional>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -13,7 +15,11 @@
 #include <scene/scene.hpp>
 
 #include "components/label_component.hpp"
+#include "components/space_object_component.hpp"
+#include "render/upload_ring.hpp"
 #include "systems/label_system.hpp"
+#include "systems/space_object_culling_system.hpp"
+#include "game.hpp"
 
 namespace WingsOfSteel
 {
@@ -24,15 +30,6 @@ void LabelSystem::Initialize(Scene* pScene)
         m_pShader = std::dynamic_pointer_cast<ResourceShader>(pResource);
         CreateRenderPipeline();
     });
-
-    wgpu::Device device = GetRenderSystem()->GetDevice();
-    wgpu::BufferDescriptor bufferDescriptor{
-        .label = "Label vertex buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex,
-        .size = kMaxLabels * kVerticesPerQuad * sizeof(VertexP2C3UV)
-    };
-    m_VertexBuffer = device.CreateBuffer(&bufferDescriptor);
-    m_VertexData.reserve(kMaxLabels * kVerticesPerQuad);
 }
 
 void LabelSystem::CreateRenderPipeline()
@@ -73,14 +70,39 @@ void LabelSystem::Update(float delta)
         return;
     }
 
+    m_VisibleLabels.clear();
     entt::registry& registry = GetActiveScene()->GetRegistry();
-    auto view = registry.view<LabelComponent, const TransformComponent>();
 
     const CameraComponent& cameraComponent = GetActiveScene()->GetCamera()->GetComponent<CameraComponent>();
     const uint32_t windowWidth = GetWindow()->GetWidth();
     const uint32_t windowHeight = GetWindow()->GetHeight();
-    view.each([&cameraComponent, windowWidth, windowHeight](LabelComponent& labelComponent, const TransformComponent& transformComponent) {
-        labelComponent.SetScreenSpacePosition(cameraComponent.camera.WorldToScreen(transformComponent.GetTranslation(), windowWidth, windowHeight));
+    const auto project = [this, &cameraComponent, windowWidth, windowHeight](const entt::entity entity, LabelComponent& labelComponent, const glm::vec3& position) {
+        labelComponent.SetScreenSpacePosition(cameraComponent.camera.WorldToScreen(position, windowWidth, windowHeight));
+        m_VisibleLabels.push_back(entity);
+    };
+
+    // Space objects are only labelled while they're visible. Anything else with a label always is.
+    SpaceObjectCullingSystem* pCullingSystem = GetActiveScene()->GetSystem<SpaceObjectCullingSystem>();
+    if (pCullingSystem == nullptr)
+    {
+        registry.view<LabelComponent, const TransformComponent>().each([&project](const auto entity, LabelComponent& labelComponent, const TransformComponent& transformComponent) {
+            project(entity, labelComponent, transformComponent.GetTranslation());
+        });
+        return;
+    }
+
+    for (const uint32_t index : pCullingSystem->GetVisibleIndices())
+    {
+        const entt::entity entity = pCullingSystem->GetEntity(index);
+        LabelComponent* pLabelComponent = registry.try_get<LabelComponent>(entity);
+        if (pLabelComponent)
+        {
+            project(entity, *pLabelComponent, pCullingSystem->GetPosition(index));
+        }
+    }
+
+    registry.view<LabelComponent, const TransformComponent>(entt::exclude<SpaceObjectComponent>).each([&project](const auto entity, LabelComponent& labelComponent, const TransformComponent& transformComponent) {
+        project(entity, labelComponent, transformComponent.GetTranslation());
     });
 }
 
@@ -94,12 +116,18 @@ void LabelSystem::Render(wgpu::RenderPassEncoder& renderPass)
     m_VertexData.clear();
 
     entt::registry& registry = GetActiveScene()->GetRegistry();
-    auto view = registry.view<LabelComponent>();
 
     const glm::vec3 quadColor(1.0f, 1.0f, 1.0f); // White
 
-    view.each([this, &quadColor](const auto entity, const LabelComponent& labelComponent) {
-        const glm::vec2& pos = labelComponent.GetScreenSpacePosition();
+    for (const entt::entity entity : m_VisibleLabels)
+    {
+        const LabelComponent* pLabelComponent = registry.try_get<LabelComponent>(entity);
+        if (pLabelComponent == nullptr)
+        {
+            continue;
+        }
+
+        const glm::vec2& pos = pLabelComponent->GetScreenSpacePosition();
 
         // Generate 6 vertices for a quad (2 triangles) centered at pos
         // Triangle 1: top-left, top-right, bottom-left
@@ -119,17 +147,21 @@ void LabelSystem::Render(wgpu::RenderPassEncoder& renderPass)
         m_VertexData.push_back({ glm::vec2(right, top), quadColor, glm::vec2(1.0f, 0.0f) });
         m_VertexData.push_back({ glm::vec2(right, bottom), quadColor, glm::vec2(1.0f, 1.0f) });
         m_VertexData.push_back({ glm::vec2(left, bottom), quadColor, glm::vec2(0.0f, 1.0f) });
-    });
+    }
 
     if (m_VertexData.empty())
     {
         return;
     }
 
-    GetRenderSystem()->GetDevice().GetQueue().WriteBuffer(m_VertexBuffer, 0, m_VertexData.data(), m_VertexData.size() * sizeof(VertexP2C3UV));
+    const std::optional<UploadRing::Allocation> allocation = Game::Get()->GetUploadRing()->Upload(m_VertexData.data(), m_VertexData.size() * sizeof(VertexP2C3UV), UploadRing::kVertexAlignment);
+    if (!allocation.has_value())
+    {
+        return;
+    }
 
     renderPass.SetPipeline(m_RenderPipeline);
-    renderPass.SetVertexBuffer(0, m_VertexBuffer);
+    renderPass.SetVertexBuffer(0, allocation->buffer, allocation->offset, allocation->size);
     renderPass.Draw(m_VertexData.size());
 }
 
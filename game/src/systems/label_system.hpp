@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include <entt/entt.hpp>
 #include <webgpu/webgpu_cpp.h>
 
 #include <render/vertex_types.hpp>
@@ -25,14 +26,13 @@ public:
 private:
     void CreateRenderPipeline();
 
-    static constexpr size_t kMaxLabels = 1024;
     static constexpr size_t kVerticesPerQuad = 6;
     static constexpr float kQuadHalfSize = 10.0f;
 
     ResourceShaderSharedPtr m_pShader;
     wgpu::RenderPipeline m_RenderPipeline;
-    wgpu::Buffer m_VertexBuffer;
-    std::vector<VertexP2C3UV> m_VertexData;
+    std::vector<entt::entity> m_VisibleLabels; // Labelled entities to draw, as of the last update
+    std::vector<VertexP2C3UV> m_VertexData; // Staging for the upload ring
 };
 
 } // namespace WingsOfSteel
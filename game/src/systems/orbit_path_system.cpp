@@ -0,0 +1,524 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <pandora.hpp>
+#include <render/rendersystem.hpp>
+#include <render/window.hpp>
+#include <resources/resource_system.hpp>
+#include <scene/scene.hpp>
+
+#include "systems/orbit_path_system.hpp"
+#include "components/space_object_component.hpp"
+#include "game.hpp"
+#include "jobs/worker_pool.hpp"
+#include "sector/sector.hpp"
+#include "space_objects/space_object.hpp"
+#include "space_objects/space_object_catalogue.hpp"
+#include "systems/orbit_simulation_system.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+constexpr double kMu = 398600.4418; // km³/s²
+
+// Largest distance a chord may stray from the ellipse, as a fraction of the distance from the Earth at that
+// point, so it is about the same on screen wherever the camera is looking from.
+constexpr double kRelativeSagitta = 5.0e-4;
+
+// Even a circular orbit needs enough points to look round; a very eccentric one is capped so a single
+// object can't take over the buffers.
+constexpr size_t kMinimumVertexCount = 32;
+constexpr size_t kMaximumVertexCount = 512;
+
+constexpr size_t kSamplingGrainSize = 64; // Paths per job
+constexpr uint32_t kPrimitiveRestart = 0xFFFFFFFFu;
+
+void Sample(const OrbitPathSystem::Ellipse& ellipse, std::vector<glm::vec3>& vertices)
+{
+    vertices.clear();
+
+    const double n = ellipse.meanMotion * 2.0 * glm::pi<double>() / 86400.0;
+    const double e = ellipse.eccentricity;
+    if (n <= 0.0 || e < 0.0 || e >= 1.0)
+    {
+        return;
+    }
+
+    const double a = std::cbrt(kMu / (n * n));
+    const double b = a * std::sqrt(1.0 - e * e);
+
+    const double cos_omega = std::cos(glm::radians(static_cast<double>(ellipse.rightAscensionOfAscendingNode)));
+    const double sin_omega = std::sin(glm::radians(static_cast<double>(ellipse.rightAscensionOfAscendingNode)));
+    const double cos_i = std::cos(glm::radians(static_cast<double>(ellipse.inclination)));
+    const double sin_i = std::sin(glm::radians(static_cast<double>(ellipse.inclination)));
+    const double cos_w = std::cos(glm::radians(static_cast<double>(ellipse.argumentOfPericenter)));
+    const double sin_w = std::sin(glm::radians(static_cast<double>(ellipse.argumentOfPericenter)));
+
+    const glm::dvec3 p(cos_omega * cos_w - sin_omega * sin_w * cos_i, sin_omega * cos_w + cos_omega * sin_w * cos_i, sin_w * sin_i);
+    const glm::dvec3 q(-(cos_omega * sin_w + sin_omega * cos_w * cos_i), -(sin_omega * sin_w - cos_omega * cos_w * cos_i), cos_w * sin_i);
+
+    // Stepping in eccentric anomaly E, a chord of length L across a curve of curvature k strays L²k/8 from
+    // it, which gives the longest chord within the tolerance; dividing by |dr/dE| turns it into a step in E.
+    const double twoPi = 2.0 * glm::pi<double>();
+    const double minimumStep = twoPi / kMaximumVertexCount;
+    const double maximumStep = twoPi / kMinimumVertexCount;
+    vertices.reserve(kMinimumVertexCount);
+    for (double E = 0.0; E < twoPi - minimumStep * 0.5;)
+    {
+        const double cosE = std::cos(E);
+        const double sinE = std::sin(E);
+        vertices.emplace_back((cosE - e) * a * p + sinE * b * q);
+
+        const double speed2 = a * a * sinE * sinE + b * b * cosE * cosE; // |dr/dE|²
+        const double curvature = a * b / (speed2 * std::sqrt(speed2));
+        const double tolerance = kRelativeSagitta * a * (1.0 - e * cosE);
+        const double chord = std::sqrt(8.0 * tolerance / curvature);
+        E += std::clamp(chord / std::sqrt(speed2), minimumStep, maximumStep);
+    }
+}
+
+} // anonymous namespace
+
+OrbitPathSystem::OrbitPathSystem()
+{
+    GetResourceSystem()->RequestResource("/shaders/orbit_path.wgsl", [this](ResourceSharedPtr pResource) {
+        m_pShader = std::dynamic_pointer_cast<ResourceShader>(pResource);
+        CreateRenderPipeline();
+        HandleShaderInjection();
+    });
+}
+
+OrbitPathSystem::~OrbitPathSystem()
+{
+    if (GetResourceSystem() && m_ShaderInjectionSignalId.has_value())
+    {
+        GetResourceSystem()->GetShaderInjectedSignal().Disconnect(m_ShaderInjectionSignalId.value());
+    }
+
+    if (m_pRegistry)
+    {
+        m_pRegistry->on_construct<SpaceObjectComponent>().disconnect<&OrbitPathSystem::OnSpaceObjectConstructed>(this);
+        m_pRegistry->on_update<SpaceObjectComponent>().disconnect<&OrbitPathSystem::OnSpaceObjectUpdated>(this);
+        m_pRegistry->on_destroy<SpaceObjectComponent>().disconnect<&OrbitPathSystem::OnSpaceObjectDestroyed>(this);
+    }
+}
+
+void OrbitPathSystem::Initialize(Scene* pScene)
+{
+    m_pRegistry = &pScene->GetRegistry();
+    m_pRegistry->on_construct<SpaceObjectComponent>().connect<&OrbitPathSystem::OnSpaceObjectConstructed>(this);
+    m_pRegistry->on_update<SpaceObjectComponent>().connect<&OrbitPathSystem::OnSpaceObjectUpdated>(this);
+    m_pRegistry->on_destroy<SpaceObjectComponent>().connect<&OrbitPathSystem::OnSpaceObjectDestroyed>(this);
+}
+
+void OrbitPathSystem::OnSpaceObjectConstructed(entt::registry& registry, entt::entity entity)
+{
+    // Paths are added in the next update, so a group's worth of new entities is sampled in one go.
+    const uint32_t noradCatalogueId = registry.get<const SpaceObjectComponent>(entity).GetNoradCatalogueId();
+    if (IsInShownGroup(noradCatalogueId))
+    {
+        m_PendingGroupPaths.push_back(noradCatalogueId);
+    }
+}
+
+void OrbitPathSystem::OnSpaceObjectUpdated(entt::registry& registry, entt::entity entity)
+{
+    // The component is patched when its object gets a new element set, which may also have added it to a
+    // shown group.
+    const uint32_t noradCatalogueId = registry.get<const SpaceObjectComponent>(entity).GetNoradCatalogueId();
+    if (IsOrbitShown(noradCatalogueId))
+    {
+        m_StalePaths.push_back(noradCatalogueId);
+    }
+    else if (IsInShownGroup(noradCatalogueId))
+    {
+        m_PendingGroupPaths.push_back(noradCatalogueId);
+    }
+}
+
+void OrbitPathSystem::OnSpaceObjectDestroyed(entt::registry& registry, entt::entity entity)
+{
+    RemovePath(registry.get<const SpaceObjectComponent>(entity).GetNoradCatalogueId());
+}
+
+void OrbitPathSystem::Update(float delta)
+{
+    // The simulation has already been updated this frame, and may have moved objects on to other element sets.
+    const OrbitSimulationSystem* pSimulationSystem = Game::Get()->GetSector()->GetSystem<OrbitSimulationSystem>();
+    for (const uint32_t noradCatalogueId : pSimulationSystem->GetSwitchedElementSets())
+    {
+        if (IsOrbitShown(noradCatalogueId))
+        {
+            m_StalePaths.push_back(noradCatalogueId);
+        }
+    }
+
+    ResampleStalePaths();
+    if (!m_PendingGroupPaths.empty())
+    {
+        AddPaths(m_PendingGroupPaths, false);
+        m_PendingGroupPaths.clear();
+    }
+
+    if (m_BuffersDirty)
+    {
+        UpdateBuffers();
+    }
+}
+
+void OrbitPathSystem::Render(wgpu::RenderPassEncoder& renderPass)
+{
+    if (!m_RenderPipeline || m_IndexCount == 0)
+    {
+        return;
+    }
+
+    renderPass.SetPipeline(m_RenderPipeline);
+    renderPass.SetVertexBuffer(0, m_VertexBuffer, 0, m_VertexCount * sizeof(glm::vec3));
+    renderPass.SetIndexBuffer(m_IndexBuffer, wgpu::IndexFormat::Uint32, 0, m_IndexCount * sizeof(uint32_t));
+    renderPass.DrawIndexed(m_IndexCount);
+}
+
+bool OrbitPathSystem::ShowOrbit(uint32_t noradCatalogueId)
+{
+    ShowOrbits({ noradCatalogueId });
+    return IsOrbitShown(noradCatalogueId);
+}
+
+void OrbitPathSystem::HideOrbit(uint32_t noradCatalogueId)
+{
+    RemovePath(noradCatalogueId);
+}
+
+void OrbitPathSystem::ShowOrbits(const std::vector<uint32_t>& noradCatalogueIds)
+{
+    AddPaths(noradCatalogueIds, true);
+}
+
+void OrbitPathSystem::HideOrbits(const std::vector<uint32_t>& noradCatalogueIds)
+{
+    for (const uint32_t noradCatalogueId : noradCatalogueIds)
+    {
+        RemovePath(noradCatalogueId);
+    }
+}
+
+void OrbitPathSystem::ClearOrbits()
+{
+    m_ShownGroups = 0;
+    m_PendingGroupPaths.clear();
+    if (m_Paths.empty())
+    {
+        return;
+    }
+
+    m_Paths.clear();
+    m_PathIndices.Clear();
+    m_StalePaths.clear();
+    m_BuffersDirty = true;
+}
+
+void OrbitPathSystem::ShowGroupOrbits(SpaceObjectCatalogue::GroupMask groups)
+{
+    m_ShownGroups |= groups;
+    AddPaths(Game::Get()->GetSector()->GetSpaceObjectCatalogue()->GetNoradIds(groups), false);
+}
+
+void OrbitPathSystem::HideGroupOrbits(SpaceObjectCatalogue::GroupMask groups)
+{
+    m_ShownGroups &= ~groups;
+
+    // Collected first, as removing a path moves another one.
+    std::vector<uint32_t> hidden;
+    for (const Path& path : m_Paths)
+    {
+        if (!path.pinned && !IsInShownGroup(path.noradCatalogueId))
+        {
+            hidden.push_back(path.noradCatalogueId);
+        }
+    }
+    HideOrbits(hidden);
+}
+
+bool OrbitPathSystem::IsOrbitShown(uint32_t noradCatalogueId) const
+{
+    return m_PathIndices.Find(noradCatalogueId) != FlatIdMap::kNotFound;
+}
+
+bool OrbitPathSystem::IsInShownGroup(uint32_t noradCatalogueId) const
+{
+    return m_ShownGroups != 0 && (Game::Get()->GetSector()->GetSpaceObjectCatalogue()->GetGroups(noradCatalogueId) & m_ShownGroups) != 0;
+}
+
+void OrbitPathSystem::AddPaths(const std::vector<uint32_t>& noradCatalogueIds, bool pinned)
+{
+    const OrbitSimulationSystem* pSimulationSystem = Game::Get()->GetSector()->GetSystem<OrbitSimulationSystem>();
+    std::vector<uint32_t> pathIndices;
+    std::vector<Ellipse> ellipses;
+    for (const uint32_t noradCatalogueId : noradCatalogueIds)
+    {
+        const uint32_t shownPathIndex = m_PathIndices.Find(noradCatalogueId);
+        if (shownPathIndex != FlatIdMap::kNotFound)
+        {
+            m_Paths[shownPathIndex].pinned = m_Paths[shownPathIndex].pinned || pinned;
+            continue;
+        }
+
+        if (!pSimulationSystem->GetElementSet(noradCatalogueId, m_ElementSet))
+        {
+            continue;
+        }
+
+        const uint32_t pathIndex = static_cast<uint32_t>(m_Paths.size());
+        m_Paths.push_back({ noradCatalogueId, pinned, {} });
+        m_PathIndices.Set(noradCatalogueId, pathIndex);
+        pathIndices.push_back(pathIndex);
+        ellipses.push_back(GetEllipse(m_ElementSet));
+    }
+
+    SamplePaths(pathIndices, ellipses);
+}
+
+void OrbitPathSystem::SamplePaths(const std::vector<uint32_t>& pathIndices, const std::vector<Ellipse>& ellipses)
+{
+    if (pathIndices.empty())
+    {
+        return;
+    }
+
+    Game::Get()->GetWorkerPool()->ParallelFor(pathIndices.size(), kSamplingGrainSize, [this, &pathIndices, &ellipses](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+        {
+            Sample(ellipses[index], m_Paths[pathIndices[index]].vertices);
+        }
+    });
+    m_BuffersDirty = true;
+}
+
+OrbitPathSystem::Ellipse OrbitPathSystem::GetEllipse(const SpaceObject& elementSet)
+{
+    return { elementSet.GetMeanMotion(), elementSet.GetEccentricity(), elementSet.GetInclination(), elementSet.GetRightAscensionOfAscendingNode(), elementSet.GetArgumentOfPericenter() };
+}
+
+void OrbitPathSystem::RemovePath(uint32_t noradCatalogueId)
+{
+    const uint32_t pathIndex = m_PathIndices.Find(noradCatalogueId);
+    if (pathIndex == FlatIdMap::kNotFound)
+    {
+        return;
+    }
+
+    // The last path takes the removed one's place.
+    if (pathIndex + 1 < m_Paths.size())
+    {
+        m_Paths[pathIndex] = std::move(m_Paths.back());
+        m_PathIndices.Set(m_Paths[pathIndex].noradCatalogueId, pathIndex);
+    }
+    m_Paths.pop_back();
+    m_PathIndices.Erase(noradCatalogueId);
+    m_BuffersDirty = true;
+}
+
+void OrbitPathSystem::ResampleStalePaths()
+{
+    if (m_StalePaths.empty())
+    {
+        return;
+    }
+
+    // An object may have been updated more than once since the last frame, or hidden since.
+    std::sort(m_StalePaths.begin(), m_StalePaths.end());
+    m_StalePaths.erase(std::unique(m_StalePaths.begin(), m_StalePaths.end()), m_StalePaths.end());
+
+    // Objects which have left the catalogue are dropped first, as removing a path moves another one.
+    const OrbitSimulationSystem* pSimulationSystem = Game::Get()->GetSector()->GetSystem<OrbitSimulationSystem>();
+    std::vector<Ellipse> ellipses;
+    std::vector<uint32_t> noradCatalogueIds;
+    for (const uint32_t noradCatalogueId : m_StalePaths)
+    {
+        if (!IsOrbitShown(noradCatalogueId))
+        {
+            continue;
+        }
+
+        if (pSimulationSystem->GetElementSet(noradCatalogueId, m_ElementSet))
+        {
+            noradCatalogueIds.push_back(noradCatalogueId);
+            ellipses.push_back(GetEllipse(m_ElementSet));
+        }
+        else
+        {
+            RemovePath(noradCatalogueId);
+        }
+    }
+    m_StalePaths.clear();
+
+    std::vector<uint32_t> pathIndices;
+    pathIndices.reserve(noradCatalogueIds.size());
+    for (const uint32_t noradCatalogueId : noradCatalogueIds)
+    {
+        pathIndices.push_back(m_PathIndices.Find(noradCatalogueId));
+    }
+    SamplePaths(pathIndices, ellipses);
+}
+
+void OrbitPathSystem::UpdateBuffers()
+{
+    m_BuffersDirty = false;
+
+    // Each path is a line strip closed by repeating its first vertex, and followed by a primitive restart so
+    // the next one isn't joined to it.
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+    size_t vertexCount = 0;
+    for (const Path& path : m_Paths)
+    {
+        vertexCount += path.vertices.size();
+    }
+    vertices.reserve(vertexCount);
+    indices.reserve(vertexCount + m_Paths.size() * 2);
+
+    for (const Path& path : m_Paths)
+    {
+        if (path.vertices.empty())
+        {
+            continue;
+        }
+
+        const uint32_t first = static_cast<uint32_t>(vertices.size());
+        vertices.insert(vertices.end(), path.vertices.begin(), path.vertices.end());
+        for (uint32_t index = first; index < vertices.size(); ++index)
+        {
+            indices.push_back(index);
+        }
+        indices.push_back(first);
+        indices.push_back(kPrimitiveRestart);
+    }
+
+    m_VertexCount = vertices.size();
+    m_IndexCount = static_cast<uint32_t>(indices.size());
+    if (m_IndexCount == 0)
+    {
+        return;
+    }
+
+    // The buffers only grow, to a power of two, so showing and hiding paths rarely recreates them.
+    wgpu::Device device = GetRenderSystem()->GetDevice();
+    const uint64_t vertexBytes = vertices.size() * sizeof(glm::vec3);
+    if (vertexBytes > m_VertexBufferCapacity)
+    {
+        m_VertexBufferCapacity = std::bit_ceil(vertexBytes);
+        wgpu::BufferDescriptor vertexBufferDescriptor{
+            .label = "Orbit path vertex buffer",
+            .usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst,
+            .size = m_VertexBufferCapacity
+        };
+        m_VertexBuffer = device.CreateBuffer(&vertexBufferDescriptor);
+    }
+
+    const uint64_t indexBytes = indices.size() * sizeof(uint32_t);
+    if (indexBytes > m_IndexBufferCapacity)
+    {
+        m_IndexBufferCapacity = std::bit_ceil(indexBytes);
+        wgpu::BufferDescriptor indexBufferDescriptor{
+            .label = "Orbit path index buffer",
+            .usage = wgpu::BufferUsage::Index | wgpu::BufferUsage::CopyDst,
+            .size = m_IndexBufferCapacity
+        };
+        m_IndexBuffer = device.CreateBuffer(&indexBufferDescriptor);
+    }
+
+    device.GetQueue().WriteBuffer(m_VertexBuffer, 0, vertices.data(), vertexBytes);
+    device.GetQueue().WriteBuffer(m_IndexBuffer, 0, indices.data(), indexBytes);
+}
+
+void OrbitPathSystem::CreateRenderPipeline()
+{
+    if (!m_pShader)
+    {
+        return;
+    }
+
+    wgpu::BlendState blendState{
+        .color = {
+            .operation = wgpu::BlendOperation::Add,
+            .srcFactor = wgpu::BlendFactor::SrcAlpha,
+            .dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha },
+        .alpha = { .operation = wgpu::BlendOperation::Add, .srcFactor = wgpu::BlendFactor::One, .dstFactor = wgpu::BlendFactor::OneMinusSrcAlpha }
+    };
+
+    wgpu::ColorTargetState colorTargetState{
+        .format = GetWindow()->GetTextureFormat(),
+        .blend = &blendState,
+        .writeMask = wgpu::ColorWriteMask::All
+    };
+
+    wgpu::FragmentState fragmentState{
+        .module = m_pShader->GetShaderModule(),
+        .targetCount = 1,
+        .targets = &colorTargetState
+    };
+
+    wgpu::BindGroupLayout bindGroupLayout = GetRenderSystem()->GetGlobalUniformsLayout();
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &bindGroupLayout
+    };
+    wgpu::PipelineLayout pipelineLayout = GetRenderSystem()->GetDevice().CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+    wgpu::VertexAttribute attribute;
+    attribute.format = wgpu::VertexFormat::Float32x3;
+    attribute.offset = 0;
+    attribute.shaderLocation = 0;
+
+    wgpu::VertexBufferLayout vertexBufferLayout;
+    vertexBufferLayout.arrayStride = sizeof(glm::vec3);
+    vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
+    vertexBufferLayout.attributeCount = 1;
+    vertexBufferLayout.attributes = &attribute;
+
+    // Hidden behind the Earth, but not hiding each other or the sprites drawn after them.
+    wgpu::DepthStencilState depthState{
+        .format = wgpu::TextureFormat::Depth32Float,
+        .depthWriteEnabled = false,
+        .depthCompare = wgpu::CompareFunction::Less
+    };
+
+    wgpu::RenderPipelineDescriptor descriptor{
+        .label = "Orbit path render pipeline",
+        .layout = pipelineLayout,
+        .vertex = {
+            .module = m_pShader->GetShaderModule(),
+            .bufferCount = 1,
+            .buffers = &vertexBufferLayout },
+        .primitive = { .topology = wgpu::PrimitiveTopology::LineStrip, .stripIndexFormat = wgpu::IndexFormat::Uint32 },
+        .depthStencil = &depthState,
+        .multisample = { .count = RenderSystem::MsaaSampleCount },
+        .fragment = &fragmentState
+    };
+    m_RenderPipeline = GetRenderSystem()->GetDevice().CreateRenderPipeline(&descriptor);
+}
+
+void OrbitPathSystem::HandleShaderInjection()
+{
+    if (!m_ShaderInjectionSignalId.has_value())
+    {
+        m_ShaderInjectionSignalId = GetResourceSystem()->GetShaderInjectedSignal().Connect(
+            [this](ResourceShader* pResourceShader) {
+                if (m_pShader.get() == pResourceShader)
+                {
+                    CreateRenderPipeline();
+                }
+            });
+    }
+}
+
+} // namespace WingsOfSteel
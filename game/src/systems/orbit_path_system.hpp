@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+#include <webgpu/webgpu_cpp.h>
+
+#include <core/signal.hpp>
+#include <resources/resource_shader.hpp>
+#include <scene/systems/system.hpp>
+
+#include "space_objects/flat_id_map.hpp"
+#include "space_objects/space_object.hpp"
+#include "space_objects/space_object_catalogue.hpp"
+
+namespace WingsOfSteel
+{
+
+// Draws the orbits of chosen space objects as closed polylines. A path is sampled once, when it is shown or
+// its object gets a new element set, rather than every frame: points are spaced along the ellipse so that
+// each chord strays no further from it than a small fraction of the distance from the Earth, which puts
+// them close together around perigee and far apart around apogee. Every path lives in one vertex buffer and
+// one index buffer on the GPU, rebuilt only when the set of paths changes, and all of them are drawn with a
+// single indexed line strip draw, so a whole constellation costs next to nothing per frame.
+//
+// The ellipse is the one described by the element set OrbitSimulationSystem propagates the object from,
+// without the drift of the node and perigee. Paths are sampled again as the simulation time moves from one
+// element set in the object's history to the next.
+//
+// Orbits are shown object by object, or for whole catalogue groups. A group's orbits stay shown for objects
+// added to it later, and hiding a group keeps the paths of objects which are also in another shown group or
+// were shown on their own.
+class OrbitPathSystem : public System
+{
+public:
+    // The elements which shape and orient the ellipse, so sampling doesn't need a whole element set.
+    struct Ellipse
+    {
+        float meanMotion; // rev/day
+        float eccentricity;
+        float inclination; // deg
+        float rightAscensionOfAscendingNode; // deg
+        float argumentOfPericenter; // deg
+    };
+
+    OrbitPathSystem();
+    ~OrbitPathSystem();
+
+    void Initialize(Scene* pScene) override;
+    void Update(float delta) override;
+    void Render(wgpu::RenderPassEncoder& renderPass);
+
+    // Returns false if the object isn't in the catalogue.
+    bool ShowOrbit(uint32_t noradCatalogueId);
+    void HideOrbit(uint32_t noradCatalogueId); // Even if the object is in a shown group
+    void ShowOrbits(const std::vector<uint32_t>& noradCatalogueIds);
+    void HideOrbits(const std::vector<uint32_t>& noradCatalogueIds);
+    void ClearOrbits(); // Also hides every group
+    bool IsOrbitShown(uint32_t noradCatalogueId) const;
+
+    void ShowGroupOrbits(SpaceObjectCatalogue::GroupMask groups);
+    void HideGroupOrbits(SpaceObjectCatalogue::GroupMask groups);
+    SpaceObjectCatalogue::GroupMask GetShownGroups() const { return m_ShownGroups; }
+
+    size_t GetPathCount() const { return m_Paths.size(); }
+    size_t GetVertexCount() const { return m_VertexCount; }
+
+private:
+    struct Path
+    {
+        uint32_t noradCatalogueId;
+        bool pinned; // Shown on its own, rather than only through its groups
+        std::vector<glm::vec3> vertices; // km, ECI, around the orbit once without repeating the first
+    };
+
+    void OnSpaceObjectConstructed(entt::registry& registry, entt::entity entity);
+    void OnSpaceObjectUpdated(entt::registry& registry, entt::entity entity);
+    void OnSpaceObjectDestroyed(entt::registry& registry, entt::entity entity);
+    bool IsInShownGroup(uint32_t noradCatalogueId) const;
+    void AddPaths(const std::vector<uint32_t>& noradCatalogueIds, bool pinned);
+    void SamplePaths(const std::vector<uint32_t>& pathIndices, const std::vector<Ellipse>& ellipses);
+    static Ellipse GetEllipse(const SpaceObject& elementSet);
+    void RemovePath(uint32_t noradCatalogueId);
+    void ResampleStalePaths();
+    void UpdateBuffers();
+    void CreateRenderPipeline();
+    void HandleShaderInjection();
+
+    entt::registry* m_pRegistry{ nullptr }; // Whose signals the system is connected to
+    ResourceShaderSharedPtr m_pShader;
+    wgpu::RenderPipeline m_RenderPipeline;
+    std::optional<SignalId> m_ShaderInjectionSignalId;
+
+    std::vector<Path> m_Paths;
+    FlatIdMap m_PathIndices; // Index in m_Paths, by NORAD catalogue ID
+    std::vector<uint32_t> m_StalePaths; // NORAD catalogue IDs of paths whose element set has changed
+    SpaceObjectCatalogue::GroupMask m_ShownGroups{ 0 };
+    std::vector<uint32_t> m_PendingGroupPaths; // NORAD catalogue IDs of objects which joined a shown group
+    SpaceObject m_ElementSet; // Scratch for the element set a path is sampled from
+
+    wgpu::Buffer m_VertexBuffer;
+    wgpu::Buffer m_IndexBuffer;
+    uint64_t m_VertexBufferCapacity{ 0 }; // bytes
+    uint64_t m_IndexBufferCapacity{ 0 }; // bytes
+    size_t m_VertexCount{ 0 };
+    uint32_t m_IndexCount{ 0 };
+    bool m_BuffersDirty{ false };
+};
+
+} // namespace WingsOfSteel
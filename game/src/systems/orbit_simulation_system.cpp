@@ -1,18 +1,25 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <limits>
+#include <optional>
 
 #include <glm/glm.hpp>
-#include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include <render/debug_render.hpp>
-#include <scene/components/debug_render_component.hpp>
+#include <pandora.hpp>
+#include <render/window.hpp>
+#include <scene/components/camera_component.hpp>
 #include <scene/components/transform_component.hpp>
+#include <scene/entity.hpp>
 #include <scene/scene.hpp>
-#include <pandora.hpp>
 
 #include "systems/orbit_simulation_system.hpp"
 #include "components/space_object_component.hpp"
+#include "game.hpp"
+#include "jobs/worker_pool.hpp"
+#include "sector/sector.hpp"
+#include "space_objects/space_object_catalogue.hpp"
 
 namespace WingsOfSteel
 {
@@ -20,118 +27,702 @@ namespace WingsOfSteel
 namespace
 {
 
-// Earth's gravitational parameter (km³/s²)
-constexpr double kMu = 398600.4418;
+// Number of objects propagated per job. Large enough to amortise the scheduling overhead, small enough
+// for a few thousand objects to still be spread over several workers.
+constexpr size_t kPropagationGrainSize = 1024;
+
+// Upper bound on the orbital arc between two keys (rad). This is what spaces the keys of objects which
+// are off-screen or hidden, and keeps them close enough to be accurate again soon after they come into view.
+constexpr double kMaximumAngularStep = 0.5;
+
+// Occlusion only needs to be approximate, so the Earth is treated as a sphere (km).
+constexpr float kEarthRadius = 6378.137f;
+
+// High fidelity objects are re-seeded from the analytic model once the clock is this far (s) from the last
+// seed, e.g. after jumping to another epoch, rather than integrating all the way there.
+constexpr double kMaximumNumericalSpan = 7.0 * 86400.0;
+
+// Converts a BSTAR drag term (1/earth radii) into a ballistic coefficient Cd·A/m (m²/kg), by way of the
+// reference density SGP4 assumes.
+constexpr double kBstarToBallisticCoefficient = 12.741621;
+
+} // anonymous namespace
+
+OrbitSimulationSystem::OrbitSimulationSystem()
+{
+
+}
+
+OrbitSimulationSystem::~OrbitSimulationSystem()
+{
+    if (m_pRegistry)
+    {
+        m_pRegistry->on_construct<SpaceObjectComponent>().disconnect<&OrbitSimulationSystem::OnSpaceObjectChanged>(this);
+        m_pRegistry->on_update<SpaceObjectComponent>().disconnect<&OrbitSimulationSystem::OnSpaceObjectChanged>(this);
+        m_pRegistry->on_destroy<SpaceObjectComponent>().disconnect<&OrbitSimulationSystem::OnSpaceObjectDestroyed>(this);
+    }
+}
+
+void OrbitSimulationSystem::Initialize(Scene* pScene)
+{
+    // Space objects which are added, removed or have their element sets replaced are collected here and
+    // applied to the propagation store at the next update, once all their components are in place.
+    m_pRegistry = &pScene->GetRegistry();
+    m_pRegistry->on_construct<SpaceObjectComponent>().connect<&OrbitSimulationSystem::OnSpaceObjectChanged>(this);
+    m_pRegistry->on_update<SpaceObjectComponent>().connect<&OrbitSimulationSystem::OnSpaceObjectChanged>(this);
+    m_pRegistry->on_destroy<SpaceObjectComponent>().connect<&OrbitSimulationSystem::OnSpaceObjectDestroyed>(this);
+}
+
+void OrbitSimulationSystem::OnSpaceObjectChanged(entt::registry& registry, entt::entity entity)
+{
+    if (!m_PropagationStoreDirty)
+    {
+        m_ChangedEntities.push_back(entity);
+    }
+}
+
+void OrbitSimulationSystem::OnSpaceObjectDestroyed(entt::registry& registry, entt::entity entity)
+{
+    if (!m_PropagationStoreDirty)
+    {
+        m_DestroyedEntities.push_back(entity);
+    }
+}
+
+void OrbitSimulationSystem::SetPropagationModel(PropagationStore::Model model)
+{
+    m_PropagationStore.SetModel(model);
+    m_NumericalPropagatorDirty = true;
+    m_EphemerisCache.Invalidate();
+    InvalidateKeys();
+}
 
-// Solve Kepler's equation: M = E - e*sin(E)
-// Returns Eccentric Anomaly E given Mean Anomaly M and eccentricity e
-// Uses Newton-Raphson iteration
-double SolveKeplerEquation(double meanAnomaly, double eccentricity, int maxIterations = 10, double tolerance = 1e-10)
+void OrbitSimulationSystem::SetKeplerAccuracy(KeplerSolver::Accuracy accuracy)
 {
-    double E = meanAnomaly; // Initial guess
-    for (int i = 0; i < maxIterations; ++i)
+    m_PropagationStore.SetKeplerAccuracy(accuracy);
+    m_EphemerisCache.Invalidate();
+    InvalidateKeys();
+}
+
+void OrbitSimulationSystem::RebuildPropagationStore(entt::registry& registry)
+{
+    m_PropagationStore.Clear();
+    m_Entities.clear();
+    m_EntitySlots.clear();
+    m_FreeSlots.clear();
+    m_ChangedEntities.clear();
+    m_DestroyedEntities.clear();
+
+    // Element sets are read from the catalogue, which is their only copy.
+    const SpaceObjectCatalogue* pCatalogue = Game::Get()->GetSector()->GetSpaceObjectCatalogue();
+    auto view = registry.view<const SpaceObjectComponent, const TransformComponent>();
+    view.each([this, pCatalogue](const auto entity, const SpaceObjectComponent& spaceObjectComponent, const TransformComponent& transformComponent)
     {
-        double f = E - eccentricity * std::sin(E) - meanAnomaly;
-        double fPrime = 1.0 - eccentricity * std::cos(E);
-        double delta = f / fPrime;
-        E -= delta;
-        if (std::abs(delta) < tolerance)
+        const std::optional<SpaceObjectView> spaceObject = pCatalogue->GetByNoradId(spaceObjectComponent.GetNoradCatalogueId());
+        if (!spaceObject.has_value())
         {
-            break;
+            return;
         }
+
+        spaceObject->Unpack(m_ElementSet);
+        const uint32_t slot = static_cast<uint32_t>(m_PropagationStore.Add(m_ElementSet));
+        m_Entities.push_back(entity);
+
+        const size_t entityIndex = entt::to_entity(entity);
+        if (entityIndex >= m_EntitySlots.size())
+        {
+            m_EntitySlots.resize(entityIndex + 1, kNoSlot);
+        }
+        m_EntitySlots[entityIndex] = slot;
+    });
+
+    m_Positions.resize(m_Entities.size());
+    m_ElementSetValidity.resize(m_Entities.size());
+    for (size_t slot = 0; slot < m_Entities.size(); ++slot)
+    {
+        InvalidateElementSet(slot);
     }
-    return E;
+    m_NumericalPropagatorDirty = true;
+    m_EphemerisCache.Invalidate();
+    InvalidateKeys();
+    m_ScheduleCursor = 0;
+    m_PropagationStoreDirty = false;
 }
 
-// Calculate Cartesian position (in km) from Keplerian orbital elements
-// Propagates the position to the current system time
-glm::dvec3 CalculateCartesianPosition(const SpaceObject& spaceObject)
+uint32_t OrbitSimulationSystem::GetSlot(entt::entity entity) const
 {
-    // Convert mean motion from rev/day to rad/s
-    double n = spaceObject.GetMeanMotion() * 2.0 * glm::pi<double>() / 86400.0;
+    // Entity indices are recycled, so the slot only belongs to the entity if the versions match too.
+    const size_t entityIndex = entt::to_entity(entity);
+    const uint32_t slot = entityIndex < m_EntitySlots.size() ? m_EntitySlots[entityIndex] : kNoSlot;
+    return slot != kNoSlot && m_Entities[slot] == entity ? slot : kNoSlot;
+}
+
+void OrbitSimulationSystem::ApplySpaceObjectChanges(entt::registry& registry)
+{
+    if (m_ChangedEntities.empty() && m_DestroyedEntities.empty())
+    {
+        return;
+    }
 
-    // Calculate semi-major axis from mean motion: n = sqrt(mu/a³) => a = (mu/n²)^(1/3)
-    double a = std::cbrt(kMu / (n * n));
+    // Removals go first, so an entity index which was recycled within the frame gets a slot of its own.
+    for (const entt::entity entity : m_DestroyedEntities)
+    {
+        const uint32_t slot = GetSlot(entity);
+        if (slot != kNoSlot)
+        {
+            m_Entities[slot] = entt::null;
+            m_EntitySlots[entt::to_entity(entity)] = kNoSlot;
+            m_FreeSlots.push_back(slot);
+        }
+    }
 
-    double e = spaceObject.GetEccentricity();
+    const SpaceObjectCatalogue* pCatalogue = Game::Get()->GetSector()->GetSpaceObjectCatalogue();
+    for (const entt::entity entity : m_ChangedEntities)
+    {
+        if (!registry.valid(entity) || !registry.all_of<SpaceObjectComponent, TransformComponent>(entity))
+        {
+            continue;
+        }
 
-    // Convert angles from degrees to radians
-    double i = glm::radians(static_cast<double>(spaceObject.GetInclination()));
-    double omega = glm::radians(static_cast<double>(spaceObject.GetRightAscensionOfAscendingNode())); // RAAN (Ω)
-    double w = glm::radians(static_cast<double>(spaceObject.GetArgumentOfPericenter())); // Argument of pericenter (ω)
-    double M_epoch = glm::radians(static_cast<double>(spaceObject.GetMeanAnomaly()));
+        const std::optional<SpaceObjectView> spaceObject = pCatalogue->GetByNoradId(registry.get<const SpaceObjectComponent>(entity).GetNoradCatalogueId());
+        if (!spaceObject.has_value())
+        {
+            continue;
+        }
 
-    // Propagate mean anomaly to current time
-    auto now = std::chrono::system_clock::now();
-    auto epoch = spaceObject.GetEpoch();
-    double deltaSeconds = std::chrono::duration<double>(now - epoch).count();
-    double M = M_epoch + n * deltaSeconds;
+        uint32_t slot = GetSlot(entity);
+        if (slot == kNoSlot && !m_FreeSlots.empty())
+        {
+            slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+        else if (slot == kNoSlot)
+        {
+            slot = static_cast<uint32_t>(m_Entities.size());
+            m_Entities.push_back(entt::null);
+            m_Positions.emplace_back(0.0f);
+            m_ElementSetValidity.emplace_back();
+            m_Keys0.emplace_back();
+            m_Keys1.emplace_back();
+        }
 
-    // Normalize to [0, 2π]
-    M = std::fmod(M, 2.0 * glm::pi<double>());
-    if (M < 0.0) M += 2.0 * glm::pi<double>();
+        spaceObject->Unpack(m_ElementSet);
+        if (slot < m_PropagationStore.GetCount())
+        {
+            m_PropagationStore.Set(slot, m_ElementSet);
+        }
+        else
+        {
+            m_PropagationStore.Add(m_ElementSet);
+        }
 
-    // Solve Kepler's equation to get Eccentric Anomaly
-    double E = SolveKeplerEquation(M, e);
+        m_Entities[slot] = entity;
+        const size_t entityIndex = entt::to_entity(entity);
+        if (entityIndex >= m_EntitySlots.size())
+        {
+            m_EntitySlots.resize(entityIndex + 1, kNoSlot);
+        }
+        m_EntitySlots[entityIndex] = slot;
+        InvalidateKeys(slot);
+        InvalidateElementSet(slot);
+    }
 
-    // Calculate True Anomaly from Eccentric Anomaly
-    // tan(nu/2) = sqrt((1+e)/(1-e)) * tan(E/2)
-    double nu = 2.0 * std::atan2(
-        std::sqrt(1.0 + e) * std::sin(E / 2.0),
-        std::sqrt(1.0 - e) * std::cos(E / 2.0)
-    );
+    m_ChangedEntities.clear();
+    m_DestroyedEntities.clear();
 
-    // Calculate orbital radius
-    double r = a * (1.0 - e * std::cos(E));
+    // The cache is rebuilt in the background, and high fidelity objects may have new element sets or slots.
+    m_EphemerisCache.Invalidate();
+    m_NumericalPropagatorDirty = true;
+}
 
-    // Position in perifocal (orbital plane) coordinates
-    double x_pf = r * std::cos(nu);
-    double y_pf = r * std::sin(nu);
+bool OrbitSimulationSystem::AddHighFidelityObject(uint32_t noradCatalogueId)
+{
+    if (std::find(m_HighFidelityIds.begin(), m_HighFidelityIds.end(), noradCatalogueId) != m_HighFidelityIds.end())
+    {
+        return false;
+    }
 
-    // Transform from perifocal to ECI (Earth-Centered Inertial) coordinates
-    // Using the rotation: R = R_z(-Ω) * R_x(-i) * R_z(-ω)
-    double cos_omega = std::cos(omega);
-    double sin_omega = std::sin(omega);
-    double cos_i = std::cos(i);
-    double sin_i = std::sin(i);
-    double cos_w = std::cos(w);
-    double sin_w = std::sin(w);
+    bool found = false;
+    entt::registry& registry = GetActiveScene()->GetRegistry();
+    registry.view<const SpaceObjectComponent>().each([noradCatalogueId, &found](const SpaceObjectComponent& spaceObjectComponent)
+    {
+        found = found || spaceObjectComponent.GetNoradCatalogueId() == noradCatalogueId;
+    });
 
-    // Combined rotation matrix elements (optimized form)
-    double x = x_pf * (cos_omega * cos_w - sin_omega * sin_w * cos_i)
-             - y_pf * (cos_omega * sin_w + sin_omega * cos_w * cos_i);
+    if (found)
+    {
+        m_HighFidelityIds.push_back(noradCatalogueId);
+        m_NumericalPropagatorDirty = true;
+    }
+    return found;
+}
 
-    double y = x_pf * (sin_omega * cos_w + cos_omega * sin_w * cos_i)
-             - y_pf * (sin_omega * sin_w - cos_omega * cos_w * cos_i);
+void OrbitSimulationSystem::ClearHighFidelityObjects()
+{
+    m_HighFidelityIds.clear();
+    m_HighFidelitySlots.clear();
+    m_NumericalPropagator.Clear();
+}
 
-    double z = x_pf * (sin_w * sin_i)
-             + y_pf * (cos_w * sin_i);
+void OrbitSimulationSystem::InvalidateKeys()
+{
+    const size_t count = m_PropagationStore.GetCount();
+    m_Keys0.resize(count);
+    m_Keys1.resize(count);
+    for (size_t slot = 0; slot < count; ++slot)
+    {
+        InvalidateKeys(slot);
+    }
+}
 
-    return glm::dvec3(x, y, z);
+void OrbitSimulationSystem::InvalidateKeys(size_t slot)
+{
+    // An empty interval never contains the current time, and is how slots without keys are recognised.
+    m_Keys0[slot] = { std::numeric_limits<double>::infinity(), glm::vec3(0.0f), glm::vec3(0.0f) };
+    m_Keys1[slot] = { -std::numeric_limits<double>::infinity(), glm::vec3(0.0f), glm::vec3(0.0f) };
 }
 
-} // anonymous namespace
+void OrbitSimulationSystem::InvalidateElementSet(size_t slot)
+{
+    // An empty span never contains the current time, so the slot's element set is picked again.
+    m_ElementSetValidity[slot] = { std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+    m_ElementSetWindow = m_ElementSetValidity[slot];
+}
 
-OrbitSimulationSystem::OrbitSimulationSystem()
+void OrbitSimulationSystem::SelectElementSets(double time, entt::registry& registry)
 {
-    
+    m_ElementSetTime = time;
+    m_SwitchedElementSets.clear();
+    if (time >= m_ElementSetWindow.from && time < m_ElementSetWindow.until)
+    {
+        return;
+    }
+
+    const ElementSetHistory& history = Game::Get()->GetSector()->GetSpaceObjectCatalogue()->GetHistory();
+    m_ElementSetWindow = { -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+    bool changed = false;
+    for (size_t slot = 0; slot < m_Entities.size(); ++slot)
+    {
+        if (m_Entities[slot] == entt::null)
+        {
+            continue;
+        }
+
+        ElementSetHistory::Validity& validity = m_ElementSetValidity[slot];
+        if (time < validity.from || time >= validity.until)
+        {
+            // Objects without a history keep the catalogue's element set, which is then valid forever.
+            const uint32_t noradCatalogueId = registry.get<const SpaceObjectComponent>(m_Entities[slot]).GetNoradCatalogueId();
+            const uint32_t row = history.FindClosest(noradCatalogueId, time, validity);
+            if (row == ElementSetHistory::kNoElementSet)
+            {
+                validity = { -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+            }
+            else
+            {
+                history.Apply(row, m_ElementSet);
+                const double epoch = std::chrono::duration<double>(m_ElementSet.GetEpoch().time_since_epoch()).count();
+                if (epoch != m_PropagationStore.GetEpoch(slot))
+                {
+                    m_PropagationStore.Set(slot, m_ElementSet);
+                    InvalidateKeys(slot);
+                    m_SwitchedElementSets.push_back(noradCatalogueId);
+                    changed = true;
+                }
+            }
+        }
+
+        m_ElementSetWindow.from = std::max(m_ElementSetWindow.from, validity.from);
+        m_ElementSetWindow.until = std::min(m_ElementSetWindow.until, validity.until);
+    }
+
+    if (changed)
+    {
+        m_EphemerisCache.Invalidate();
+        m_NumericalPropagatorDirty = true;
+    }
 }
 
-OrbitSimulationSystem::~OrbitSimulationSystem()
+bool OrbitSimulationSystem::GetElementSet(uint32_t noradCatalogueId, SpaceObject& elementSet) const
 {
-    
+    const SpaceObjectCatalogue* pCatalogue = Game::Get()->GetSector()->GetSpaceObjectCatalogue();
+    const std::optional<SpaceObjectView> spaceObject = pCatalogue->GetByNoradId(noradCatalogueId);
+    if (!spaceObject.has_value())
+    {
+        return false;
+    }
+    spaceObject->Unpack(elementSet);
+
+    // Found the same way SelectElementSets() finds it. The slot's element set is only selected again once
+    // the time leaves its validity, but until then the closest one can't have changed.
+    if (!std::isnan(m_ElementSetTime))
+    {
+        ElementSetHistory::Validity validity;
+        const uint32_t row = pCatalogue->GetHistory().FindClosest(noradCatalogueId, m_ElementSetTime, validity);
+        if (row != ElementSetHistory::kNoElementSet)
+        {
+            pCatalogue->GetHistory().Apply(row, elementSet);
+        }
+    }
+    return true;
 }
 
 void OrbitSimulationSystem::Update(float delta)
 {
     entt::registry& registry = GetActiveScene()->GetRegistry();
-    auto view = registry.view<const SpaceObjectComponent, TransformComponent>();
+    if (m_PropagationStoreDirty)
+    {
+        RebuildPropagationStore(registry);
+    }
+    else
+    {
+        ApplySpaceObjectChanges(registry);
+    }
+
+    // All objects are propagated and interpolated to the same instant, which only changes once per frame.
+    const double time = Game::Get()->GetSector()->GetSimulationClock().GetTime();
+    SelectElementSets(time, registry);
+    m_EphemerisCache.Update(time, m_PropagationStore, Game::Get()->GetWorkerPool());
+    if (m_EphemerisCache.Contains(time))
+    {
+        // The keys go stale while the cache is in use, but ScheduleKeys() replaces them as soon as it's needed again.
+        m_PropagationCount = 0;
+        EvaluateEphemeris(time, registry);
+    }
+    else
+    {
+        ScheduleKeys(time);
+        Interpolate(time, registry);
+    }
+    UpdateHighFidelityObjects(time, registry);
+    m_LastTime = time;
+}
+
+void OrbitSimulationSystem::ScheduleKeys(double time)
+{
+    const size_t count = m_PropagationStore.GetCount();
+    m_DueSlots.clear();
+    m_RequestSlots.clear();
+    m_RequestTimes.clear();
+    m_PropagationCount = 0;
+
+    // Find the slots whose keys no longer bracket the current time. The scan resumes wherever the budget
+    // ran out on the previous frame, so deferred objects are first in line.
+    size_t cost = 0;
+    size_t firstDeferredSlot = count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t slot = (m_ScheduleCursor + i) % count;
+        if (m_Entities[slot] == entt::null)
+        {
+            continue;
+        }
+
+        PropagationKey& key0 = m_Keys0[slot];
+        const PropagationKey& key1 = m_Keys1[slot];
+        if (time >= key0.time && time <= key1.time)
+        {
+            continue;
+        }
+
+        const bool hasKeys = key0.time <= key1.time;
+        if (hasKeys && m_PropagationBudget > 0 && cost >= m_PropagationBudget)
+        {
+            if (firstDeferredSlot == count)
+            {
+                firstDeferredSlot = slot;
+            }
+            continue;
+        }
+
+        if (hasKeys && time > key1.time)
+        {
+            // Moving forwards, so the segment's end key becomes the start of the next one.
+            key0 = key1;
+            cost += 1;
+        }
+        else
+        {
+            // No keys yet, or the clock has been moved backwards, so a new start key is needed.
+            m_RequestSlots.push_back(static_cast<uint32_t>(slot));
+            m_RequestTimes.push_back(time);
+            cost += 2;
+        }
+        m_DueSlots.push_back(static_cast<uint32_t>(slot));
+    }
+
+    if (firstDeferredSlot != count)
+    {
+        m_ScheduleCursor = firstDeferredSlot;
+    }
 
-    view.each([&registry](const auto entity, const SpaceObjectComponent& spaceObjectComponent, TransformComponent& transformComponent)
+    PropagateRequests();
+    for (size_t i = 0; i < m_RequestSlots.size(); ++i)
     {
-        glm::dvec3 position = CalculateCartesianPosition(spaceObjectComponent.GetSpaceObject()); // Position is in km, in ECI coordinates
-        transformComponent.transform = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y, position.z));
+        m_Keys0[m_RequestSlots[i]] = { m_RequestTimes[i], m_RequestPositions[i], m_RequestVelocities[i] };
+    }
+
+    WorkerPool* pWorkerPool = Game::Get()->GetWorkerPool();
+    const size_t dueCount = m_DueSlots.size();
+    m_DueIntervals.resize(dueCount);
+    ViewState viewState;
+    if (m_LevelOfDetailEnabled && GetViewState(viewState))
+    {
+        pWorkerPool->ParallelFor(dueCount, kPropagationGrainSize, [this, &viewState](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_DueIntervals[i] = CalculateKeyInterval(m_Keys0[m_DueSlots[i]], viewState);
+            }
+        });
+    }
+    else
+    {
+        std::fill(m_DueIntervals.begin(), m_DueIntervals.end(), 0.0);
+    }
+
+    // Request the end key of every due slot.
+    const double frameDelta = std::abs(time - m_LastTime);
+    m_RequestSlots.clear();
+    m_RequestTimes.clear();
+    for (size_t i = 0; i < dueCount; ++i)
+    {
+        const uint32_t slot = m_DueSlots[i];
+        const PropagationKey& key0 = m_Keys0[slot];
+        const double interval = m_DueIntervals[i];
+        if (interval <= frameDelta || key0.time + interval <= time)
+        {
+            // The object would be due again by the next frame regardless, so it is propagated to the
+            // current time and both keys collapse onto the result.
+            if (key0.time == time)
+            {
+                m_Keys1[slot] = key0;
+            }
+            else
+            {
+                m_RequestSlots.push_back(slot);
+                m_RequestTimes.push_back(time);
+            }
+        }
+        else
+        {
+            m_RequestSlots.push_back(slot);
+            m_RequestTimes.push_back(key0.time + interval);
+        }
+    }
+
+    PropagateRequests();
+    for (size_t i = 0; i < m_RequestSlots.size(); ++i)
+    {
+        const PropagationKey key{ m_RequestTimes[i], m_RequestPositions[i], m_RequestVelocities[i] };
+        m_Keys1[m_RequestSlots[i]] = key;
+
+        // End keys are always in the future, unless they were collapsed onto the current time above.
+        if (key.time == time)
+        {
+            m_Keys0[m_RequestSlots[i]] = key;
+        }
+    }
+}
+
+void OrbitSimulationSystem::PropagateRequests()
+{
+    const size_t count = m_RequestSlots.size();
+    m_RequestPositions.resize(count);
+    m_RequestVelocities.resize(count);
+    Game::Get()->GetWorkerPool()->ParallelFor(count, kPropagationGrainSize, [this](size_t begin, size_t end)
+    {
+        m_PropagationStore.Propagate(&m_RequestSlots[begin], &m_RequestTimes[begin], end - begin, &m_RequestPositions[begin], &m_RequestVelocities[begin]);
     });
+    m_PropagationCount += count;
+}
+
+bool OrbitSimulationSystem::GetViewState(ViewState& viewState) const
+{
+    EntitySharedPtr pCamera = GetActiveScene() ? GetActiveScene()->GetCamera() : nullptr;
+    if (pCamera == nullptr || !pCamera->HasComponent<CameraComponent>())
+    {
+        return false;
+    }
+
+    const uint32_t windowWidth = GetWindow()->GetWidth();
+    const uint32_t windowHeight = GetWindow()->GetHeight();
+    if (windowWidth == 0 || windowHeight == 0)
+    {
+        return false;
+    }
+
+    // Everything is derived from points unprojected onto the near plane, so it holds whatever the camera's
+    // field of view and aspect ratio are.
+    const Camera& camera = pCamera->GetComponent<CameraComponent>().camera;
+    const glm::vec2 screenCentre(windowWidth * 0.5f, windowHeight * 0.5f);
+    const glm::vec3 nearCentre = camera.ScreenToWorld(screenCentre, windowWidth, windowHeight, 0.0f);
+    const glm::vec3 nearCentreOffset = camera.ScreenToWorld(screenCentre + glm::vec2(0.0f, 1.0f), windowWidth, windowHeight, 0.0f);
+    const glm::vec3 nearCorner = camera.ScreenToWorld(glm::vec2(0.0f), windowWidth, windowHeight, 0.0f);
+
+    viewState.position = camera.GetPosition();
+    const float nearDistance = glm::length(nearCentre - viewState.position);
+    if (nearDistance <= 0.0f)
+    {
+        return false;
+    }
+
+    viewState.forward = (nearCentre - viewState.position) / nearDistance;
+    viewState.cosHalfFieldOfView = glm::dot(glm::normalize(nearCorner - viewState.position), viewState.forward);
+    viewState.pixelAngle = glm::length(nearCentreOffset - nearCentre) / nearDistance;
+    return true;
+}
+
+double OrbitSimulationSystem::CalculateKeyInterval(const PropagationKey& key, const ViewState& viewState) const
+{
+    const float radius = glm::length(key.position);
+    const float speed = glm::length(key.velocity);
+    if (radius <= 0.0f || speed <= 0.0f)
+    {
+        return 0.0;
+    }
+
+    // Angular rate about the Earth's centre. Including the radial part of the velocity overestimates it for
+    // eccentric orbits, which errs on the side of shorter intervals.
+    const double angularRate = static_cast<double>(speed) / radius;
+
+    double angularStep = kMaximumAngularStep;
+    const glm::vec3 toObject = key.position - viewState.position;
+    const float distance = glm::length(toObject);
+    if (distance > 0.0f && glm::dot(toObject, viewState.forward) >= viewState.cosHalfFieldOfView * distance)
+    {
+        // The object is inside the view cone, and is visible unless the line of sight passes through the Earth.
+        const float closestApproach = glm::clamp(-glm::dot(viewState.position, toObject) / (distance * distance), 0.0f, 1.0f);
+        const glm::vec3 closestPoint = viewState.position + toObject * closestApproach;
+        if (glm::dot(closestPoint, closestPoint) > kEarthRadius * kEarthRadius)
+        {
+            // For motion along a circle of radius r, a cubic Hermite segment spanning an angle θ is off by at
+            // most r·θ⁴/384, so θ follows from the largest error which still fits in the tolerance.
+            const double tolerance = static_cast<double>(m_ScreenSpaceErrorTolerance) * viewState.pixelAngle * distance;
+            angularStep = std::min(angularStep, std::pow(384.0 * tolerance / radius, 0.25));
+        }
+    }
+
+    return angularStep / angularRate;
+}
+
+void OrbitSimulationSystem::SeedNumericalPropagator(double time, entt::registry& registry)
+{
+    m_NumericalPropagator.Clear();
+    m_HighFidelitySlots.clear();
+    const SpaceObjectCatalogue* pCatalogue = Game::Get()->GetSector()->GetSpaceObjectCatalogue();
+    for (size_t slot = 0; slot < m_Entities.size(); ++slot)
+    {
+        if (m_Entities[slot] == entt::null)
+        {
+            continue;
+        }
+
+        const uint32_t noradCatalogueId = registry.get<const SpaceObjectComponent>(m_Entities[slot]).GetNoradCatalogueId();
+        if (std::find(m_HighFidelityIds.begin(), m_HighFidelityIds.end(), noradCatalogueId) == m_HighFidelityIds.end())
+        {
+            continue;
+        }
+
+        const std::optional<SpaceObjectView> spaceObject = pCatalogue->GetByNoradId(noradCatalogueId);
+        if (!spaceObject.has_value())
+        {
+            continue;
+        }
+
+        glm::vec3 position;
+        glm::vec3 velocity;
+        m_PropagationStore.Propagate(time, slot, slot + 1, &position, &velocity);
+        const double ballisticCoefficient = kBstarToBallisticCoefficient * std::max(0.0f, spaceObject->GetBstar().value_or(0.0f));
+        m_NumericalPropagator.Add(time, glm::dvec3(position), glm::dvec3(velocity), ballisticCoefficient);
+        m_HighFidelitySlots.push_back(static_cast<uint32_t>(slot));
+    }
+
+    m_NumericalSeedTime = time;
+    m_NumericalPropagatorDirty = false;
+}
+
+void OrbitSimulationSystem::UpdateHighFidelityObjects(double time, entt::registry& registry)
+{
+    if (m_HighFidelityIds.empty())
+    {
+        return;
+    }
+
+    if (m_NumericalPropagatorDirty || std::abs(time - m_NumericalSeedTime) > kMaximumNumericalSpan)
+    {
+        SeedNumericalPropagator(time, registry);
+    }
+
+    // Overrides whatever the analytic model wrote for these slots this frame.
+    m_NumericalPropagator.Advance(time, Game::Get()->GetWorkerPool());
+    for (size_t i = 0; i < m_HighFidelitySlots.size(); ++i)
+    {
+        const uint32_t slot = m_HighFidelitySlots[i];
+        m_Positions[slot] = glm::vec3(m_NumericalPropagator.GetPosition(i));
+        TransformComponent& transformComponent = registry.get<TransformComponent>(m_Entities[slot]);
+        transformComponent.transform = glm::translate(glm::mat4(1.0f), m_Positions[slot]);
+    }
+}
+
+void OrbitSimulationSystem::EvaluateEphemeris(double time, entt::registry& registry)
+{
+    Game::Get()->GetWorkerPool()->ParallelFor(m_PropagationStore.GetCount(), kPropagationGrainSize,
+        [this, time, &registry](size_t begin, size_t end)
+        {
+            m_EphemerisCache.Evaluate(time, begin, end, m_PropagationStore, m_Positions.data());
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                if (m_Entities[slot] == entt::null)
+                {
+                    continue;
+                }
+
+                TransformComponent& transformComponent = registry.get<TransformComponent>(m_Entities[slot]);
+                transformComponent.transform = glm::translate(glm::mat4(1.0f), m_Positions[slot]);
+            }
+        });
+}
+
+void OrbitSimulationSystem::Interpolate(double time, entt::registry& registry)
+{
+    // Each job only touches its own slots and the transforms of the entities owning them, so the
+    // transforms can be written back from the workers without any locking. Looking components up
+    // doesn't modify the registry, and nothing is added to or removed from it while the jobs run.
+    // The same goes for EvaluateEphemeris().
+    Game::Get()->GetWorkerPool()->ParallelFor(m_PropagationStore.GetCount(), kPropagationGrainSize,
+        [this, time, &registry](size_t begin, size_t end)
+        {
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                if (m_Entities[slot] == entt::null)
+                {
+                    continue;
+                }
+
+                const PropagationKey& key0 = m_Keys0[slot];
+                const PropagationKey& key1 = m_Keys1[slot];
+
+                // Objects whose keys have fallen behind because of the budget hold their end key.
+                glm::vec3 position = key1.position;
+                const double duration = key1.time - key0.time;
+                if (duration > 0.0)
+                {
+                    const float s = static_cast<float>(std::clamp((time - key0.time) / duration, 0.0, 1.0));
+                    const float s2 = s * s;
+                    const float s3 = s2 * s;
+                    const float h = static_cast<float>(duration);
+                    position = (2.0f * s3 - 3.0f * s2 + 1.0f) * key0.position
+                        + (s3 - 2.0f * s2 + s) * h * key0.velocity
+                        + (-2.0f * s3 + 3.0f * s2) * key1.position
+                        + (s3 - s2) * h * key1.velocity;
+                }
+
+                m_Positions[slot] = position; // km, in ECI coordinates
+                TransformComponent& transformComponent = registry.get<TransformComponent>(m_Entities[slot]);
+                transformComponent.transform = glm::translate(glm::mat4(1.0f), position);
+            }
+        });
 }
 
 } // namespace WingsOfSteel
@@ -1,21 +1,165 @@
-
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
 #include <scene/systems/system.hpp>
 
+#include "propagation/ephemeris_cache.hpp"
+#include "propagation/numerical_propagator.hpp"
+#include "propagation/propagation_store.hpp"
+#include "space_objects/element_set_history.hpp"
+#include "space_objects/space_object.hpp"
+
 namespace WingsOfSteel
 {
 
+// Propagates every space object to the simulation clock's time and writes the results to its transform.
+// Rather than propagating every object every frame, each object is propagated ahead to a key at which it
+// next needs an exact position, and displayed positions are interpolated between its last two keys with a
+// cubic Hermite curve. The time between keys is chosen so the interpolation error stays below a fraction of
+// a pixel, and is as long as possible for objects which are off-screen or hidden behind the Earth.
+// Whenever the ephemeris cache covers the current time, positions are read from it instead.
+// Objects selected for high fidelity are integrated numerically instead, seeded from the analytic model.
+// Objects with several element sets in the catalogue's history are propagated from the one closest to the
+// simulation time, so scrubbing the timeline far back or ahead doesn't extrapolate from a distant epoch.
 class OrbitSimulationSystem : public System
 {
 public:
     OrbitSimulationSystem();
     ~OrbitSimulationSystem();
 
-    void Initialize(Scene* pScene) override {}
+    void Initialize(Scene* pScene) override;
     void Update(float delta) override;
 
+    PropagationStore::Model GetPropagationModel() const { return m_PropagationStore.GetModel(); }
+    void SetPropagationModel(PropagationStore::Model model);
+
+    KeplerSolver::Accuracy GetKeplerAccuracy() const { return m_PropagationStore.GetKeplerAccuracy(); }
+    void SetKeplerAccuracy(KeplerSolver::Accuracy accuracy);
+
+    // When disabled, every object is propagated every frame.
+    bool IsLevelOfDetailEnabled() const { return m_LevelOfDetailEnabled; }
+    void SetLevelOfDetailEnabled(bool enabled) { m_LevelOfDetailEnabled = enabled; }
+
+    // Largest acceptable on-screen interpolation error, in pixels.
+    float GetScreenSpaceErrorTolerance() const { return m_ScreenSpaceErrorTolerance; }
+    void SetScreenSpaceErrorTolerance(float pixels) { m_ScreenSpaceErrorTolerance = pixels; }
+
+    // Maximum number of propagations per frame, or 0 for no limit. Objects which miss out hold their last
+    // key until a later frame gets to them. Objects without any keys yet are always propagated.
+    size_t GetPropagationBudget() const { return m_PropagationBudget; }
+    void SetPropagationBudget(size_t budget) { m_PropagationBudget = budget; }
+
+    EphemerisCache& GetEphemerisCache() { return m_EphemerisCache; }
+
+    // Objects are selected for numerical propagation by their NORAD catalogue ID. Returns false if there is
+    // no such object, or if it is already selected.
+    bool AddHighFidelityObject(uint32_t noradCatalogueId);
+    void ClearHighFidelityObjects();
+    size_t GetHighFidelityObjectCount() const { return m_HighFidelityIds.size(); }
+    NumericalPropagator& GetNumericalPropagator() { return m_NumericalPropagator; }
+
+    // Number of propagations carried out in the last update.
+    size_t GetPropagationCount() const { return m_PropagationCount; }
+
+    // Fills in the element set an object is propagated from: the one in the catalogue's history closest to
+    // the time of the last update, or the catalogue's latest before the first update or for objects without a
+    // history. Returns false if the object isn't in the catalogue.
+    bool GetElementSet(uint32_t noradCatalogueId, SpaceObject& elementSet) const;
+
+    // NORAD catalogue IDs of the objects whose element set the last update switched to another one from the
+    // history, as the simulation time moved.
+    const std::vector<uint32_t>& GetSwitchedElementSets() const { return m_SwitchedElementSets; }
+
 private:
+    struct PropagationKey
+    {
+        double time; // Seconds since the Unix epoch
+        glm::vec3 position; // km, ECI
+        glm::vec3 velocity; // km/s, ECI
+    };
+
+    struct ViewState
+    {
+        glm::vec3 position;
+        glm::vec3 forward;
+        float cosHalfFieldOfView; // Across the diagonal, so the cone contains the whole frustum
+        float pixelAngle; // Angle subtended by a pixel at the centre of the screen (rad)
+    };
+
+    void OnSpaceObjectChanged(entt::registry& registry, entt::entity entity);
+    void OnSpaceObjectDestroyed(entt::registry& registry, entt::entity entity);
+    void RebuildPropagationStore(entt::registry& registry);
+    void ApplySpaceObjectChanges(entt::registry& registry);
+    uint32_t GetSlot(entt::entity entity) const;
+    void InvalidateKeys();
+    void InvalidateKeys(size_t slot);
+    void InvalidateElementSet(size_t slot);
+    void SelectElementSets(double time, entt::registry& registry);
+    bool GetViewState(ViewState& viewState) const;
+    void ScheduleKeys(double time);
+    void PropagateRequests();
+    double CalculateKeyInterval(const PropagationKey& key, const ViewState& viewState) const;
+    void Interpolate(double time, entt::registry& registry);
+    void EvaluateEphemeris(double time, entt::registry& registry);
+    void SeedNumericalPropagator(double time, entt::registry& registry);
+    void UpdateHighFidelityObjects(double time, entt::registry& registry);
+
+    entt::registry* m_pRegistry{ nullptr }; // Whose signals the system is connected to
+    PropagationStore m_PropagationStore;
+    EphemerisCache m_EphemerisCache;
+    std::vector<entt::entity> m_Entities; // Entity owning each propagation store slot, or entt::null if it's free
+    std::vector<glm::vec3> m_Positions;
+    bool m_PropagationStoreDirty{ true };
+
+    // Space objects added, changed or removed since the last update are applied to their slots alone, rather
+    // than rebuilding the store. Slots left behind by removed objects are reused before the store grows.
+    static constexpr uint32_t kNoSlot = ~0u;
+    std::vector<uint32_t> m_EntitySlots; // Slot of each entity, indexed by entity, or kNoSlot
+    std::vector<uint32_t> m_FreeSlots;
+    std::vector<entt::entity> m_ChangedEntities;
+    std::vector<entt::entity> m_DestroyedEntities;
+
+    // Each slot keeps its element set until the time leaves the span in which it is the closest one. The
+    // window is the span in which none of them change, so most frames don't look at the slots at all.
+    std::vector<ElementSetHistory::Validity> m_ElementSetValidity;
+    ElementSetHistory::Validity m_ElementSetWindow{ 0.0, 0.0 };
+    double m_ElementSetTime{ std::numeric_limits<double>::quiet_NaN() }; // Time the element sets were last selected for
+    std::vector<uint32_t> m_SwitchedElementSets;
+    SpaceObject m_ElementSet; // Scratch for the element set being applied or unpacked from the catalogue
+
+    // Objects are interpolated between m_Keys0[slot] and m_Keys1[slot].
+    std::vector<PropagationKey> m_Keys0;
+    std::vector<PropagationKey> m_Keys1;
+
+    // Slots which need new keys this frame, and their intervals until the next key.
+    std::vector<uint32_t> m_DueSlots;
+    std::vector<double> m_DueIntervals;
+    size_t m_ScheduleCursor{ 0 };
+
+    // Batched propagation requests, so they can be spread over the worker pool.
+    std::vector<uint32_t> m_RequestSlots;
+    std::vector<double> m_RequestTimes;
+    std::vector<glm::vec3> m_RequestPositions;
+    std::vector<glm::vec3> m_RequestVelocities;
+
+    // High fidelity objects, and the propagation store slot of each numerical propagator index.
+    NumericalPropagator m_NumericalPropagator;
+    std::vector<uint32_t> m_HighFidelityIds;
+    std::vector<uint32_t> m_HighFidelitySlots;
+    double m_NumericalSeedTime{ 0.0 };
+    bool m_NumericalPropagatorDirty{ true };
+
+    double m_LastTime{ 0.0 };
+    bool m_LevelOfDetailEnabled{ true };
+    float m_ScreenSpaceErrorTolerance{ 0.25f };
+    size_t m_PropagationBudget{ 0 };
+    size_t m_PropagationCount{ 0 };
 };
 
 } // namespace WingsOfSteel
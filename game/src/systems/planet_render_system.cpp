@@ -12,7 +12,9 @@
 
 #include "components/atmosphere_component.hpp"
 #include "components/planet_component.hpp"
+#include "render/upload_ring.hpp"
 #include "sector/planet_mesh_generator.hpp"
+#include "game.hpp"
 
 namespace WingsOfSteel
 {
@@ -118,17 +120,6 @@ void PlanetRenderSystem::Update(float delta)
             }
         });
     }
-
-    // Initialize atmosphere components
-    {
-        auto view = registry.view<AtmosphereComponent>();
-        view.each([this](const auto entity, AtmosphereComponent& atmosphereComponent) {
-            if (!atmosphereComponent.initialized && m_AtmosphereBindGroupLayout)
-            {
-                InitializeAtmosphereComponent(atmosphereComponent);
-            }
-        });
-    }
 }
 
 void PlanetRenderSystem::Render(wgpu::RenderPassEncoder& renderPass)
@@ -184,21 +175,20 @@ void PlanetRenderSystem::Render(wgpu::RenderPassEncoder& renderPass)
     {
         auto atmosphereView = registry.view<PlanetComponent, AtmosphereComponent>();
         atmosphereView.each([this, &renderPass](const auto entity, PlanetComponent& planetComponent, AtmosphereComponent& atmosphereComponent) {
-            if (!planetComponent.initialized || !atmosphereComponent.initialized)
+            if (!planetComponent.initialized || !planetComponent.vertexBuffer || !planetComponent.indexBuffer)
             {
                 return;
             }
 
-            if (!planetComponent.vertexBuffer || !planetComponent.indexBuffer || !atmosphereComponent.bindGroup)
+            // Uniforms are rewritten every frame, in case they changed
+            const std::optional<uint32_t> uniformOffset = UpdateAtmosphereUniforms(atmosphereComponent, planetComponent);
+            if (!uniformOffset.has_value())
             {
                 return;
             }
 
-            // Update atmosphere uniforms in case they changed
-            UpdateAtmosphereUniforms(atmosphereComponent, planetComponent);
-
             renderPass.SetPipeline(m_AtmospherePipeline);
-            renderPass.SetBindGroup(1, atmosphereComponent.bindGroup);
+            renderPass.SetBindGroup(1, m_AtmosphereBindGroup, 1, &uniformOffset.value());
             renderPass.SetVertexBuffer(0, planetComponent.vertexBuffer);
             renderPass.SetIndexBuffer(planetComponent.indexBuffer, wgpu::IndexFormat::Uint32);
             renderPass.DrawIndexed(planetComponent.indexCount);
@@ -462,7 +452,10 @@ void PlanetRenderSystem::CreateAtmosphereBindGroupLayout()
     wgpu::BindGroupLayoutEntry entry{
         .binding = 0,
         .visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
-        .buffer = { .type = wgpu::BufferBindingType::Uniform }
+        .buffer = {
+            .type = wgpu::BufferBindingType::Uniform,
+            .hasDynamicOffset = true,
+            .minBindingSize = sizeof(AtmosphereUniformData) }
     };
 
     wgpu::BindGroupLayoutDescriptor layoutDesc{
@@ -473,22 +466,17 @@ void PlanetRenderSystem::CreateAtmosphereBindGroupLayout()
     m_AtmosphereBindGroupLayout = device.CreateBindGroupLayout(&layoutDesc);
 }
 
-void PlanetRenderSystem::InitializeAtmosphereComponent(AtmosphereComponent& atmosphereComponent)
+void PlanetRenderSystem::UpdateAtmosphereBindGroup(const wgpu::Buffer& uniformBuffer)
 {
-    wgpu::Device device = GetRenderSystem()->GetDevice();
-
-    // Create uniform buffer
-    wgpu::BufferDescriptor bufferDesc{
-        .label = "Atmosphere uniform buffer",
-        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
-        .size = sizeof(AtmosphereUniformData)
-    };
-    atmosphereComponent.uniformBuffer = device.CreateBuffer(&bufferDesc);
+    // The uniforms live in the upload ring, so the bind group only changes when the ring's buffer does.
+    if (m_AtmosphereBindGroup && m_AtmosphereBindGroupBuffer.Get() == uniformBuffer.Get())
+    {
+        return;
+    }
 
-    // Create bind group
     wgpu::BindGroupEntry entry{
         .binding = 0,
-        .buffer = atmosphereComponent.uniformBuffer,
+        .buffer = uniformBuffer,
         .size = sizeof(AtmosphereUniformData)
     };
 
@@ -498,13 +486,11 @@ void PlanetRenderSystem::InitializeAtmosphereComponent(AtmosphereComponent& atmo
         .entryCount = 1,
         .entries = &entry
     };
-    atmosphereComponent.bindGroup = device.CreateBindGroup(&bindGroupDesc);
-
-    // Uniform data will be written in Render() where we have access to PlanetComponent
-    atmosphereComponent.initialized = true;
+    m_AtmosphereBindGroup = GetRenderSystem()->GetDevice().CreateBindGroup(&bindGroupDesc);
+    m_AtmosphereBindGroupBuffer = uniformBuffer;
 }
 
-void PlanetRenderSystem::UpdateAtmosphereUniforms(AtmosphereComponent& atmosphereComponent, PlanetComponent& planetComponent)
+std::optional<uint32_t> PlanetRenderSystem::UpdateAtmosphereUniforms(const AtmosphereComponent& atmosphereComponent, const PlanetComponent& planetComponent)
 {
     // Use the larger radius (equatorial) since mesh vertices extend to semiMajorRadius
     // The atmosphere shell must encompass all possible vertex positions
@@ -544,11 +530,14 @@ void PlanetRenderSystem::UpdateAtmosphereUniforms(AtmosphereComponent& atmospher
         ._padding1 = 0.0f
     };
 
-    GetRenderSystem()->GetDevice().GetQueue().WriteBuffer(
-        atmosphereComponent.uniformBuffer,
-        0,
-        &data,
-        sizeof(AtmosphereUniformData));
+    const std::optional<UploadRing::Allocation> allocation = Game::Get()->GetUploadRing()->Upload(&data, sizeof(AtmosphereUniformData), UploadRing::kUniformAlignment);
+    if (!allocation.has_value())
+    {
+        return std::nullopt;
+    }
+
+    UpdateAtmosphereBindGroup(allocation->buffer);
+    return static_cast<uint32_t>(allocation->offset);
 }
 
 } // namespace WingsOfSteel
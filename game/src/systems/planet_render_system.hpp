@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 
 #include <webgpu/webgpu_cpp.h>
@@ -35,8 +36,8 @@ private:
     void CreateTextureBindGroupLayout();
     void CreateAtmosphereBindGroupLayout();
     void CreateTextureBindGroup(PlanetComponent& planetComponent);
-    void InitializeAtmosphereComponent(AtmosphereComponent& atmosphereComponent);
-    void UpdateAtmosphereUniforms(AtmosphereComponent& atmosphereComponent, PlanetComponent& planetComponent);
+    void UpdateAtmosphereBindGroup(const wgpu::Buffer& uniformBuffer);
+    std::optional<uint32_t> UpdateAtmosphereUniforms(const AtmosphereComponent& atmosphereComponent, const PlanetComponent& planetComponent); // Returns the uniforms' dynamic offset
     void HandleShaderInjection();
 
     ResourceShaderSharedPtr m_pShader;
@@ -48,6 +49,8 @@ private:
     wgpu::RenderPipeline m_AtmospherePipeline;
     wgpu::BindGroupLayout m_TextureBindGroupLayout;
     wgpu::BindGroupLayout m_AtmosphereBindGroupLayout;
+    wgpu::BindGroup m_AtmosphereBindGroup; // Shared by every atmosphere, each at its own dynamic offset
+    wgpu::Buffer m_AtmosphereBindGroupBuffer; // The upload ring buffer m_AtmosphereBindGroup was created for
     wgpu::Sampler m_TextureSampler;
     bool m_Initialized{ false };
     bool m_WireframeInitialized{ false };
@@ -0,0 +1,182 @@
+#include <glm/glm.hpp>
+
+#include <pandora.hpp>
+#include <render/window.hpp>
+#include <scene/components/camera_component.hpp>
+#include <scene/components/transform_component.hpp>
+#include <scene/entity.hpp>
+#include <scene/scene.hpp>
+
+#include "systems/space_object_culling_system.hpp"
+#include "components/planet_component.hpp"
+#include "components/space_object_component.hpp"
+#include "game.hpp"
+#include "jobs/worker_pool.hpp"
+#include "propagation/simd_lanes.hpp"
+
+namespace WingsOfSteel
+{
+
+namespace
+{
+
+// Number of objects tested per job. A multiple of every SIMD width, so only the last job sees the padding.
+constexpr size_t kCullingGrainSize = 4096;
+
+// The frustum is widened by this much on every side (px), so sprites and labels whose centre is just off
+// the screen aren't culled while part of them is still on it.
+constexpr float kGuardBand = 16.0f;
+
+size_t PadToLanes(size_t count)
+{
+    return (count + F32Lanes::kWidth - 1) / F32Lanes::kWidth * F32Lanes::kWidth;
+}
+
+} // anonymous namespace
+
+SpaceObjectCullingSystem::SpaceObjectCullingSystem()
+{
+}
+
+SpaceObjectCullingSystem::~SpaceObjectCullingSystem()
+{
+}
+
+void SpaceObjectCullingSystem::Initialize(Scene* pScene)
+{
+}
+
+void SpaceObjectCullingSystem::Update(float delta)
+{
+    if (GetActiveScene() == nullptr)
+    {
+        return;
+    }
+
+    entt::registry& registry = GetActiveScene()->GetRegistry();
+    GatherPositions(registry);
+
+    const size_t count = m_Entities.size();
+    m_VisibleIndices.clear();
+    m_VisibleIndices.reserve(count);
+
+    m_ViewState = CalculateViewState(registry);
+    if (!m_Enabled || !m_ViewState.has_value())
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            m_VisibleIndices.push_back(static_cast<uint32_t>(index));
+        }
+        return;
+    }
+
+    Game::Get()->GetWorkerPool()->ParallelFor(m_X.size(), kCullingGrainSize, [this](size_t begin, size_t end)
+    {
+        CullPositions(m_ViewState.value(), m_X.data(), m_Y.data(), m_Z.data(), m_Visibility.data(), begin, end);
+    });
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        if (m_Visibility[index] != 0.0f)
+        {
+            m_VisibleIndices.push_back(static_cast<uint32_t>(index));
+        }
+    }
+}
+
+void SpaceObjectCullingSystem::GatherPositions(entt::registry& registry)
+{
+    auto view = registry.view<const SpaceObjectComponent, const TransformComponent>();
+
+    m_Entities.clear();
+    m_X.clear();
+    m_Y.clear();
+    m_Z.clear();
+    m_Entities.reserve(view.size_hint());
+    view.each([this](const auto entity, const SpaceObjectComponent&, const TransformComponent& transformComponent)
+    {
+        // Translation is in column 3.
+        m_Entities.push_back(entity);
+        m_X.push_back(transformComponent.transform[3].x);
+        m_Y.push_back(transformComponent.transform[3].y);
+        m_Z.push_back(transformComponent.transform[3].z);
+    });
+
+    // The padding is at the origin, which is never visible, and is ignored anyway.
+    const size_t paddedCount = PadToLanes(m_Entities.size());
+    m_X.resize(paddedCount, 0.0f);
+    m_Y.resize(paddedCount, 0.0f);
+    m_Z.resize(paddedCount, 0.0f);
+    m_Visibility.resize(paddedCount);
+}
+
+std::optional<SpaceObjectCullingSystem::ViewState> SpaceObjectCullingSystem::CalculateViewState(entt::registry& registry) const
+{
+    EntitySharedPtr pCamera = GetActiveScene()->GetCamera();
+    if (pCamera == nullptr || !pCamera->HasComponent<CameraComponent>())
+    {
+        return std::nullopt;
+    }
+
+    const uint32_t windowWidth = GetWindow()->GetWidth();
+    const uint32_t windowHeight = GetWindow()->GetHeight();
+    if (windowWidth == 0 || windowHeight == 0)
+    {
+        return std::nullopt;
+    }
+
+    // The planes are built from points unprojected onto the near plane, like the propagation level of detail,
+    // so they fit whatever projection the camera uses.
+    const Camera& camera = pCamera->GetComponent<CameraComponent>().camera;
+    const glm::vec3 cameraPosition = camera.GetPosition();
+    const glm::vec2 screenCentre(windowWidth * 0.5f, windowHeight * 0.5f);
+    const glm::vec3 nearCentre = camera.ScreenToWorld(screenCentre, windowWidth, windowHeight, 0.0f);
+    const float nearDistance = glm::length(nearCentre - cameraPosition);
+    if (nearDistance <= 0.0f)
+    {
+        return std::nullopt;
+    }
+    const glm::vec3 forward = (nearCentre - cameraPosition) / nearDistance;
+
+    ViewState viewState;
+
+    const float left = -kGuardBand;
+    const float top = -kGuardBand;
+    const float right = windowWidth + kGuardBand;
+    const float bottom = windowHeight + kGuardBand;
+    const std::array<glm::vec3, 4> corners = {
+        camera.ScreenToWorld(glm::vec2(left, top), windowWidth, windowHeight, 0.0f) - cameraPosition,
+        camera.ScreenToWorld(glm::vec2(right, top), windowWidth, windowHeight, 0.0f) - cameraPosition,
+        camera.ScreenToWorld(glm::vec2(right, bottom), windowWidth, windowHeight, 0.0f) - cameraPosition,
+        camera.ScreenToWorld(glm::vec2(left, bottom), windowWidth, windowHeight, 0.0f) - cameraPosition
+    };
+
+    for (size_t side = 0; side < corners.size(); ++side)
+    {
+        // Each side contains the camera and two adjacent corners. Which way the normal points depends on
+        // the handedness of the screen, so it's turned towards the view direction.
+        glm::vec3 normal = glm::normalize(glm::cross(corners[side], corners[(side + 1) % corners.size()]));
+        if (glm::dot(normal, forward) < 0.0f)
+        {
+            normal = -normal;
+        }
+        viewState.planes[side] = glm::vec4(normal, -glm::dot(normal, cameraPosition));
+    }
+    viewState.planes[4] = glm::vec4(forward, -glm::dot(forward, nearCentre));
+
+    // The Earth is at the origin, with its polar axis along Y.
+    auto planetView = registry.view<const PlanetComponent>();
+    for (const entt::entity entity : planetView)
+    {
+        const PlanetComponent& planetComponent = registry.get<const PlanetComponent>(entity);
+        viewState.inverseRadii = 1.0f / glm::vec3(planetComponent.semiMajorRadius, planetComponent.semiMinorRadius, planetComponent.semiMajorRadius);
+        viewState.scaledCameraPosition = cameraPosition * viewState.inverseRadii;
+        viewState.horizonDistance2 = glm::dot(viewState.scaledCameraPosition, viewState.scaledCameraPosition) - 1.0f;
+        viewState.occlusionEnabled = viewState.horizonDistance2 > 0.0f;
+        break;
+    }
+
+    return viewState;
+}
+
+} // namespace WingsOfSteel
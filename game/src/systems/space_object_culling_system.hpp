@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
+#include <scene/systems/system.hpp>
+
+#include "render/view_culling.hpp"
+
+namespace WingsOfSteel
+{
+
+// Works out which space objects can be seen, once per frame, after they have been propagated and the camera
+// has moved. Each object's position is tested against the sides and near plane of the view frustum and
+// against the cone of the Earth's shadow from the camera, several objects at a time (see CullPositions), and
+// the survivors are written to a compact list of indices which the sprite and label systems draw from.
+class SpaceObjectCullingSystem : public System
+{
+public:
+    SpaceObjectCullingSystem();
+    ~SpaceObjectCullingSystem();
+
+    void Initialize(Scene* pScene) override;
+    void Update(float delta) override;
+
+    // When disabled, every object is visible.
+    bool IsEnabled() const { return m_Enabled; }
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+
+    // Indices of the visible objects, in the order the registry returned them.
+    std::span<const uint32_t> GetVisibleIndices() const { return m_VisibleIndices; }
+    entt::entity GetEntity(uint32_t index) const { return m_Entities[index]; }
+    glm::vec3 GetPosition(uint32_t index) const { return glm::vec3(m_X[index], m_Y[index], m_Z[index]); }
+
+    size_t GetObjectCount() const { return m_Entities.size(); }
+    size_t GetVisibleCount() const { return m_VisibleIndices.size(); }
+
+    using ViewState = CullingViewState;
+
+    // The volume objects were culled against in the last update, whether or not culling is enabled, for
+    // anything else culling against the same view. Empty if there was no camera to cull for.
+    const std::optional<ViewState>& GetViewState() const { return m_ViewState; }
+
+private:
+    void GatherPositions(entt::registry& registry);
+    std::optional<ViewState> CalculateViewState(entt::registry& registry) const;
+
+    // Positions are kept as a structure of arrays, padded to a whole number of SIMD lanes.
+    std::vector<entt::entity> m_Entities;
+    std::vector<float> m_X;
+    std::vector<float> m_Y;
+    std::vector<float> m_Z;
+    std::vector<float> m_Visibility; // 1 for visible objects, 0 for culled ones
+    std::vector<uint32_t> m_VisibleIndices;
+    std::optional<ViewState> m_ViewState;
+
+    bool m_Enabled{ true };
+};
+
+} // namespace WingsOfSteel
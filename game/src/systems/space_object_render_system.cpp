@@ -1,40 +1,314 @@
-#include <core/color.hpp>
-#include <render/debug_render.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include <pandora.hpp>
+#include <render/rendersystem.hpp>
+#include <render/window.hpp>
+#include <resources/resource_system.hpp>
 #include <scene/components/transform_component.hpp>
 #include <scene/scene.hpp>
-#include <pandora.hpp>
 
 #include "systems/space_object_render_system.hpp"
 #include "components/space_object_component.hpp"
+#include "game.hpp"
+#include "render/upload_ring.hpp"
+#include "sector/sector.hpp"
+#include "space_objects/catalogue_index.hpp"
+#include "space_objects/space_object_catalogue.hpp"
+#include "systems/space_object_culling_system.hpp"
 
 namespace WingsOfSteel
 {
 
+namespace
+{
+
+// Must match SpriteUniforms in space_object_sprite.wgsl
+struct SpriteUniformData
+{
+    float referenceDistance; // km
+    float minimumSize; // px
+    float maximumSize; // px
+    float _padding0;
+};
+
+// Sprites are drawn at their nominal size from about the default camera distance, grow as the camera moves
+// in and shrink as it moves out, but never vanish nor swamp the view.
+constexpr float kReferenceDistance = 20000.0f;
+constexpr float kMinimumSize = 1.5f;
+constexpr float kMaximumSize = 24.0f;
+
+// By OrbitalRegime. LEO keeps the cyan the objects have always been drawn in.
+const std::array<glm::vec3, 5> kRegimeColors = {
+    glm::vec3(0.0f, 1.0f, 1.0f), // LEO
+    glm::vec3(1.0f, 0.85f, 0.2f), // MEO
+    glm::vec3(1.0f, 0.3f, 0.8f), // GEO
+    glm::vec3(1.0f, 0.5f, 0.1f), // HEO
+    glm::vec3(0.6f, 0.6f, 0.6f) // Other
+};
+
+uint32_t PackStyle(const glm::vec3& color, float size)
+{
+    const auto toByte = [](float value) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+    };
+    return toByte(color.r * 255.0f) | (toByte(color.g * 255.0f) << 8) | (toByte(color.b * 255.0f) << 16) | (toByte(size * 4.0f) << 24);
+}
+
+} // anonymous namespace
+
 SpaceObjectRenderSystem::SpaceObjectRenderSystem()
 {
+    CreateBindGroupLayout();
+    UpdateStyles();
+
+    GetResourceSystem()->RequestResource("/shaders/space_object_sprite.wgsl", [this](ResourceSharedPtr pResource) {
+        m_pShader = std::dynamic_pointer_cast<ResourceShader>(pResource);
+        CreateRenderPipeline();
+        HandleShaderInjection();
+    });
+
+    wgpu::BufferDescriptor uniformBufferDescriptor{
+        .label = "Space object sprite uniform buffer",
+        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
+        .size = sizeof(SpriteUniformData)
+    };
+    m_UniformBuffer = GetRenderSystem()->GetDevice().CreateBuffer(&uniformBufferDescriptor);
+
+    const SpriteUniformData data{
+        .referenceDistance = kReferenceDistance,
+        .minimumSize = kMinimumSize,
+        .maximumSize = kMaximumSize,
+        ._padding0 = 0.0f
+    };
+    GetRenderSystem()->GetDevice().GetQueue().WriteBuffer(m_UniformBuffer, 0, &data, sizeof(SpriteUniformData));
+    CreateBindGroup();
 }
 
 SpaceObjectRenderSystem::~SpaceObjectRenderSystem()
 {
+    if (GetResourceSystem() && m_ShaderInjectionSignalId.has_value())
+    {
+        GetResourceSystem()->GetShaderInjectedSignal().Disconnect(m_ShaderInjectionSignalId.value());
+    }
+
+    if (m_pRegistry)
+    {
+        m_pRegistry->on_construct<SpaceObjectComponent>().disconnect<&SpaceObjectRenderSystem::OnSpaceObjectChanged>(this);
+        m_pRegistry->on_update<SpaceObjectComponent>().disconnect<&SpaceObjectRenderSystem::OnSpaceObjectChanged>(this);
+    }
+}
+
+void SpaceObjectRenderSystem::Initialize(Scene* pScene)
+{
+    // New objects and new element sets may change an object's regime, so it is worked out again.
+    m_pRegistry = &pScene->GetRegistry();
+    m_pRegistry->on_construct<SpaceObjectComponent>().connect<&SpaceObjectRenderSystem::OnSpaceObjectChanged>(this);
+    m_pRegistry->on_update<SpaceObjectComponent>().connect<&SpaceObjectRenderSystem::OnSpaceObjectChanged>(this);
+}
+
+void SpaceObjectRenderSystem::OnSpaceObjectChanged(entt::registry& registry, entt::entity entity)
+{
+    const size_t entityIndex = entt::to_entity(entity);
+    if (entityIndex < m_EntityStyles.size())
+    {
+        m_EntityStyles[entityIndex] = kUnclassified;
+    }
 }
 
 void SpaceObjectRenderSystem::Update(float delta)
 {
+    m_Instances.clear();
+    SpaceObjectCullingSystem* pCullingSystem = GetActiveScene()->GetSystem<SpaceObjectCullingSystem>();
+    if (pCullingSystem == nullptr)
+    {
+        return;
+    }
+
     entt::registry& registry = GetActiveScene()->GetRegistry();
-    auto view = registry.view<const SpaceObjectComponent, const TransformComponent>();
+    const std::span<const uint32_t> visibleIndices = pCullingSystem->GetVisibleIndices();
+    m_Instances.reserve(visibleIndices.size());
+    for (const uint32_t index : visibleIndices)
+    {
+        const entt::entity entity = pCullingSystem->GetEntity(index);
+        const size_t entityIndex = entt::to_entity(entity);
+        if (entityIndex >= m_EntityStyles.size())
+        {
+            m_EntityStyles.resize(entityIndex + 1, kUnclassified);
+        }
 
-    DebugRender* pDebugRender = GetDebugRender();
+        uint8_t& style = m_EntityStyles[entityIndex];
+        if (style == kUnclassified)
+        {
+            style = Classify(registry.get<const SpaceObjectComponent>(entity).GetNoradCatalogueId());
+        }
+
+        m_Instances.push_back({ pCullingSystem->GetPosition(index), m_Styles[style] });
+    }
+}
 
-    view.each([pDebugRender](const auto entity, const SpaceObjectComponent& spaceObjectComponent, const TransformComponent& transformComponent)
+void SpaceObjectRenderSystem::Render(wgpu::RenderPassEncoder& renderPass)
+{
+    if (!m_RenderPipeline || m_Instances.empty())
     {
-        // Extract position from transform matrix (translation is in column 3)
-        glm::vec3 position = glm::vec3(transformComponent.transform[3]);
+        return;
+    }
 
-        // Draw a small cube at the space object's position
-        // Size of 100km to be visible at orbital scale
-        constexpr float kBoxSize = 100.0f;
-        pDebugRender->Box(position, Color::Cyan, kBoxSize, kBoxSize, kBoxSize);
-    });
+    const std::optional<UploadRing::Allocation> allocation = Game::Get()->GetUploadRing()->Upload(m_Instances.data(), m_Instances.size() * sizeof(InstanceData), UploadRing::kVertexAlignment);
+    if (!allocation.has_value())
+    {
+        return;
+    }
+
+    // Four vertices per instance, expanded into a quad by the vertex shader.
+    renderPass.SetPipeline(m_RenderPipeline);
+    renderPass.SetBindGroup(1, m_BindGroup);
+    renderPass.SetVertexBuffer(0, allocation->buffer, allocation->offset, allocation->size);
+    renderPass.Draw(4, static_cast<uint32_t>(m_Instances.size()));
+}
+
+void SpaceObjectRenderSystem::SetPointSize(float pixels)
+{
+    m_PointSize = pixels;
+    UpdateStyles();
+}
+
+void SpaceObjectRenderSystem::SetColorByRegimeEnabled(bool enabled)
+{
+    m_ColorByRegime = enabled;
+    UpdateStyles();
+}
+
+uint8_t SpaceObjectRenderSystem::Classify(uint32_t noradCatalogueId) const
+{
+    const std::optional<SpaceObjectView> spaceObject = Game::Get()->GetSector()->GetSpaceObjectCatalogue()->GetByNoradId(noradCatalogueId);
+    const OrbitalRegime regime = spaceObject.has_value() ? CatalogueIndex::GetRegime(spaceObject->GetMeanMotion(), spaceObject->GetEccentricity()) : OrbitalRegime::Other;
+    return static_cast<uint8_t>(regime);
+}
+
+void SpaceObjectRenderSystem::UpdateStyles()
+{
+    for (size_t style = 0; style < kStyleCount; ++style)
+    {
+        m_Styles[style] = PackStyle(m_ColorByRegime ? kRegimeColors[style] : kRegimeColors[0], m_PointSize);
+    }
+}
+
+void SpaceObjectRenderSystem::CreateBindGroupLayout()
+{
+    wgpu::BindGroupLayoutEntry entry{
+        .binding = 0,
+        .visibility = wgpu::ShaderStage::Vertex,
+        .buffer = { .type = wgpu::BufferBindingType::Uniform }
+    };
+
+    wgpu::BindGroupLayoutDescriptor layoutDescriptor{
+        .label = "Space object sprite bind group layout",
+        .entryCount = 1,
+        .entries = &entry
+    };
+    m_BindGroupLayout = GetRenderSystem()->GetDevice().CreateBindGroupLayout(&layoutDescriptor);
+}
+
+void SpaceObjectRenderSystem::CreateBindGroup()
+{
+    wgpu::BindGroupEntry entry{
+        .binding = 0,
+        .buffer = m_UniformBuffer,
+        .size = sizeof(SpriteUniformData)
+    };
+
+    wgpu::BindGroupDescriptor bindGroupDescriptor{
+        .label = "Space object sprite bind group",
+        .layout = m_BindGroupLayout,
+        .entryCount = 1,
+        .entries = &entry
+    };
+    m_BindGroup = GetRenderSystem()->GetDevice().CreateBindGroup(&bindGroupDescriptor);
+}
+
+void SpaceObjectRenderSystem::CreateRenderPipeline()
+{
+    if (!m_pShader)
+    {
+        return;
+    }
+
+    wgpu::ColorTargetState colorTargetState{
+        .format = GetWindow()->GetTextureFormat()
+    };
+
+    wgpu::FragmentState fragmentState{
+        .module = m_pShader->GetShaderModule(),
+        .targetCount = 1,
+        .targets = &colorTargetState
+    };
+
+    std::array<wgpu::BindGroupLayout, 2> bindGroupLayouts = {
+        GetRenderSystem()->GetGlobalUniformsLayout(),
+        m_BindGroupLayout
+    };
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDescriptor{
+        .bindGroupLayoutCount = static_cast<uint32_t>(bindGroupLayouts.size()),
+        .bindGroupLayouts = bindGroupLayouts.data()
+    };
+    wgpu::PipelineLayout pipelineLayout = GetRenderSystem()->GetDevice().CreatePipelineLayout(&pipelineLayoutDescriptor);
+
+    // One InstanceData per sprite. The style is read as four bytes and unpacked by the shader.
+    std::array<wgpu::VertexAttribute, 2> attributes;
+    attributes[0].format = wgpu::VertexFormat::Float32x3;
+    attributes[0].offset = offsetof(InstanceData, position);
+    attributes[0].shaderLocation = 0;
+    attributes[1].format = wgpu::VertexFormat::Uint8x4;
+    attributes[1].offset = offsetof(InstanceData, style);
+    attributes[1].shaderLocation = 1;
+
+    wgpu::VertexBufferLayout vertexBufferLayout;
+    vertexBufferLayout.arrayStride = sizeof(InstanceData);
+    vertexBufferLayout.stepMode = wgpu::VertexStepMode::Instance;
+    vertexBufferLayout.attributeCount = static_cast<uint32_t>(attributes.size());
+    vertexBufferLayout.attributes = attributes.data();
+
+    // Sprites are hidden behind the Earth and write depth like any opaque geometry; their corners are
+    // discarded in the fragment shader rather than blended, so they don't need sorting.
+    wgpu::DepthStencilState depthState{
+        .format = wgpu::TextureFormat::Depth32Float,
+        .depthWriteEnabled = true,
+        .depthCompare = wgpu::CompareFunction::Less
+    };
+
+    wgpu::RenderPipelineDescriptor descriptor{
+        .label = "Space object sprite render pipeline",
+        .layout = pipelineLayout,
+        .vertex = {
+            .module = m_pShader->GetShaderModule(),
+            .bufferCount = 1,
+            .buffers = &vertexBufferLayout },
+        .primitive = { .topology = wgpu::PrimitiveTopology::TriangleStrip },
+        .depthStencil = &depthState,
+        .multisample = { .count = RenderSystem::MsaaSampleCount },
+        .fragment = &fragmentState
+    };
+    m_RenderPipeline = GetRenderSystem()->GetDevice().CreateRenderPipeline(&descriptor);
+}
+
+void SpaceObjectRenderSystem::HandleShaderInjection()
+{
+    if (!m_ShaderInjectionSignalId.has_value())
+    {
+        m_ShaderInjectionSignalId = GetResourceSystem()->GetShaderInjectedSignal().Connect(
+            [this](ResourceShader* pResourceShader) {
+                if (m_pShader.get() == pResourceShader)
+                {
+                    CreateRenderPipeline();
+                }
+            });
+    }
 }
 
 } // namespace WingsOfSteel
@@ -1,18 +1,81 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+#include <webgpu/webgpu_cpp.h>
+
+#include <core/signal.hpp>
+#include <resources/resource_shader.hpp>
 #include <scene/systems/system.hpp>
 
 namespace WingsOfSteel
 {
 
+// Draws every visible space object as a point sprite, all of them in a single instanced draw call. Each frame
+// the positions left by SpaceObjectCullingSystem are packed into compact instances, 16 bytes per object: the
+// position, and a colour and size packed into one word, which are streamed through the upload ring. The
+// vertex shader expands each instance into a camera-facing quad which shrinks with distance, between a
+// minimum and maximum size in pixels.
+// Objects are coloured by orbital regime, which is worked out once per object and kept until its element
+// set changes.
 class SpaceObjectRenderSystem : public System
 {
 public:
     SpaceObjectRenderSystem();
     ~SpaceObjectRenderSystem();
 
-    void Initialize(Scene* pScene) override {}
+    void Initialize(Scene* pScene) override;
     void Update(float delta) override;
+    void Render(wgpu::RenderPassEncoder& renderPass);
+
+    // Size of the sprites at the reference distance, in pixels.
+    float GetPointSize() const { return m_PointSize; }
+    void SetPointSize(float pixels);
+
+    bool IsColorByRegimeEnabled() const { return m_ColorByRegime; }
+    void SetColorByRegimeEnabled(bool enabled);
+
+    size_t GetInstanceCount() const { return m_Instances.size(); }
+
+private:
+    // Must match InstanceInput in space_object_sprite.wgsl
+    struct InstanceData
+    {
+        glm::vec3 position; // km, ECI
+        uint32_t style; // Red, green, blue, and the size in quarter pixels
+    };
+
+    // One per OrbitalRegime.
+    static constexpr size_t kStyleCount = 5;
+    static constexpr uint8_t kUnclassified = 0xFF;
+
+    void OnSpaceObjectChanged(entt::registry& registry, entt::entity entity);
+    uint8_t Classify(uint32_t noradCatalogueId) const;
+    void UpdateStyles();
+    void CreateBindGroupLayout();
+    void CreateBindGroup();
+    void CreateRenderPipeline();
+    void HandleShaderInjection();
+
+    entt::registry* m_pRegistry{ nullptr }; // Whose signals the system is connected to
+    ResourceShaderSharedPtr m_pShader;
+    wgpu::BindGroupLayout m_BindGroupLayout;
+    wgpu::BindGroup m_BindGroup;
+    wgpu::RenderPipeline m_RenderPipeline;
+    wgpu::Buffer m_UniformBuffer;
+    std::optional<SignalId> m_ShaderInjectionSignalId;
+
+    std::vector<InstanceData> m_Instances; // Staging for the upload
+    std::vector<uint8_t> m_EntityStyles; // Index in m_Styles of each entity, by entity index, or kUnclassified
+    std::array<uint32_t, kStyleCount> m_Styles{};
+
+    float m_PointSize{ 4.0f };
+    bool m_ColorByRegime{ true };
 };
 
 } // namespace WingsOfSteel
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "space_objects/catalogue_index.hpp"
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/space_object.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+constexpr double kMu = 398600.4418; // km³/s²
+constexpr double kEarthRadius = 6378.137; // km
+constexpr double kPi = 3.14159265358979323846;
+
+struct Orbit
+{
+    float meanMotion; // rev/day
+    float eccentricity;
+};
+
+Orbit GetOrbit(double perigeeAltitude, double apogeeAltitude)
+{
+    const double semiMajorAxis = kEarthRadius + (perigeeAltitude + apogeeAltitude) * 0.5;
+    const double eccentricity = (apogeeAltitude - perigeeAltitude) / (2.0 * semiMajorAxis);
+    const double meanMotion = std::sqrt(kMu / (semiMajorAxis * semiMajorAxis * semiMajorAxis)) * 86400.0 / (2.0 * kPi);
+    return { static_cast<float>(meanMotion), static_cast<float>(eccentricity) };
+}
+
+// SpaceObjects can only be filled in by the readers, so each one is read from a row of OMM CSV.
+SpaceObject MakeSpaceObject(uint32_t noradId, const std::string& name, const std::string& objectId, double perigeeAltitude, double apogeeAltitude, double inclination = 51.6)
+{
+    const Orbit orbit = GetOrbit(perigeeAltitude, apogeeAltitude);
+    const std::string text = "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,NORAD_CAT_ID\n"
+        + name + "," + objectId + ",2024-01-01T00:00:00," + std::to_string(orbit.meanMotion) + "," + std::to_string(orbit.eccentricity) + ","
+        + std::to_string(inclination) + ",0,0,0," + std::to_string(noradId) + "\n";
+
+    SpaceObject spaceObject;
+    OmmCsvReader::Read(text, [&spaceObject](const SpaceObject& row) {
+        spaceObject = row;
+    });
+    return spaceObject;
+}
+
+std::vector<uint32_t> Sorted(std::vector<uint32_t> noradIds)
+{
+    std::sort(noradIds.begin(), noradIds.end());
+    return noradIds;
+}
+
+} // anonymous namespace
+
+TEST(CatalogueIndexClassifiesKnownOrbits)
+{
+    const auto getRegime = [](double perigeeAltitude, double apogeeAltitude) {
+        const Orbit orbit = GetOrbit(perigeeAltitude, apogeeAltitude);
+        return CatalogueIndex::GetRegime(orbit.meanMotion, orbit.eccentricity);
+    };
+
+    CHECK(getRegime(415.0, 420.0) == OrbitalRegime::LEO); // ISS
+    CHECK(getRegime(20100.0, 20300.0) == OrbitalRegime::MEO); // GPS
+    CHECK(getRegime(35780.0, 35790.0) == OrbitalRegime::GEO);
+    CHECK(getRegime(600.0, 39700.0) == OrbitalRegime::HEO); // Molniya
+    CHECK(getRegime(250.0, 35786.0) == OrbitalRegime::HEO); // GTO
+    CHECK(getRegime(500.0, 20000.0) == OrbitalRegime::HEO); // Transfer to MEO, once in none of the regimes
+    CHECK(getRegime(36500.0, 36600.0) == OrbitalRegime::Other); // Graveyard, once in none of the regimes
+    CHECK(getRegime(20000.0, 40000.0) == OrbitalRegime::Other);
+}
+
+TEST(CatalogueIndexRegimeQueriesContainTheirOrbits)
+{
+    // Every orbit on a grid of perigee and apogee altitudes falls within the ranges of its regime.
+    for (double perigeeAltitude = 150.0; perigeeAltitude < 60000.0; perigeeAltitude *= 1.17)
+    {
+        for (double apogeeAltitude = perigeeAltitude; apogeeAltitude < 60000.0; apogeeAltitude *= 1.13)
+        {
+            const Orbit orbit = GetOrbit(perigeeAltitude, apogeeAltitude);
+            const OrbitalRegime regime = CatalogueIndex::GetRegime(orbit.meanMotion, orbit.eccentricity);
+            const CatalogueIndex::RangeQuery query = CatalogueIndex::GetRegimeQuery(regime);
+            const auto contains = [](const std::optional<CatalogueIndex::Range>& range, double value) {
+                return !range.has_value() || (value >= range->minimum - 1.0 && value <= range->maximum + 1.0);
+            };
+            CHECK(contains(query.perigeeAltitude, perigeeAltitude));
+            CHECK(contains(query.apogeeAltitude, apogeeAltitude));
+        }
+    }
+}
+
+TEST(CatalogueIndexFindsEachObjectInOneRegime)
+{
+    CatalogueIndex index;
+    index.Insert(MakeSpaceObject(1, "LEO", "2000-001A", 415.0, 420.0));
+    index.Insert(MakeSpaceObject(2, "MEO", "2000-002A", 20100.0, 20300.0));
+    index.Insert(MakeSpaceObject(3, "GEO", "2000-003A", 35780.0, 35790.0));
+    index.Insert(MakeSpaceObject(4, "MOLNIYA", "2000-004A", 600.0, 39700.0));
+    index.Insert(MakeSpaceObject(5, "TRANSFER", "2000-005A", 500.0, 20000.0));
+    index.Insert(MakeSpaceObject(6, "GRAVEYARD", "2000-006A", 36500.0, 36600.0));
+
+    const auto find = [&index](OrbitalRegime regime) {
+        std::vector<uint32_t> noradIds;
+        index.FindByRegime(regime, noradIds);
+        return Sorted(noradIds);
+    };
+    CHECK(find(OrbitalRegime::LEO) == std::vector<uint32_t>({ 1 }));
+    CHECK(find(OrbitalRegime::MEO) == std::vector<uint32_t>({ 2 }));
+    CHECK(find(OrbitalRegime::GEO) == std::vector<uint32_t>({ 3 }));
+    CHECK(find(OrbitalRegime::HEO) == std::vector<uint32_t>({ 4, 5 }));
+    CHECK(find(OrbitalRegime::Other) == std::vector<uint32_t>({ 6 }));
+}
+
+TEST(CatalogueIndexFindsNamesByPrefix)
+{
+    CatalogueIndex index;
+    index.Insert(MakeSpaceObject(3, "STARLINK-1003", "2019-029C", 540.0, 550.0));
+    index.Insert(MakeSpaceObject(1, "STARLINK-1001", "2019-029A", 540.0, 550.0));
+    index.Insert(MakeSpaceObject(2, "STARLINK-1002", "2019-029B", 540.0, 550.0));
+    index.Insert(MakeSpaceObject(4, "ISS (ZARYA)", "1998-067A", 415.0, 420.0));
+
+    // Case-insensitive, in name order, and cut off at the maximum count.
+    std::vector<uint32_t> noradIds;
+    index.FindByNamePrefix("starlink", 2, noradIds);
+    CHECK(noradIds == std::vector<uint32_t>({ 1, 2 }));
+
+    noradIds.clear();
+    index.FindByNamePrefix("ISS", 10, noradIds);
+    CHECK(noradIds == std::vector<uint32_t>({ 4 }));
+
+    noradIds.clear();
+    index.FindByNamePrefix("ONEWEB", 10, noradIds);
+    CHECK(noradIds.empty());
+}
+
+TEST(CatalogueIndexReplacesAndErasesObjects)
+{
+    CatalogueIndex index;
+    index.Insert(MakeSpaceObject(25544, "ISS (ZARYA)", "1998-067A", 415.0, 420.0));
+    CHECK(index.FindByObjectId("1998-067A") == 25544u);
+
+    // A new element set under a new name replaces every entry of the old one.
+    index.Insert(MakeSpaceObject(25544, "ISS", "1998-067A", 20100.0, 20300.0));
+    CHECK(index.GetCount() == 1);
+
+    std::vector<uint32_t> noradIds;
+    index.FindByNamePrefix("ISS (", 10, noradIds);
+    CHECK(noradIds.empty());
+    index.FindByRegime(OrbitalRegime::LEO, noradIds);
+    CHECK(noradIds.empty());
+    index.FindByRegime(OrbitalRegime::MEO, noradIds);
+    CHECK(noradIds == std::vector<uint32_t>({ 25544 }));
+
+    index.Erase(25544);
+    CHECK(index.GetCount() == 0);
+    CHECK(!index.FindByObjectId("1998-067A").has_value());
+}
+
+TEST(CatalogueIndexFindsObjectsInEveryRange)
+{
+    CatalogueIndex index;
+    index.Insert(MakeSpaceObject(1, "SUN-SYNCHRONOUS", "2000-001A", 700.0, 710.0, 98.2));
+    index.Insert(MakeSpaceObject(2, "LOW SUN-SYNCHRONOUS", "2000-002A", 300.0, 310.0, 97.0));
+    index.Insert(MakeSpaceObject(3, "ISS", "2000-003A", 415.0, 420.0, 51.6));
+    index.Insert(MakeSpaceObject(4, "POLAR MEO", "2000-004A", 8000.0, 8100.0, 98.0));
+
+    CatalogueIndex::RangeQuery query;
+    query.inclination = CatalogueIndex::Range{ 96.0f, 100.0f };
+    std::vector<uint32_t> noradIds;
+    index.FindInRanges(query, noradIds);
+    CHECK(Sorted(noradIds) == std::vector<uint32_t>({ 1, 2, 4 }));
+
+    query.perigeeAltitude = CatalogueIndex::Range{ 500.0f, 1000.0f };
+    noradIds.clear();
+    index.FindInRanges(query, noradIds);
+    CHECK(noradIds == std::vector<uint32_t>({ 1 }));
+
+    // A query without any ranges matches nothing, rather than everything.
+    noradIds.clear();
+    index.FindInRanges(CatalogueIndex::RangeQuery(), noradIds);
+    CHECK(noradIds.empty());
+}
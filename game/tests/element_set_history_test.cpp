@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cmath>
+#include <span>
+#include <string>
+
+#include "space_objects/element_set_history.hpp"
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/space_object.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+// SpaceObjects can only be filled in by the readers, so each one is read from a row of OMM CSV. An empty
+// bstar leaves B* absent.
+SpaceObject MakeElementSet(const std::string& epoch, const std::string& meanAnomaly, const std::string& bstar)
+{
+    const std::string text = "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,NORAD_CAT_ID,BSTAR\n"
+        "ISS (ZARYA),1998-067A," + epoch + ",15.5,.0005,51.6,247.4,130.5," + meanAnomaly + ",25544," + bstar + "\n";
+
+    SpaceObject spaceObject;
+    OmmCsvReader::Read(text, [&spaceObject](const SpaceObject& row) {
+        spaceObject = row;
+    });
+    return spaceObject;
+}
+
+double GetSeconds(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+TEST(ElementSetHistoryKeepsAbsentBstarAbsent)
+{
+    ElementSetHistory history;
+    history.Append(MakeElementSet("2024-01-01T00:00:00", "10", ""));
+    history.Append(MakeElementSet("2024-01-02T00:00:00", "20", ".00012"));
+
+    const std::span<const uint32_t> rows = history.GetElementSets(25544);
+    CHECK(rows.size() == 2);
+    if (rows.size() != 2)
+    {
+        return;
+    }
+
+    // Applying a row with B* over an element set without it, and back again.
+    SpaceObject spaceObject = MakeElementSet("2024-01-03T00:00:00", "30", "");
+    history.Apply(rows[1], spaceObject);
+    CHECK_NEAR(spaceObject.GetBstar().value_or(0.0f), 0.00012, 1.0e-9);
+    history.Apply(rows[0], spaceObject);
+    CHECK(!spaceObject.GetBstar().has_value());
+    CHECK_NEAR(spaceObject.GetMeanAnomaly(), 10.0, 1.0e-6);
+}
+
+TEST(ElementSetHistoryFindsTheClosestEpoch)
+{
+    // 2024-01-01, 2024-01-03 and 2024-01-05 at midnight, appended out of order.
+    constexpr double kDay = 86400.0;
+    constexpr double kFirstEpoch = 1704067200.0;
+    ElementSetHistory history;
+    history.Append(MakeElementSet("2024-01-03T00:00:00", "20", ""));
+    history.Append(MakeElementSet("2024-01-01T00:00:00", "10", ""));
+    history.Append(MakeElementSet("2024-01-05T00:00:00", "30", ""));
+
+    // Appending the same epoch again replaces that element set rather than adding one.
+    history.Append(MakeElementSet("2024-01-05T00:00:00", "35", ""));
+    CHECK(history.GetElementSetCount(25544) == 3);
+
+    ElementSetHistory::Validity validity;
+    SpaceObject spaceObject;
+    const uint32_t row = history.FindClosest(25544, kFirstEpoch + 2.5 * kDay, validity);
+    CHECK(row != ElementSetHistory::kNoElementSet);
+    history.Apply(row, spaceObject);
+    CHECK_NEAR(GetSeconds(spaceObject.GetEpoch()), kFirstEpoch + 2.0 * kDay, 1.0e-6);
+    CHECK_NEAR(validity.from, kFirstEpoch + kDay, 1.0e-6);
+    CHECK_NEAR(validity.until, kFirstEpoch + 3.0 * kDay, 1.0e-6);
+
+    history.Apply(history.FindClosest(25544, kFirstEpoch + 10.0 * kDay, validity), spaceObject);
+    CHECK_NEAR(spaceObject.GetMeanAnomaly(), 35.0, 1.0e-6);
+    CHECK(std::isinf(validity.until));
+
+    CHECK(history.FindClosest(1, kFirstEpoch, validity) == ElementSetHistory::kNoElementSet);
+}
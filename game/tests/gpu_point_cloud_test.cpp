@@ -0,0 +1,392 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "jobs/worker_pool.hpp"
+#include "propagation/propagation_store.hpp"
+#include "propagation/simd_lanes.hpp"
+#include "propagation/sgp4.hpp"
+#include "render/gpu_point_cloud.hpp"
+#include "render/view_culling.hpp"
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/space_object.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+constexpr double kMu = 398600.4418; // km³/s²
+constexpr double kPi = 3.14159265358979323846;
+
+// The shader propagates in single precision, with sin and cos which WGSL only requires to be accurate to 2^-11
+// absolute, so positions are checked against the double precision two-body model to within this fraction of
+// the semi-major axis: 130 m in low Earth orbit, 3 km for the most eccentric orbits below. Emulating the
+// shader in single precision gives errors of at most 3.7e-6 of the semi-major axis.
+constexpr double kPositionTolerance = 2.0e-5;
+
+// The tests run on whichever adapter the system has, preferring a software one (SwiftShader or lavapipe), so
+// they give the same results on a build machine without a GPU.
+struct TestDevice
+{
+    wgpu::Instance instance;
+    wgpu::Device device;
+};
+
+TestDevice CreateTestDevice()
+{
+    TestDevice testDevice;
+    testDevice.instance = wgpu::CreateInstance();
+
+    wgpu::Adapter adapter;
+    for (bool forceFallbackAdapter : { true, false })
+    {
+        const wgpu::RequestAdapterOptions options{ .forceFallbackAdapter = forceFallbackAdapter };
+        bool done = false;
+        testDevice.instance.RequestAdapter(&options, wgpu::CallbackMode::AllowProcessEvents,
+            [&adapter, &done](wgpu::RequestAdapterStatus status, wgpu::Adapter result, wgpu::StringView) {
+                if (status == wgpu::RequestAdapterStatus::Success)
+                {
+                    adapter = std::move(result);
+                }
+                done = true;
+            });
+        while (!done)
+        {
+            testDevice.instance.ProcessEvents();
+        }
+
+        if (adapter)
+        {
+            break;
+        }
+    }
+
+    if (!adapter)
+    {
+        return testDevice;
+    }
+
+    wgpu::DeviceDescriptor deviceDescriptor;
+    deviceDescriptor.SetUncapturedErrorCallback([](const wgpu::Device&, wgpu::ErrorType, wgpu::StringView message) {
+        Test::Fail(__FILE__, __LINE__, "WebGPU error: " + std::string(message.data, message.length));
+    });
+
+    bool done = false;
+    adapter.RequestDevice(&deviceDescriptor, wgpu::CallbackMode::AllowProcessEvents,
+        [&testDevice, &done](wgpu::RequestDeviceStatus status, wgpu::Device result, wgpu::StringView) {
+            if (status == wgpu::RequestDeviceStatus::Success)
+            {
+                testDevice.device = std::move(result);
+            }
+            done = true;
+        });
+    while (!done)
+    {
+        testDevice.instance.ProcessEvents();
+    }
+    return testDevice;
+}
+
+wgpu::ShaderModule LoadShader(const wgpu::Device& device, const std::string& fileName)
+{
+    std::ifstream file(std::string(GAME_SHADER_DIRECTORY) + "/" + fileName);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string code = stream.str();
+    if (code.empty())
+    {
+        Test::Fail(__FILE__, __LINE__, "Failed to read shader " + fileName);
+        return nullptr;
+    }
+
+    wgpu::ShaderSourceWGSL source;
+    source.code = wgpu::StringView(code.data(), code.size());
+    const wgpu::ShaderModuleDescriptor descriptor{
+        .nextInChain = &source,
+        .label = wgpu::StringView(fileName.data(), fileName.size())
+    };
+    return device.CreateShaderModule(&descriptor);
+}
+
+// Copies the buffer to one which can be mapped, waits for the copy and returns its contents.
+template <typename T>
+std::vector<T> ReadBuffer(const TestDevice& testDevice, const wgpu::Buffer& buffer, size_t count)
+{
+    const uint64_t size = count * sizeof(T);
+    const wgpu::BufferDescriptor readbackBufferDescriptor{
+        .label = "Test readback buffer",
+        .usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+        .size = size
+    };
+    wgpu::Buffer readbackBuffer = testDevice.device.CreateBuffer(&readbackBufferDescriptor);
+
+    wgpu::CommandEncoder encoder = testDevice.device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(buffer, 0, readbackBuffer, 0, size);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    testDevice.device.GetQueue().Submit(1, &commands);
+
+    bool mapped = false;
+    bool done = false;
+    readbackBuffer.MapAsync(wgpu::MapMode::Read, 0, size, wgpu::CallbackMode::AllowProcessEvents,
+        [&mapped, &done](wgpu::MapAsyncStatus status, wgpu::StringView) {
+            mapped = status == wgpu::MapAsyncStatus::Success;
+            done = true;
+        });
+    while (!done)
+    {
+        testDevice.instance.ProcessEvents();
+    }
+
+    std::vector<T> values(count);
+    if (!mapped)
+    {
+        Test::Fail(__FILE__, __LINE__, "Failed to map the readback buffer");
+        return values;
+    }
+
+    std::memcpy(values.data(), readbackBuffer.GetConstMappedRange(0, size), size);
+    readbackBuffer.Unmap();
+    readbackBuffer.Destroy();
+    return values;
+}
+
+// Propagates, and then culls against the view if there is one, in a single pass as GpuPropagationSystem does.
+void Propagate(const TestDevice& testDevice, const GpuPointCloud& pointCloud, const CullingViewState* pViewState = nullptr)
+{
+    wgpu::CommandEncoder encoder = testDevice.device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder computePass = encoder.BeginComputePass();
+    CHECK(pointCloud.EncodePropagation(computePass));
+    if (pViewState)
+    {
+        CHECK(pointCloud.EncodeCulling(computePass, *pViewState));
+    }
+    computePass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    testDevice.device.GetQueue().Submit(1, &commands);
+}
+
+// A fixed population covering circular to highly eccentric orbits (e up to 0.95) at two perigee radii, with
+// the angles spread so every part of each orbit is sampled. SpaceObjects can only be filled in by the readers,
+// so it is written out as OMM CSV.
+std::vector<SpaceObject> MakePopulation()
+{
+    std::string text = "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,NORAD_CAT_ID\n";
+    uint32_t noradId = 1;
+    for (double eccentricity : { 0.0, 0.1, 0.3, 0.5, 0.7, 0.8, 0.85, 0.9, 0.95 })
+    {
+        for (double perigeeRadius : { 6678.0, 7500.0 })
+        {
+            const double semiMajorAxis = perigeeRadius / (1.0 - eccentricity);
+            const double meanMotion = std::sqrt(kMu / (semiMajorAxis * semiMajorAxis * semiMajorAxis)) * 86400.0 / (2.0 * kPi);
+            for (int step = 0; step < 60; ++step)
+            {
+                char row[256];
+                std::snprintf(row, sizeof(row), "TEST,2024-001A,2024-01-01T00:00:00,%.12f,%.7f,%.4f,%.4f,%.4f,%.4f,%u\n",
+                    meanMotion, eccentricity, std::fmod(step * 37.0, 180.0), std::fmod(step * 53.0, 360.0),
+                    std::fmod(step * 71.0, 360.0), step * 6.0, noradId++);
+                text += row;
+            }
+        }
+    }
+
+    std::vector<SpaceObject> spaceObjects;
+    OmmCsvReader::Read(text, [&spaceObjects](const SpaceObject& spaceObject) {
+        spaceObjects.push_back(spaceObject);
+    });
+    return spaceObjects;
+}
+
+// A camera about four Earth radii out, looking at the Earth's centre with a 60° field of view, so the
+// population is split between objects outside the frustum, objects behind the Earth and visible ones.
+CullingViewState MakeViewState(bool occlusionEnabled)
+{
+    const glm::vec3 cameraPosition(8000.0f, 6000.0f, 22000.0f);
+    const glm::vec3 forward = glm::normalize(-cameraPosition);
+    const glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+    const glm::vec3 up = glm::cross(right, forward);
+    const float cosHalfAngle = std::cos(glm::radians(30.0f));
+    const float sinHalfAngle = std::sin(glm::radians(30.0f));
+
+    CullingViewState viewState;
+    const std::array<glm::vec3, 4> sideNormals = {
+        right * cosHalfAngle + forward * sinHalfAngle,
+        -right * cosHalfAngle + forward * sinHalfAngle,
+        up * cosHalfAngle + forward * sinHalfAngle,
+        -up * cosHalfAngle + forward * sinHalfAngle
+    };
+    for (size_t side = 0; side < sideNormals.size(); ++side)
+    {
+        viewState.planes[side] = glm::vec4(sideNormals[side], -glm::dot(sideNormals[side], cameraPosition));
+    }
+    viewState.planes[4] = glm::vec4(forward, -glm::dot(forward, cameraPosition) - 1.0f);
+
+    viewState.inverseRadii = 1.0f / glm::vec3(6378.137f, 6356.752f, 6378.137f);
+    viewState.scaledCameraPosition = cameraPosition * viewState.inverseRadii;
+    viewState.horizonDistance2 = glm::dot(viewState.scaledCameraPosition, viewState.scaledCameraPosition) - 1.0f;
+    viewState.occlusionEnabled = occlusionEnabled;
+    return viewState;
+}
+
+// Whether the position is close enough to one of the view's boundaries that single precision rounding, which
+// may differ between the shader and the CPU (fused multiply-adds, the order of the sums), could put it on
+// either side.
+bool IsNearBoundary(const CullingViewState& viewState, const glm::vec3& position)
+{
+    constexpr double kMargin = 1.0e-5;
+    const glm::dvec3 p(position);
+    for (const glm::vec4& plane : viewState.planes)
+    {
+        const double distance = glm::dot(glm::dvec3(glm::vec3(plane)), p) + plane.w;
+        if (std::abs(distance) <= kMargin * (glm::length(p) + std::abs(plane.w)))
+        {
+            return true;
+        }
+    }
+
+    if (!viewState.occlusionEnabled)
+    {
+        return false;
+    }
+
+    const glm::dvec3 c(viewState.scaledCameraPosition);
+    const glm::dvec3 toObject = p * glm::dvec3(viewState.inverseRadii) - c;
+    const double alongCentre = -glm::dot(toObject, c);
+    const double toObjectLength2 = glm::dot(toObject, toObject);
+    const double horizonDistance2 = viewState.horizonDistance2;
+    return std::abs(alongCentre - horizonDistance2) <= kMargin * (std::abs(alongCentre) + horizonDistance2)
+        || std::abs(alongCentre * alongCentre - toObjectLength2 * horizonDistance2) <= kMargin * (alongCentre * alongCentre + toObjectLength2 * horizonDistance2);
+}
+
+} // anonymous namespace
+
+// Propagates on the GPU at the reference time and almost kMaximumTimeOffset either side of it, the furthest
+// the shader is asked to propagate before the reference time is moved, and checks every position against
+// PropagationStore's two-body model.
+TEST(GpuPointCloudMatchesTwoBodyPropagation)
+{
+    const TestDevice testDevice = CreateTestDevice();
+    if (!testDevice.device)
+    {
+        Test::Fail(__FILE__, __LINE__, "No WebGPU adapter to run the test on");
+        return;
+    }
+
+    const std::vector<SpaceObject> spaceObjects = MakePopulation();
+    CHECK(spaceObjects.size() == 9 * 2 * 60);
+
+    PropagationStore store;
+    store.SetModel(PropagationStore::Model::TwoBody);
+    std::vector<Sgp4Elements> elements;
+    std::vector<double> semiMajorAxes;
+    for (const SpaceObject& spaceObject : spaceObjects)
+    {
+        store.Add(spaceObject);
+        elements.push_back(Sgp4Elements::FromSpaceObject(spaceObject));
+        const double meanMotion = elements.back().meanMotion * 2.0 * kPi / 86400.0;
+        semiMajorAxes.push_back(std::cbrt(kMu / (meanMotion * meanMotion)));
+    }
+
+    WorkerPool workerPool(1);
+    GpuPointCloud pointCloud(testDevice.device);
+    pointCloud.SetPropagationShader(LoadShader(testDevice.device, "gpu_propagation.wgsl"));
+
+    const double referenceTime = elements.front().epoch + 2.5 * 86400.0;
+    pointCloud.SetObjects(elements, referenceTime, workerPool);
+    CHECK(pointCloud.GetObjectCount() == spaceObjects.size());
+
+    for (double timeOffset : { 0.0, 0.999 * GpuPointCloud::kMaximumTimeOffset, -0.999 * GpuPointCloud::kMaximumTimeOffset })
+    {
+        const double time = referenceTime + timeOffset;
+        pointCloud.SetTime(time, workerPool);
+        Propagate(testDevice, pointCloud);
+        const std::vector<glm::vec4> positions = ReadBuffer<glm::vec4>(testDevice, pointCloud.GetPositionBuffer(), spaceObjects.size());
+
+        std::vector<glm::vec3> expectedPositions(spaceObjects.size());
+        store.Propagate(time, 0, spaceObjects.size(), expectedPositions.data());
+
+        double worstError = 0.0;
+        for (size_t index = 0; index < spaceObjects.size(); ++index)
+        {
+            const double error = glm::distance(glm::dvec3(glm::vec3(positions[index])), glm::dvec3(expectedPositions[index]));
+            worstError = std::max(worstError, error / semiMajorAxes[index]);
+        }
+        CHECK(worstError <= kPositionTolerance);
+    }
+}
+
+// Culls the propagated population on the GPU, with and without the Earth occluding it, and checks the vertex
+// count the culling pass leaves for DrawIndirect() against CullPositions, which SpaceObjectCullingSystem culls
+// with, run on the same positions and view. Only positions within rounding of a boundary may differ.
+TEST(GpuPointCloudCullingMatchesCullPositions)
+{
+    const TestDevice testDevice = CreateTestDevice();
+    if (!testDevice.device)
+    {
+        Test::Fail(__FILE__, __LINE__, "No WebGPU adapter to run the test on");
+        return;
+    }
+
+    std::vector<Sgp4Elements> elements;
+    for (const SpaceObject& spaceObject : MakePopulation())
+    {
+        elements.push_back(Sgp4Elements::FromSpaceObject(spaceObject));
+    }
+    const size_t count = elements.size();
+
+    WorkerPool workerPool(1);
+    GpuPointCloud pointCloud(testDevice.device);
+    pointCloud.SetPropagationShader(LoadShader(testDevice.device, "gpu_propagation.wgsl"));
+    pointCloud.SetCullingShader(LoadShader(testDevice.device, "gpu_point_cloud_cull.wgsl"));
+    pointCloud.SetObjects(elements, elements.front().epoch + 2.5 * 86400.0, workerPool);
+
+    std::array<size_t, 2> visibleCounts{};
+    for (bool occlusionEnabled : { false, true })
+    {
+        const CullingViewState viewState = MakeViewState(occlusionEnabled);
+        Propagate(testDevice, pointCloud, &viewState);
+        const std::vector<glm::vec4> positions = ReadBuffer<glm::vec4>(testDevice, pointCloud.GetPositionBuffer(), count);
+        const std::vector<uint32_t> drawArguments = ReadBuffer<uint32_t>(testDevice, pointCloud.GetDrawArgumentsBuffer(), 4);
+
+        const size_t paddedCount = (count + F32Lanes::kWidth - 1) / F32Lanes::kWidth * F32Lanes::kWidth;
+        std::vector<float> x(paddedCount, 0.0f);
+        std::vector<float> y(paddedCount, 0.0f);
+        std::vector<float> z(paddedCount, 0.0f);
+        std::vector<float> visibility(paddedCount);
+        for (size_t index = 0; index < count; ++index)
+        {
+            x[index] = positions[index].x;
+            y[index] = positions[index].y;
+            z[index] = positions[index].z;
+        }
+        CullPositions(viewState, x.data(), y.data(), z.data(), visibility.data(), 0, paddedCount);
+
+        size_t visibleCount = 0;
+        size_t nearBoundaryCount = 0;
+        for (size_t index = 0; index < count; ++index)
+        {
+            visibleCount += visibility[index] != 0.0f ? 1 : 0;
+            nearBoundaryCount += IsNearBoundary(viewState, glm::vec3(positions[index])) ? 1 : 0;
+        }
+
+        const size_t gpuVisibleCount = drawArguments[0];
+        CHECK(std::max(gpuVisibleCount, visibleCount) - std::min(gpuVisibleCount, visibleCount) <= nearBoundaryCount);
+        CHECK(drawArguments[1] == 1);
+
+        // The view has to cull some of the population, and leave some of it, for the comparison to mean anything.
+        CHECK(visibleCount > 0 && visibleCount < count);
+        visibleCounts[occlusionEnabled ? 1 : 0] = visibleCount;
+    }
+    CHECK(visibleCounts[1] < visibleCounts[0]);
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "propagation/kepler_solver.hpp"
+#include "propagation/kepler_solver_kernel.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+// The bounds documented in kepler_solver.hpp.
+constexpr double kDoubleTolerance = 2.0e-15;
+constexpr double kSingleTolerance = 1.0e-6;
+
+constexpr double kTwoPi = 6.28318530717958647692;
+
+// Mean anomalies across [-π, π], and the same values a few turns either side, so the reduction is covered too.
+std::vector<double> GetMeanAnomalies()
+{
+    constexpr int kSteps = 1000;
+    std::vector<double> meanAnomalies;
+    for (int turn = -3; turn <= 3; ++turn)
+    {
+        for (int step = 0; step <= kSteps; ++step)
+        {
+            meanAnomalies.push_back((step * 2.0 / kSteps - 1.0) * kTwoPi * 0.5 + turn * kTwoPi);
+        }
+    }
+    return meanAnomalies;
+}
+
+// E = π and E = -π are the same solution, so differences are taken around the circle.
+double GetAngleDifference(double a, double b)
+{
+    return std::abs(std::remainder(a - b, kTwoPi));
+}
+
+} // anonymous namespace
+
+TEST(KeplerSolverKernelsMatchScalarSolverInDouble)
+{
+    const std::vector<double> meanAnomalies = GetMeanAnomalies();
+    const size_t count = meanAnomalies.size();
+    for (const KeplerSolverKernels& kernels : GetSupportedKeplerSolverKernels())
+    {
+        double worstError = 0.0;
+        for (int step = 0; step <= 99; ++step)
+        {
+            const std::vector<double> eccentricities(count, step * 0.01);
+            std::vector<double> eccentricAnomalies(count);
+            std::vector<double> sinE(count);
+            std::vector<double> cosE(count);
+            kernels.pSolveDouble(meanAnomalies.data(), eccentricities.data(), eccentricAnomalies.data(), count);
+            kernels.pSolveSinCosDouble(meanAnomalies.data(), eccentricities.data(), sinE.data(), cosE.data(), count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double expected = SolveKeplerScalar(meanAnomalies[i], eccentricities[i]);
+                worstError = std::max(worstError, GetAngleDifference(eccentricAnomalies[i], expected));
+                worstError = std::max(worstError, GetAngleDifference(std::atan2(sinE[i], cosE[i]), expected));
+            }
+        }
+        CHECK(worstError <= kDoubleTolerance);
+    }
+}
+
+TEST(KeplerSolverKernelsMatchScalarSolverInSingle)
+{
+    const std::vector<double> meanAnomalies = GetMeanAnomalies();
+    const size_t count = meanAnomalies.size();
+    std::vector<float> meanAnomaliesSingle(count);
+    std::transform(meanAnomalies.begin(), meanAnomalies.end(), meanAnomaliesSingle.begin(), [](double value) { return static_cast<float>(value); });
+
+    for (const KeplerSolverKernels& kernels : GetSupportedKeplerSolverKernels())
+    {
+        double worstError = 0.0;
+        for (int step = 0; step <= 95; ++step)
+        {
+            const std::vector<float> eccentricities(count, step * 0.01f);
+            std::vector<float> eccentricAnomalies(count);
+            std::vector<float> sinE(count);
+            std::vector<float> cosE(count);
+            kernels.pSolveFloat(meanAnomaliesSingle.data(), eccentricities.data(), eccentricAnomalies.data(), count);
+            kernels.pSolveSinCosFloat(meanAnomaliesSingle.data(), eccentricities.data(), sinE.data(), cosE.data(), count);
+
+            // The reference solves for exactly the single precision inputs.
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double expected = SolveKeplerScalar(meanAnomaliesSingle[i], eccentricities[i]);
+                worstError = std::max(worstError, GetAngleDifference(eccentricAnomalies[i], expected));
+                worstError = std::max(worstError, GetAngleDifference(std::atan2(sinE[i], cosE[i]), expected));
+            }
+        }
+        CHECK(worstError <= kSingleTolerance);
+    }
+}
+
+// Orbits past the vectorized range are handed to the scalar solver, whichever kernels are dispatched to.
+TEST(KeplerSolverHandsNearParabolicOrbitsToScalarSolver)
+{
+    const std::vector<double> meanAnomalies = GetMeanAnomalies();
+    const size_t count = meanAnomalies.size();
+    const std::vector<double> eccentricities(count, 0.999);
+    std::vector<double> eccentricAnomalies(count);
+    KeplerSolver::Solve(meanAnomalies.data(), eccentricities.data(), eccentricAnomalies.data(), count);
+
+    double worstError = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        worstError = std::max(worstError, GetAngleDifference(eccentricAnomalies[i], SolveKeplerScalar(meanAnomalies[i], eccentricities[i])));
+    }
+    CHECK(worstError == 0.0);
+}
@@ -0,0 +1,18 @@
+#include <iostream>
+
+#include "test.hpp"
+
+int main()
+{
+    using namespace WingsOfSteel::Test;
+
+    for (const Case& testCase : GetCases())
+    {
+        const size_t failuresBefore = GetFailureCount();
+        testCase.function();
+        std::cout << (GetFailureCount() == failuresBefore ? "[ OK ] " : "[FAIL] ") << testCase.name << std::endl;
+    }
+
+    std::cout << GetCases().size() << " tests, " << GetFailureCount() << " failed checks" << std::endl;
+    return GetFailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/space_object.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+std::vector<SpaceObject> Read(std::string_view text, OmmCsvReader::Result& result)
+{
+    std::vector<SpaceObject> spaceObjects;
+    result = OmmCsvReader::Read(text, [&spaceObjects](const SpaceObject& spaceObject) {
+        spaceObjects.push_back(spaceObject);
+    });
+    return spaceObjects;
+}
+
+double GetSeconds(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+// A row as Celestrak publishes it, with the byte order mark it puts at the start of the file.
+TEST(OmmCsvReaderReadsEveryColumn)
+{
+    OmmCsvReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "\xEF\xBB\xBFOBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,"
+        "EPHEMERIS_TYPE,CLASSIFICATION_TYPE,NORAD_CAT_ID,ELEMENT_SET_NO,REV_AT_EPOCH,BSTAR,MEAN_MOTION_DOT,MEAN_MOTION_DDOT\r\n"
+        "ISS (ZARYA),1998-067A,2008-09-20T12:25:40.104192,15.72125391,.0006703,51.6416,247.4627,130.536,325.0288,"
+        "0,U,25544,292,56353,-.11606E-4,-.00002182,0\r\n",
+        result);
+
+    CHECK(result.records == 1);
+    CHECK(result.rejected == 0);
+    CHECK(spaceObjects.size() == 1);
+    if (spaceObjects.size() != 1)
+    {
+        return;
+    }
+
+    const SpaceObject& iss = spaceObjects[0];
+    CHECK(iss.GetObjectName() == "ISS (ZARYA)");
+    CHECK(iss.GetObjectId() == "1998-067A");
+    CHECK(iss.GetNoradCatalogueId() == 25544);
+    CHECK_NEAR(GetSeconds(iss.GetEpoch()), 1221913540.104192, 1.0e-6);
+    CHECK_NEAR(iss.GetMeanMotion(), 15.72125391, 1.0e-6);
+    CHECK_NEAR(iss.GetEccentricity(), 0.0006703, 1.0e-9);
+    CHECK_NEAR(iss.GetInclination(), 51.6416, 1.0e-4);
+    CHECK_NEAR(iss.GetRightAscensionOfAscendingNode(), 247.4627, 1.0e-4);
+    CHECK_NEAR(iss.GetArgumentOfPericenter(), 130.536, 1.0e-4);
+    CHECK_NEAR(iss.GetMeanAnomaly(), 325.0288, 1.0e-4);
+    CHECK(iss.GetElementSetNumber() == 292u);
+    CHECK(iss.GetRevolutionsAtEpoch() == 56353u);
+    CHECK_NEAR(iss.GetBstar().value_or(0.0f), -0.11606e-4, 1.0e-10);
+    CHECK_NEAR(iss.GetMeanMotionFirstDerivative().value_or(1.0f), -0.00002182, 1.0e-10);
+}
+
+TEST(OmmCsvReaderFindsColumnsByName)
+{
+    // Columns in another order, an unknown column, a quoted name with a comma and doubled quotes, and an
+    // empty B*, which is absent rather than zero.
+    OmmCsvReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "NORAD_CAT_ID,COMMENT,BSTAR,OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY\n"
+        "100001,ignored,,\"DEBRIS, \"\"A\"\"\",2020-001A,2020-01-01T12:00:00,15,.0001,97.5,120,90,270\n",
+        result);
+
+    CHECK(result.records == 1);
+    CHECK(spaceObjects.size() == 1);
+    if (spaceObjects.size() != 1)
+    {
+        return;
+    }
+
+    CHECK(spaceObjects[0].GetNoradCatalogueId() == 100001);
+    CHECK(spaceObjects[0].GetObjectName() == "DEBRIS, \"A\"");
+    CHECK(spaceObjects[0].GetObjectId() == "2020-001A");
+    CHECK_NEAR(GetSeconds(spaceObjects[0].GetEpoch()), 1577880000.0, 1.0e-6);
+    CHECK(!spaceObjects[0].GetBstar().has_value());
+}
+
+TEST(OmmCsvReaderRejectsRowsMissingRequiredFields)
+{
+    // The second row has no mean anomaly.
+    OmmCsvReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,NORAD_CAT_ID\n"
+        "A,2020-001A,2020-01-01T12:00:00,15,.0001,97.5,120,90,270,1\n"
+        "B,2020-001B,2020-01-01T12:00:00,15,.0001,97.5,120,90,,2\n",
+        result);
+
+    CHECK(result.records == 1);
+    CHECK(result.rejected == 1);
+    CHECK(spaceObjects.size() == 1);
+    CHECK(!spaceObjects.empty() && spaceObjects[0].GetNoradCatalogueId() == 1);
+}
@@ -0,0 +1,118 @@
+#include <chrono>
+
+#include <glm/vec3.hpp>
+
+#include "propagation/sgp4.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+// Element set epochs are a two-digit year and a fractional day of the year, starting at 1.
+double GetEpoch(int year, double dayOfYear)
+{
+    const std::chrono::sys_days yearStart = std::chrono::year(year) / std::chrono::January / 1;
+    return std::chrono::duration<double>(yearStart.time_since_epoch()).count() + (dayOfYear - 1.0) * 86400.0;
+}
+
+struct ReferenceState
+{
+    double minutesSinceEpoch;
+    glm::dvec3 position; // km, TEME
+    glm::dvec3 velocity; // km/s, TEME
+};
+
+void CheckAgainstReference(const Sgp4Elements& elements, const std::vector<ReferenceState>& states)
+{
+    Sgp4 sgp4;
+    const size_t index = sgp4.Add(elements);
+    CHECK(sgp4.GetInitialisationError(index) == Sgp4::Error::None);
+
+    for (const ReferenceState& state : states)
+    {
+        glm::dvec3 position;
+        glm::dvec3 velocity;
+        const Sgp4::Error error = sgp4.Propagate(index, elements.epoch + state.minutesSinceEpoch * 60.0, position, velocity);
+        CHECK(error == Sgp4::Error::None);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            CHECK_NEAR(position[axis], state.position[axis], 1.0e-3);
+            CHECK_NEAR(velocity[axis], state.velocity[axis], 1.0e-6);
+        }
+    }
+}
+
+} // anonymous namespace
+
+// Verification vectors from Vallado et al., "Revisiting Spacetrack Report #3" (AIAA 2006-6753).
+
+// 1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753
+// 2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667
+TEST(Sgp4NearEarthMatchesReference)
+{
+    Sgp4Elements elements;
+    elements.epoch = GetEpoch(2000, 179.78495062);
+    elements.meanMotion = 10.82419157;
+    elements.eccentricity = 0.1859667;
+    elements.inclination = 34.2682;
+    elements.rightAscensionOfAscendingNode = 348.7242;
+    elements.argumentOfPericenter = 331.7664;
+    elements.meanAnomaly = 19.3264;
+    elements.bstar = 0.28098e-4;
+
+    CheckAgainstReference(elements, {
+        { 0.0, { 7022.46529266, -1400.08296755, 0.03995155 }, { 1.893841015, 6.405893759, 4.534807250 } },
+        { 360.0, { -7154.03120202, -3783.17682504, -3536.19412294 }, { 4.741887409, -4.151817765, -2.093935425 } },
+        { 720.0, { -7134.59340119, 6531.68641334, 3260.27186483 }, { -4.113793027, -2.911922039, -2.557327851 } }
+    });
+}
+
+namespace
+{
+
+// 1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813
+// 2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656
+// A 12 hour resonant Molniya orbit, which goes through the deep space model.
+Sgp4Elements GetMolniyaElements()
+{
+    Sgp4Elements elements;
+    elements.epoch = GetEpoch(2006, 176.33215444);
+    elements.meanMotion = 2.00491383;
+    elements.eccentricity = 0.6877146;
+    elements.inclination = 64.1586;
+    elements.rightAscensionOfAscendingNode = 279.0717;
+    elements.argumentOfPericenter = 264.7651;
+    elements.meanAnomaly = 20.2257;
+    elements.bstar = 0.11873e-3;
+    return elements;
+}
+
+const ReferenceState kMolniyaAtEpoch{ 0.0, { 2349.89483350, -14785.93811562, 0.02119378 }, { 2.721488096, -3.256811655, 4.498416672 } };
+
+} // anonymous namespace
+
+TEST(Sgp4DeepSpaceMatchesReference)
+{
+    CheckAgainstReference(GetMolniyaElements(), { kMolniyaAtEpoch });
+}
+
+TEST(Sgp4SetKeepsDeepSpaceSlot)
+{
+    // Setting a slot again must give the same result as adding it, without leaving its old terms behind.
+    const Sgp4Elements elements = GetMolniyaElements();
+    Sgp4 sgp4;
+    const size_t index = sgp4.Add(elements);
+    sgp4.Set(index, elements);
+    sgp4.Set(index, elements);
+
+    glm::dvec3 position;
+    glm::dvec3 velocity;
+    CHECK(sgp4.Propagate(index, elements.epoch, position, velocity) == Sgp4::Error::None);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        CHECK_NEAR(position[axis], kMolniyaAtEpoch.position[axis], 1.0e-3);
+        CHECK_NEAR(velocity[axis], kMolniyaAtEpoch.velocity[axis], 1.0e-6);
+    }
+}
@@ -0,0 +1,91 @@
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "space_objects/omm_csv_reader.hpp"
+#include "space_objects/space_object.hpp"
+#include "space_objects/space_object_catalogue.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+// SpaceObjects can only be filled in by the readers, so each one is read from a row of OMM CSV.
+SpaceObject MakeElementSet(uint32_t noradId, const std::string& name, const std::string& epoch, const std::string& meanAnomaly)
+{
+    const std::string text = "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,NORAD_CAT_ID\n"
+        + name + ",2000-001A," + epoch + ",15.5,.0005,51.6,247.4,130.5," + meanAnomaly + "," + std::to_string(noradId) + "\n";
+
+    SpaceObject spaceObject;
+    OmmCsvReader::Read(text, [&spaceObject](const SpaceObject& row) {
+        spaceObject = row;
+    });
+    return spaceObject;
+}
+
+} // anonymous namespace
+
+TEST(SpaceObjectCatalogueMergesInBatches)
+{
+    SpaceObjectCatalogue catalogue;
+    catalogue.Add(MakeElementSet(1, "SHARED", "2024-01-02T00:00:00", "20"), 1);
+
+    // The shared object has an older and a newer element set in the source, and two new objects follow it.
+    SpaceObjectCatalogue source;
+    source.Add(MakeElementSet(1, "SHARED", "2024-01-01T00:00:00", "10"));
+    source.Add(MakeElementSet(1, "SHARED (RENAMED)", "2024-01-03T00:00:00", "30"));
+    source.Add(MakeElementSet(2, "SECOND", "2024-01-01T00:00:00", "10"));
+    source.Add(MakeElementSet(3, "THIRD", "2024-01-01T00:00:00", "10"));
+
+    std::vector<uint32_t> added;
+    std::vector<uint32_t> updated;
+    catalogue.Merge(source, 0, 2, 2, added, updated);
+    catalogue.Merge(source, 2, source.GetCount(), 2, added, updated);
+    CHECK(added == std::vector<uint32_t>({ 2, 3 }));
+    CHECK(updated == std::vector<uint32_t>({ 1 }));
+    CHECK(catalogue.GetCount() == 3);
+
+    // The record holds the latest element set, under its new name, and the history every one of them.
+    const std::optional<SpaceObjectView> shared = catalogue.GetByNoradId(1);
+    CHECK(shared.has_value() && shared->GetObjectName() == "SHARED (RENAMED)");
+    CHECK_NEAR(shared.has_value() ? shared->GetMeanAnomaly() : 0.0f, 30.0, 1.0e-6);
+    CHECK(catalogue.GetHistory().GetElementSetCount(1) == 3);
+    CHECK(catalogue.GetGroups(1) == 3);
+    CHECK(catalogue.GetGroups(2) == 2);
+    CHECK(catalogue.GetObjectName(3) == "THIRD");
+
+    // Releasing the second group leaves the shared object, which is still in the first.
+    std::vector<uint32_t> removed;
+    catalogue.ReleaseGroups(2, removed);
+    CHECK(removed.size() == 2);
+    CHECK(catalogue.GetObjectName(1) == "SHARED (RENAMED)");
+}
+
+TEST(SpaceObjectCatalogueMergesMappedSnapshots)
+{
+    const std::string filePath = (std::filesystem::temp_directory_path() / "space_object_catalogue_test.snapshot").string();
+    {
+        SpaceObjectCatalogue written;
+        written.Add(MakeElementSet(1, "FIRST", "2024-01-01T00:00:00", "10"));
+        written.Add(MakeElementSet(2, "SECOND", "2024-01-01T00:00:00", "20"));
+        CHECK(written.WriteSnapshot(filePath));
+    }
+
+    // Records come straight from the mapped file, which has no history, so each becomes its object's only
+    // element set.
+    SpaceObjectCatalogue source;
+    CHECK(source.MapSnapshot(filePath));
+    SpaceObjectCatalogue catalogue;
+    std::vector<uint32_t> added;
+    std::vector<uint32_t> updated;
+    catalogue.Merge(source, 0, source.GetCount(), 1, added, updated);
+    CHECK(added.size() == 2);
+    CHECK(catalogue.GetObjectName(2) == "SECOND");
+    CHECK(catalogue.GetHistory().GetElementSetCount(2) == 1);
+    CHECK(catalogue.FindByNamePrefix("FIR", 10) == std::vector<uint32_t>({ 1 }));
+
+    std::filesystem::remove(filePath);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace WingsOfSteel::Test
+{
+
+// A deliberately small test harness, so the tests don't need a framework of their own. TEST() registers a
+// function which the test runner calls in turn; CHECK() and CHECK_NEAR() report a failure and carry on, so a
+// single run shows every failing check.
+struct Case
+{
+    const char* name;
+    std::function<void()> function;
+};
+
+inline std::vector<Case>& GetCases()
+{
+    static std::vector<Case> sCases;
+    return sCases;
+}
+
+inline size_t& GetFailureCount()
+{
+    static size_t sFailureCount = 0;
+    return sFailureCount;
+}
+
+struct Registration
+{
+    Registration(const char* name, std::function<void()> function)
+    {
+        GetCases().push_back({ name, std::move(function) });
+    }
+};
+
+inline void Fail(const char* file, int line, const std::string& message)
+{
+    std::cerr << file << ":" << line << ": " << message << std::endl;
+    ++GetFailureCount();
+}
+
+} // namespace WingsOfSteel::Test
+
+#define TEST_CONCATENATE_INNER(a, b) a##b
+#define TEST_CONCATENATE(a, b) TEST_CONCATENATE_INNER(a, b)
+
+#define TEST(name)                                                                                                    \
+    static void TEST_CONCATENATE(Test_, name)();                                                                      \
+    static WingsOfSteel::Test::Registration TEST_CONCATENATE(sRegistration_, name)(#name, &TEST_CONCATENATE(Test_, name)); \
+    static void TEST_CONCATENATE(Test_, name)()
+
+#define CHECK(condition)                                                                   \
+    do                                                                                     \
+    {                                                                                      \
+        if (!(condition))                                                                  \
+        {                                                                                  \
+            WingsOfSteel::Test::Fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+        }                                                                                  \
+    } while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                                                    \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        const double testActual = static_cast<double>(actual);                                                                     \
+        const double testExpected = static_cast<double>(expected);                                                                 \
+        if (!(std::abs(testActual - testExpected) <= (tolerance)))                                                                 \
+        {                                                                                                                          \
+            WingsOfSteel::Test::Fail(__FILE__, __LINE__, #actual " is " + std::to_string(testActual) + ", expected " + std::to_string(testExpected)); \
+        }                                                                                                                          \
+    } while (false)
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "space_objects/space_object.hpp"
+#include "space_objects/tle_reader.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+
+namespace
+{
+
+std::vector<SpaceObject> Read(std::string_view text, TleReader::Result& result)
+{
+    std::vector<SpaceObject> spaceObjects;
+    result = TleReader::Read(text, [&spaceObjects](const SpaceObject& spaceObject) {
+        spaceObjects.push_back(spaceObject);
+    });
+    return spaceObjects;
+}
+
+double GetSeconds(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+// The example element set from the format's definition on Celestrak.
+TEST(TleReaderReadsEveryColumn)
+{
+    TleReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "ISS (ZARYA)\n"
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927\n"
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537\n",
+        result);
+
+    CHECK(result.records == 1);
+    CHECK(result.rejected == 0);
+    CHECK(spaceObjects.size() == 1);
+    if (spaceObjects.size() != 1)
+    {
+        return;
+    }
+
+    const SpaceObject& iss = spaceObjects[0];
+    CHECK(iss.GetObjectName() == "ISS (ZARYA)");
+    CHECK(iss.GetObjectId() == "1998-067A");
+    CHECK(iss.GetNoradCatalogueId() == 25544);
+    CHECK_NEAR(GetSeconds(iss.GetEpoch()), 1221913540.104, 1.0e-3); // 2008-09-20T12:25:40.104Z
+    CHECK_NEAR(iss.GetInclination(), 51.6416, 1.0e-4);
+    CHECK_NEAR(iss.GetRightAscensionOfAscendingNode(), 247.4627, 1.0e-4);
+    CHECK_NEAR(iss.GetEccentricity(), 0.0006703, 1.0e-9);
+    CHECK_NEAR(iss.GetArgumentOfPericenter(), 130.5360, 1.0e-4);
+    CHECK_NEAR(iss.GetMeanAnomaly(), 325.0288, 1.0e-4);
+    CHECK_NEAR(iss.GetMeanMotion(), 15.72125391, 1.0e-6);
+    CHECK(iss.GetRevolutionsAtEpoch() == 56353u);
+    CHECK(iss.GetElementSetNumber() == 292u);
+    CHECK(iss.GetBstar().has_value());
+    CHECK_NEAR(iss.GetBstar().value_or(0.0f), -0.11606e-4, 1.0e-10);
+    CHECK_NEAR(iss.GetMeanMotionFirstDerivative().value_or(1.0f), -0.00002182, 1.0e-10);
+    CHECK_NEAR(iss.GetMeanMotionSecondDerivative().value_or(1.0f), 0.0, 1.0e-10);
+}
+
+TEST(TleReaderDecodesAlpha5CatalogueNumbers)
+{
+    // A is 10, so A0001 is 100001.
+    TleReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "0 TEST OBJECT\n"
+        "1 A0001U 20001A   20001.50000000  .00000000  00000-0  10000-3 0  9996\n"
+        "2 A0001  97.5000 120.0000 0001000  90.0000 270.0000 15.00000000    13\n",
+        result);
+
+    CHECK(result.records == 1);
+    CHECK(spaceObjects.size() == 1);
+    if (spaceObjects.size() != 1)
+    {
+        return;
+    }
+
+    CHECK(spaceObjects[0].GetNoradCatalogueId() == 100001);
+    CHECK(spaceObjects[0].GetObjectName() == "TEST OBJECT"); // Space-Track's "0 " is dropped
+    CHECK(spaceObjects[0].GetObjectId() == "2020-001A");
+    CHECK_NEAR(GetSeconds(spaceObjects[0].GetEpoch()), 1577880000.0, 1.0e-3); // Noon on 2020-01-01
+    CHECK_NEAR(spaceObjects[0].GetBstar().value_or(0.0f), 1.0e-4, 1.0e-10);
+}
+
+TEST(TleReaderRejectsBadChecksums)
+{
+    // The last digit of the second line is off by one.
+    TleReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927\n"
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563538\n",
+        result);
+
+    CHECK(result.records == 0);
+    CHECK(result.rejected == 1);
+    CHECK(spaceObjects.empty());
+}
+
+TEST(TleReaderReadsTwoLineSetsWithoutTitles)
+{
+    TleReader::Result result;
+    const std::vector<SpaceObject> spaceObjects = Read(
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927\r\n"
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537\r\n"
+        "1 A0001U 20001A   20001.50000000  .00000000  00000-0  10000-3 0  9996\r\n"
+        "2 A0001  97.5000 120.0000 0001000  90.0000 270.0000 15.00000000    13\r\n",
+        result);
+
+    CHECK(result.records == 2);
+    CHECK(spaceObjects.size() == 2);
+    if (spaceObjects.size() != 2)
+    {
+        return;
+    }
+
+    CHECK(spaceObjects[0].GetObjectName() == "UNKNOWN");
+    CHECK(spaceObjects[0].GetNoradCatalogueId() == 25544);
+    CHECK(spaceObjects[1].GetObjectName() == "UNKNOWN");
+    CHECK(spaceObjects[1].GetNoradCatalogueId() == 100001);
+}